@@ -0,0 +1,152 @@
+//! Shared helpers for the benchmark suites.
+//!
+//! Besides the synthetic model generator, this module installs a counting global
+//! allocator, so that every benchmark can report how many allocations an operation
+//! performs and how much the peak resident set size grows while it runs.
+
+#![allow(dead_code)]
+
+use std::{
+    alloc::{GlobalAlloc, Layout, System},
+    sync::atomic::{AtomicUsize, Ordering},
+};
+
+use sbml::prelude::*;
+
+/// Model sizes (number of species and reactions) every benchmark is run for.
+pub const SIZES: [usize; 3] = [1_000, 10_000, 100_000];
+
+/// A global allocator that counts allocations on top of the system allocator.
+pub struct CountingAllocator;
+
+static ALLOCATIONS: AtomicUsize = AtomicUsize::new(0);
+static ALLOCATED_BYTES: AtomicUsize = AtomicUsize::new(0);
+
+unsafe impl GlobalAlloc for CountingAllocator {
+    unsafe fn alloc(&self, layout: Layout) -> *mut u8 {
+        ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+        ALLOCATED_BYTES.fetch_add(layout.size(), Ordering::Relaxed);
+        System.alloc(layout)
+    }
+
+    unsafe fn dealloc(&self, ptr: *mut u8, layout: Layout) {
+        System.dealloc(ptr, layout)
+    }
+
+    unsafe fn realloc(&self, ptr: *mut u8, layout: Layout, new_size: usize) -> *mut u8 {
+        ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+        ALLOCATED_BYTES.fetch_add(new_size, Ordering::Relaxed);
+        System.realloc(ptr, layout, new_size)
+    }
+}
+
+#[global_allocator]
+static GLOBAL: CountingAllocator = CountingAllocator;
+
+/// Runs an operation once and prints the Rust-side allocations it performed and the
+/// growth of the peak resident set size.
+///
+/// Allocations made by libSBML itself go through the C++ allocator and are not
+/// counted, but they are reflected in the peak RSS.
+pub fn report<T>(label: &str, operation: impl FnOnce() -> T) -> T {
+    reset_peak_rss();
+    let rss_before = peak_rss_kb();
+    let allocations = ALLOCATIONS.load(Ordering::Relaxed);
+    let bytes = ALLOCATED_BYTES.load(Ordering::Relaxed);
+
+    let result = operation();
+
+    let allocations = ALLOCATIONS.load(Ordering::Relaxed) - allocations;
+    let bytes = ALLOCATED_BYTES.load(Ordering::Relaxed) - bytes;
+    let rss = match (rss_before, peak_rss_kb()) {
+        (Some(before), Some(after)) => format!("{} KiB", after.saturating_sub(before)),
+        _ => "n/a".to_string(),
+    };
+    eprintln!("{label:<48} allocations: {allocations:>10}  bytes: {bytes:>12}  peak RSS +{rss}");
+
+    result
+}
+
+/// Returns the peak resident set size of the process in KiB, if available.
+fn peak_rss_kb() -> Option<u64> {
+    let status = std::fs::read_to_string("/proc/self/status").ok()?;
+    status
+        .lines()
+        .find_map(|line| line.strip_prefix("VmHWM:"))
+        .and_then(|value| value.trim().trim_end_matches("kB").trim().parse().ok())
+}
+
+/// Resets the peak resident set size to the current one, where supported.
+fn reset_peak_rss() {
+    let _ = std::fs::write("/proc/self/clear_refs", "5");
+}
+
+/// Builds a synthetic model with `n` species, `n` reactions and `n / 10` parameters.
+///
+/// Every reaction converts one species into the next one, following mass action
+/// kinetics, so that all reactions and species references are valid.
+pub fn synthetic_document(n: usize) -> SBMLDocument {
+    let doc = SBMLDocument::default();
+    let model = doc.create_model("synthetic");
+    model
+        .build_compartment("cell")
+        .size(1.0)
+        .constant(true)
+        .build();
+
+    let species_ids: Vec<String> = (0..n).map(|i| format!("s{i}")).collect();
+    let species: Vec<SpeciesSpec> = species_ids
+        .iter()
+        .map(|id| {
+            SpeciesSpec::new(id)
+                .compartment("cell")
+                .initial_concentration(1.0)
+                .boundary_condition(false)
+                .constant(false)
+                .has_only_substance_units(false)
+        })
+        .collect();
+    model.add_species_batch(&species);
+
+    let parameter_ids: Vec<String> = (0..n.div_ceil(10)).map(|i| format!("k{i}")).collect();
+    let parameters: Vec<ParameterSpec> = parameter_ids
+        .iter()
+        .map(|id| ParameterSpec::new(id).value(0.1).constant(true))
+        .collect();
+    model.add_parameters_batch(&parameters);
+
+    let reaction_ids: Vec<String> = (0..n).map(|i| format!("r{i}")).collect();
+    let stoichiometries: Vec<([(&str, f64); 1], [(&str, f64); 1])> = (0..n)
+        .map(|i| {
+            (
+                [(species_ids[i].as_str(), 1.0)],
+                [(species_ids[(i + 1) % n].as_str(), 1.0)],
+            )
+        })
+        .collect();
+    let formulas: Vec<String> = (0..n)
+        .map(|i| format!("{} * {}", parameter_ids[i / 10], species_ids[i]))
+        .collect();
+    let reactions: Vec<ReactionSpec> = (0..n)
+        .map(|i| {
+            ReactionSpec::new(&reaction_ids[i])
+                .reversible(false)
+                .reactants(&stoichiometries[i].0)
+                .products(&stoichiometries[i].1)
+                .kinetic_law(&formulas[i])
+        })
+        .collect();
+    model.add_reactions_batch(&reactions);
+
+    doc
+}
+
+/// Serializes a synthetic model of the given size.
+pub fn synthetic_xml(n: usize) -> String {
+    synthetic_document(n).to_xml_string()
+}
+
+/// Returns `count` species ids spread evenly over a synthetic model of size `n`.
+pub fn lookup_ids(n: usize, count: usize) -> Vec<String> {
+    (0..count).map(|i| format!("s{}", i * n / count)).collect()
+}
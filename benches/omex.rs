@@ -0,0 +1,82 @@
+//! Benchmarks for opening, reading and saving COMBINE archives.
+//!
+//! Run with `cargo bench --bench omex`. Every archive holds a synthetic SBML model
+//! and a data table of matching size.
+
+mod common;
+
+use std::{hint::black_box, path::PathBuf};
+
+use common::{report, synthetic_xml, SIZES};
+use criterion::{criterion_group, criterion_main, BenchmarkId, Criterion};
+use sbml::combine::{CombineArchive, KnownFormats};
+
+/// Writes an archive with a model of size `n` and returns its path.
+fn create_archive(dir: &tempfile::TempDir, n: usize) -> PathBuf {
+    let path = dir.path().join(format!("synthetic_{n}.omex"));
+    let model = synthetic_xml(n);
+    let data: String = (0..n)
+        .map(|i| format!("{i}\t{}\n", i as f64 * 0.5))
+        .collect();
+
+    let mut archive = CombineArchive::new();
+    archive
+        .add_entry("./model.xml", KnownFormats::SBML, true, model.as_bytes())
+        .unwrap();
+    archive
+        .add_entry("./data.tsv", KnownFormats::TSV, false, data.as_bytes())
+        .unwrap();
+    archive.save(&path).unwrap();
+    path
+}
+
+fn bench_omex(c: &mut Criterion) {
+    let dir = tempfile::tempdir().unwrap();
+    let archives: Vec<(usize, PathBuf)> = SIZES
+        .iter()
+        .map(|&n| (n, create_archive(&dir, n)))
+        .collect();
+
+    for (n, path) in &archives {
+        let mut archive = report(&format!("omex/open/{n}"), || {
+            CombineArchive::open(path).unwrap()
+        });
+        report(&format!("omex/entry/{n}"), || {
+            archive.entry("./model.xml").unwrap().as_bytes().len()
+        });
+        let target = dir.path().join(format!("report_{n}.omex"));
+        report(&format!("omex/save/{n}"), || archive.save(&target).unwrap());
+    }
+
+    let mut group = c.benchmark_group("omex/open");
+    for (n, path) in &archives {
+        group.bench_with_input(BenchmarkId::from_parameter(n), path, |b, path| {
+            b.iter(|| CombineArchive::open(black_box(path)).unwrap())
+        });
+    }
+    group.finish();
+
+    let mut group = c.benchmark_group("omex/entry");
+    group.sample_size(10);
+    for (n, path) in &archives {
+        let mut archive = CombineArchive::open(path).unwrap();
+        group.bench_function(BenchmarkId::from_parameter(n), |b| {
+            b.iter(|| archive.entry(black_box("./model.xml")).unwrap())
+        });
+    }
+    group.finish();
+
+    let mut group = c.benchmark_group("omex/save");
+    group.sample_size(10);
+    for (n, path) in &archives {
+        let mut archive = CombineArchive::open(path).unwrap();
+        let target = dir.path().join(format!("saved_{n}.omex"));
+        group.bench_function(BenchmarkId::from_parameter(n), |b| {
+            b.iter(|| archive.save(&target).unwrap())
+        });
+    }
+    group.finish();
+}
+
+criterion_group!(benches, bench_omex);
+criterion_main!(benches);
@@ -0,0 +1,116 @@
+//! Benchmarks for reading, wrapping, querying, writing and validating SBML models.
+//!
+//! Run with `cargo bench --bench sbml`. Before the timed runs, the allocations and
+//! peak RSS growth of every operation are printed once per model size.
+
+mod common;
+
+use std::hint::black_box;
+
+use common::{lookup_ids, report, synthetic_xml, SIZES};
+use criterion::{criterion_group, criterion_main, BatchSize, BenchmarkId, Criterion};
+use sbml::prelude::*;
+
+/// Number of `get_species` lookups per iteration.
+const LOOKUPS: usize = 1_000;
+
+fn report_allocations(xmls: &[(usize, String)]) {
+    for (n, xml) in xmls {
+        let doc = report(&format!("reader/from_xml_string/{n}"), || {
+            SBMLReader::from_xml_string(xml)
+        });
+        let model = report(&format!("document/model/{n}"), || doc.model().unwrap());
+        report(&format!("model/list_of_species/{n}"), || {
+            model.list_of_species().len()
+        });
+        let ids = lookup_ids(*n, LOOKUPS);
+        report(&format!("model/get_species/{n}"), || {
+            ids.iter().filter_map(|id| model.get_species(id)).count()
+        });
+        report(&format!("writer/to_xml_string/{n}"), || {
+            doc.to_xml_string().len()
+        });
+        report(&format!("validation/check_consistency/{n}"), || {
+            doc.check_consistency().errors.len()
+        });
+    }
+}
+
+fn bench_sbml(c: &mut Criterion) {
+    let xmls: Vec<(usize, String)> = SIZES.iter().map(|&n| (n, synthetic_xml(n))).collect();
+    report_allocations(&xmls);
+
+    let mut group = c.benchmark_group("reader/from_xml_string");
+    group.sample_size(10);
+    for (n, xml) in &xmls {
+        group.bench_with_input(BenchmarkId::from_parameter(n), xml, |b, xml| {
+            b.iter(|| SBMLReader::from_xml_string(black_box(xml)))
+        });
+    }
+    group.finish();
+
+    let mut group = c.benchmark_group("document/model");
+    group.sample_size(10);
+    for (n, xml) in &xmls {
+        let doc = SBMLReader::from_xml_string(xml);
+        group.bench_function(BenchmarkId::from_parameter(n), |b| {
+            b.iter(|| black_box(doc.model()))
+        });
+    }
+    group.finish();
+
+    let mut group = c.benchmark_group("model/list_of_species");
+    group.sample_size(10);
+    for (n, xml) in &xmls {
+        let doc = SBMLReader::from_xml_string(xml);
+        group.bench_function(BenchmarkId::from_parameter(n), |b| {
+            b.iter_batched(
+                || doc.model().unwrap(),
+                |model| model.list_of_species().len(),
+                BatchSize::PerIteration,
+            )
+        });
+    }
+    group.finish();
+
+    let mut group = c.benchmark_group("model/get_species");
+    for (n, xml) in &xmls {
+        let doc = SBMLReader::from_xml_string(xml);
+        let model = doc.model().unwrap();
+        let ids = lookup_ids(*n, LOOKUPS);
+        group.bench_function(BenchmarkId::from_parameter(n), |b| {
+            b.iter(|| {
+                ids.iter()
+                    .filter_map(|id| model.get_species(black_box(id)))
+                    .count()
+            })
+        });
+    }
+    group.finish();
+
+    let mut group = c.benchmark_group("writer/to_xml_string");
+    group.sample_size(10);
+    for (n, xml) in &xmls {
+        let doc = SBMLReader::from_xml_string(xml);
+        group.bench_function(BenchmarkId::from_parameter(n), |b| {
+            b.iter(|| doc.to_xml_string())
+        });
+    }
+    group.finish();
+
+    let mut group = c.benchmark_group("validation/check_consistency");
+    group.sample_size(10);
+    for (n, xml) in &xmls {
+        group.bench_function(BenchmarkId::from_parameter(n), |b| {
+            b.iter_batched(
+                || SBMLReader::from_xml_string(xml),
+                |doc| doc.check_consistency(),
+                BatchSize::PerIteration,
+            )
+        });
+    }
+    group.finish();
+}
+
+criterion_group!(benches, bench_sbml);
+criterion_main!(benches);
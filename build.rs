@@ -26,6 +26,7 @@ fn main() -> Result<(), BuilderError> {
     // Ensure cargo rebuilds if this build script changes
     println!("cargo:rerun-if-changed=build.rs");
     println!("cargo:rerun-if-changed=src/lib.rs");
+    println!("cargo:rerun-if-changed=src/shim.h");
 
     let (include_paths, cargo_metadata) =
         if let Ok((paths, link_paths)) = from_pkg_config("libsbml") {
@@ -0,0 +1,585 @@
+//! Bulk construction of model components.
+//!
+//! Creating elements one by one through [`Model::create_species`] or the builders
+//! crosses the FFI boundary once per setter and converts every string argument on the
+//! way. For generated models with tens of thousands of elements this overhead quickly
+//! dominates. The specs in this module describe a complete element up front, so that
+//! [`Model::add_species_batch`], [`Model::add_parameters_batch`] and
+//! [`Model::add_reactions_batch`] can create and populate a whole batch through a
+//! single call into the C++ helpers in `src/shim.h`. Numeric attributes are passed as
+//! packed arrays and all strings of the batch as one buffer with offsets, and the
+//! native lists are grown once for the whole batch.
+//!
+//! # Example
+//!
+//! ```no_run
+//! use sbml::prelude::*;
+//!
+//! let doc = SBMLDocument::default();
+//! let model = doc.create_model("batch");
+//! model.create_compartment("cytosol");
+//!
+//! let species = ["glc", "g6p"].map(|id| SpeciesSpec::new(id).compartment("cytosol"));
+//! model.add_species_batch(&species);
+//!
+//! let reactions = [ReactionSpec::new("hk")
+//!     .reactants(&[("glc", 1.0)])
+//!     .products(&[("g6p", 1.0)])
+//!     .kinetic_law("k * glc")];
+//! model.add_reactions_batch(&reactions);
+//! ```
+
+use std::rc::Rc;
+
+use autocxx::c_int;
+
+use crate::{
+    model::Model,
+    parameter::Parameter,
+    reaction::Reaction,
+    sbmlcxx::{self},
+    species::Species,
+    traits::{fromptr::FromPtr, inner::Inner},
+};
+
+/// Description of a species to be created by [`Model::add_species_batch`].
+///
+/// Attributes left as `None` keep the libSBML defaults.
+#[derive(Debug, Clone, Copy, Default, PartialEq)]
+pub struct SpeciesSpec<'s> {
+    /// Identifier of the species
+    pub id: &'s str,
+    /// Human readable name
+    pub name: Option<&'s str>,
+    /// Identifier of the compartment the species resides in
+    pub compartment: Option<&'s str>,
+    /// Initial amount of the species
+    pub initial_amount: Option<f64>,
+    /// Initial concentration of the species
+    pub initial_concentration: Option<f64>,
+    /// Substance units of the species
+    pub unit: Option<&'s str>,
+    /// Whether the species is a boundary species
+    pub boundary_condition: Option<bool>,
+    /// Whether the amount of the species is constant
+    pub constant: Option<bool>,
+    /// Whether the species is expressed in substance units only
+    pub has_only_substance_units: Option<bool>,
+}
+
+impl<'s> SpeciesSpec<'s> {
+    /// Creates a spec for a species with the given id and default attributes.
+    pub fn new(id: &'s str) -> Self {
+        Self {
+            id,
+            ..Default::default()
+        }
+    }
+
+    /// Sets the name of the species.
+    pub fn name(mut self, name: &'s str) -> Self {
+        self.name = Some(name);
+        self
+    }
+
+    /// Sets the compartment of the species.
+    pub fn compartment(mut self, compartment: &'s str) -> Self {
+        self.compartment = Some(compartment);
+        self
+    }
+
+    /// Sets the initial amount of the species.
+    pub fn initial_amount(mut self, amount: f64) -> Self {
+        self.initial_amount = Some(amount);
+        self
+    }
+
+    /// Sets the initial concentration of the species.
+    pub fn initial_concentration(mut self, concentration: f64) -> Self {
+        self.initial_concentration = Some(concentration);
+        self
+    }
+
+    /// Sets the substance units of the species.
+    pub fn unit(mut self, unit: &'s str) -> Self {
+        self.unit = Some(unit);
+        self
+    }
+
+    /// Sets whether the species is a boundary species.
+    pub fn boundary_condition(mut self, boundary: bool) -> Self {
+        self.boundary_condition = Some(boundary);
+        self
+    }
+
+    /// Sets whether the amount of the species is constant.
+    pub fn constant(mut self, constant: bool) -> Self {
+        self.constant = Some(constant);
+        self
+    }
+
+    /// Sets whether the species is expressed in substance units only.
+    pub fn has_only_substance_units(mut self, has_only_substance_units: bool) -> Self {
+        self.has_only_substance_units = Some(has_only_substance_units);
+        self
+    }
+}
+
+/// Description of a parameter to be created by [`Model::add_parameters_batch`].
+///
+/// Attributes left as `None` keep the libSBML defaults.
+#[derive(Debug, Clone, Copy, Default, PartialEq)]
+pub struct ParameterSpec<'s> {
+    /// Identifier of the parameter
+    pub id: &'s str,
+    /// Human readable name
+    pub name: Option<&'s str>,
+    /// Value of the parameter
+    pub value: Option<f64>,
+    /// Units of the parameter
+    pub units: Option<&'s str>,
+    /// Whether the parameter is constant
+    pub constant: Option<bool>,
+}
+
+impl<'s> ParameterSpec<'s> {
+    /// Creates a spec for a parameter with the given id and default attributes.
+    pub fn new(id: &'s str) -> Self {
+        Self {
+            id,
+            ..Default::default()
+        }
+    }
+
+    /// Sets the name of the parameter.
+    pub fn name(mut self, name: &'s str) -> Self {
+        self.name = Some(name);
+        self
+    }
+
+    /// Sets the value of the parameter.
+    pub fn value(mut self, value: f64) -> Self {
+        self.value = Some(value);
+        self
+    }
+
+    /// Sets the units of the parameter.
+    pub fn units(mut self, units: &'s str) -> Self {
+        self.units = Some(units);
+        self
+    }
+
+    /// Sets whether the parameter is constant.
+    pub fn constant(mut self, constant: bool) -> Self {
+        self.constant = Some(constant);
+        self
+    }
+}
+
+/// Description of a reaction to be created by [`Model::add_reactions_batch`].
+///
+/// Reactants and products are given as `(species id, stoichiometry)` pairs.
+#[derive(Debug, Clone, Copy, Default, PartialEq)]
+pub struct ReactionSpec<'s> {
+    /// Identifier of the reaction
+    pub id: &'s str,
+    /// Human readable name
+    pub name: Option<&'s str>,
+    /// Whether the reaction is reversible
+    pub reversible: Option<bool>,
+    /// Species consumed by the reaction
+    pub reactants: &'s [(&'s str, f64)],
+    /// Species produced by the reaction
+    pub products: &'s [(&'s str, f64)],
+    /// Species modifying the reaction without being consumed or produced
+    pub modifiers: &'s [&'s str],
+    /// Infix formula of the kinetic law
+    pub kinetic_law: Option<&'s str>,
+}
+
+impl<'s> ReactionSpec<'s> {
+    /// Creates a spec for a reaction with the given id and no participants.
+    pub fn new(id: &'s str) -> Self {
+        Self {
+            id,
+            ..Default::default()
+        }
+    }
+
+    /// Sets the name of the reaction.
+    pub fn name(mut self, name: &'s str) -> Self {
+        self.name = Some(name);
+        self
+    }
+
+    /// Sets whether the reaction is reversible.
+    pub fn reversible(mut self, reversible: bool) -> Self {
+        self.reversible = Some(reversible);
+        self
+    }
+
+    /// Sets the reactants of the reaction.
+    pub fn reactants(mut self, reactants: &'s [(&'s str, f64)]) -> Self {
+        self.reactants = reactants;
+        self
+    }
+
+    /// Sets the products of the reaction.
+    pub fn products(mut self, products: &'s [(&'s str, f64)]) -> Self {
+        self.products = products;
+        self
+    }
+
+    /// Sets the modifiers of the reaction.
+    pub fn modifiers(mut self, modifiers: &'s [&'s str]) -> Self {
+        self.modifiers = modifiers;
+        self
+    }
+
+    /// Sets the kinetic law of the reaction from an infix formula.
+    pub fn kinetic_law(mut self, formula: &'s str) -> Self {
+        self.kinetic_law = Some(formula);
+        self
+    }
+}
+
+/// Creates one native species per spec in a single FFI call and wraps them.
+pub(crate) fn create_species<'a>(model: &Model<'a>, specs: &[SpeciesSpec]) -> Vec<Rc<Species<'a>>> {
+    let mut strings = StringArena::with_capacity(specs.len() * 4);
+    let mut values = Vec::with_capacity(specs.len() * 2);
+    let mut flags = Vec::with_capacity(specs.len() * 3);
+    for spec in specs {
+        strings.push(spec.id);
+        strings.push(spec.name.unwrap_or_default());
+        strings.push(spec.compartment.unwrap_or_default());
+        strings.push(spec.unit.unwrap_or_default());
+        values.push(spec.initial_amount.unwrap_or(f64::NAN));
+        values.push(spec.initial_concentration.unwrap_or(f64::NAN));
+        flags.push(flag(spec.boundary_condition));
+        flags.push(flag(spec.constant));
+        flags.push(flag(spec.has_only_substance_units));
+    }
+
+    let mut created = vec![0usize; specs.len()];
+    // SAFETY: All buffers hold the number of entries the shim reads for
+    // `specs.len()` species and outlive the call
+    unsafe {
+        sbmlcxx::sbmlrs::createSpeciesBatch(
+            model.inner().borrow_mut().as_mut(),
+            specs.len(),
+            strings.bytes.as_ptr().cast(),
+            strings.offsets.as_ptr(),
+            values.as_ptr(),
+            flags.as_ptr(),
+            created.as_mut_ptr(),
+        );
+    }
+
+    created
+        .into_iter()
+        .map(|address| {
+            Rc::new(
+                Species::from_ptr(address as *mut sbmlcxx::Species).with_changes(model.changes()),
+            )
+        })
+        .collect()
+}
+
+/// Creates one native parameter per spec in a single FFI call and wraps them.
+pub(crate) fn create_parameters<'a>(
+    model: &Model<'a>,
+    specs: &[ParameterSpec],
+) -> Vec<Rc<Parameter<'a>>> {
+    let mut strings = StringArena::with_capacity(specs.len() * 3);
+    let mut values = Vec::with_capacity(specs.len());
+    let mut flags = Vec::with_capacity(specs.len());
+    for spec in specs {
+        strings.push(spec.id);
+        strings.push(spec.name.unwrap_or_default());
+        strings.push(spec.units.unwrap_or_default());
+        values.push(spec.value.unwrap_or(f64::NAN));
+        flags.push(flag(spec.constant));
+    }
+
+    let mut created = vec![0usize; specs.len()];
+    // SAFETY: All buffers hold the number of entries the shim reads for
+    // `specs.len()` parameters and outlive the call
+    unsafe {
+        sbmlcxx::sbmlrs::createParametersBatch(
+            model.inner().borrow_mut().as_mut(),
+            specs.len(),
+            strings.bytes.as_ptr().cast(),
+            strings.offsets.as_ptr(),
+            values.as_ptr(),
+            flags.as_ptr(),
+            created.as_mut_ptr(),
+        );
+    }
+
+    created
+        .into_iter()
+        .map(|address| {
+            Rc::new(
+                Parameter::from_ptr(address as *mut sbmlcxx::Parameter)
+                    .with_changes(model.changes()),
+            )
+        })
+        .collect()
+}
+
+/// Creates one native reaction per spec, including its species references and
+/// kinetic law, in a single FFI call and wraps them.
+///
+/// The species references are not wrapped here. Like for reactions read from a
+/// document, they are wrapped on first access.
+pub(crate) fn create_reactions<'a>(
+    model: &Model<'a>,
+    specs: &[ReactionSpec],
+) -> Vec<Rc<Reaction<'a>>> {
+    let n_references: usize = specs
+        .iter()
+        .map(|spec| spec.reactants.len() + spec.products.len())
+        .sum();
+    let n_modifiers: usize = specs.iter().map(|spec| spec.modifiers.len()).sum();
+
+    let mut strings = StringArena::with_capacity(specs.len() * 3 + n_references + n_modifiers);
+    let mut counts = Vec::with_capacity(specs.len() * 3);
+    let mut stoichiometries = Vec::with_capacity(n_references);
+    let mut flags = Vec::with_capacity(specs.len() * 2);
+    for spec in specs {
+        strings.push(spec.id);
+        strings.push(spec.name.unwrap_or_default());
+        strings.push(spec.kinetic_law.unwrap_or_default());
+        for &(species, stoichiometry) in spec.reactants.iter().chain(spec.products) {
+            strings.push(species);
+            stoichiometries.push(stoichiometry);
+        }
+        for species in spec.modifiers {
+            strings.push(species);
+        }
+        counts.extend([
+            spec.reactants.len(),
+            spec.products.len(),
+            spec.modifiers.len(),
+        ]);
+        flags.push(flag(spec.reversible));
+        flags.push(flag(Some(spec.kinetic_law.is_some())));
+    }
+
+    let mut created = vec![0usize; specs.len()];
+    // SAFETY: All buffers hold the number of entries the shim reads for
+    // `specs.len()` reactions and their participants and outlive the call
+    unsafe {
+        sbmlcxx::sbmlrs::createReactionsBatch(
+            model.inner().borrow_mut().as_mut(),
+            specs.len(),
+            strings.bytes.as_ptr().cast(),
+            strings.offsets.as_ptr(),
+            counts.as_ptr(),
+            stoichiometries.as_ptr(),
+            flags.as_ptr(),
+            created.as_mut_ptr(),
+        );
+    }
+
+    created
+        .into_iter()
+        .map(|address| {
+            let reaction = Reaction::from_ptr(address as *mut sbmlcxx::Reaction);
+            Rc::new(reaction.tracked_by(model).with_changes(model.changes()))
+        })
+        .collect()
+}
+
+/// Strings of a batch, stored back to back in a single buffer.
+///
+/// String `i` spans the bytes from `offsets[i]` to `offsets[i + 1]`, so that the
+/// shim can read all strings of a batch from two pointers.
+struct StringArena {
+    bytes: Vec<u8>,
+    offsets: Vec<usize>,
+}
+
+impl StringArena {
+    /// Creates an empty arena with room for `strings` offsets.
+    fn with_capacity(strings: usize) -> Self {
+        let mut offsets = Vec::with_capacity(strings + 1);
+        offsets.push(0);
+        Self {
+            bytes: Vec::new(),
+            offsets,
+        }
+    }
+
+    /// Appends a string.
+    fn push(&mut self, value: &str) {
+        self.bytes.extend_from_slice(value.as_bytes());
+        self.offsets.push(self.bytes.len());
+    }
+}
+
+/// Encodes an optional flag for the shim, where negative values mean unset.
+fn flag(value: Option<bool>) -> c_int {
+    match value {
+        None => c_int(-1),
+        Some(false) => c_int(0),
+        Some(true) => c_int(1),
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use crate::prelude::*;
+
+    #[test]
+    fn test_add_species_batch() {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("test");
+        model.create_compartment("cytosol");
+
+        let existing = model.create_species("existing");
+        let specs = [
+            SpeciesSpec::new("glc")
+                .name("Glucose")
+                .compartment("cytosol")
+                .initial_concentration(10.0)
+                .unit("mole"),
+            SpeciesSpec::new("atp")
+                .compartment("cytosol")
+                .initial_amount(2.5)
+                .boundary_condition(true)
+                .constant(true)
+                .has_only_substance_units(true),
+        ];
+        let created = model.add_species_batch(&specs);
+
+        assert_eq!(created.len(), 2);
+        assert_eq!(model.list_of_species().len(), 3);
+        assert_eq!(model.list_of_species()[0].id(), existing.id());
+
+        let glc = model.get_species("glc").expect("species not found");
+        assert_eq!(glc.name(), Some("Glucose".to_string()));
+        assert_eq!(glc.compartment(), Some("cytosol".to_string()));
+        assert_eq!(glc.initial_concentration(), Some(10.0));
+        assert_eq!(glc.initial_amount(), None);
+        assert_eq!(glc.unit(), Some("mole".to_string()));
+        assert!(!glc.constant());
+
+        let atp = model.get_species("atp").expect("species not found");
+        assert_eq!(atp.name(), None);
+        assert_eq!(atp.initial_amount(), Some(2.5));
+        assert_eq!(atp.boundary_condition(), Some(true));
+        assert!(atp.constant());
+        assert_eq!(atp.has_only_substance_units(), Some(true));
+    }
+
+    #[test]
+    fn test_add_parameters_batch() {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("test");
+
+        let specs = [
+            ParameterSpec::new("k1").value(0.5).units("per_second"),
+            ParameterSpec::new("k2").name("Rate 2").constant(false),
+        ];
+        model.add_parameters_batch(&specs);
+
+        let k1 = model.get_parameter("k1").expect("parameter not found");
+        assert_eq!(k1.value(), Some(0.5));
+        assert_eq!(k1.units(), Some("per_second".to_string()));
+        assert_eq!(k1.constant(), Some(true));
+
+        let k2 = model.get_parameter("k2").expect("parameter not found");
+        assert_eq!(k2.name(), Some("Rate 2".to_string()));
+        assert_eq!(k2.value(), None);
+        assert_eq!(k2.constant(), Some(false));
+    }
+
+    #[test]
+    fn test_add_reactions_batch() {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("test");
+        model.add_species_batch(&["a", "b", "e"].map(SpeciesSpec::new));
+
+        let specs = [
+            ReactionSpec::new("r1")
+                .name("Conversion")
+                .reversible(false)
+                .reactants(&[("a", 2.0)])
+                .products(&[("b", 1.0)])
+                .modifiers(&["e"])
+                .kinetic_law("k1 * a"),
+            ReactionSpec::new("r2").reactants(&[("b", 1.0)]),
+        ];
+        let created = model.add_reactions_batch(&specs);
+        assert_eq!(created.len(), 2);
+
+        let r1 = model.get_reaction("r1").expect("reaction not found");
+        assert_eq!(r1.name(), Some("Conversion".to_string()));
+        assert_eq!(r1.reversible(), Some(false));
+        assert_eq!(r1.reactants().borrow().len(), 1);
+        assert_eq!(r1.reactants().borrow()[0].species(), "a");
+        assert_eq!(r1.reactants().borrow()[0].stoichiometry(), 2.0);
+        assert_eq!(r1.products().borrow()[0].species(), "b");
+        assert_eq!(r1.modifiers().borrow()[0].species(), "e");
+        assert_eq!(
+            r1.kinetic_law().expect("kinetic law not set").formula(),
+            "k1 * a"
+        );
+
+        let r2 = model.get_reaction("r2").expect("reaction not found");
+        assert!(r2.products().borrow().is_empty());
+        assert!(r2.kinetic_law().is_none());
+
+        // Batch-created reactions can be extended through the regular API
+        r2.create_product("a", 1.0);
+        assert_eq!(r2.products().borrow().len(), 1);
+    }
+
+    #[test]
+    fn test_packed_batch_layout() {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("test");
+        let ids: Vec<String> = (0..100).map(|i| format!("s{i}")).collect();
+        let species: Vec<SpeciesSpec> = ids
+            .iter()
+            .enumerate()
+            .map(|(i, id)| SpeciesSpec::new(id).initial_amount(i as f64))
+            .collect();
+        model.add_species_batch(&species);
+
+        // Reaction s<i> produces s<i+1> and s<i+2> and is modified by s<i+1>
+        let products: Vec<[(&str, f64); 2]> = ids
+            .windows(3)
+            .map(|window| [(window[1].as_str(), 1.0), (window[2].as_str(), 2.0)])
+            .collect();
+        let modifiers: Vec<[&str; 1]> = ids.windows(3).map(|window| [window[1].as_str()]).collect();
+        let reactions: Vec<ReactionSpec> = ids
+            .iter()
+            .zip(&products)
+            .zip(&modifiers)
+            .map(|((id, products), modifiers)| {
+                ReactionSpec::new(id)
+                    .products(products)
+                    .modifiers(modifiers)
+            })
+            .collect();
+        let created = model.add_reactions_batch(&reactions);
+        assert_eq!(created.len(), 98);
+
+        assert_eq!(
+            model.get_species("s42").unwrap().initial_amount(),
+            Some(42.0)
+        );
+        let reaction = model.get_reaction("s57").expect("reaction not found");
+        let products = reaction.products();
+        let products = products.borrow();
+        assert_eq!(products.len(), 2);
+        assert_eq!(products[0].species(), "s58");
+        assert_eq!(products[1].species(), "s59");
+        assert_eq!(products[1].stoichiometry(), 2.0);
+        assert!(reaction.reactants().borrow().is_empty());
+        assert_eq!(reaction.modifiers().borrow()[0].species(), "s58");
+        assert!(reaction.kinetic_law().is_none());
+    }
+}
@@ -1,6 +1,6 @@
 use std::{cell::RefCell, pin::Pin};
 
-use crate::{inner, model::Model, pin_ptr, sbmlcxx, upcast_annotation};
+use crate::{incremental::ChangeTracker, inner, model::Model, pin_ptr, sbmlcxx, upcast_annotation};
 
 /// A safe wrapper around the libSBML ListOfParameters class.
 ///
@@ -9,6 +9,10 @@ use crate::{inner, model::Model, pin_ptr, sbmlcxx, upcast_annotation};
 pub struct ListOfParameters<'a> {
     /// The underlying libSBML Model pointer wrapped in RefCell and Pin
     inner: RefCell<Pin<&'a mut sbmlcxx::ListOfParameters>>,
+    /// Cache of the most recently deserialized annotation
+    annotation_cache: AnnotationCache,
+    /// Marks the section of the document that contains this element
+    changes: ChangeTracker<'a>,
 }
 
 impl<'a> ListOfParameters<'a> {
@@ -18,6 +22,8 @@ impl<'a> ListOfParameters<'a> {
 
         Self {
             inner: RefCell::new(parameters),
+            annotation_cache: AnnotationCache::default(),
+            changes: model.changes(),
         }
     }
 }
@@ -1,6 +1,8 @@
 use std::{cell::RefCell, pin::Pin};
 
-use crate::{inner, model::Model, pin_ptr, sbase, sbmlcxx, upcast_annotation};
+use crate::{
+    incremental::ChangeTracker, inner, model::Model, pin_ptr, sbase, sbmlcxx, upcast_annotation,
+};
 
 /// A safe wrapper around the libSBML ListOfReactions class.
 ///
@@ -9,6 +11,10 @@ use crate::{inner, model::Model, pin_ptr, sbase, sbmlcxx, upcast_annotation};
 pub struct ListOfReactions<'a> {
     /// The underlying libSBML Model pointer wrapped in RefCell and Pin
     inner: RefCell<Pin<&'a mut sbmlcxx::ListOfReactions>>,
+    /// Cache of the most recently deserialized annotation
+    annotation_cache: AnnotationCache,
+    /// Marks the section of the document that contains this element
+    changes: ChangeTracker<'a>,
 }
 
 impl<'a> ListOfReactions<'a> {
@@ -18,6 +24,8 @@ impl<'a> ListOfReactions<'a> {
 
         Self {
             inner: RefCell::new(reactions),
+            annotation_cache: AnnotationCache::default(),
+            changes: model.changes(),
         }
     }
 }
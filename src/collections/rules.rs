@@ -1,6 +1,6 @@
 use std::{cell::RefCell, pin::Pin};
 
-use crate::{inner, model::Model, pin_ptr, sbmlcxx, upcast_annotation};
+use crate::{incremental::ChangeTracker, inner, model::Model, pin_ptr, sbmlcxx, upcast_annotation};
 
 /// A safe wrapper around the libSBML ListOfRules class.
 ///
@@ -9,6 +9,10 @@ use crate::{inner, model::Model, pin_ptr, sbmlcxx, upcast_annotation};
 pub struct ListOfRules<'a> {
     /// The underlying libSBML Model pointer wrapped in RefCell and Pin
     inner: RefCell<Pin<&'a mut sbmlcxx::ListOfRules>>,
+    /// Cache of the most recently deserialized annotation
+    annotation_cache: AnnotationCache,
+    /// Marks the section of the document that contains this element
+    changes: ChangeTracker<'a>,
 }
 
 impl<'a> ListOfRules<'a> {
@@ -18,6 +22,8 @@ impl<'a> ListOfRules<'a> {
 
         Self {
             inner: RefCell::new(rules),
+            annotation_cache: AnnotationCache::default(),
+            changes: model.changes(),
         }
     }
 }
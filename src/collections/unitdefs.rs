@@ -1,6 +1,6 @@
 use std::{cell::RefCell, pin::Pin};
 
-use crate::{inner, model::Model, pin_ptr, sbmlcxx, upcast_annotation};
+use crate::{incremental::ChangeTracker, inner, model::Model, pin_ptr, sbmlcxx, upcast_annotation};
 
 /// A safe wrapper around the libSBML ListOfCompartments class.
 ///
@@ -9,6 +9,10 @@ use crate::{inner, model::Model, pin_ptr, sbmlcxx, upcast_annotation};
 pub struct ListOfUnitDefinitions<'a> {
     /// The underlying libSBML Model pointer wrapped in RefCell and Pin
     inner: RefCell<Pin<&'a mut sbmlcxx::ListOfUnitDefinitions>>,
+    /// Cache of the most recently deserialized annotation
+    annotation_cache: AnnotationCache,
+    /// Marks the section of the document that contains this element
+    changes: ChangeTracker<'a>,
 }
 
 impl<'a> ListOfUnitDefinitions<'a> {
@@ -22,6 +26,8 @@ impl<'a> ListOfUnitDefinitions<'a> {
 
         Self {
             inner: RefCell::new(unitdefs),
+            annotation_cache: AnnotationCache::default(),
+            changes: model.changes(),
         }
     }
 }
@@ -0,0 +1,1518 @@
+//! Asynchronous access to COMBINE Archives on network-backed storage.
+//!
+//! [`AsyncCombineArchive`] reads an archive from any source implementing tokio's
+//! [`AsyncRead`] and [`AsyncSeek`], such as a file or a ranged HTTP or object storage
+//! reader. Opening an archive only reads the end of the ZIP file with its central
+//! directory and the manifest. Every other entry is fetched with a ranged read of its
+//! local header and compressed data when it is accessed.
+//!
+//! Archives are written to any [`AsyncWrite`] in a single forward pass. Unchanged
+//! entries are streamed from the source as raw compressed bytes, and only one new
+//! entry is held in memory at a time, so the output can be uploaded in parts as it
+//! is produced.
+//!
+//! ```no_run
+//! use sbml::combine::AsyncCombineArchive;
+//!
+//! # async fn run() -> Result<(), sbml::combine::error::CombineArchiveError> {
+//! let file = tokio::fs::File::open("model.omex").await?;
+//! let mut archive = AsyncCombineArchive::open(file).await?;
+//! let master = archive.master().await?;
+//!
+//! let output = tokio::fs::File::create("copy.omex").await?;
+//! archive.write_to(output).await?;
+//! # Ok(())
+//! # }
+//! ```
+//!
+//! Archives and entries beyond 4 GiB are read and written with ZIP64 extensions.
+//! Stored and deflated entries are decompressed directly, entries with other
+//! compression methods, such as Zstandard, are decompressed with the same ZIP reader
+//! as [`CombineArchive`]. Entry names are kept as they are stored, so rewriting an
+//! archive does not change names that are not valid UTF-8.
+//!
+//! [`CombineArchive`]: super::CombineArchive
+
+use std::{
+    cell::RefCell,
+    collections::{HashMap, HashSet},
+    io::{Cursor, Read, SeekFrom},
+};
+
+use tokio::io::{AsyncRead, AsyncReadExt, AsyncSeek, AsyncSeekExt, AsyncWrite, AsyncWriteExt};
+
+use super::{
+    combinearchive::{compress_entry, Compression, ContentIndex, Entry, EntryOptions},
+    error::CombineArchiveError,
+    manifest::{Content, OmexManifest},
+};
+
+/// Signature of a local file header
+const LOCAL_HEADER_SIGNATURE: u32 = 0x0403_4b50;
+/// Signature of a central directory file header
+const CENTRAL_HEADER_SIGNATURE: u32 = 0x0201_4b50;
+/// Signature of the end of central directory record
+const END_OF_CENTRAL_DIRECTORY_SIGNATURE: u32 = 0x0605_4b50;
+/// Signature of the ZIP64 end of central directory record
+const ZIP64_END_OF_CENTRAL_DIRECTORY_SIGNATURE: u32 = 0x0606_4b50;
+/// Signature of the ZIP64 end of central directory locator
+const ZIP64_LOCATOR_SIGNATURE: u32 = 0x0706_4b50;
+/// Length of a local file header without file name and extra field
+const LOCAL_HEADER_LEN: usize = 30;
+/// Length of a central directory file header without name, extra field and comment
+const CENTRAL_HEADER_LEN: usize = 46;
+/// Length of the end of central directory record without comment
+const END_OF_CENTRAL_DIRECTORY_LEN: usize = 22;
+/// Length of the ZIP64 end of central directory record without extensible data
+const ZIP64_END_OF_CENTRAL_DIRECTORY_LEN: usize = 56;
+/// Length of the ZIP64 end of central directory locator
+const ZIP64_LOCATOR_LEN: usize = 20;
+/// Header id of the ZIP64 extended information extra field
+const ZIP64_EXTRA_TAG: u16 = 0x0001;
+/// Version of the ZIP specification needed for ZIP64 extensions
+const VERSION_ZIP64: u16 = 45;
+/// Flag marking sizes and CRC that follow the data in a data descriptor
+const FLAG_DATA_DESCRIPTOR: u16 = 1 << 3;
+/// Compression method of stored entries
+const METHOD_STORED: u16 = 0;
+/// Compression method of deflated entries
+const METHOD_DEFLATED: u16 = 8;
+/// Compression methods decompressed with the ZIP reader of [`CombineArchive`]:
+/// Deflate64, bzip2, LZMA, Zstandard and XZ
+///
+/// [`CombineArchive`]: super::CombineArchive
+const METHODS_OF_ZIP_READER: [u16; 5] = [9, 12, 14, 93, 95];
+
+/// A COMBINE Archive read from and written to asynchronous I/O.
+///
+/// This is the asynchronous counterpart of [`CombineArchive`](super::CombineArchive)
+/// for archives that are not stored on a local disk. Entries are read on demand with
+/// ranged reads, and changes are staged in memory until the archive is written with
+/// [`write_to`](Self::write_to).
+pub struct AsyncCombineArchive<R> {
+    /// The manifest containing metadata about all files in the archive
+    pub manifest: OmexManifest,
+
+    /// Source of the original archive, `None` for archives created from scratch
+    source: Option<R>,
+    /// Central directory of the original archive, in the order of the ZIP file
+    records: Vec<ZipRecord>,
+    /// Position of each original entry in `records` by its name in the ZIP file
+    record_index: HashMap<String, usize>,
+    /// Index of the manifest content by location and format
+    content_index: RefCell<ContentIndex>,
+    /// New or modified entries waiting to be written
+    pending_entries: HashMap<String, Vec<u8>>,
+    /// Compression chosen for pending entries, entries without one use the default
+    entry_compression: HashMap<String, Compression>,
+    /// Entries marked for removal
+    removed_entries: HashSet<String>,
+}
+
+impl<R: AsyncRead + AsyncSeek + Unpin> AsyncCombineArchive<R> {
+    /// Creates a new empty COMBINE Archive.
+    ///
+    /// Like [`CombineArchive::new`](super::CombineArchive::new), the archive starts
+    /// with the mandatory entries for the archive itself and its manifest.
+    pub fn new() -> Self {
+        let mut manifest = OmexManifest::new();
+        manifest
+            .add_entry(
+                ".",
+                "http://identifiers.org/combine.specifications/omex",
+                false,
+            )
+            .expect("Failed to add mandatory archive entry");
+        manifest
+            .add_entry(
+                "./manifest.xml",
+                "http://identifiers.org/combine.specifications/omex-manifest",
+                false,
+            )
+            .expect("Failed to add mandatory manifest entry");
+
+        Self::with_manifest(manifest, None, Vec::new())
+    }
+
+    /// Opens an existing COMBINE Archive from an asynchronous source.
+    ///
+    /// Only the end of the source, holding the central directory, and the manifest are
+    /// read. The source is kept and entries are read from it when they are accessed.
+    ///
+    /// # Arguments
+    ///
+    /// * `source` - Reader over the complete OMEX file
+    ///
+    /// # Errors
+    ///
+    /// * `CombineArchiveError::Io` - If reading fails or the source is not a ZIP
+    ///   archive supported by the asynchronous reader
+    /// * `CombineArchiveError::ManifestFileMissing` - If the manifest.xml file is missing
+    /// * `CombineArchiveError::Manifest` - If the manifest.xml is invalid
+    pub async fn open(mut source: R) -> Result<Self, CombineArchiveError> {
+        let records = read_central_directory(&mut source).await?;
+        let manifest_record = records
+            .iter()
+            .find(|record| record.name == "manifest.xml")
+            .ok_or(CombineArchiveError::ManifestFileMissing)?;
+        let manifest_xml = String::from_utf8(read_record(&mut source, manifest_record).await?)
+            .map_err(|e| invalid_data(format!("manifest.xml is not valid UTF-8: {e}")))?;
+        let mut manifest = OmexManifest::from_xml(&manifest_xml)?;
+
+        // Ensure the mandatory entries are present (for backwards compatibility)
+        if !manifest.has_location(".") {
+            manifest.add_entry(
+                ".",
+                "http://identifiers.org/combine.specifications/omex",
+                false,
+            )?;
+        }
+        if !manifest.has_location("./manifest.xml") {
+            manifest.add_entry(
+                "./manifest.xml",
+                "http://identifiers.org/combine.specifications/omex-manifest",
+                false,
+            )?;
+        }
+
+        Ok(Self::with_manifest(manifest, Some(source), records))
+    }
+
+    /// Adds data to the archive from any asynchronous source.
+    ///
+    /// Entries are staged in memory until the archive is written. Existing entries
+    /// are handled like in [`CombineArchive::add_entry`](super::CombineArchive::add_entry).
+    ///
+    /// # Arguments
+    ///
+    /// * `location` - Location within the archive (e.g., "./model.xml")
+    /// * `format` - MIME type or format identifier for the file
+    /// * `master` - Whether this file is the master file of the archive
+    /// * `data` - Data source implementing `AsyncRead`
+    ///
+    /// # Errors
+    ///
+    /// * `CombineArchiveError::Io` - If reading from the data source fails
+    /// * `CombineArchiveError::Manifest` - If there's an error updating the manifest
+    pub async fn add_entry(
+        &mut self,
+        location: impl Into<String>,
+        format: impl Into<String>,
+        master: bool,
+        data: impl AsyncRead + Unpin,
+    ) -> Result<(), CombineArchiveError> {
+        self.add_entry_with_options(location, format, master, data, EntryOptions::default())
+            .await
+    }
+
+    /// Adds data to the archive like [`add_entry`](Self::add_entry), with explicit
+    /// options for how the entry is written.
+    ///
+    /// # Errors
+    ///
+    /// * `CombineArchiveError::Io` - If reading from the data source fails
+    /// * `CombineArchiveError::Manifest` - If there's an error updating the manifest
+    pub async fn add_entry_with_options(
+        &mut self,
+        location: impl Into<String>,
+        format: impl Into<String>,
+        master: bool,
+        mut data: impl AsyncRead + Unpin,
+        options: EntryOptions,
+    ) -> Result<(), CombineArchiveError> {
+        let location = location.into();
+        let format = format.into();
+
+        let mut data_buf = Vec::new();
+        data.read_to_end(&mut data_buf).await?;
+
+        let unchanged = self
+            .find_content(&location)
+            .map(|existing| existing.format == format && existing.master == master);
+        match unchanged {
+            Some(true) => {}
+            Some(false) => {
+                self.manifest.content.retain(|c| c.location != location);
+                self.manifest.add_entry(location.clone(), format, master)?;
+            }
+            None => self.manifest.add_entry(location.clone(), format, master)?,
+        }
+        self.content_index.get_mut().invalidate();
+
+        let zip_location = location.replace("./", "");
+        self.removed_entries.remove(&zip_location);
+        self.entry_compression
+            .insert(zip_location.clone(), options.compression);
+        self.pending_entries.insert(zip_location, data_buf);
+
+        Ok(())
+    }
+
+    /// Removes an entry from the archive.
+    ///
+    /// # Errors
+    ///
+    /// * `CombineArchiveError::CannotRemoveMandatoryEntry` - If attempting to remove
+    ///   the archive self-reference or the manifest
+    pub fn remove_entry(&mut self, location: &str) -> Result<(), CombineArchiveError> {
+        if location == "." || location == "./manifest.xml" {
+            return Err(CombineArchiveError::CannotRemoveMandatoryEntry(
+                location.to_string(),
+            ));
+        }
+
+        let zip_location = location.replace("./", "");
+        self.manifest.content.retain(|c| c.location != location);
+        self.content_index.get_mut().invalidate();
+        self.removed_entries.insert(zip_location.clone());
+        self.pending_entries.remove(&zip_location);
+        self.entry_compression.remove(&zip_location);
+
+        Ok(())
+    }
+
+    /// Retrieves an entry from the archive.
+    ///
+    /// Pending changes are returned from memory. Entries of the original archive are
+    /// fetched with a ranged read of their local header and compressed data, and their
+    /// checksum is verified after decompression.
+    ///
+    /// # Arguments
+    ///
+    /// * `location` - Location of the entry to retrieve (e.g., "./model.xml")
+    ///
+    /// # Errors
+    ///
+    /// * `CombineArchiveError::FileNotFound` - If the entry doesn't exist
+    /// * `CombineArchiveError::Io` - If reading or decompressing the entry fails
+    pub async fn entry(&mut self, location: &str) -> Result<Entry, CombineArchiveError> {
+        let content = self
+            .find_content(location)
+            .ok_or_else(|| CombineArchiveError::FileNotFound(location.to_string()))?
+            .clone();
+
+        let zip_location = location.replace("./", "");
+        if let Some(data) = self.pending_entries.get(&zip_location) {
+            return Ok(Entry {
+                content,
+                data: data.clone(),
+            });
+        }
+        if self.removed_entries.contains(&zip_location) {
+            return Err(CombineArchiveError::FileNotFound(location.to_string()));
+        }
+
+        let record = self
+            .record_index
+            .get(&zip_location)
+            .map(|&position| &self.records[position]);
+        match (self.source.as_mut(), record) {
+            (Some(source), Some(record)) => {
+                let data = read_record(source, record).await?;
+                Ok(Entry { content, data })
+            }
+            _ => Err(CombineArchiveError::FileNotFound(location.to_string())),
+        }
+    }
+
+    /// Retrieves the first entry with the specified format.
+    ///
+    /// # Errors
+    ///
+    /// * `CombineArchiveError::FileNotFound` - If no entry with the specified format is found
+    /// * Other errors from [`entry`](Self::entry) method
+    pub async fn entry_by_format(
+        &mut self,
+        format: impl Into<String>,
+    ) -> Result<Entry, CombineArchiveError> {
+        let format = format.into();
+        let position = self
+            .content_index
+            .borrow_mut()
+            .find_format(&self.manifest.content, &format)
+            .ok_or(CombineArchiveError::FileNotFound(format.to_string()))?;
+        let location = self.manifest.content[position].location.clone();
+        self.entry(&location).await
+    }
+
+    /// Retrieves the master file of the archive.
+    ///
+    /// # Errors
+    ///
+    /// * `CombineArchiveError::MasterFileNotFound` - If no master file is defined
+    /// * Other errors from [`entry`](Self::entry) method
+    pub async fn master(&mut self) -> Result<Entry, CombineArchiveError> {
+        let location = self
+            .manifest
+            .master_file()
+            .ok_or(CombineArchiveError::MasterFileNotFound)?
+            .location
+            .clone();
+        self.entry(&location).await
+    }
+
+    /// Lists all entries in the archive, including pending additions and removals.
+    pub fn list_entries(&self) -> Vec<&Content> {
+        self.manifest.content.iter().collect()
+    }
+
+    /// Checks if an entry exists in the archive.
+    pub fn has_entry(&self, location: &str) -> bool {
+        self.find_content(location).is_some()
+    }
+
+    /// Writes the complete archive with all current entries to `output`.
+    ///
+    /// The archive is written front to back without seeking. Unchanged entries are
+    /// copied from the source as raw compressed bytes in small chunks. New and modified
+    /// entries are compressed one at a time, and the manifest and central directory are
+    /// written last. The output is flushed but not shut down, so that callers decide
+    /// when a multipart upload is completed.
+    ///
+    /// The archive itself is not changed: its source and pending changes are kept, so
+    /// that it can be written again.
+    ///
+    /// # Arguments
+    ///
+    /// * `output` - Destination of the archive
+    ///
+    /// # Returns
+    ///
+    /// The output, after the complete archive has been written to it.
+    ///
+    /// # Errors
+    ///
+    /// * `CombineArchiveError::Io` - If reading the source or writing the output fails
+    /// * `CombineArchiveError::Zip` - If compressing an entry fails
+    /// * `CombineArchiveError::Manifest` - If the manifest cannot be serialized
+    pub async fn write_to<W: AsyncWrite + Unpin>(
+        &mut self,
+        mut output: W,
+    ) -> Result<W, CombineArchiveError> {
+        let mut written = Vec::new();
+        let mut offset = 0u64;
+
+        // Copy entries from the original archive that aren't removed or overwritten
+        if let Some(source) = self.source.as_mut() {
+            for record in &self.records {
+                if self.removed_entries.contains(&record.name)
+                    || self.pending_entries.contains_key(&record.name)
+                    || record.name == "manifest.xml"
+                {
+                    continue;
+                }
+
+                let data_offset = locate_data(source, record).await?;
+                let copy = record.relocated(offset);
+                offset += copy.write_local_header(&mut output).await?;
+                source.seek(SeekFrom::Start(data_offset)).await?;
+                let copied = tokio::io::copy(
+                    &mut (&mut *source).take(record.compressed_size),
+                    &mut output,
+                )
+                .await?;
+                if copied != record.compressed_size {
+                    return Err(truncated(&record.name));
+                }
+                offset += copied;
+                written.push(copy);
+            }
+        }
+
+        // Add all pending entries (new or modified files), sorted by name
+        let mut pending: Vec<&String> = self.pending_entries.keys().collect();
+        pending.sort_unstable();
+        for name in pending {
+            let compression = self
+                .entry_compression
+                .get(name)
+                .copied()
+                .unwrap_or_default();
+            let data = &self.pending_entries[name];
+            let record = write_compressed(&mut output, name, data, compression, offset).await?;
+            offset = record.end;
+            written.push(record.record);
+        }
+
+        // Always add manifest last to ensure it's up to date
+        let manifest_xml = self.manifest.to_xml().map_err(|e| {
+            CombineArchiveError::Manifest(quick_xml::DeError::Custom(e.to_string()))
+        })?;
+        let record = write_compressed(
+            &mut output,
+            "manifest.xml",
+            manifest_xml.as_bytes(),
+            Compression::default(),
+            offset,
+        )
+        .await?;
+        offset = record.end;
+        written.push(record.record);
+
+        write_central_directory(&mut output, &written, offset).await?;
+        output.flush().await?;
+        Ok(output)
+    }
+
+    /// Consumes the archive and returns its source, if it was opened from one.
+    pub fn into_inner(self) -> Option<R> {
+        self.source
+    }
+
+    /// Creates an archive from its parts.
+    fn with_manifest(manifest: OmexManifest, source: Option<R>, records: Vec<ZipRecord>) -> Self {
+        let record_index = records
+            .iter()
+            .enumerate()
+            .map(|(position, record)| (record.name.clone(), position))
+            .collect();
+
+        Self {
+            manifest,
+            source,
+            records,
+            record_index,
+            content_index: RefCell::new(ContentIndex::default()),
+            pending_entries: HashMap::new(),
+            entry_compression: HashMap::new(),
+            removed_entries: HashSet::new(),
+        }
+    }
+
+    /// Finds content metadata by location.
+    fn find_content(&self, location: &str) -> Option<&Content> {
+        let position = self
+            .content_index
+            .borrow_mut()
+            .find_location(&self.manifest.content, location)?;
+        self.manifest.content.get(position)
+    }
+}
+
+impl<R: AsyncRead + AsyncSeek + Unpin> Default for AsyncCombineArchive<R> {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+/// An entry of the central directory of a ZIP archive
+#[derive(Debug, Clone, PartialEq, Eq)]
+struct ZipRecord {
+    /// Name of the entry within the ZIP file, as used to look up entries
+    name: String,
+    /// Name of the entry exactly as stored in the ZIP file, which need not be UTF-8
+    raw_name: Vec<u8>,
+    /// Version of the ZIP specification that created the entry
+    version_made_by: u16,
+    /// Version of the ZIP specification needed to extract the entry
+    version_needed: u16,
+    /// General purpose bit flags
+    flags: u16,
+    /// Compression method
+    method: u16,
+    /// Last modification time in MS-DOS format
+    modified_time: u16,
+    /// Last modification date in MS-DOS format
+    modified_date: u16,
+    /// CRC-32 of the uncompressed data
+    crc32: u32,
+    /// Size of the compressed data
+    compressed_size: u64,
+    /// Size of the uncompressed data
+    uncompressed_size: u64,
+    /// External file attributes
+    external_attributes: u32,
+    /// Offset of the local header from the start of the archive
+    header_offset: u64,
+}
+
+/// A record written to the output, with the offset just past its data
+struct WrittenRecord {
+    record: ZipRecord,
+    end: u64,
+}
+
+impl ZipRecord {
+    /// Returns a copy of the record for a local header at `header_offset`.
+    ///
+    /// Sizes and CRC are known from the central directory, so a trailing data
+    /// descriptor is never needed.
+    fn relocated(&self, header_offset: u64) -> Self {
+        Self {
+            flags: self.flags & !FLAG_DATA_DESCRIPTOR,
+            header_offset,
+            ..self.clone()
+        }
+    }
+
+    /// Returns the version needed to extract the record as written, which is at
+    /// least 4.5 if its headers need ZIP64 extra fields.
+    fn version_needed(&self, zip64: bool) -> u16 {
+        if zip64 {
+            self.version_needed.max(VERSION_ZIP64)
+        } else {
+            self.version_needed
+        }
+    }
+
+    /// Writes the local header of the record and returns its length.
+    async fn write_local_header<W: AsyncWrite + Unpin>(
+        &self,
+        output: &mut W,
+    ) -> Result<u64, CombineArchiveError> {
+        let mut header = Vec::with_capacity(LOCAL_HEADER_LEN + self.raw_name.len());
+        self.push_local_header(&mut header)?;
+        output.write_all(&header).await?;
+        Ok(header.len() as u64)
+    }
+
+    /// Appends the local header of the record to `buf`.
+    ///
+    /// Both sizes are moved to a ZIP64 extra field if either of them does not fit
+    /// into its 32-bit field, as the local header requires.
+    fn push_local_header(&self, buf: &mut Vec<u8>) -> Result<(), CombineArchiveError> {
+        let zip64 = needs_zip64(self.compressed_size) || needs_zip64(self.uncompressed_size);
+        let mut extra = Vec::new();
+        if zip64 {
+            extra.extend_from_slice(&ZIP64_EXTRA_TAG.to_le_bytes());
+            extra.extend_from_slice(&16u16.to_le_bytes());
+            extra.extend_from_slice(&self.uncompressed_size.to_le_bytes());
+            extra.extend_from_slice(&self.compressed_size.to_le_bytes());
+        }
+        let (compressed_size, uncompressed_size) = if zip64 {
+            (u32::MAX, u32::MAX)
+        } else {
+            (self.compressed_size as u32, self.uncompressed_size as u32)
+        };
+
+        buf.extend_from_slice(&LOCAL_HEADER_SIGNATURE.to_le_bytes());
+        buf.extend_from_slice(&self.version_needed(zip64).to_le_bytes());
+        buf.extend_from_slice(&self.flags.to_le_bytes());
+        buf.extend_from_slice(&self.method.to_le_bytes());
+        buf.extend_from_slice(&self.modified_time.to_le_bytes());
+        buf.extend_from_slice(&self.modified_date.to_le_bytes());
+        buf.extend_from_slice(&self.crc32.to_le_bytes());
+        buf.extend_from_slice(&compressed_size.to_le_bytes());
+        buf.extend_from_slice(&uncompressed_size.to_le_bytes());
+        buf.extend_from_slice(&to_u16(self.raw_name.len(), "File name")?.to_le_bytes());
+        buf.extend_from_slice(&to_u16(extra.len(), "Extra field")?.to_le_bytes());
+        buf.extend_from_slice(&self.raw_name);
+        buf.extend_from_slice(&extra);
+        Ok(())
+    }
+
+    /// Appends the central directory header of the record to `buf`.
+    ///
+    /// Sizes and offset that do not fit into their 32-bit fields are written to a
+    /// ZIP64 extra field instead.
+    fn push_central_header(&self, buf: &mut Vec<u8>) -> Result<(), CombineArchiveError> {
+        let mut values = Vec::new();
+        let mut field = |value: u64| {
+            if needs_zip64(value) {
+                values.extend_from_slice(&value.to_le_bytes());
+                u32::MAX
+            } else {
+                value as u32
+            }
+        };
+        let uncompressed_size = field(self.uncompressed_size);
+        let compressed_size = field(self.compressed_size);
+        let header_offset = field(self.header_offset);
+        let zip64 = !values.is_empty();
+        let mut extra = Vec::with_capacity(values.len() + 4);
+        if zip64 {
+            extra.extend_from_slice(&ZIP64_EXTRA_TAG.to_le_bytes());
+            extra.extend_from_slice(&to_u16(values.len(), "Extra field")?.to_le_bytes());
+            extra.extend_from_slice(&values);
+        }
+
+        buf.extend_from_slice(&CENTRAL_HEADER_SIGNATURE.to_le_bytes());
+        buf.extend_from_slice(&self.version_made_by.to_le_bytes());
+        buf.extend_from_slice(&self.version_needed(zip64).to_le_bytes());
+        buf.extend_from_slice(&self.flags.to_le_bytes());
+        buf.extend_from_slice(&self.method.to_le_bytes());
+        buf.extend_from_slice(&self.modified_time.to_le_bytes());
+        buf.extend_from_slice(&self.modified_date.to_le_bytes());
+        buf.extend_from_slice(&self.crc32.to_le_bytes());
+        buf.extend_from_slice(&compressed_size.to_le_bytes());
+        buf.extend_from_slice(&uncompressed_size.to_le_bytes());
+        buf.extend_from_slice(&to_u16(self.raw_name.len(), "File name")?.to_le_bytes());
+        buf.extend_from_slice(&to_u16(extra.len(), "Extra field")?.to_le_bytes());
+        // File comment length, disk number, internal attributes
+        buf.extend_from_slice(&[0; 6]);
+        buf.extend_from_slice(&self.external_attributes.to_le_bytes());
+        buf.extend_from_slice(&header_offset.to_le_bytes());
+        buf.extend_from_slice(&self.raw_name);
+        buf.extend_from_slice(&extra);
+        Ok(())
+    }
+
+    /// Parses the central directory header at the start of `buf`.
+    ///
+    /// Sizes and offset stored in a ZIP64 extra field replace the 32-bit fields
+    /// that hold the `0xFFFFFFFF` placeholder.
+    ///
+    /// # Returns
+    /// The record and the length of its header
+    fn parse_central_header(buf: &[u8]) -> Result<(Self, usize), CombineArchiveError> {
+        if buf.len() < CENTRAL_HEADER_LEN || le_u32(buf, 0) != CENTRAL_HEADER_SIGNATURE {
+            return Err(invalid_data("Invalid central directory header".to_string()));
+        }
+
+        let name_len = le_u16(buf, 28) as usize;
+        let extra_len = le_u16(buf, 30) as usize;
+        let comment_len = le_u16(buf, 32) as usize;
+        let len = CENTRAL_HEADER_LEN + name_len + extra_len + comment_len;
+        if buf.len() < len {
+            return Err(invalid_data("Truncated central directory".to_string()));
+        }
+
+        let raw_name = buf[CENTRAL_HEADER_LEN..CENTRAL_HEADER_LEN + name_len].to_vec();
+        let mut record = Self {
+            name: String::from_utf8_lossy(&raw_name).into_owned(),
+            raw_name,
+            version_made_by: le_u16(buf, 4),
+            version_needed: le_u16(buf, 6),
+            flags: le_u16(buf, 8),
+            method: le_u16(buf, 10),
+            modified_time: le_u16(buf, 12),
+            modified_date: le_u16(buf, 14),
+            crc32: le_u32(buf, 16),
+            compressed_size: le_u32(buf, 20) as u64,
+            uncompressed_size: le_u32(buf, 24) as u64,
+            external_attributes: le_u32(buf, 38),
+            header_offset: le_u32(buf, 42) as u64,
+        };
+
+        let extra_start = CENTRAL_HEADER_LEN + name_len;
+        let extra = &buf[extra_start..extra_start + extra_len];
+        record.apply_zip64_extra(extra)?;
+
+        Ok((record, len))
+    }
+
+    /// Reads the values of the placeholder fields from the ZIP64 extra field.
+    fn apply_zip64_extra(&mut self, extra: &[u8]) -> Result<(), CombineArchiveError> {
+        let placeholder = u32::MAX as u64;
+        let mut fields = [
+            &mut self.uncompressed_size,
+            &mut self.compressed_size,
+            &mut self.header_offset,
+        ];
+        if !fields.iter().any(|field| **field == placeholder) {
+            return Ok(());
+        }
+
+        let mut position = 0;
+        while position + 4 <= extra.len() {
+            let tag = le_u16(extra, position);
+            let len = le_u16(extra, position + 2) as usize;
+            let data = extra.get(position + 4..position + 4 + len).ok_or_else(|| {
+                invalid_data(format!("Invalid extra field of entry {}", self.name))
+            })?;
+            if tag == ZIP64_EXTRA_TAG {
+                let mut read = 0;
+                for field in fields.iter_mut().filter(|field| ***field == placeholder) {
+                    if read + 8 > data.len() {
+                        break;
+                    }
+                    **field = le_u64(data, read);
+                    read += 8;
+                }
+                return Ok(());
+            }
+            position += 4 + len;
+        }
+
+        Err(invalid_data(format!(
+            "Missing ZIP64 extra field of entry {}",
+            self.name
+        )))
+    }
+}
+
+/// Reads the central directory from the end of a ZIP archive.
+///
+/// The end of central directory record is searched in the last 64 KiB of the source,
+/// the maximum length of its trailing comment. The ZIP64 end of central directory
+/// record and the central directory are taken from the same read if they lie within
+/// it, and are otherwise fetched with further ranged reads.
+async fn read_central_directory<R: AsyncRead + AsyncSeek + Unpin>(
+    source: &mut R,
+) -> Result<Vec<ZipRecord>, CombineArchiveError> {
+    let len = source.seek(SeekFrom::End(0)).await?;
+    let tail_len = len.min((END_OF_CENTRAL_DIRECTORY_LEN + u16::MAX as usize) as u64);
+    let tail_start = len - tail_len;
+    source.seek(SeekFrom::Start(tail_start)).await?;
+    let mut tail = vec![0; tail_len as usize];
+    source.read_exact(&mut tail).await?;
+    let tail = Tail {
+        start: tail_start,
+        bytes: tail,
+    };
+
+    let eocd = tail
+        .bytes
+        .len()
+        .checked_sub(END_OF_CENTRAL_DIRECTORY_LEN)
+        .and_then(|last| {
+            (0..=last).rev().find(|&position| {
+                le_u32(&tail.bytes, position) == END_OF_CENTRAL_DIRECTORY_SIGNATURE
+                    && position
+                        + END_OF_CENTRAL_DIRECTORY_LEN
+                        + le_u16(&tail.bytes, position + 20) as usize
+                        <= tail.bytes.len()
+            })
+        })
+        .ok_or_else(|| invalid_data("Not a ZIP archive".to_string()))?;
+
+    let mut n_entries = le_u16(&tail.bytes, eocd + 10) as u64;
+    let mut directory_len = le_u32(&tail.bytes, eocd + 12) as u64;
+    let mut directory_offset = le_u32(&tail.bytes, eocd + 16) as u64;
+    let eocd = tail_start + eocd as u64;
+    let mut directory_end = eocd;
+
+    // Archives with ZIP64 extensions keep the real values in the ZIP64 end of central
+    // directory record, found through the locator in front of the end of central
+    // directory record
+    let placeholders = n_entries == u16::MAX as u64
+        || directory_len == u32::MAX as u64
+        || directory_offset == u32::MAX as u64;
+    if placeholders && eocd >= ZIP64_LOCATOR_LEN as u64 {
+        let locator_offset = eocd - ZIP64_LOCATOR_LEN as u64;
+        let locator = tail.read(source, locator_offset, ZIP64_LOCATOR_LEN).await?;
+        if le_u32(&locator, 0) == ZIP64_LOCATOR_SIGNATURE {
+            let record_offset = le_u64(&locator, 8);
+            if record_offset > locator_offset {
+                return Err(invalid_data(
+                    "ZIP64 end of central directory lies outside of the archive".to_string(),
+                ));
+            }
+            let record = tail
+                .read(source, record_offset, ZIP64_END_OF_CENTRAL_DIRECTORY_LEN)
+                .await?;
+            if le_u32(&record, 0) != ZIP64_END_OF_CENTRAL_DIRECTORY_SIGNATURE {
+                return Err(invalid_data(
+                    "Invalid ZIP64 end of central directory record".to_string(),
+                ));
+            }
+            n_entries = le_u64(&record, 32);
+            directory_len = le_u64(&record, 40);
+            directory_offset = le_u64(&record, 48);
+            directory_end = record_offset;
+        }
+    }
+
+    if directory_offset
+        .checked_add(directory_len)
+        .map_or(true, |end| end > directory_end)
+    {
+        return Err(invalid_data(
+            "Central directory lies outside of the archive".to_string(),
+        ));
+    }
+
+    let directory = tail
+        .read(source, directory_offset, directory_len as usize)
+        .await?;
+    let capacity = n_entries.min(directory_len / CENTRAL_HEADER_LEN as u64);
+    let mut records = Vec::with_capacity(capacity as usize);
+    let mut position = 0;
+    for _ in 0..n_entries {
+        let (record, len) = ZipRecord::parse_central_header(&directory[position..])?;
+        records.push(record);
+        position += len;
+    }
+    Ok(records)
+}
+
+/// The last bytes of a source, read while searching the end of central directory
+struct Tail {
+    /// Offset of the first byte of the tail in the source
+    start: u64,
+    bytes: Vec<u8>,
+}
+
+impl Tail {
+    /// Returns `len` bytes at `offset` of the source, copied from the tail if they lie
+    /// within it and read from the source otherwise.
+    async fn read<R: AsyncRead + AsyncSeek + Unpin>(
+        &self,
+        source: &mut R,
+        offset: u64,
+        len: usize,
+    ) -> Result<Vec<u8>, CombineArchiveError> {
+        if offset >= self.start {
+            let start = (offset - self.start) as usize;
+            if let Some(bytes) = self.bytes.get(start..start + len) {
+                return Ok(bytes.to_vec());
+            }
+        }
+
+        source.seek(SeekFrom::Start(offset)).await?;
+        let mut bytes = vec![0; len];
+        source.read_exact(&mut bytes).await?;
+        Ok(bytes)
+    }
+}
+
+/// Reads the local header of a record and returns the offset of its data.
+async fn locate_data<R: AsyncRead + AsyncSeek + Unpin>(
+    source: &mut R,
+    record: &ZipRecord,
+) -> Result<u64, CombineArchiveError> {
+    source.seek(SeekFrom::Start(record.header_offset)).await?;
+    let mut header = [0; LOCAL_HEADER_LEN];
+    source.read_exact(&mut header).await?;
+    if le_u32(&header, 0) != LOCAL_HEADER_SIGNATURE {
+        return Err(invalid_data(format!(
+            "Invalid local header of entry {}",
+            record.name
+        )));
+    }
+
+    let name_len = le_u16(&header, 26) as u64;
+    let extra_len = le_u16(&header, 28) as u64;
+    Ok(record.header_offset + LOCAL_HEADER_LEN as u64 + name_len + extra_len)
+}
+
+/// Reads and decompresses the data of a record, verifying its checksum.
+async fn read_record<R: AsyncRead + AsyncSeek + Unpin>(
+    source: &mut R,
+    record: &ZipRecord,
+) -> Result<Vec<u8>, CombineArchiveError> {
+    let data_offset = locate_data(source, record).await?;
+    source.seek(SeekFrom::Start(data_offset)).await?;
+    let mut compressed = vec![0; record.compressed_size as usize];
+    source
+        .read_exact(&mut compressed)
+        .await
+        .map_err(|_| truncated(&record.name))?;
+
+    let data = match record.method {
+        METHOD_STORED => compressed,
+        METHOD_DEFLATED => {
+            let mut data = Vec::with_capacity(record.uncompressed_size as usize);
+            flate2::read::DeflateDecoder::new(compressed.as_slice()).read_to_end(&mut data)?;
+            data
+        }
+        method if METHODS_OF_ZIP_READER.contains(&method) => decompress(record, compressed)?,
+        _ => return Err(unsupported_method(record)),
+    };
+
+    if data.len() as u64 != record.uncompressed_size || crc32fast::hash(&data) != record.crc32 {
+        return Err(invalid_data(format!(
+            "Checksum mismatch in entry {}",
+            record.name
+        )));
+    }
+    Ok(data)
+}
+
+/// Decompresses the data of a record with one of [`METHODS_OF_ZIP_READER`].
+///
+/// The data is wrapped into a single-entry archive in memory and read with the same
+/// ZIP reader as [`CombineArchive`](super::CombineArchive), so that the asynchronous
+/// archive reads every entry the synchronous one can read.
+///
+/// # Errors
+/// An error of kind [`Unsupported`](std::io::ErrorKind::Unsupported) naming the
+/// method if the ZIP reader was built without support for it
+fn decompress(record: &ZipRecord, compressed: Vec<u8>) -> Result<Vec<u8>, CombineArchiveError> {
+    let record = record.relocated(0);
+    let mut part = Vec::with_capacity(compressed.len() + 2 * record.raw_name.len() + 256);
+    record.push_local_header(&mut part)?;
+    part.extend_from_slice(&compressed);
+    drop(compressed);
+    let directory_offset = part.len() as u64;
+    push_central_directory(&mut part, std::slice::from_ref(&record), directory_offset)?;
+
+    let mut archive = zip::ZipArchive::new(Cursor::new(part))?;
+    let mut file = match archive.by_index(0) {
+        Ok(file) => file,
+        Err(zip::result::ZipError::UnsupportedArchive(_)) => {
+            return Err(unsupported_method(&record));
+        }
+        Err(e) => return Err(e.into()),
+    };
+    let mut data = Vec::with_capacity(record.uncompressed_size as usize);
+    file.read_to_end(&mut data)?;
+    Ok(data)
+}
+
+/// Compresses an entry and writes its local header and data at `offset`.
+///
+/// The entry is compressed with the same ZIP writer as [`CombineArchive`](super::CombineArchive)
+/// into a single-entry archive in memory, whose record and compressed data are then
+/// written to the output.
+async fn write_compressed<W: AsyncWrite + Unpin>(
+    output: &mut W,
+    name: &str,
+    data: &[u8],
+    compression: Compression,
+    offset: u64,
+) -> Result<WrittenRecord, CombineArchiveError> {
+    let mut part = Cursor::new(compress_entry(name, data, compression)?);
+    let record = read_central_directory(&mut part)
+        .await?
+        .into_iter()
+        .next()
+        .ok_or_else(|| invalid_data(format!("Failed to compress entry {name}")))?;
+    let data_offset = locate_data(&mut part, &record).await? as usize;
+    let compressed_end = data_offset + record.compressed_size as usize;
+    let compressed = &part.get_ref()[data_offset..compressed_end];
+
+    let record = record.relocated(offset);
+    let header_len = record.write_local_header(output).await?;
+    output.write_all(compressed).await?;
+
+    Ok(WrittenRecord {
+        end: offset + header_len + compressed.len() as u64,
+        record,
+    })
+}
+
+/// Writes the central directory and the end of central directory record.
+async fn write_central_directory<W: AsyncWrite + Unpin>(
+    output: &mut W,
+    records: &[ZipRecord],
+    offset: u64,
+) -> Result<(), CombineArchiveError> {
+    let mut directory = Vec::new();
+    push_central_directory(&mut directory, records, offset)?;
+    output.write_all(&directory).await?;
+    Ok(())
+}
+
+/// Appends the central directory starting at `offset` and the end of central
+/// directory record to `buf`.
+///
+/// If the number of entries, the length or the offset of the directory do not fit
+/// into the end of central directory record, a ZIP64 end of central directory
+/// record and its locator are written in front of it.
+fn push_central_directory(
+    buf: &mut Vec<u8>,
+    records: &[ZipRecord],
+    offset: u64,
+) -> Result<(), CombineArchiveError> {
+    let start = buf.len();
+    for record in records {
+        record.push_central_header(buf)?;
+    }
+
+    let n_entries = records.len() as u64;
+    let directory_len = (buf.len() - start) as u64;
+    let zip64 = n_entries >= u16::MAX as u64 || needs_zip64(directory_len) || needs_zip64(offset);
+    if zip64 {
+        let record_offset = offset + directory_len;
+        buf.extend_from_slice(&ZIP64_END_OF_CENTRAL_DIRECTORY_SIGNATURE.to_le_bytes());
+        // Size of the remaining record
+        buf.extend_from_slice(&(ZIP64_END_OF_CENTRAL_DIRECTORY_LEN as u64 - 12).to_le_bytes());
+        buf.extend_from_slice(&VERSION_ZIP64.to_le_bytes());
+        buf.extend_from_slice(&VERSION_ZIP64.to_le_bytes());
+        // Number of this disk and of the disk with the central directory
+        buf.extend_from_slice(&[0; 8]);
+        buf.extend_from_slice(&n_entries.to_le_bytes());
+        buf.extend_from_slice(&n_entries.to_le_bytes());
+        buf.extend_from_slice(&directory_len.to_le_bytes());
+        buf.extend_from_slice(&offset.to_le_bytes());
+
+        buf.extend_from_slice(&ZIP64_LOCATOR_SIGNATURE.to_le_bytes());
+        // Disk with the ZIP64 end of central directory record
+        buf.extend_from_slice(&0u32.to_le_bytes());
+        buf.extend_from_slice(&record_offset.to_le_bytes());
+        // Total number of disks
+        buf.extend_from_slice(&1u32.to_le_bytes());
+    }
+
+    let n_entries = n_entries.min(u16::MAX as u64) as u16;
+    let directory_len = directory_len.min(u32::MAX as u64) as u32;
+    let offset = offset.min(u32::MAX as u64) as u32;
+    buf.extend_from_slice(&END_OF_CENTRAL_DIRECTORY_SIGNATURE.to_le_bytes());
+    // Number of this disk and of the disk with the central directory
+    buf.extend_from_slice(&[0; 4]);
+    buf.extend_from_slice(&n_entries.to_le_bytes());
+    buf.extend_from_slice(&n_entries.to_le_bytes());
+    buf.extend_from_slice(&directory_len.to_le_bytes());
+    buf.extend_from_slice(&offset.to_le_bytes());
+    // Comment length
+    buf.extend_from_slice(&0u16.to_le_bytes());
+    Ok(())
+}
+
+/// Reads a little-endian u16 at `position`.
+fn le_u16(buf: &[u8], position: usize) -> u16 {
+    u16::from_le_bytes([buf[position], buf[position + 1]])
+}
+
+/// Reads a little-endian u32 at `position`.
+fn le_u32(buf: &[u8], position: usize) -> u32 {
+    u32::from_le_bytes([
+        buf[position],
+        buf[position + 1],
+        buf[position + 2],
+        buf[position + 3],
+    ])
+}
+
+/// Reads a little-endian u64 at `position`.
+fn le_u64(buf: &[u8], position: usize) -> u64 {
+    let mut bytes = [0; 8];
+    bytes.copy_from_slice(&buf[position..position + 8]);
+    u64::from_le_bytes(bytes)
+}
+
+/// Returns whether a size or offset needs a ZIP64 field, since it does not fit
+/// into 32 bits or equals the placeholder for ZIP64 values.
+fn needs_zip64(value: u64) -> bool {
+    value >= u32::MAX as u64
+}
+
+/// Converts the length of a header field to its 16-bit length field.
+fn to_u16(value: usize, field: &str) -> Result<u16, CombineArchiveError> {
+    u16::try_from(value)
+        .map_err(|_| invalid_data(format!("{field} of {value} bytes is too long for ZIP")))
+}
+
+fn invalid_data(message: String) -> CombineArchiveError {
+    CombineArchiveError::Io(std::io::Error::new(
+        std::io::ErrorKind::InvalidData,
+        message,
+    ))
+}
+
+fn truncated(name: &str) -> CombineArchiveError {
+    CombineArchiveError::Io(std::io::Error::new(
+        std::io::ErrorKind::UnexpectedEof,
+        format!("Data of entry {name} is truncated"),
+    ))
+}
+
+fn unsupported_method(record: &ZipRecord) -> CombineArchiveError {
+    CombineArchiveError::Io(std::io::Error::new(
+        std::io::ErrorKind::Unsupported,
+        format!(
+            "Compression method {} of entry {} is not supported",
+            record.method, record.name
+        ),
+    ))
+}
+
+#[cfg(test)]
+mod tests {
+    use std::{
+        pin::Pin,
+        task::{Context, Poll},
+    };
+
+    use tokio::io::ReadBuf;
+
+    use super::*;
+    use crate::combine::{CombineArchive, KnownFormats};
+
+    /// Builds an archive with a master SBML file and a large, stored data entry
+    fn sample_archive() -> Vec<u8> {
+        let mut archive = CombineArchive::new();
+        archive
+            .add_entry(
+                "./model.xml",
+                KnownFormats::SBML,
+                true,
+                &b"<sbml>model</sbml>"[..],
+            )
+            .unwrap();
+        archive
+            .add_entry_with_options(
+                "./data.bin",
+                "application/octet-stream",
+                false,
+                &vec![7u8; 256 * 1024][..],
+                EntryOptions::new().compression(Compression::Stored),
+            )
+            .unwrap();
+        archive.to_bytes().unwrap()
+    }
+
+    /// Counts the bytes read from the wrapped source
+    struct CountingReader {
+        inner: Cursor<Vec<u8>>,
+        bytes_read: usize,
+    }
+
+    impl AsyncRead for CountingReader {
+        fn poll_read(
+            mut self: Pin<&mut Self>,
+            cx: &mut Context<'_>,
+            buf: &mut ReadBuf<'_>,
+        ) -> Poll<std::io::Result<()>> {
+            let before = buf.filled().len();
+            let result = Pin::new(&mut self.inner).poll_read(cx, buf);
+            self.bytes_read += buf.filled().len() - before;
+            result
+        }
+    }
+
+    impl AsyncSeek for CountingReader {
+        fn start_seek(mut self: Pin<&mut Self>, position: SeekFrom) -> std::io::Result<()> {
+            Pin::new(&mut self.inner).start_seek(position)
+        }
+
+        fn poll_complete(
+            mut self: Pin<&mut Self>,
+            cx: &mut Context<'_>,
+        ) -> Poll<std::io::Result<u64>> {
+            Pin::new(&mut self.inner).poll_complete(cx)
+        }
+    }
+
+    /// A source whose data starts after `padding` zero bytes, to place an archive
+    /// beyond 4 GiB without allocating the bytes in front of it
+    struct PaddedReader {
+        padding: u64,
+        data: Vec<u8>,
+        position: u64,
+    }
+
+    impl AsyncRead for PaddedReader {
+        fn poll_read(
+            mut self: Pin<&mut Self>,
+            _cx: &mut Context<'_>,
+            buf: &mut ReadBuf<'_>,
+        ) -> Poll<std::io::Result<()>> {
+            let len = self.padding + self.data.len() as u64;
+            let n = (len.saturating_sub(self.position) as usize).min(buf.remaining());
+            if self.position < self.padding {
+                let zeros = n.min((self.padding - self.position) as usize);
+                buf.put_slice(&vec![0; zeros]);
+                self.position += zeros as u64;
+            } else {
+                let start = (self.position - self.padding) as usize;
+                buf.put_slice(&self.data[start..start + n]);
+                self.position += n as u64;
+            }
+            Poll::Ready(Ok(()))
+        }
+    }
+
+    impl AsyncSeek for PaddedReader {
+        fn start_seek(mut self: Pin<&mut Self>, position: SeekFrom) -> std::io::Result<()> {
+            let len = self.padding + self.data.len() as u64;
+            self.position = match position {
+                SeekFrom::Start(offset) => offset,
+                SeekFrom::End(offset) => len.saturating_add_signed(offset),
+                SeekFrom::Current(offset) => self.position.saturating_add_signed(offset),
+            };
+            Ok(())
+        }
+
+        fn poll_complete(
+            self: Pin<&mut Self>,
+            _cx: &mut Context<'_>,
+        ) -> Poll<std::io::Result<u64>> {
+            Poll::Ready(Ok(self.position))
+        }
+    }
+
+    /// Returns the offsets of the method and name fields of the local and central
+    /// headers of an entry.
+    fn header_fields(bytes: &[u8], name: &[u8]) -> Vec<(usize, usize)> {
+        let mut fields = Vec::new();
+        for position in 0..bytes.len().saturating_sub(CENTRAL_HEADER_LEN) {
+            let (method, name_len, name_start) = match le_u32(bytes, position) {
+                LOCAL_HEADER_SIGNATURE => (8, 26, LOCAL_HEADER_LEN),
+                CENTRAL_HEADER_SIGNATURE => (10, 28, CENTRAL_HEADER_LEN),
+                _ => continue,
+            };
+            let name_start = position + name_start;
+            if le_u16(bytes, position + name_len) as usize == name.len()
+                && bytes[name_start..].starts_with(name)
+            {
+                fields.push((position + method, name_start));
+            }
+        }
+        fields
+    }
+
+    #[tokio::test]
+    async fn test_async_open_reads_only_requested_ranges() {
+        let bytes = sample_archive();
+        let total = bytes.len();
+        let source = CountingReader {
+            inner: Cursor::new(bytes),
+            bytes_read: 0,
+        };
+
+        let mut archive = AsyncCombineArchive::open(source).await.unwrap();
+        assert!(archive.has_entry("./model.xml"));
+        assert!(archive.has_entry("./data.bin"));
+
+        let master = archive.master().await.unwrap();
+        assert_eq!(master.as_string().unwrap(), "<sbml>model</sbml>");
+        let by_format = archive.entry_by_format(KnownFormats::SBML).await.unwrap();
+        assert_eq!(by_format.content.location, "./model.xml");
+
+        // The stored data entry makes up most of the archive and was never read
+        let source = archive.into_inner().unwrap();
+        assert!(source.bytes_read < total / 2);
+    }
+
+    #[tokio::test]
+    async fn test_async_entry_data() {
+        let mut archive = AsyncCombineArchive::open(Cursor::new(sample_archive()))
+            .await
+            .unwrap();
+        let data = archive.entry("./data.bin").await.unwrap();
+        assert_eq!(data.as_bytes(), &vec![7u8; 256 * 1024][..]);
+
+        assert!(matches!(
+            archive.entry("./missing.xml").await,
+            Err(CombineArchiveError::FileNotFound(_))
+        ));
+    }
+
+    #[tokio::test]
+    async fn test_async_write_roundtrip() {
+        let mut archive = AsyncCombineArchive::open(Cursor::new(sample_archive()))
+            .await
+            .unwrap();
+        archive.remove_entry("./data.bin").unwrap();
+        archive
+            .add_entry("./notes.txt", "text/plain", false, &b"notes"[..])
+            .await
+            .unwrap();
+        archive
+            .add_entry(
+                "./model.xml",
+                KnownFormats::SBML,
+                true,
+                &b"<sbml>updated</sbml>"[..],
+            )
+            .await
+            .unwrap();
+        assert!(archive.remove_entry("./manifest.xml").is_err());
+
+        let bytes = archive.write_to(Vec::new()).await.unwrap();
+
+        // The output is read back by the synchronous archive
+        let dir = tempfile::tempdir().unwrap();
+        let path = dir.path().join("written.omex");
+        std::fs::write(&path, &bytes).unwrap();
+        let mut written = CombineArchive::open(&path).unwrap();
+        assert!(!written.has_entry("./data.bin"));
+        assert_eq!(
+            written.master().unwrap().as_string().unwrap(),
+            "<sbml>updated</sbml>"
+        );
+        assert_eq!(
+            written.entry("./notes.txt").unwrap().as_string().unwrap(),
+            "notes"
+        );
+
+        // And by the asynchronous one
+        let mut reopened = AsyncCombineArchive::open(Cursor::new(bytes)).await.unwrap();
+        assert_eq!(reopened.list_entries().len(), written.list_entries().len());
+        assert_eq!(
+            reopened.entry("./notes.txt").await.unwrap().as_bytes(),
+            b"notes"
+        );
+    }
+
+    #[tokio::test]
+    async fn test_async_write_copies_unchanged_entries() {
+        let mut archive = AsyncCombineArchive::open(Cursor::new(sample_archive()))
+            .await
+            .unwrap();
+        let bytes = archive.write_to(Vec::new()).await.unwrap();
+
+        let mut reopened = AsyncCombineArchive::open(Cursor::new(bytes)).await.unwrap();
+        assert_eq!(
+            reopened.entry("./data.bin").await.unwrap().as_bytes(),
+            &vec![7u8; 256 * 1024][..]
+        );
+        assert_eq!(
+            reopened.master().await.unwrap().as_string().unwrap(),
+            "<sbml>model</sbml>"
+        );
+    }
+
+    #[tokio::test]
+    async fn test_async_new_archive() {
+        let mut archive = AsyncCombineArchive::<Cursor<Vec<u8>>>::new();
+        archive
+            .add_entry("./model.xml", KnownFormats::SBML, true, &b"<sbml/>"[..])
+            .await
+            .unwrap();
+        let bytes = archive.write_to(Vec::new()).await.unwrap();
+
+        let mut reopened = AsyncCombineArchive::open(Cursor::new(bytes)).await.unwrap();
+        assert_eq!(reopened.master().await.unwrap().as_bytes(), b"<sbml/>");
+    }
+
+    #[tokio::test]
+    async fn test_async_open_invalid() {
+        let result = AsyncCombineArchive::open(Cursor::new(b"not a zip".to_vec())).await;
+        assert!(matches!(result, Err(CombineArchiveError::Io(_))));
+    }
+
+    #[tokio::test]
+    async fn test_async_zstd_entry() {
+        let mut archive = CombineArchive::new();
+        archive
+            .add_entry_with_options(
+                "./model.xml",
+                KnownFormats::SBML,
+                true,
+                &b"<sbml>zstd</sbml>"[..],
+                EntryOptions::new().compression(Compression::Zstd(None)),
+            )
+            .unwrap();
+        let bytes = archive.to_bytes().unwrap();
+
+        let mut archive = AsyncCombineArchive::open(Cursor::new(bytes)).await.unwrap();
+        assert_eq!(
+            archive.master().await.unwrap().as_bytes(),
+            b"<sbml>zstd</sbml>"
+        );
+
+        archive
+            .add_entry_with_options(
+                "./notes.txt",
+                "text/plain",
+                false,
+                &b"notes"[..],
+                EntryOptions::new().compression(Compression::Zstd(None)),
+            )
+            .await
+            .unwrap();
+        let bytes = archive.write_to(Vec::new()).await.unwrap();
+        let mut reopened = AsyncCombineArchive::open(Cursor::new(bytes)).await.unwrap();
+        assert_eq!(
+            reopened.entry("./notes.txt").await.unwrap().as_bytes(),
+            b"notes"
+        );
+        assert_eq!(
+            reopened.master().await.unwrap().as_bytes(),
+            b"<sbml>zstd</sbml>"
+        );
+    }
+
+    #[tokio::test]
+    async fn test_async_unsupported_method() {
+        let mut bytes = sample_archive();
+        let fields = header_fields(&bytes, b"data.bin");
+        assert_eq!(fields.len(), 2);
+        for (method, _) in fields {
+            bytes[method..method + 2].copy_from_slice(&77u16.to_le_bytes());
+        }
+
+        let mut archive = AsyncCombineArchive::open(Cursor::new(bytes)).await.unwrap();
+        match archive.entry("./data.bin").await {
+            Err(CombineArchiveError::Io(e)) => {
+                assert_eq!(e.kind(), std::io::ErrorKind::Unsupported);
+                assert!(e.to_string().contains("Compression method 77"));
+            }
+            other => panic!("Expected an unsupported method error, got {other:?}"),
+        }
+        assert!(archive.master().await.is_ok());
+    }
+
+    #[tokio::test]
+    async fn test_async_write_keeps_raw_names() {
+        let raw_name = b"dat\xff.bin";
+        let mut bytes = sample_archive();
+        for (_, name) in header_fields(&bytes, b"data.bin") {
+            bytes[name..name + raw_name.len()].copy_from_slice(raw_name);
+        }
+
+        let mut archive = AsyncCombineArchive::open(Cursor::new(bytes)).await.unwrap();
+        let written = archive.write_to(Vec::new()).await.unwrap();
+        assert_eq!(header_fields(&written, raw_name).len(), 2);
+
+        let records = read_central_directory(&mut Cursor::new(written))
+            .await
+            .unwrap();
+        let record = records
+            .iter()
+            .find(|record| record.raw_name == raw_name)
+            .unwrap();
+        assert_eq!(record.name, "dat\u{fffd}.bin");
+    }
+
+    #[test]
+    fn test_zip64_central_header() {
+        let record = ZipRecord {
+            name: "large.bin".to_string(),
+            raw_name: b"large.bin".to_vec(),
+            version_made_by: 20,
+            version_needed: 20,
+            flags: 0,
+            method: METHOD_STORED,
+            modified_time: 0,
+            modified_date: 0,
+            crc32: 0x1234_5678,
+            compressed_size: 5 << 30,
+            uncompressed_size: 5 << 30,
+            external_attributes: 0,
+            header_offset: 6 << 30,
+        };
+
+        let mut buf = Vec::new();
+        record.push_central_header(&mut buf).unwrap();
+        let (parsed, len) = ZipRecord::parse_central_header(&buf).unwrap();
+        assert_eq!(len, buf.len());
+        assert_eq!(parsed.version_needed, VERSION_ZIP64);
+        assert_eq!(
+            parsed,
+            ZipRecord {
+                version_needed: VERSION_ZIP64,
+                ..record.clone()
+            }
+        );
+
+        // Records that fit into the 32-bit fields have no extra field
+        let small = ZipRecord {
+            compressed_size: 10,
+            uncompressed_size: 10,
+            header_offset: 0,
+            ..record
+        };
+        let mut buf = Vec::new();
+        small.push_central_header(&mut buf).unwrap();
+        assert_eq!(buf.len(), CENTRAL_HEADER_LEN + small.raw_name.len());
+        assert_eq!(ZipRecord::parse_central_header(&buf).unwrap().0, small);
+    }
+
+    #[tokio::test]
+    async fn test_async_open_zip64_archive() {
+        // Move the entries of an archive beyond 4 GiB and write a ZIP64 directory
+        let bytes = sample_archive();
+        let records = read_central_directory(&mut Cursor::new(bytes.as_slice()))
+            .await
+            .unwrap();
+        let data_end = le_u32(&bytes, bytes.len() - END_OF_CENTRAL_DIRECTORY_LEN + 16) as u64;
+
+        let padding = 5 << 30;
+        let relocated: Vec<ZipRecord> = records
+            .iter()
+            .map(|record| record.relocated(record.header_offset + padding))
+            .collect();
+        let mut data = bytes[..data_end as usize].to_vec();
+        push_central_directory(&mut data, &relocated, padding + data_end).unwrap();
+        assert_eq!(header_fields(&data, b"manifest.xml").len(), 2);
+
+        let source = PaddedReader {
+            padding,
+            data,
+            position: 0,
+        };
+        let mut archive = AsyncCombineArchive::open(source).await.unwrap();
+        assert_eq!(
+            archive.master().await.unwrap().as_string().unwrap(),
+            "<sbml>model</sbml>"
+        );
+        assert_eq!(
+            archive.entry("./data.bin").await.unwrap().as_bytes(),
+            &vec![7u8; 256 * 1024][..]
+        );
+    }
+}
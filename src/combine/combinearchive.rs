@@ -1,14 +1,41 @@
 use std::{
     collections::HashMap,
-    io::{Cursor, Read, Write},
+    fs::File,
+    io::{BufReader, BufWriter, Cursor, Read, Seek, Write},
     path::Path,
+    sync::{
+        atomic::{AtomicUsize, Ordering},
+        Mutex, MutexGuard, PoisonError,
+    },
+    thread,
+};
+use zip::{write::SimpleFileOptions, CompressionMethod, ZipArchive, ZipWriter};
+
+use crate::{
+    combine::manifest::{KnownFormats, OmexManifest},
+    instrument::{trace_event, trace_span},
+    memory::{self, MemoryUsage},
+    reader::SBMLReader,
+    sbmldoc::SBMLDocument,
+    writer::temp_path_for,
 };
-use zip::{write::SimpleFileOptions, ZipArchive, ZipWriter};
-
-use crate::combine::manifest::OmexManifest;
 
 use super::{error::CombineArchiveError, manifest::Content};
 
+/// Source of an archive's original ZIP data, either a file on disk or an in-memory buffer
+///
+/// Requires `Send` and `Sync`, so that an archive can be moved to and shared between
+/// threads like one that holds its data in memory.
+trait ReadSeek: Read + Seek + Send + Sync {}
+
+impl<T: Read + Seek + Send + Sync> ReadSeek for T {}
+
+/// Size of the read buffer in front of an archive opened from disk
+const ZIP_READ_BUFFER_BYTES: usize = 8 * 1024;
+
+/// Estimated size of the parsed central directory record of an entry, without its name
+const ZIP_ENTRY_BYTES: usize = 256;
+
 /// A COMBINE Archive (OMEX) implementation for managing collections of files
 /// with metadata according to the COMBINE Archive specification.
 ///
@@ -17,16 +44,28 @@ use super::{error::CombineArchiveError, manifest::Content};
 /// provides a high-level interface for creating, reading, and modifying OMEX files.
 pub struct CombineArchive {
     /// The manifest containing metadata about all files in the archive
+    ///
+    /// Lookups by location and format go through an index that is rebuilt whenever
+    /// the number of entries changes or a cached position turns out to be stale.
+    /// Renaming entries in place is not detected, use
+    /// [`remove_entry`](Self::remove_entry) and [`add_entry`](Self::add_entry) instead.
     pub manifest: OmexManifest,
 
     /// Optional path to the archive file on disk
     path: Option<std::path::PathBuf>,
 
     // Internal state for efficient mutation tracking
-    /// Original ZIP data when loaded from file
-    original_zip: Option<Vec<u8>>,
+    /// Original ZIP archive when loaded from file, with its central directory parsed once
+    ///
+    /// Archives opened from disk are read through the file handle, so only the central
+    /// directory and the entries actually accessed are ever read into memory.
+    original_zip: Option<ZipArchive<Box<dyn ReadSeek>>>,
+    /// Index of the manifest content by location and format
+    content_index: Mutex<ContentIndex>,
     /// New or modified entries waiting to be written
     pending_entries: HashMap<String, Vec<u8>>,
+    /// Compression chosen for pending entries, entries without one use the default
+    entry_compression: HashMap<String, Compression>,
     /// Entries marked for removal
     removed_entries: std::collections::HashSet<String>,
     /// Flag indicating if the archive needs to be rebuilt
@@ -44,6 +83,72 @@ pub struct Entry {
     pub data: Vec<u8>,
 }
 
+/// Compression applied to an entry when the archive is written.
+///
+/// Already compressed payloads (images, HDF5 files, nested archives) gain
+/// nothing from being deflated again and are best stored as-is.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum Compression {
+    /// Store the data without compression
+    Stored,
+    /// Deflate compression, `None` selects the default level
+    Deflated(Option<i64>),
+    /// Zstandard compression, `None` selects the default level
+    Zstd(Option<i64>),
+}
+
+impl Default for Compression {
+    fn default() -> Self {
+        Compression::Deflated(None)
+    }
+}
+
+impl Compression {
+    /// Returns the ZIP file options for this compression
+    fn file_options(self) -> SimpleFileOptions {
+        let (method, level) = match self {
+            Compression::Stored => (CompressionMethod::Stored, None),
+            Compression::Deflated(level) => (CompressionMethod::Deflated, level),
+            Compression::Zstd(level) => (CompressionMethod::Zstd, level),
+        };
+
+        SimpleFileOptions::default()
+            .compression_method(method)
+            .compression_level(level)
+    }
+}
+
+/// Options controlling how an entry is added to a COMBINE Archive.
+///
+/// # Example
+///
+/// ```no_run
+/// use sbml::combine::{CombineArchive, Compression, EntryOptions};
+///
+/// let mut archive = CombineArchive::new();
+/// let options = EntryOptions::new().compression(Compression::Stored);
+/// archive
+///     .add_entry_with_options("./figure.png", "image/png", false, &b"..."[..], options)
+///     .unwrap();
+/// ```
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct EntryOptions {
+    pub(super) compression: Compression,
+}
+
+impl EntryOptions {
+    /// Creates options with the default Deflate compression
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Sets the compression used when the entry is written
+    pub fn compression(mut self, compression: Compression) -> Self {
+        self.compression = compression;
+        self
+    }
+}
+
 impl CombineArchive {
     /// Creates a new empty COMBINE Archive.
     ///
@@ -82,7 +187,9 @@ impl CombineArchive {
             manifest,
             path: None,
             original_zip: None,
+            content_index: Mutex::new(ContentIndex::default()),
             pending_entries: HashMap::new(),
+            entry_compression: HashMap::new(),
             removed_entries: std::collections::HashSet::new(),
             needs_rebuild: false,
         }
@@ -90,8 +197,10 @@ impl CombineArchive {
 
     /// Opens an existing COMBINE Archive from a file.
     ///
-    /// This method reads the ZIP file, extracts and parses the manifest,
-    /// and prepares the archive for reading and modification.
+    /// This method reads the ZIP central directory, extracts and parses the manifest,
+    /// and prepares the archive for reading and modification. The file stays open and
+    /// entries are only read from it when they are accessed, so opening large archives
+    /// does not require loading them into memory.
     ///
     /// # Arguments
     ///
@@ -118,10 +227,15 @@ impl CombineArchive {
     /// The manifest reference at "./manifest.xml" must exist in the archive or an error will be thrown.
     pub fn open<P: AsRef<Path>>(path: P) -> Result<Self, CombineArchiveError> {
         let path_buf = path.as_ref().to_path_buf();
-        let zip_data = std::fs::read(&path_buf)?;
+        trace_span!(
+            "omex_open",
+            path = %path_buf.display(),
+            bytes_in = std::fs::metadata(&path_buf).map_or(0, |m| m.len())
+        );
+        let mut zip_archive = Self::open_zip(&path_buf)?;
 
         // Extract and parse the manifest - this will fail if manifest.xml doesn't exist
-        let mut manifest = Self::extract_manifest(&zip_data)?;
+        let mut manifest = Self::extract_manifest(&mut zip_archive)?;
 
         // Ensure archive self-reference entry is present (for backwards compatibility)
         // The manifest.xml entry should already be present in the manifest since we read it from the file
@@ -145,8 +259,10 @@ impl CombineArchive {
         Ok(Self {
             manifest,
             path: Some(path_buf),
-            original_zip: Some(zip_data),
+            original_zip: Some(zip_archive),
+            content_index: Mutex::new(ContentIndex::default()),
             pending_entries: HashMap::new(),
+            entry_compression: HashMap::new(),
             removed_entries: std::collections::HashSet::new(),
             needs_rebuild: false,
         })
@@ -205,11 +321,37 @@ impl CombineArchive {
     /// * `CombineArchiveError::Io` - If reading from the data source fails
     /// * `CombineArchiveError::Manifest` - If there's an error updating the manifest
     pub fn add_entry(
+        &mut self,
+        location: impl Into<String>,
+        format: impl Into<String>,
+        master: bool,
+        data: impl Read,
+    ) -> Result<(), CombineArchiveError> {
+        self.add_entry_with_options(location, format, master, data, EntryOptions::default())
+    }
+
+    /// Adds data to the archive like [`add_entry`](Self::add_entry), with explicit
+    /// options for how the entry is written.
+    ///
+    /// # Arguments
+    ///
+    /// * `location` - Location within the archive (e.g., "./model.xml")
+    /// * `format` - MIME type or format identifier for the file
+    /// * `master` - Whether this file is the master file of the archive
+    /// * `data` - Data source implementing `Read`
+    /// * `options` - Options such as the compression of the entry
+    ///
+    /// # Errors
+    ///
+    /// * `CombineArchiveError::Io` - If reading from the data source fails
+    /// * `CombineArchiveError::Manifest` - If there's an error updating the manifest
+    pub fn add_entry_with_options(
         &mut self,
         location: impl Into<String>,
         format: impl Into<String>,
         master: bool,
         mut data: impl Read,
+        options: EntryOptions,
     ) -> Result<(), CombineArchiveError> {
         let location = location.into();
         let format = format.into();
@@ -223,17 +365,21 @@ impl CombineArchive {
 
                 let zip_location = location.replace("./", "");
                 self.removed_entries.remove(&zip_location);
+                self.entry_compression
+                    .insert(zip_location.clone(), options.compression);
                 self.pending_entries.insert(zip_location, data_buf);
                 self.needs_rebuild = true;
                 return Ok(());
             } else {
                 // Different metadata - remove the old entry first
                 self.manifest.content.retain(|c| c.location != location);
+                self.content_index_mut().invalidate();
             }
         }
 
         // Add new entry to manifest
         self.manifest.add_entry(location.clone(), format, master)?;
+        self.content_index_mut().invalidate();
 
         // Read and store the data
         let mut data_buf = Vec::new();
@@ -241,6 +387,8 @@ impl CombineArchive {
 
         let zip_location = location.replace("./", "");
         self.removed_entries.remove(&zip_location);
+        self.entry_compression
+            .insert(zip_location.clone(), options.compression);
         self.pending_entries.insert(zip_location, data_buf);
         self.needs_rebuild = true;
 
@@ -282,10 +430,12 @@ impl CombineArchive {
 
         // Remove from manifest
         self.manifest.content.retain(|c| c.location != location);
+        self.content_index_mut().invalidate();
 
         // Mark for removal from ZIP
         self.removed_entries.insert(zip_location.clone());
         self.pending_entries.remove(&zip_location);
+        self.entry_compression.remove(&zip_location);
         self.needs_rebuild = true;
 
         Ok(())
@@ -311,16 +461,19 @@ impl CombineArchive {
     /// * `CombineArchiveError::Zip` - If there's an error reading from the ZIP
     /// * `CombineArchiveError::Io` - If there's an I/O error
     pub fn entry(&mut self, location: &str) -> Result<Entry, CombineArchiveError> {
-        if !self.manifest.has_location(location) {
-            return Err(CombineArchiveError::FileNotFound(location.to_string()));
-        }
+        trace_span!("omex_entry", location);
+        let content = self
+            .find_content(location)
+            .ok_or_else(|| CombineArchiveError::FileNotFound(location.to_string()))?
+            .clone();
 
         let zip_location = location.replace("./", "");
 
         // Check pending entries first (most recent changes)
         if let Some(data) = self.pending_entries.get(&zip_location) {
+            trace_event!(bytes_out = data.len(), pending = true);
             return Ok(Entry {
-                content: self.find_content(location).unwrap().clone(),
+                content,
                 data: data.clone(),
             });
         }
@@ -331,21 +484,62 @@ impl CombineArchive {
         }
 
         // Read from original ZIP archive
-        if let Some(ref zip_data) = self.original_zip {
-            let mut archive = ZipArchive::new(Cursor::new(zip_data))?;
+        if let Some(archive) = self.original_zip.as_mut() {
             let mut file = archive.by_name(&zip_location)?;
-            let mut data = Vec::new();
+            let mut data = Vec::with_capacity(file.size() as usize);
             file.read_to_end(&mut data)?;
+            trace_event!(bytes_out = data.len(), pending = false);
 
-            return Ok(Entry {
-                content: self.find_content(location).unwrap().clone(),
-                data,
-            });
+            return Ok(Entry { content, data });
         }
 
         Err(CombineArchiveError::FileNotFound(location.to_string()))
     }
 
+    /// Returns a reader streaming the data of an entry.
+    ///
+    /// In contrast to [`entry`](Self::entry), the data is not loaded into memory up
+    /// front. Entries stored in the original archive are decompressed while they are
+    /// read, pending entries are read from their staged buffer.
+    ///
+    /// # Arguments
+    ///
+    /// * `location` - Location of the entry to read (e.g., "./model.xml")
+    ///
+    /// # Returns
+    ///
+    /// Returns a reader over the entry data, or an error if the entry doesn't exist.
+    ///
+    /// # Errors
+    ///
+    /// * `CombineArchiveError::FileNotFound` - If the entry doesn't exist
+    /// * `CombineArchiveError::Zip` - If there's an error reading from the ZIP
+    pub fn entry_reader(
+        &mut self,
+        location: &str,
+    ) -> Result<Box<dyn Read + '_>, CombineArchiveError> {
+        if self.find_content(location).is_none() {
+            return Err(CombineArchiveError::FileNotFound(location.to_string()));
+        }
+
+        let zip_location = location.replace("./", "");
+
+        // Check pending entries first (most recent changes)
+        if let Some(data) = self.pending_entries.get(&zip_location) {
+            return Ok(Box::new(Cursor::new(data.as_slice())));
+        }
+
+        // Check if it was removed
+        if self.removed_entries.contains(&zip_location) {
+            return Err(CombineArchiveError::FileNotFound(location.to_string()));
+        }
+
+        match self.original_zip.as_mut() {
+            Some(archive) => Ok(Box::new(archive.by_name(&zip_location)?)),
+            None => Err(CombineArchiveError::FileNotFound(location.to_string())),
+        }
+    }
+
     /// Retrieves an entry from the archive by format.
     ///
     /// This method returns the first entry with the specified format.
@@ -367,14 +561,11 @@ impl CombineArchive {
         format: impl Into<String>,
     ) -> Result<Entry, CombineArchiveError> {
         let format = format.into();
-        let location = self
-            .manifest
-            .content
-            .iter()
-            .find(|c| c.format == format)
-            .ok_or(CombineArchiveError::FileNotFound(format.to_string()))?
-            .location
-            .clone();
+        let position = self
+            .content_index()
+            .find_format(&self.manifest.content, &format)
+            .ok_or(CombineArchiveError::FileNotFound(format.to_string()))?;
+        let location = self.manifest.content[position].location.clone();
         self.entry(&location)
     }
 
@@ -402,6 +593,88 @@ impl CombineArchive {
         self.entry(&location)
     }
 
+    /// Reads and parses every SBML entry of the archive.
+    ///
+    /// All manifest entries whose format is SBML, including level and version specific
+    /// SBML formats, are parsed in manifest order. The compressed data of each entry is
+    /// copied from the archive one after another into an in-memory ZIP holding only
+    /// that entry, while decompression, parsing and validation run concurrently on a
+    /// pool of scoped worker threads. Workers decompress the entry in chunks straight
+    /// into the native string handed to libSBML, so the decompressed document is held
+    /// in memory once. Pending entries are copied from their staged buffer into the
+    /// native string in one go.
+    ///
+    /// # Arguments
+    ///
+    /// * `parallel` - Whether to process the entries on worker threads
+    /// * `validate` - Whether to check the consistency of every document, the results
+    ///   are available from [`SBMLDocument::error_log`]
+    ///
+    /// # Returns
+    ///
+    /// The manifest content of every SBML entry together with its parsed document, or
+    /// the error that occurred while reading the entry.
+    pub fn load_sbml_entries(
+        &mut self,
+        parallel: bool,
+        validate: bool,
+    ) -> Vec<(Content, Result<SBMLDocument, CombineArchiveError>)> {
+        trace_span!("omex_load_sbml", parallel, validate);
+        let contents: Vec<Content> = self
+            .manifest
+            .content
+            .iter()
+            .filter(|content| KnownFormats::SBML.matches(&content.format))
+            .cloned()
+            .collect();
+
+        // Gather the data of all entries up front, since the archive is read sequentially
+        let mut errors = Vec::with_capacity(contents.len());
+        let mut sources = Vec::with_capacity(contents.len());
+        for content in &contents {
+            let zip_location = content.location.replace("./", "");
+            let source = if let Some(data) = self.pending_entries.get(&zip_location) {
+                Ok(SbmlSource::Pending(data))
+            } else if self.removed_entries.contains(&zip_location) {
+                Err(CombineArchiveError::FileNotFound(content.location.clone()))
+            } else if let Some(archive) = self.original_zip.as_mut() {
+                extract_raw_entry(archive, &zip_location).map(SbmlSource::Packed)
+            } else {
+                Err(CombineArchiveError::FileNotFound(content.location.clone()))
+            };
+
+            match source {
+                Ok(source) => {
+                    sources.push(Some(source));
+                    errors.push(None);
+                }
+                Err(e) => {
+                    sources.push(None);
+                    errors.push(Some(e));
+                }
+            }
+        }
+
+        let documents = map_concurrently(&sources, parallel, |source| {
+            source
+                .as_ref()
+                .map(|source| parse_sbml_entry(source, validate))
+        });
+
+        contents
+            .into_iter()
+            .zip(documents.into_iter().zip(errors))
+            .map(|(content, (document, error))| {
+                let document = match (document, error) {
+                    (Some(document), _) => document,
+                    (None, Some(error)) => Err(error),
+                    (None, None) => unreachable!("every SBML entry has a source or an error"),
+                };
+                (content, document)
+            })
+            .collect()
+    }
+
     /// Lists all entries in the archive.
     ///
     /// Returns references to the metadata for all files in the archive.
@@ -427,7 +700,45 @@ impl CombineArchive {
     ///
     /// `true` if the entry exists, `false` otherwise.
     pub fn has_entry(&self, location: &str) -> bool {
-        self.manifest.has_location(location)
+        self.find_content(location).is_some()
+    }
+
+    /// Reports the memory held by the archive's buffers.
+    ///
+    /// Covers the data of pending entries, the manifest, the lookup indices and the
+    /// parsed central directory of the original archive. Entries that were only
+    /// written to disk are not held in memory. See [`MemoryUsage`] for details.
+    pub fn memory_usage(&self) -> MemoryUsage {
+        let manifest = self.manifest.xmlns.capacity()
+            + memory::vec_bytes(&self.manifest.content)
+            + self
+                .manifest
+                .content
+                .iter()
+                .map(|content| content.location.capacity() + content.format.capacity())
+                .sum::<usize>();
+        let pending = memory::string_map_bytes(&self.pending_entries)
+            + self
+                .pending_entries
+                .values()
+                .map(Vec::capacity)
+                .sum::<usize>();
+        let original = self.original_zip.as_ref().map_or(0, |archive| {
+            ZIP_READ_BUFFER_BYTES
+                + archive.len() * ZIP_ENTRY_BYTES
+                + archive.file_names().map(str::len).sum::<usize>()
+        });
+
+        MemoryUsage {
+            archive_bytes: std::mem::size_of::<Self>()
+                + manifest
+                + pending
+                + original
+                + self.content_index().heap_bytes()
+                + memory::string_map_bytes(&self.entry_compression)
+                + memory::string_set_bytes(&self.removed_entries),
+            ..MemoryUsage::default()
+        }
     }
 
     /// Saves the archive to a file.
@@ -445,15 +756,54 @@ impl CombineArchive {
     /// * `CombineArchiveError::Io` - If the file cannot be written
     /// * `CombineArchiveError::Zip` - If there's an error creating the ZIP
     /// * `CombineArchiveError::Manifest` - If the manifest cannot be serialized
+    /// * `CombineArchiveError::Reopen` - If the archive was saved, but the saved file
+    ///   could not be opened again. The archive then no longer has access to the
+    ///   entry data and should be opened again from `path`
     pub fn save<P: AsRef<Path>>(&mut self, path: P) -> Result<(), CombineArchiveError> {
-        let zip_data = self.build_zip()?;
-        std::fs::write(path, &zip_data)?;
+        let path = path.as_ref();
+        trace_span!("omex_save", path = %path.display());
+
+        // Write next to the target and move the result into place afterwards, since
+        // the target may be the very archive that unchanged entries are copied from
+        let temp_path = temp_path_for(path)?;
+
+        let result = File::create(&temp_path)
+            .map_err(CombineArchiveError::from)
+            .and_then(|file| self.write_zip(BufWriter::new(file)))
+            .and_then(|writer| {
+                let file = writer.into_inner().map_err(|e| e.into_error())?;
+                file.sync_all()?;
+                Ok(())
+            })
+            .and_then(|_| {
+                // Windows refuses to replace a file that is still open, so release the
+                // original archive, which may be the target, before moving the new one
+                let original = self.original_zip.take();
+                std::fs::rename(&temp_path, path).map_err(|e| {
+                    self.original_zip = original;
+                    CombineArchiveError::from(e)
+                })
+            });
 
-        // Update internal state to reflect saved state
-        self.original_zip = Some(zip_data);
+        if let Err(e) = result {
+            let _ = std::fs::remove_file(&temp_path);
+            return Err(e);
+        }
+
+        // The saved file now holds every entry, so the pending state is cleared
+        // before reopening it. If that fails, the archive is left without entry data
+        // instead of mixing pending changes with a missing original
         self.pending_entries.clear();
+        self.entry_compression.clear();
         self.removed_entries.clear();
         self.needs_rebuild = false;
+        self.original_zip =
+            Some(
+                Self::open_zip(path).map_err(|e| CombineArchiveError::Reopen {
+                    path: path.to_path_buf(),
+                    source: Box::new(e),
+                })?,
+            );
 
         Ok(())
     }
@@ -490,15 +840,21 @@ impl CombineArchive {
     /// * `CombineArchiveError::Zip` - If there's an error creating the ZIP
     /// * `CombineArchiveError::Manifest` - If the manifest cannot be serialized
     pub fn to_bytes(&mut self) -> Result<Vec<u8>, CombineArchiveError> {
-        self.build_zip()
+        Ok(self.write_zip(Cursor::new(Vec::new()))?.into_inner())
     }
 
     // Private helper methods
 
-    /// Extracts and parses the manifest from ZIP data.
-    fn extract_manifest(zip_data: &[u8]) -> Result<OmexManifest, CombineArchiveError> {
-        let mut archive = ZipArchive::new(Cursor::new(zip_data))?;
+    /// Opens a ZIP archive on disk, reading only its central directory.
+    fn open_zip(path: &Path) -> Result<ZipArchive<Box<dyn ReadSeek>>, CombineArchiveError> {
+        let file: Box<dyn ReadSeek> = Box::new(BufReader::new(File::open(path)?));
+        Ok(ZipArchive::new(file)?)
+    }
 
+    /// Extracts and parses the manifest from ZIP data.
+    fn extract_manifest<R: Read + Seek>(
+        archive: &mut ZipArchive<R>,
+    ) -> Result<OmexManifest, CombineArchiveError> {
         // Check if manifest.xml exists in the archive
         let mut manifest_buf = Vec::new();
         match archive.by_name("manifest.xml") {
@@ -517,56 +873,280 @@ impl CombineArchive {
         Ok(manifest)
     }
 
+    /// Locks the content index.
+    ///
+    /// The index is a cache that is rebuilt whenever it looks outdated, so a panic
+    /// while it was locked leaves nothing to recover from.
+    fn content_index(&self) -> MutexGuard<'_, ContentIndex> {
+        self.content_index
+            .lock()
+            .unwrap_or_else(PoisonError::into_inner)
+    }
+
+    /// Returns the content index without locking it.
+    fn content_index_mut(&mut self) -> &mut ContentIndex {
+        self.content_index
+            .get_mut()
+            .unwrap_or_else(PoisonError::into_inner)
+    }
+
     /// Finds content metadata by location.
     fn find_content(&self, location: &str) -> Option<&Content> {
-        self.manifest
-            .content
-            .iter()
-            .find(|c| c.location == location)
+        let position = self
+            .content_index()
+            .find_location(&self.manifest.content, location)?;
+        self.manifest.content.get(position)
     }
 
-    /// Builds the complete ZIP archive with current state.
-    fn build_zip(&self) -> Result<Vec<u8>, CombineArchiveError> {
-        let mut buffer = Vec::new();
-        let mut writer = ZipWriter::new(Cursor::new(&mut buffer));
-        let options =
-            SimpleFileOptions::default().compression_method(zip::CompressionMethod::Deflated);
+    /// Writes the complete ZIP archive with current state.
+    ///
+    /// Unchanged entries of the original archive are copied as raw compressed bytes,
+    /// so only new and modified entries are compressed. The archive is streamed into
+    /// `output`, which is returned once the archive is complete.
+    fn write_zip<W: Write + Seek>(&mut self, output: W) -> Result<W, CombineArchiveError> {
+        trace_span!("build_zip", entries = self.pending_entries.len());
+        let mut writer = ZipWriter::new(output);
 
         // Copy entries from original ZIP that aren't removed or overwritten
-        if let Some(ref original_data) = self.original_zip {
-            let mut original_archive = ZipArchive::new(Cursor::new(original_data))?;
+        if let Some(original_archive) = self.original_zip.as_mut() {
             for i in 0..original_archive.len() {
-                let mut file = original_archive.by_index(i)?;
-                let name = file.name().to_string();
+                let file = original_archive.by_index_raw(i)?;
+                let name = file.name();
 
                 // Skip if removed, overwritten, or is manifest (we'll add manifest last)
-                if self.removed_entries.contains(&name)
-                    || self.pending_entries.contains_key(&name)
+                if self.removed_entries.contains(name)
+                    || self.pending_entries.contains_key(name)
                     || name == "manifest.xml"
                 {
                     continue;
                 }
 
-                writer.start_file(&name, options)?;
-                std::io::copy(&mut file, &mut writer)?;
+                writer.raw_copy_file(file)?;
             }
         }
 
-        // Add all pending entries (new or modified files)
-        for (name, data) in &self.pending_entries {
-            writer.start_file(name, options)?;
-            writer.write_all(data)?;
+        // Add all pending entries (new or modified files), compressed up front
+        let parts = self.compress_pending_entries()?;
+        trace_event!(
+            bytes_in = self.pending_entries.values().map(Vec::len).sum::<usize>(),
+            bytes_out = parts.iter().map(Vec::len).sum::<usize>()
+        );
+        for compressed in parts {
+            let mut part = ZipArchive::new(Cursor::new(compressed))?;
+            writer.raw_copy_file(part.by_index_raw(0)?)?;
         }
 
         // Always add manifest last to ensure it's up to date
         let manifest_xml = self.manifest.to_xml().map_err(|e| {
             CombineArchiveError::Manifest(quick_xml::DeError::Custom(e.to_string()))
         })?;
-        writer.start_file("manifest.xml", options)?;
+        writer.start_file("manifest.xml", Compression::default().file_options())?;
         writer.write_all(manifest_xml.as_bytes())?;
 
-        writer.finish()?;
-        Ok(buffer)
+        Ok(writer.finish()?)
+    }
+
+    /// Compresses all pending entries concurrently.
+    ///
+    /// Each entry is compressed into its own single-entry ZIP in memory by a pool of
+    /// scoped worker threads. The results are returned sorted by entry name, so that
+    /// they can be raw-copied into the output archive in a deterministic order.
+    fn compress_pending_entries(&self) -> Result<Vec<Vec<u8>>, CombineArchiveError> {
+        let mut jobs: Vec<(&str, &[u8], Compression)> = self
+            .pending_entries
+            .iter()
+            .map(|(name, data)| {
+                let compression = self
+                    .entry_compression
+                    .get(name)
+                    .copied()
+                    .unwrap_or_default();
+                (name.as_str(), data.as_slice(), compression)
+            })
+            .collect();
+        jobs.sort_unstable_by_key(|(name, _, _)| *name);
+
+        map_concurrently(&jobs, true, |&(name, data, compression)| {
+            compress_entry(name, data, compression)
+        })
+        .into_iter()
+        .collect()
+    }
+}
+
+/// Applies `f` to every job on a pool of scoped worker threads.
+///
+/// Workers take the next job from a shared counter until all jobs are done. The
+/// results are returned in the order of the jobs. With `parallel` set to false, or if
+/// only one thread is available, the jobs are processed on the calling thread.
+fn map_concurrently<T, U, F>(jobs: &[T], parallel: bool, f: F) -> Vec<U>
+where
+    T: Sync,
+    U: Send,
+    F: Fn(&T) -> U + Sync,
+{
+    let n_workers = if parallel {
+        thread::available_parallelism()
+            .map(|n| n.get())
+            .unwrap_or(1)
+            .min(jobs.len())
+    } else {
+        1
+    };
+
+    if n_workers <= 1 {
+        return jobs.iter().map(f).collect();
+    }
+
+    let next = AtomicUsize::new(0);
+    let mut done: Vec<(usize, U)> = thread::scope(|scope| {
+        let workers: Vec<_> = (0..n_workers)
+            .map(|_| {
+                scope.spawn(|| {
+                    let mut done = Vec::new();
+                    loop {
+                        let i = next.fetch_add(1, Ordering::Relaxed);
+                        let Some(job) = jobs.get(i) else {
+                            break;
+                        };
+                        done.push((i, f(job)));
+                    }
+                    done
+                })
+            })
+            .collect();
+
+        workers
+            .into_iter()
+            .flat_map(|worker| worker.join().expect("archive worker panicked"))
+            .collect()
+    });
+
+    done.sort_unstable_by_key(|(i, _)| *i);
+    done.into_iter().map(|(_, result)| result).collect()
+}
+
+/// Data of an SBML entry handed to a parser
+enum SbmlSource<'a> {
+    /// Uncompressed data of a pending entry
+    Pending(&'a [u8]),
+    /// A single-entry ZIP holding the compressed data of an entry of the original archive
+    Packed(Vec<u8>),
+}
+
+/// Copies the compressed data of an entry into an in-memory ZIP containing only that entry
+fn extract_raw_entry<R: Read + Seek>(
+    archive: &mut ZipArchive<R>,
+    name: &str,
+) -> Result<Vec<u8>, CombineArchiveError> {
+    let index = archive
+        .index_for_name(name)
+        .ok_or_else(|| CombineArchiveError::FileNotFound(name.to_string()))?;
+    let mut writer = ZipWriter::new(Cursor::new(Vec::new()));
+    writer.raw_copy_file(archive.by_index_raw(index)?)?;
+    Ok(writer.finish()?.into_inner())
+}
+
+/// Parses an SBML entry, optionally checking its consistency
+fn parse_sbml_entry(
+    source: &SbmlSource,
+    validate: bool,
+) -> Result<SBMLDocument, CombineArchiveError> {
+    let document = match source {
+        SbmlSource::Pending(data) => SBMLReader::from_bytes(data),
+        SbmlSource::Packed(bytes) => {
+            let mut part = ZipArchive::new(Cursor::new(bytes.as_slice()))?;
+            let file = part.by_index(0)?;
+            SBMLReader::from_reader(file)?
+        }
+    };
+
+    if validate {
+        document.check_consistency_lazy();
+    }
+    Ok(document)
+}
+
+/// Compresses a single entry into an in-memory ZIP containing only that entry
+pub(super) fn compress_entry(
+    name: &str,
+    data: &[u8],
+    compression: Compression,
+) -> Result<Vec<u8>, CombineArchiveError> {
+    let mut writer = ZipWriter::new(Cursor::new(Vec::new()));
+    let options = compression
+        .file_options()
+        .large_file(data.len() as u64 >= u32::MAX as u64);
+    writer.start_file(name, options)?;
+    writer.write_all(data)?;
+    Ok(writer.finish()?.into_inner())
+}
+
+/// Maps manifest locations and formats to positions in [`OmexManifest::content`].
+///
+/// The index is built on first use and rebuilt whenever it has been invalidated, the
+/// number of entries changed, or a cached position no longer matches its key.
+#[derive(Debug, Default)]
+pub(super) struct ContentIndex {
+    /// Position of the entry at each location
+    locations: HashMap<String, usize>,
+    /// Position of the first entry of each format
+    formats: HashMap<String, usize>,
+    /// Number of entries the index was built from, `None` if it needs to be rebuilt
+    len: Option<usize>,
+}
+
+impl ContentIndex {
+    /// Returns the size of the index on the heap.
+    fn heap_bytes(&self) -> usize {
+        memory::string_map_bytes(&self.locations) + memory::string_map_bytes(&self.formats)
+    }
+
+    /// Marks the index as outdated.
+    pub(super) fn invalidate(&mut self) {
+        self.len = None;
+    }
+
+    /// Returns the position of the entry at `location`.
+    pub(super) fn find_location(&mut self, content: &[Content], location: &str) -> Option<usize> {
+        self.sync(content);
+        let position = *self.locations.get(location)?;
+        if content[position].location == location {
+            return Some(position);
+        }
+
+        self.rebuild(content);
+        self.locations.get(location).copied()
+    }
+
+    /// Returns the position of the first entry with the given `format`.
+    pub(super) fn find_format(&mut self, content: &[Content], format: &str) -> Option<usize> {
+        self.sync(content);
+        let position = *self.formats.get(format)?;
+        if content[position].format == format {
+            return Some(position);
+        }
+
+        self.rebuild(content);
+        self.formats.get(format).copied()
+    }
+
+    /// Rebuilds the index if it is outdated or does not match the content length.
+    fn sync(&mut self, content: &[Content]) {
+        if self.len != Some(content.len()) {
+            self.rebuild(content);
+        }
+    }
+
+    /// Rebuilds the index from scratch.
+    fn rebuild(&mut self, content: &[Content]) {
+        self.locations.clear();
+        self.formats.clear();
+        for (position, c) in content.iter().enumerate() {
+            self.locations.entry(c.location.clone()).or_insert(position);
+            self.formats.entry(c.format.clone()).or_insert(position);
+        }
+        self.len = Some(content.len());
     }
 }
 
@@ -1323,6 +1903,364 @@ mod tests {
         assert_eq!(entry.as_string().unwrap(), "<model>v1</model>");
     }
 
+    #[test]
+    fn test_save_changes_copies_unchanged_entries_raw() {
+        let temp_dir = create_test_dir();
+        let archive_path = temp_dir.path().join("raw_copy.omex");
+
+        let mut archive = CombineArchive::new();
+        archive
+            .add_entry("./model.xml", KnownFormats::SBML, true, b"<v1/>".as_slice())
+            .unwrap();
+        archive
+            .add_entry(
+                "./data.tsv",
+                "text/tab-separated-values",
+                false,
+                "a\tb\n".repeat(10_000).as_bytes(),
+            )
+            .unwrap();
+        archive.save(&archive_path).unwrap();
+
+        let raw_entry = |name: &str| {
+            let mut zip = ZipArchive::new(File::open(&archive_path).unwrap()).unwrap();
+            let file = zip.by_name(name).unwrap();
+            (file.crc32(), file.compressed_size())
+        };
+        let (crc_before, size_before) = raw_entry("data.tsv");
+
+        // Update only the master file in place
+        let mut archive = CombineArchive::open(&archive_path).unwrap();
+        archive
+            .add_entry("./model.xml", KnownFormats::SBML, true, b"<v2/>".as_slice())
+            .unwrap();
+        archive.save_changes().unwrap();
+
+        let (crc_after, size_after) = raw_entry("data.tsv");
+        assert_eq!(crc_before, crc_after);
+        assert_eq!(size_before, size_after);
+
+        let mut archive = CombineArchive::open(&archive_path).unwrap();
+        assert_eq!(archive.master().unwrap().as_string().unwrap(), "<v2/>");
+        assert_eq!(
+            archive.entry("./data.tsv").unwrap().data,
+            "a\tb\n".repeat(10_000).into_bytes()
+        );
+
+        // No temporary files are left behind
+        assert_eq!(fs::read_dir(temp_dir.path()).unwrap().count(), 1);
+    }
+
+    #[test]
+    fn test_save_over_source() {
+        let temp_dir = create_test_dir();
+        let archive_path = temp_dir.path().join("source.omex");
+
+        let mut archive = CombineArchive::new();
+        archive
+            .add_entry("./model.xml", KnownFormats::SBML, true, b"<v1/>".as_slice())
+            .unwrap();
+        archive.save(&archive_path).unwrap();
+
+        // The archive keeps reading from the file it saves over, twice in a row
+        let mut archive = CombineArchive::open(&archive_path).unwrap();
+        archive
+            .add_entry("./data.csv", "text/csv", false, b"a,b".as_slice())
+            .unwrap();
+        archive.save(&archive_path).unwrap();
+        archive
+            .add_entry("./model.xml", KnownFormats::SBML, true, b"<v2/>".as_slice())
+            .unwrap();
+        archive.save(&archive_path).unwrap();
+        assert_eq!(archive.entry("./data.csv").unwrap().data, b"a,b");
+
+        let mut reopened = CombineArchive::open(&archive_path).unwrap();
+        assert_eq!(reopened.master().unwrap().as_string().unwrap(), "<v2/>");
+        assert_eq!(reopened.entry("./data.csv").unwrap().data, b"a,b");
+    }
+
+    #[test]
+    fn test_concurrent_saves_to_same_path() {
+        let temp_dir = create_test_dir();
+        let archive_path = temp_dir.path().join("shared.omex");
+
+        // Every save writes a temporary file of its own before moving it into place
+        std::thread::scope(|scope| {
+            for _ in 0..4 {
+                scope.spawn(|| {
+                    let mut archive = CombineArchive::new();
+                    archive
+                        .add_entry("./model.xml", KnownFormats::SBML, true, b"<v/>".as_slice())
+                        .unwrap();
+                    for _ in 0..4 {
+                        archive.save(&archive_path).unwrap();
+                    }
+                    assert_eq!(archive.entry("./model.xml").unwrap().data, b"<v/>");
+                });
+            }
+        });
+
+        let entries = std::fs::read_dir(temp_dir.path()).unwrap().count();
+        assert_eq!(entries, 1);
+        let mut reopened = CombineArchive::open(&archive_path).unwrap();
+        assert_eq!(reopened.master().unwrap().as_string().unwrap(), "<v/>");
+    }
+
+    #[test]
+    fn test_archive_is_send_and_sync() {
+        fn assert_send_sync<T: Send + Sync>() {}
+        assert_send_sync::<CombineArchive>();
+    }
+
+    #[test]
+    fn test_entry_reader() {
+        let temp_dir = create_test_dir();
+        let archive_path = temp_dir.path().join("streaming.omex");
+        let large = vec![b'x'; 1 << 20];
+
+        let mut archive = CombineArchive::new();
+        archive
+            .add_entry("./large.bin", "application/octet-stream", false, &large[..])
+            .unwrap();
+
+        // Pending entries are streamed from their staged buffer
+        let mut data = Vec::new();
+        archive
+            .entry_reader("./large.bin")
+            .unwrap()
+            .read_to_end(&mut data)
+            .unwrap();
+        assert_eq!(data, large);
+
+        archive.save(&archive_path).unwrap();
+
+        // Saved entries are decompressed while reading
+        let mut archive = CombineArchive::open(&archive_path).unwrap();
+        let mut reader = archive.entry_reader("./large.bin").unwrap();
+        let mut chunk = [0u8; 4096];
+        let mut total = 0;
+        loop {
+            let n = reader.read(&mut chunk).unwrap();
+            if n == 0 {
+                break;
+            }
+            assert!(chunk[..n].iter().all(|&b| b == b'x'));
+            total += n;
+        }
+        drop(reader);
+        assert_eq!(total, large.len());
+
+        assert!(matches!(
+            archive.entry_reader("./missing.bin"),
+            Err(CombineArchiveError::FileNotFound(_))
+        ));
+    }
+
+    #[test]
+    fn test_per_entry_compression() {
+        let temp_dir = create_test_dir();
+        let archive_path = temp_dir.path().join("compression.omex");
+        let payload = vec![b'a'; 64 * 1024];
+
+        let mut archive = CombineArchive::new();
+        archive
+            .add_entry_with_options(
+                "./stored.bin",
+                "application/octet-stream",
+                false,
+                &payload[..],
+                EntryOptions::new().compression(Compression::Stored),
+            )
+            .unwrap();
+        archive
+            .add_entry_with_options(
+                "./zstd.bin",
+                "application/octet-stream",
+                false,
+                &payload[..],
+                EntryOptions::new().compression(Compression::Zstd(Some(3))),
+            )
+            .unwrap();
+        archive
+            .add_entry_with_options(
+                "./fast.bin",
+                "application/octet-stream",
+                false,
+                &payload[..],
+                EntryOptions::new().compression(Compression::Deflated(Some(1))),
+            )
+            .unwrap();
+        archive
+            .add_entry(
+                "./default.bin",
+                "application/octet-stream",
+                false,
+                &payload[..],
+            )
+            .unwrap();
+        archive.save(&archive_path).unwrap();
+
+        let mut zip = ZipArchive::new(File::open(&archive_path).unwrap()).unwrap();
+        let methods = [
+            ("stored.bin", CompressionMethod::Stored),
+            ("zstd.bin", CompressionMethod::Zstd),
+            ("fast.bin", CompressionMethod::Deflated),
+            ("default.bin", CompressionMethod::Deflated),
+            ("manifest.xml", CompressionMethod::Deflated),
+        ];
+        for (name, method) in methods {
+            assert_eq!(zip.by_name(name).unwrap().compression(), method, "{name}");
+        }
+
+        let mut archive = CombineArchive::open(&archive_path).unwrap();
+        for location in ["./stored.bin", "./zstd.bin", "./fast.bin", "./default.bin"] {
+            assert_eq!(archive.entry(location).unwrap().data, payload);
+        }
+    }
+
+    #[test]
+    fn test_load_sbml_entries() {
+        let temp_dir = create_test_dir();
+        let archive_path = temp_dir.path().join("models.omex");
+
+        let mut archive = CombineArchive::new();
+        archive
+            .add_file(
+                "tests/data/example.xml",
+                "./example.xml",
+                KnownFormats::SBML,
+                true,
+            )
+            .unwrap();
+        archive
+            .add_file(
+                "tests/data/odes_example_test.xml",
+                "./odes.xml",
+                "http://identifiers.org/combine.specifications/sbml.level-3.version-2",
+                false,
+            )
+            .unwrap();
+        archive
+            .add_entry("./data.csv", KnownFormats::CSV, false, &b"a,b"[..])
+            .unwrap();
+        archive.save(&archive_path).unwrap();
+
+        let mut archive = CombineArchive::open(&archive_path).unwrap();
+        archive
+            .add_entry(
+                "./pending.xml",
+                KnownFormats::SBML,
+                false,
+                include_bytes!("../../tests/data/example.xml").as_slice(),
+            )
+            .unwrap();
+
+        for parallel in [false, true] {
+            let loaded = archive.load_sbml_entries(parallel, true);
+            let locations: Vec<&str> = loaded
+                .iter()
+                .map(|(content, _)| content.location.as_str())
+                .collect();
+            assert_eq!(locations, ["./example.xml", "./odes.xml", "./pending.xml"]);
+
+            let (_, example) = &loaded[0];
+            let example = example.as_ref().unwrap();
+            assert_eq!(example.model().unwrap().id(), "example");
+            let (_, odes) = &loaded[1];
+            assert_eq!(odes.as_ref().unwrap().model().unwrap().name(), "Test");
+            let (_, pending) = &loaded[2];
+            assert_eq!(pending.as_ref().unwrap().model().unwrap().id(), "example");
+        }
+
+        archive.remove_entry("./odes.xml").unwrap();
+        assert_eq!(archive.load_sbml_entries(true, false).len(), 2);
+    }
+
+    #[test]
+    fn test_parallel_compression_preserves_order() {
+        let bytes = {
+            let mut archive = CombineArchive::new();
+            for i in 0..32 {
+                let data = format!("entry {i} ").repeat(1000 + i * 10);
+                archive
+                    .add_entry(
+                        format!("./data/{i}.txt"),
+                        "text/plain",
+                        false,
+                        data.as_bytes(),
+                    )
+                    .unwrap();
+            }
+            archive.to_bytes().unwrap()
+        };
+
+        // Pending entries are written in name order, followed by the manifest
+        let mut zip = ZipArchive::new(Cursor::new(bytes)).unwrap();
+        let names: Vec<String> = (0..zip.len())
+            .map(|i| zip.by_index_raw(i).unwrap().name().to_string())
+            .filter(|name| name.starts_with("data/"))
+            .collect();
+        let mut sorted = names.clone();
+        sorted.sort();
+        assert_eq!(names.len(), 32);
+        assert_eq!(names, sorted);
+
+        let mut content = String::new();
+        zip.by_name("data/7.txt")
+            .unwrap()
+            .read_to_string(&mut content)
+            .unwrap();
+        assert_eq!(content, "entry 7 ".repeat(1070));
+    }
+
+    #[test]
+    fn test_indexed_lookup_after_mutations() {
+        let temp_dir = create_test_dir();
+        let archive_path = temp_dir.path().join("indexed.omex");
+
+        let mut archive = CombineArchive::new();
+        for i in 0..200 {
+            archive
+                .add_entry(
+                    format!("./data/{i}.tsv"),
+                    "text/tab-separated-values",
+                    false,
+                    format!("value\t{i}").as_bytes(),
+                )
+                .unwrap();
+        }
+        archive.save(&archive_path).unwrap();
+
+        let mut archive = CombineArchive::open(&archive_path).unwrap();
+        for i in (0..200).rev() {
+            let entry = archive.entry(&format!("./data/{i}.tsv")).unwrap();
+            assert_eq!(entry.as_string().unwrap(), format!("value\t{i}"));
+        }
+
+        // Removing shifts the positions of all following entries
+        archive.remove_entry("./data/0.tsv").unwrap();
+        assert!(!archive.has_entry("./data/0.tsv"));
+        assert!(archive.has_entry("./data/199.tsv"));
+        assert_eq!(
+            archive
+                .entry_by_format("text/tab-separated-values")
+                .unwrap()
+                .content
+                .location,
+            "./data/1.tsv"
+        );
+
+        // Changes made directly to the public manifest are picked up as well
+        archive
+            .manifest
+            .content
+            .push(Content::new("./extra.txt", "text/plain", false));
+        assert!(archive.has_entry("./extra.txt"));
+        archive.manifest.content.swap(2, 3);
+        assert!(archive.has_entry("./data/2.tsv"));
+        assert!(archive.has_entry("./data/3.tsv"));
+    }
+
     #[test]
     fn test_mandatory_entries_present_in_new_archive() {
         let archive = CombineArchive::new();
@@ -1425,7 +2363,9 @@ mod tests {
             manifest: OmexManifest::new(), // Start with truly empty manifest
             path: None,
             original_zip: None,
+            content_index: Mutex::new(ContentIndex::default()),
             pending_entries: HashMap::new(),
+            entry_compression: HashMap::new(),
             removed_entries: std::collections::HashSet::new(),
             needs_rebuild: false,
         };
@@ -1609,4 +2549,29 @@ mod tests {
             Err(CombineArchiveError::ManifestFileMissing)
         ));
     }
+
+    #[test]
+    fn test_memory_usage() {
+        let temp_dir = create_test_dir();
+        let archive_path = temp_dir.path().join("memory.omex");
+
+        let mut archive = CombineArchive::new();
+        let empty = archive.memory_usage();
+        assert_eq!(empty.native_bytes, 0);
+        assert_eq!(empty.wrapper_bytes, 0);
+
+        let data = vec![b'x'; 64 * 1024];
+        archive
+            .add_entry("./data.csv", KnownFormats::CSV, false, data.as_slice())
+            .unwrap();
+        let pending = archive.memory_usage();
+        assert!(pending.archive_bytes >= empty.archive_bytes + data.len());
+
+        // Saved entries are read from disk, only the central directory stays in memory
+        archive.save(&archive_path).unwrap();
+        let saved = archive.memory_usage();
+        assert!(saved.archive_bytes < pending.archive_bytes);
+        assert!(saved.archive_bytes > ZIP_READ_BUFFER_BYTES);
+        assert_eq!(saved.total_bytes(), saved.archive_bytes);
+    }
 }
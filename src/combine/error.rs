@@ -1,5 +1,8 @@
 /// Errors that can occur when working with COMBINE Archives.
+///
+/// New variants may be added in minor releases, so matches need a wildcard arm.
 #[derive(Debug, thiserror::Error)]
+#[non_exhaustive]
 pub enum CombineArchiveError {
     /// I/O error (file reading, writing, etc.)
     #[error("IO error: {0}")]
@@ -13,6 +16,10 @@ pub enum CombineArchiveError {
     #[error("Manifest error: {0}")]
     Manifest(#[from] quick_xml::DeError),
 
+    /// An SBML entry could not be read
+    #[error("SBML error: {0}")]
+    Sbml(#[from] crate::errors::LibSBMLError),
+
     /// Requested file not found in archive
     #[error("File not found: {0}")]
     FileNotFound(String),
@@ -37,6 +44,15 @@ pub enum CombineArchiveError {
     #[error("Cannot remove mandatory entry: {0}")]
     CannotRemoveMandatoryEntry(String),
 
+    /// The archive was saved, but the saved file could not be opened again
+    #[error("Archive saved to {path} could not be reopened: {source}")]
+    Reopen {
+        /// Path the archive was saved to
+        path: std::path::PathBuf,
+        /// Error that occurred while reopening the file
+        source: Box<CombineArchiveError>,
+    },
+
     /// The manifest.xml file is missing from the archive
     #[error("Manifest file (manifest.xml) is missing from the archive")]
     ManifestFileMissing,
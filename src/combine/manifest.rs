@@ -190,6 +190,27 @@ pub enum KnownFormats {
     CSV,
 }
 
+impl KnownFormats {
+    /// Checks whether a manifest format identifier denotes this format.
+    ///
+    /// Besides the identifiers accepted by [`FromStr`], this also accepts refinements
+    /// of the format URI such as
+    /// `http://identifiers.org/combine.specifications/sbml.level-3.version-2`.
+    ///
+    /// # Arguments
+    ///
+    /// * `format` - The format identifier of a manifest entry
+    pub fn matches(&self, format: &str) -> bool {
+        if format.parse::<KnownFormats>().as_ref() == Ok(self) {
+            return true;
+        }
+
+        format
+            .strip_prefix(&self.to_string())
+            .is_some_and(|refinement| refinement.starts_with('.'))
+    }
+}
+
 impl FromStr for KnownFormats {
     type Err = String;
 
@@ -400,6 +421,17 @@ mod tests {
         );
     }
 
+    #[test]
+    fn test_known_formats_matches() {
+        assert!(KnownFormats::SBML.matches("sbml"));
+        assert!(KnownFormats::SBML.matches("http://identifiers.org/combine.specifications/sbml"));
+        assert!(KnownFormats::SBML
+            .matches("http://identifiers.org/combine.specifications/sbml.level-3.version-2"));
+        assert!(!KnownFormats::SBML.matches("http://identifiers.org/combine.specifications/sbgn"));
+        assert!(!KnownFormats::SBML.matches("http://identifiers.org/combine.specifications/sbmlx"));
+        assert!(!KnownFormats::SEDML.matches("sbml"));
+    }
+
     #[test]
     fn test_add_content_from_known_formats() {
         let mut manifest = OmexManifest::new();
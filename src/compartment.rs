@@ -12,7 +12,9 @@ use std::{cell::RefCell, pin::Pin, rc::Rc};
 use cxx::let_cxx_string;
 
 use crate::{
-    clone, get_unit_definition, inner, into_id,
+    clone, get_unit_definition,
+    incremental::ChangeTracker,
+    index_key, inner, into_id,
     model::Model,
     optional_property, pin_ptr, required_property, sbase, sbmlcxx, sbo_term,
     traits::{fromptr::FromPtr, intoid::IntoId, sbase::SBase},
@@ -27,6 +29,9 @@ use crate::{
 /// size, volume, spatial dimensions, units, and more.
 pub struct Compartment<'a> {
     inner: RefCell<Pin<&'a mut sbmlcxx::Compartment>>,
+    annotation_cache: AnnotationCache,
+    /// Marks the section of the document that contains this element
+    changes: ChangeTracker<'a>,
 }
 
 // Set the inner trait for the Compartment struct
@@ -41,6 +46,9 @@ upcast_annotation!(Compartment<'a>, sbmlcxx::Compartment, sbmlcxx::SBase);
 // Set the into_id trait for the Compartment struct
 into_id!(&Rc<Compartment<'_>>, id);
 
+// Index Compartment collections by id
+index_key!(Compartment<'_>, getId);
+
 // Implement the Clone trait for the Compartment struct
 clone!(Compartment<'a>, sbmlcxx::Compartment);
 
@@ -63,6 +71,8 @@ impl<'a> Compartment<'a> {
 
         Self {
             inner: RefCell::new(compartment),
+            annotation_cache: AnnotationCache::default(),
+            changes: model.changes(),
         }
     }
 
@@ -70,7 +80,14 @@ impl<'a> Compartment<'a> {
     get_unit_definition!(unit);
 
     // Getter and setter methods for the id property
-    required_property!(Compartment<'a>, id, String, getId, setId);
+    required_property!(
+        Compartment<'a>,
+        id,
+        String,
+        getId,
+        setId,
+        after_set = key_changed
+    );
 
     // Getter and setter methods for the name property
     optional_property!(Compartment<'a>, name, String, getName, setName, isSetName);
@@ -138,6 +155,8 @@ impl FromPtr<sbmlcxx::Compartment> for Compartment<'_> {
         let compartment = pin_ptr!(ptr, sbmlcxx::Compartment);
         Self {
             inner: RefCell::new(compartment),
+            annotation_cache: AnnotationCache::default(),
+            changes: ChangeTracker::default(),
         }
     }
 }
@@ -0,0 +1,967 @@
+//! Compilation of SBML math into flat register programs.
+//!
+//! Evaluating a rate law or rule repeatedly, e.g. in a simulation or a parameter scan,
+//! should neither re-parse the infix formula nor walk the native math tree for every
+//! state. [`CompiledMath`] lowers an [`ASTNode`] tree once into a short list of
+//! register instructions, with all references to model components resolved to indices
+//! of a [`SymbolTable`] and constant sub-expressions folded.
+//!
+//! Programs can be evaluated for a single state with [`CompiledMath::eval`], or for
+//! many states at once with [`CompiledMath::eval_columns`]. The latter processes the
+//! states in blocks, running every instruction as a tight loop over contiguous slices
+//! that the compiler can auto-vectorize.
+//!
+//! # Example
+//!
+//! ```no_run
+//! use sbml::prelude::*;
+//!
+//! let doc = SBMLDocument::default();
+//! let model = doc.create_model("example");
+//! model.create_species("S1");
+//! model.create_parameter("k1");
+//! model.create_reaction("r1").create_kinetic_law("k1 * S1");
+//!
+//! let symbols = SymbolTable::from_model(&model);
+//! let rate_laws = CompiledMath::rate_laws(&model, &symbols).unwrap();
+//!
+//! // One column per symbol, one row per state
+//! let s1 = [1.0, 2.0, 3.0];
+//! let k1 = [0.5, 0.5, 0.5];
+//! let mut rates = [0.0; 3];
+//! rate_laws[0].eval_columns(&[&s1, &k1], &mut rates);
+//! assert_eq!(rates, [0.5, 1.0, 1.5]);
+//! ```
+
+use std::collections::HashMap;
+
+use crate::{
+    kineticlaw::KineticLaw,
+    math::{ASTNode, ASTNodeType},
+    model::Model,
+    rule::Rule,
+};
+
+/// Number of states processed per instruction in [`CompiledMath::eval_columns`]
+const LANES: usize = 256;
+
+/// Errors that can occur when compiling SBML math.
+#[derive(Debug, thiserror::Error)]
+pub enum MathError {
+    /// A name in the math refers to neither a symbol nor a local parameter
+    #[error("Unknown symbol: {0}")]
+    UnknownSymbol(String),
+
+    /// The math contains a construct the compiler cannot evaluate
+    #[error("Unsupported math construct: {0}")]
+    Unsupported(String),
+
+    /// A node has a number of children that is invalid for its type
+    #[error("Invalid number of arguments for {node:?}: {found}")]
+    InvalidArguments {
+        /// Type of the offending node
+        node: ASTNodeType,
+        /// Number of children found
+        found: usize,
+    },
+
+    /// An element that was expected to carry math has none
+    #[error("No math set for {0}")]
+    MissingMath(String),
+}
+
+/// Maps identifiers used in math to the indices of the values they are evaluated with.
+///
+/// The simulation time is resolved under the reserved name [`SymbolTable::TIME`],
+/// which cannot collide with an SBML identifier.
+#[derive(Debug, Clone, Default, PartialEq)]
+pub struct SymbolTable {
+    names: Vec<String>,
+    index: HashMap<String, usize>,
+}
+
+impl SymbolTable {
+    /// Name under which the simulation time is looked up
+    pub const TIME: &'static str = "<time>";
+
+    /// Creates an empty symbol table.
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Creates a symbol table with all species, compartments and parameters of a model,
+    /// in this order.
+    pub fn from_model(model: &Model<'_>) -> Self {
+        let mut symbols = Self::new();
+        for species in model.list_of_species() {
+            symbols.insert(&species.id());
+        }
+        for compartment in model.list_of_compartments() {
+            symbols.insert(&compartment.id());
+        }
+        for parameter in model.list_of_parameters() {
+            symbols.insert(&parameter.id());
+        }
+        symbols
+    }
+
+    /// Adds a symbol and returns its index. Symbols that already exist keep their index.
+    pub fn insert(&mut self, name: &str) -> usize {
+        if let Some(&index) = self.index.get(name) {
+            return index;
+        }
+
+        let index = self.names.len();
+        self.names.push(name.to_string());
+        self.index.insert(name.to_string(), index);
+        index
+    }
+
+    /// Returns the index of a symbol.
+    pub fn get(&self, name: &str) -> Option<usize> {
+        self.index.get(name).copied()
+    }
+
+    /// Returns the names of all symbols, ordered by index.
+    pub fn names(&self) -> &[String] {
+        &self.names
+    }
+
+    /// Returns the number of symbols.
+    pub fn len(&self) -> usize {
+        self.names.len()
+    }
+
+    /// Returns whether the table contains no symbols.
+    pub fn is_empty(&self) -> bool {
+        self.names.is_empty()
+    }
+}
+
+/// A math expression compiled into a flat register program.
+///
+/// Booleans are represented as `1.0` and `0.0`, and any non-zero value is treated as
+/// true. All branches of a piecewise expression are evaluated, and the result of the
+/// first branch whose condition holds is selected.
+#[derive(Debug, Clone, PartialEq)]
+pub struct CompiledMath {
+    program: Vec<Instruction>,
+    n_registers: usize,
+    n_symbols: usize,
+}
+
+impl CompiledMath {
+    /// Compiles a math tree, resolving names through the given symbol table.
+    ///
+    /// # Errors
+    /// Returns an error if the math references unknown symbols or contains constructs
+    /// that cannot be evaluated, such as calls of user-defined functions or `delay`.
+    pub fn compile(math: &ASTNode<'_>, symbols: &SymbolTable) -> Result<Self, MathError> {
+        Self::compile_with_locals(math, symbols, &HashMap::new())
+    }
+
+    /// Compiles the math of a kinetic law.
+    ///
+    /// Local parameters of the kinetic law shadow symbols of the same name and are
+    /// folded into the program as constants. Local parameters without a value
+    /// evaluate to NaN.
+    pub fn from_kinetic_law(
+        kinetic_law: &KineticLaw<'_>,
+        symbols: &SymbolTable,
+    ) -> Result<Self, MathError> {
+        let locals = kinetic_law
+            .local_parameters()
+            .iter()
+            .map(|parameter| (parameter.id(), parameter.value().unwrap_or(f64::NAN)))
+            .collect();
+
+        kinetic_law.with_math(|math| {
+            let math = math.ok_or_else(|| MathError::MissingMath("kinetic law".to_string()))?;
+            Self::compile_with_locals(&math, symbols, &locals)
+        })
+    }
+
+    /// Compiles the math of a rule.
+    pub fn from_rule(rule: &Rule<'_>, symbols: &SymbolTable) -> Result<Self, MathError> {
+        rule.with_math(|math| {
+            let math = math.ok_or_else(|| MathError::MissingMath(rule.variable()))?;
+            Self::compile(&math, symbols)
+        })
+    }
+
+    /// Compiles the kinetic laws of all reactions of a model, in the order of
+    /// [`Model::list_of_reactions`].
+    ///
+    /// # Errors
+    /// Returns [`MathError::MissingMath`] if a reaction has no kinetic law, or any error
+    /// encountered while compiling one of them.
+    pub fn rate_laws(model: &Model<'_>, symbols: &SymbolTable) -> Result<Vec<Self>, MathError> {
+        model
+            .list_of_reactions()
+            .iter()
+            .map(|reaction| {
+                let kinetic_law = reaction
+                    .kinetic_law()
+                    .ok_or_else(|| MathError::MissingMath(reaction.id()))?;
+                Self::from_kinetic_law(&kinetic_law, symbols)
+            })
+            .collect()
+    }
+
+    /// Returns the number of instructions of the program.
+    pub fn len(&self) -> usize {
+        self.program.len()
+    }
+
+    /// Returns whether the program is empty, which is never the case for compiled math.
+    pub fn is_empty(&self) -> bool {
+        self.program.is_empty()
+    }
+
+    /// Returns the number of registers the program needs.
+    pub fn num_registers(&self) -> usize {
+        self.n_registers
+    }
+
+    /// Returns the constant value of the program, if it does not depend on any symbol.
+    pub fn as_constant(&self) -> Option<f64> {
+        match self.program.as_slice() {
+            [Instruction::Const { value, .. }] => Some(*value),
+            _ => None,
+        }
+    }
+
+    /// Evaluates the program for a single state.
+    ///
+    /// # Arguments
+    /// * `state` - The value of every symbol, indexed as in the symbol table
+    ///
+    /// # Panics
+    /// Panics if `state` is shorter than the symbol table the program was compiled with.
+    pub fn eval(&self, state: &[f64]) -> f64 {
+        self.check_symbols(state.len());
+
+        let mut registers = vec![0.0; self.n_registers];
+        for instruction in &self.program {
+            match *instruction {
+                Instruction::Const { dst, value } => registers[dst] = value,
+                Instruction::Load { dst, symbol } => registers[dst] = state[symbol],
+                Instruction::Unary { op, dst } => registers[dst] = op.apply(registers[dst]),
+                Instruction::Binary { op, dst, rhs } => {
+                    let rhs = match rhs {
+                        Operand::Register => registers[dst + 1],
+                        Operand::Symbol(symbol) => state[symbol],
+                        Operand::Const(value) => value,
+                    };
+                    registers[dst] = op.apply(registers[dst], rhs);
+                }
+                Instruction::Select { dst } => {
+                    if registers[dst + 2] != 0.0 {
+                        registers[dst] = registers[dst + 1];
+                    }
+                }
+            }
+        }
+
+        registers[0]
+    }
+
+    /// Evaluates the program for many states at once.
+    ///
+    /// # Arguments
+    /// * `columns` - One column per symbol, indexed as in the symbol table, holding the
+    ///   value of that symbol in every state
+    /// * `out` - Receives the result for every state
+    ///
+    /// # Panics
+    /// Panics if there are fewer columns than symbols, or if a column referenced by the
+    /// program is not as long as `out`.
+    pub fn eval_columns(&self, columns: &[&[f64]], out: &mut [f64]) {
+        self.check_symbols(columns.len());
+
+        let n_states = out.len();
+        for instruction in &self.program {
+            let symbol = match *instruction {
+                Instruction::Load { symbol, .. } => symbol,
+                Instruction::Binary {
+                    rhs: Operand::Symbol(symbol),
+                    ..
+                } => symbol,
+                _ => continue,
+            };
+            assert_eq!(
+                columns[symbol].len(),
+                n_states,
+                "column {symbol} has {} values, expected {n_states}",
+                columns[symbol].len(),
+            );
+        }
+
+        let mut registers = vec![0.0; self.n_registers * LANES];
+        let mut start = 0;
+        while start < n_states {
+            let len = LANES.min(n_states - start);
+            self.eval_block(columns, start, len, &mut registers);
+            out[start..start + len].copy_from_slice(&registers[..len]);
+            start += len;
+        }
+    }
+
+    /// Runs the program on the states `start..start + len`, leaving the results in the
+    /// first register.
+    fn eval_block(&self, columns: &[&[f64]], start: usize, len: usize, registers: &mut [f64]) {
+        let column = |symbol: usize| &columns[symbol][start..start + len];
+
+        for instruction in &self.program {
+            match *instruction {
+                Instruction::Const { dst, value } => register(registers, dst, len).fill(value),
+                Instruction::Load { dst, symbol } => {
+                    register(registers, dst, len).copy_from_slice(column(symbol))
+                }
+                Instruction::Unary { op, dst } => unary_kernel(op, register(registers, dst, len)),
+                Instruction::Binary { op, dst, rhs } => {
+                    let (lhs, above) = registers.split_at_mut((dst + 1) * LANES);
+                    let lhs = &mut lhs[dst * LANES..dst * LANES + len];
+                    match rhs {
+                        Operand::Register => binary_kernel(op, lhs, &above[..len]),
+                        Operand::Symbol(symbol) => binary_kernel(op, lhs, column(symbol)),
+                        Operand::Const(value) => binary_const_kernel(op, lhs, value),
+                    }
+                }
+                Instruction::Select { dst } => {
+                    let (result, above) = registers.split_at_mut((dst + 1) * LANES);
+                    let result = &mut result[dst * LANES..dst * LANES + len];
+                    let then = &above[..len];
+                    let condition = &above[LANES..LANES + len];
+                    for ((value, &then), &condition) in result.iter_mut().zip(then).zip(condition) {
+                        if condition != 0.0 {
+                            *value = then;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /// Ensures that values for all symbols referenced by the program are provided.
+    fn check_symbols(&self, provided: usize) {
+        assert!(
+            provided >= self.n_symbols,
+            "program references {} symbols, but only {provided} values were provided",
+            self.n_symbols
+        );
+    }
+
+    /// Compiles a math tree with additional constant names shadowing the symbol table.
+    fn compile_with_locals(
+        math: &ASTNode<'_>,
+        symbols: &SymbolTable,
+        locals: &HashMap<String, f64>,
+    ) -> Result<Self, MathError> {
+        let expr = Lowering { symbols, locals }.lower(math)?;
+
+        let mut codegen = Codegen::default();
+        codegen.emit(&expr, 0);
+
+        Ok(Self {
+            program: codegen.program,
+            n_registers: codegen.n_registers,
+            n_symbols: codegen.n_symbols,
+        })
+    }
+}
+
+/// Returns the first `len` lanes of a register.
+fn register(registers: &mut [f64], index: usize, len: usize) -> &mut [f64] {
+    &mut registers[index * LANES..index * LANES + len]
+}
+
+/// Applies a unary operation to a register in place.
+fn unary_kernel(op: UnaryOp, values: &mut [f64]) {
+    match op {
+        UnaryOp::Neg => values.iter_mut().for_each(|value| *value = -*value),
+        UnaryOp::Abs => values.iter_mut().for_each(|value| *value = value.abs()),
+        op => values
+            .iter_mut()
+            .for_each(|value| *value = op.apply(*value)),
+    }
+}
+
+/// Combines a register with a slice of values in place.
+///
+/// The arithmetic operations are dispatched outside the loop, so that each of them
+/// compiles to its own vectorizable loop.
+fn binary_kernel(op: BinaryOp, lhs: &mut [f64], rhs: &[f64]) {
+    let apply = |lhs: &mut [f64], f: fn(f64, f64) -> f64| {
+        lhs.iter_mut().zip(rhs).for_each(|(a, &b)| *a = f(*a, b));
+    };
+
+    match op {
+        BinaryOp::Add => apply(lhs, |a, b| a + b),
+        BinaryOp::Sub => apply(lhs, |a, b| a - b),
+        BinaryOp::Mul => apply(lhs, |a, b| a * b),
+        BinaryOp::Div => apply(lhs, |a, b| a / b),
+        op => lhs
+            .iter_mut()
+            .zip(rhs)
+            .for_each(|(a, &b)| *a = op.apply(*a, b)),
+    }
+}
+
+/// Combines a register with a constant in place.
+fn binary_const_kernel(op: BinaryOp, lhs: &mut [f64], rhs: f64) {
+    match op {
+        BinaryOp::Add => lhs.iter_mut().for_each(|a| *a += rhs),
+        BinaryOp::Sub => lhs.iter_mut().for_each(|a| *a -= rhs),
+        BinaryOp::Mul => lhs.iter_mut().for_each(|a| *a *= rhs),
+        BinaryOp::Div => lhs.iter_mut().for_each(|a| *a /= rhs),
+        op => lhs.iter_mut().for_each(|a| *a = op.apply(*a, rhs)),
+    }
+}
+
+/// A single instruction of a compiled program.
+///
+/// Instructions always write to their lowest register `dst`. Further operands are
+/// read from the registers directly above it, so that a program evaluates like a
+/// stack machine whose depth is the register index.
+#[derive(Debug, Clone, Copy, PartialEq)]
+enum Instruction {
+    /// `dst = value`
+    Const { dst: usize, value: f64 },
+    /// `dst = symbols[symbol]`
+    Load { dst: usize, symbol: usize },
+    /// `dst = op(dst)`
+    Unary { op: UnaryOp, dst: usize },
+    /// `dst = op(dst, rhs)`
+    Binary {
+        op: BinaryOp,
+        dst: usize,
+        rhs: Operand,
+    },
+    /// `dst = if dst + 2 != 0 { dst + 1 } else { dst }`
+    Select { dst: usize },
+}
+
+/// The right-hand operand of a binary instruction.
+#[derive(Debug, Clone, Copy, PartialEq)]
+enum Operand {
+    /// The register directly above the destination
+    Register,
+    /// A symbol, read directly from the state
+    Symbol(usize),
+    /// A constant
+    Const(f64),
+}
+
+/// Operations taking a single argument.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+enum UnaryOp {
+    Neg,
+    Not,
+    Abs,
+    Exp,
+    Ln,
+    Log10,
+    Sqrt,
+    Floor,
+    Ceil,
+    Factorial,
+    Sin,
+    Cos,
+    Tan,
+    ArcSin,
+    ArcCos,
+    ArcTan,
+    Sinh,
+    Cosh,
+    Tanh,
+    ArcSinh,
+    ArcCosh,
+    ArcTanh,
+}
+
+impl UnaryOp {
+    fn apply(self, x: f64) -> f64 {
+        match self {
+            UnaryOp::Neg => -x,
+            UnaryOp::Not => boolean(x == 0.0),
+            UnaryOp::Abs => x.abs(),
+            UnaryOp::Exp => x.exp(),
+            UnaryOp::Ln => x.ln(),
+            UnaryOp::Log10 => x.log10(),
+            UnaryOp::Sqrt => x.sqrt(),
+            UnaryOp::Floor => x.floor(),
+            UnaryOp::Ceil => x.ceil(),
+            UnaryOp::Factorial => factorial(x),
+            UnaryOp::Sin => x.sin(),
+            UnaryOp::Cos => x.cos(),
+            UnaryOp::Tan => x.tan(),
+            UnaryOp::ArcSin => x.asin(),
+            UnaryOp::ArcCos => x.acos(),
+            UnaryOp::ArcTan => x.atan(),
+            UnaryOp::Sinh => x.sinh(),
+            UnaryOp::Cosh => x.cosh(),
+            UnaryOp::Tanh => x.tanh(),
+            UnaryOp::ArcSinh => x.asinh(),
+            UnaryOp::ArcCosh => x.acosh(),
+            UnaryOp::ArcTanh => x.atanh(),
+        }
+    }
+}
+
+/// Operations taking two arguments.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+enum BinaryOp {
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Pow,
+    /// Logarithm of the second argument to the base given by the first
+    Log,
+    /// Root of the second argument of the degree given by the first
+    Root,
+    Max,
+    Min,
+    Quotient,
+    Rem,
+    And,
+    Or,
+    Xor,
+    Implies,
+    Eq,
+    Neq,
+    Lt,
+    Leq,
+    Gt,
+    Geq,
+}
+
+impl BinaryOp {
+    fn apply(self, a: f64, b: f64) -> f64 {
+        match self {
+            BinaryOp::Add => a + b,
+            BinaryOp::Sub => a - b,
+            BinaryOp::Mul => a * b,
+            BinaryOp::Div => a / b,
+            BinaryOp::Pow => a.powf(b),
+            BinaryOp::Log => b.ln() / a.ln(),
+            BinaryOp::Root => b.powf(a.recip()),
+            BinaryOp::Max => a.max(b),
+            BinaryOp::Min => a.min(b),
+            BinaryOp::Quotient => (a / b).trunc(),
+            BinaryOp::Rem => a % b,
+            BinaryOp::And => boolean(a != 0.0 && b != 0.0),
+            BinaryOp::Or => boolean(a != 0.0 || b != 0.0),
+            BinaryOp::Xor => boolean((a != 0.0) != (b != 0.0)),
+            BinaryOp::Implies => boolean(a == 0.0 || b != 0.0),
+            BinaryOp::Eq => boolean(a == b),
+            BinaryOp::Neq => boolean(a != b),
+            BinaryOp::Lt => boolean(a < b),
+            BinaryOp::Leq => boolean(a <= b),
+            BinaryOp::Gt => boolean(a > b),
+            BinaryOp::Geq => boolean(a >= b),
+        }
+    }
+}
+
+/// Encodes a boolean as a number.
+fn boolean(value: bool) -> f64 {
+    if value {
+        1.0
+    } else {
+        0.0
+    }
+}
+
+/// Computes the factorial of a non-negative integer, yielding NaN for other values.
+fn factorial(x: f64) -> f64 {
+    if x < 0.0 || x.fract() != 0.0 {
+        return f64::NAN;
+    }
+    (1..=x as u64).fold(1.0, |product, n| product * n as f64)
+}
+
+/// Intermediate expression tree with names resolved and constants folded.
+#[derive(Debug, Clone, PartialEq)]
+enum Expr {
+    Const(f64),
+    Symbol(usize),
+    Unary(UnaryOp, Box<Expr>),
+    Binary(BinaryOp, Box<Expr>, Box<Expr>),
+    Select {
+        condition: Box<Expr>,
+        then: Box<Expr>,
+        otherwise: Box<Expr>,
+    },
+}
+
+impl Expr {
+    fn unary(op: UnaryOp, arg: Expr) -> Expr {
+        match arg {
+            Expr::Const(value) => Expr::Const(op.apply(value)),
+            arg => Expr::Unary(op, Box::new(arg)),
+        }
+    }
+
+    fn binary(op: BinaryOp, lhs: Expr, rhs: Expr) -> Expr {
+        match (lhs, rhs) {
+            (Expr::Const(a), Expr::Const(b)) => Expr::Const(op.apply(a, b)),
+            (lhs, rhs) => Expr::Binary(op, Box::new(lhs), Box::new(rhs)),
+        }
+    }
+
+    fn select(condition: Expr, then: Expr, otherwise: Expr) -> Expr {
+        match condition {
+            Expr::Const(value) if value != 0.0 => then,
+            Expr::Const(_) => otherwise,
+            condition => Expr::Select {
+                condition: Box::new(condition),
+                then: Box::new(then),
+                otherwise: Box::new(otherwise),
+            },
+        }
+    }
+}
+
+/// Translates a native math tree into an [`Expr`].
+struct Lowering<'s> {
+    symbols: &'s SymbolTable,
+    locals: &'s HashMap<String, f64>,
+}
+
+impl Lowering<'_> {
+    fn lower(&self, node: &ASTNode<'_>) -> Result<Expr, MathError> {
+        let node_type = node.node_type();
+        if let Some(value) = node.value() {
+            return Ok(Expr::Const(value));
+        }
+
+        let args = node
+            .children()
+            .map(|child| self.lower(&child))
+            .collect::<Result<Vec<_>, _>>()?;
+        let invalid = || MathError::InvalidArguments {
+            node: node_type,
+            found: args.len(),
+        };
+
+        let unary = |op: UnaryOp| match <[Expr; 1]>::try_from(args.clone()) {
+            Ok([arg]) => Ok(Expr::unary(op, arg)),
+            Err(_) => Err(invalid()),
+        };
+        let binary = |op: BinaryOp| match <[Expr; 2]>::try_from(args.clone()) {
+            Ok([lhs, rhs]) => Ok(Expr::binary(op, lhs, rhs)),
+            Err(_) => Err(invalid()),
+        };
+        let fold = |op: BinaryOp, empty: Option<f64>| {
+            let mut args = args.clone().into_iter();
+            let first = match (args.next(), empty) {
+                (Some(first), _) => first,
+                (None, Some(empty)) => return Ok(Expr::Const(empty)),
+                (None, None) => return Err(invalid()),
+            };
+            Ok(args.fold(first, |acc, arg| Expr::binary(op, acc, arg)))
+        };
+        let chain = |op: BinaryOp| {
+            if args.len() < 2 {
+                return Err(invalid());
+            }
+            let comparisons = args
+                .windows(2)
+                .map(|pair| Expr::binary(op, pair[0].clone(), pair[1].clone()));
+            Ok(comparisons
+                .reduce(|acc, comparison| Expr::binary(BinaryOp::And, acc, comparison))
+                .expect("at least one comparison"))
+        };
+
+        match node_type {
+            ASTNodeType::Name => self.lower_name(node),
+            ASTNodeType::Time => self.resolve(SymbolTable::TIME),
+            ASTNodeType::Plus => fold(BinaryOp::Add, Some(0.0)),
+            ASTNodeType::Times => fold(BinaryOp::Mul, Some(1.0)),
+            ASTNodeType::Minus if args.len() == 1 => unary(UnaryOp::Neg),
+            ASTNodeType::Minus => binary(BinaryOp::Sub),
+            ASTNodeType::Divide => binary(BinaryOp::Div),
+            ASTNodeType::Power | ASTNodeType::Pow => binary(BinaryOp::Pow),
+            ASTNodeType::Abs => unary(UnaryOp::Abs),
+            ASTNodeType::Exp => unary(UnaryOp::Exp),
+            ASTNodeType::Ln => unary(UnaryOp::Ln),
+            ASTNodeType::Log if args.len() == 1 => unary(UnaryOp::Log10),
+            ASTNodeType::Log => binary(BinaryOp::Log),
+            ASTNodeType::Root if args.len() == 1 => unary(UnaryOp::Sqrt),
+            ASTNodeType::Root => match binary(BinaryOp::Root)? {
+                Expr::Binary(BinaryOp::Root, degree, arg) if *degree == Expr::Const(2.0) => {
+                    Ok(Expr::unary(UnaryOp::Sqrt, *arg))
+                }
+                expr => Ok(expr),
+            },
+            ASTNodeType::Floor => unary(UnaryOp::Floor),
+            ASTNodeType::Ceiling => unary(UnaryOp::Ceil),
+            ASTNodeType::Factorial => unary(UnaryOp::Factorial),
+            ASTNodeType::Sin => unary(UnaryOp::Sin),
+            ASTNodeType::Cos => unary(UnaryOp::Cos),
+            ASTNodeType::Tan => unary(UnaryOp::Tan),
+            ASTNodeType::ArcSin => unary(UnaryOp::ArcSin),
+            ASTNodeType::ArcCos => unary(UnaryOp::ArcCos),
+            ASTNodeType::ArcTan => unary(UnaryOp::ArcTan),
+            ASTNodeType::Sinh => unary(UnaryOp::Sinh),
+            ASTNodeType::Cosh => unary(UnaryOp::Cosh),
+            ASTNodeType::Tanh => unary(UnaryOp::Tanh),
+            ASTNodeType::ArcSinh => unary(UnaryOp::ArcSinh),
+            ASTNodeType::ArcCosh => unary(UnaryOp::ArcCosh),
+            ASTNodeType::ArcTanh => unary(UnaryOp::ArcTanh),
+            ASTNodeType::Max => fold(BinaryOp::Max, None),
+            ASTNodeType::Min => fold(BinaryOp::Min, None),
+            ASTNodeType::Quotient => binary(BinaryOp::Quotient),
+            ASTNodeType::Rem => binary(BinaryOp::Rem),
+            ASTNodeType::And => fold(BinaryOp::And, Some(1.0)),
+            ASTNodeType::Or => fold(BinaryOp::Or, Some(0.0)),
+            ASTNodeType::Xor => fold(BinaryOp::Xor, Some(0.0)),
+            ASTNodeType::Not => unary(UnaryOp::Not),
+            ASTNodeType::Implies => binary(BinaryOp::Implies),
+            ASTNodeType::Eq => chain(BinaryOp::Eq),
+            ASTNodeType::Neq => binary(BinaryOp::Neq),
+            ASTNodeType::Lt => chain(BinaryOp::Lt),
+            ASTNodeType::Leq => chain(BinaryOp::Leq),
+            ASTNodeType::Gt => chain(BinaryOp::Gt),
+            ASTNodeType::Geq => chain(BinaryOp::Geq),
+            ASTNodeType::Piecewise => Ok(Self::lower_piecewise(args)),
+            ASTNodeType::Function => Err(MathError::Unsupported(format!(
+                "call of function '{}'",
+                node.name().unwrap_or_default()
+            ))),
+            other => Err(MathError::Unsupported(format!("{other:?}"))),
+        }
+    }
+
+    /// Resolves a name, preferring local parameters over symbols.
+    fn lower_name(&self, node: &ASTNode<'_>) -> Result<Expr, MathError> {
+        let name = node.name().unwrap_or_default();
+        match self.locals.get(&name) {
+            Some(&value) => Ok(Expr::Const(value)),
+            None => self.resolve(&name),
+        }
+    }
+
+    /// Looks up a symbol of the symbol table.
+    fn resolve(&self, name: &str) -> Result<Expr, MathError> {
+        self.symbols
+            .get(name)
+            .map(Expr::Symbol)
+            .ok_or_else(|| MathError::UnknownSymbol(name.to_string()))
+    }
+
+    /// Builds nested selections from `value, condition, ..., [otherwise]` arguments.
+    ///
+    /// Without an otherwise value the piecewise function is undefined if no condition
+    /// holds, which evaluates to NaN.
+    fn lower_piecewise(mut args: Vec<Expr>) -> Expr {
+        let otherwise = if args.len() % 2 == 1 {
+            args.pop().expect("odd number of arguments")
+        } else {
+            Expr::Const(f64::NAN)
+        };
+
+        let mut pieces = Vec::with_capacity(args.len() / 2);
+        let mut args = args.into_iter();
+        while let (Some(value), Some(condition)) = (args.next(), args.next()) {
+            pieces.push((value, condition));
+        }
+
+        pieces
+            .into_iter()
+            .rev()
+            .fold(otherwise, |otherwise, (value, condition)| {
+                Expr::select(condition, value, otherwise)
+            })
+    }
+}
+
+/// Emits register instructions for an [`Expr`].
+#[derive(Default)]
+struct Codegen {
+    program: Vec<Instruction>,
+    n_registers: usize,
+    n_symbols: usize,
+}
+
+impl Codegen {
+    /// Emits instructions leaving the value of `expr` in register `dst`, using only
+    /// registers from `dst` upwards.
+    fn emit(&mut self, expr: &Expr, dst: usize) {
+        self.n_registers = self.n_registers.max(dst + 1);
+
+        match expr {
+            Expr::Const(value) => self.program.push(Instruction::Const { dst, value: *value }),
+            Expr::Symbol(symbol) => {
+                self.use_symbol(*symbol);
+                self.program.push(Instruction::Load {
+                    dst,
+                    symbol: *symbol,
+                });
+            }
+            Expr::Unary(op, arg) => {
+                self.emit(arg, dst);
+                self.program.push(Instruction::Unary { op: *op, dst });
+            }
+            Expr::Binary(op, lhs, rhs) => {
+                self.emit(lhs, dst);
+                let rhs = match **rhs {
+                    Expr::Const(value) => Operand::Const(value),
+                    Expr::Symbol(symbol) => {
+                        self.use_symbol(symbol);
+                        Operand::Symbol(symbol)
+                    }
+                    ref rhs => {
+                        self.emit(rhs, dst + 1);
+                        Operand::Register
+                    }
+                };
+                self.program.push(Instruction::Binary { op: *op, dst, rhs });
+            }
+            Expr::Select {
+                condition,
+                then,
+                otherwise,
+            } => {
+                self.emit(otherwise, dst);
+                self.emit(then, dst + 1);
+                self.emit(condition, dst + 2);
+                self.program.push(Instruction::Select { dst });
+            }
+        }
+    }
+
+    fn use_symbol(&mut self, symbol: usize) {
+        self.n_symbols = self.n_symbols.max(symbol + 1);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::prelude::*;
+
+    /// Compiles a formula set as kinetic law of a fresh reaction.
+    fn compile(formula: &str, symbols: &[&str]) -> Result<CompiledMath, MathError> {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("test");
+        let kinetic_law = model.create_reaction("r").create_kinetic_law(formula);
+
+        let mut table = SymbolTable::new();
+        for symbol in symbols {
+            table.insert(symbol);
+        }
+        CompiledMath::from_kinetic_law(&kinetic_law, &table)
+    }
+
+    #[test]
+    fn test_eval_arithmetic() {
+        let program = compile("k1 * S1 - k2 * S2 / (1 + S1)", &["S1", "S2", "k1", "k2"]).unwrap();
+        let state = [2.0, 3.0, 0.5, 1.5];
+        let expected = 0.5 * 2.0 - 1.5 * 3.0 / (1.0 + 2.0);
+        assert!((program.eval(&state) - expected).abs() < 1e-12);
+    }
+
+    #[test]
+    fn test_constant_folding() {
+        let program = compile("2 * 3 + pow(2, 3)", &[]).unwrap();
+        assert_eq!(program.as_constant(), Some(14.0));
+        assert_eq!(program.eval(&[]), 14.0);
+    }
+
+    #[test]
+    fn test_functions_and_piecewise() {
+        let program =
+            compile("piecewise(exp(S1), gt(S1, 1), sqrt(S1) + abs(-2))", &["S1"]).unwrap();
+        assert!((program.eval(&[2.0]) - 2f64.exp()).abs() < 1e-12);
+        assert!((program.eval(&[0.25]) - 2.5).abs() < 1e-12);
+
+        let program = compile("log10(100) + root(3, 27) + pow(S1, 2)", &["S1"]).unwrap();
+        assert!((program.eval(&[1.0]) - 6.0).abs() < 1e-12);
+        assert!((program.eval(&[2.0]) - 9.0).abs() < 1e-12);
+    }
+
+    #[test]
+    fn test_eval_columns_matches_eval() {
+        let program = compile(
+            "Vmax * S / (Km + S) * piecewise(1, lt(S, 50), 0.5)",
+            &["S", "Vmax", "Km"],
+        )
+        .unwrap();
+
+        let n_states = 1000;
+        let s: Vec<f64> = (0..n_states).map(|i| i as f64 * 0.1).collect();
+        let vmax: Vec<f64> = (0..n_states).map(|i| 1.0 + (i % 7) as f64).collect();
+        let km = vec![2.0; n_states];
+
+        let mut out = vec![0.0; n_states];
+        program.eval_columns(&[&s, &vmax, &km], &mut out);
+
+        for i in 0..n_states {
+            let expected = program.eval(&[s[i], vmax[i], km[i]]);
+            assert!((out[i] - expected).abs() < 1e-12, "state {i}");
+        }
+    }
+
+    #[test]
+    fn test_local_parameters_shadow_symbols() {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("test");
+        model.create_species("S1");
+        model.create_parameter("k");
+        let kinetic_law = model.create_reaction("r").create_kinetic_law("k * S1");
+        kinetic_law.add_local_parameter("k", Some(3.0));
+
+        let symbols = SymbolTable::from_model(&model);
+        assert_eq!(symbols.names(), ["S1", "k"]);
+
+        let program = CompiledMath::from_kinetic_law(&kinetic_law, &symbols).unwrap();
+        assert_eq!(program.eval(&[2.0, 100.0]), 6.0);
+    }
+
+    #[test]
+    fn test_rate_laws() {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("test");
+        model.create_species("A");
+        model.create_species("B");
+        model.create_parameter("k1");
+        model.create_reaction("r1").create_kinetic_law("k1 * A");
+        model.create_reaction("r2").create_kinetic_law("k1 * A * B");
+
+        let symbols = SymbolTable::from_model(&model);
+        let rate_laws = CompiledMath::rate_laws(&model, &symbols).unwrap();
+        let rates: Vec<f64> = rate_laws
+            .iter()
+            .map(|law| law.eval(&[2.0, 3.0, 0.5]))
+            .collect();
+        assert_eq!(rates, [1.0, 3.0]);
+
+        model.create_reaction("r3");
+        assert!(matches!(
+            CompiledMath::rate_laws(&model, &symbols),
+            Err(MathError::MissingMath(id)) if id == "r3"
+        ));
+    }
+
+    #[test]
+    fn test_compile_errors() {
+        assert!(matches!(
+            compile("k1 * S1", &["S1"]),
+            Err(MathError::UnknownSymbol(name)) if name == "k1"
+        ));
+        assert!(matches!(
+            compile("f(S1)", &["S1"]),
+            Err(MathError::Unsupported(_))
+        ));
+    }
+
+    #[test]
+    #[should_panic(expected = "symbols")]
+    fn test_eval_with_missing_symbols_panics() {
+        let program = compile("S1 + S2", &["S1", "S2"]).unwrap();
+        program.eval(&[1.0]);
+    }
+}
@@ -0,0 +1,899 @@
+//! Dependency index over the species, reactions and rules of a model.
+//!
+//! Simulators and model-reduction tools repeatedly ask which reactions consume or
+//! produce a species, which kinetic laws and rules reference a symbol, and in which
+//! order assignment rules have to be evaluated. [`Model::dependency_graph`] answers
+//! these questions from a [`DependencyGraph`], which stores the edges of the model as
+//! compressed sparse rows (CSR) keyed by element index. Every query only touches the
+//! rows of the element it asks about.
+//!
+//! The graph is built on first use and kept up to date incrementally afterwards.
+//! Reactions and rules created on the model are appended, and wrappers obtained from
+//! the model report changes to their species references, kinetic laws, formulas and
+//! variables, including changes of the species an existing reference points to and
+//! of the id of a reaction. Only the changed elements are read again the next time
+//! the graph is requested. Edits made without these wrappers are not tracked; call
+//! [`Model::invalidate_dependency_graph`] after making them.
+//!
+//! Species and parameters are stored by the ids that reactions and rules refer to
+//! them by. Renaming a species does not rename these references, neither in libSBML
+//! nor in the graph, so the graph keeps reporting the reactions under the old id
+//! until the references are changed as well.
+//!
+//! ```no_run
+//! use sbml::prelude::*;
+//!
+//! let doc = SBMLReader::from_file("model.xml")?;
+//! let model = doc.model().unwrap();
+//! let graph = model.dependency_graph();
+//!
+//! for reaction in graph.reactions_consuming("glucose") {
+//!     println!("glucose is consumed by {reaction}");
+//! }
+//! println!("{:?}", graph.assignment_rule_order()?);
+//! # Ok::<(), Box<dyn std::error::Error>>(())
+//! ```
+//!
+//! [`Model::dependency_graph`]: crate::model::Model::dependency_graph
+//! [`Model::invalidate_dependency_graph`]: crate::model::Model::invalidate_dependency_graph
+
+use std::{
+    cell::{Cell, Ref, RefCell},
+    cmp::Reverse,
+    collections::{BinaryHeap, HashMap},
+    rc::Rc,
+};
+
+use crate::{
+    errors::LibSBMLError,
+    math::{ASTNode, ASTNodeType},
+    reaction::Reaction,
+    rule::{Rule, RuleType},
+    traits::inner::Inner,
+};
+
+/// The role a species plays in a reaction.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub enum SpeciesRole {
+    /// The species is consumed by the reaction
+    Reactant,
+    /// The species is produced by the reaction
+    Product,
+    /// The species modifies the reaction without being consumed or produced
+    Modifier,
+}
+
+/// Species, reaction and rule dependencies of a model.
+///
+/// Symbols, reactions and rules are numbered in the order they were indexed. The
+/// forward edges (reaction → species, kinetic law → symbol, rule → symbol) are stored
+/// per element, and the reverse edges used by the queries are repacked from them
+/// whenever an element changed.
+///
+/// Obtained from [`Model::dependency_graph`](crate::model::Model::dependency_graph).
+#[derive(Debug, Default)]
+pub struct DependencyGraph {
+    /// Ids of all referenced symbols
+    symbols: Vec<String>,
+    /// Index of every symbol by id
+    symbol_index: HashMap<String, u32>,
+    /// Indexed reactions, in model order
+    reactions: Vec<ReactionNode>,
+    /// Index of every reaction by id
+    reaction_index: HashMap<String, u32>,
+    /// Index of every reaction by the address of its native object
+    reaction_addresses: HashMap<usize, u32>,
+    /// Indexed rate and assignment rules
+    rules: Vec<RuleNode>,
+    /// Index of every rule by the address of its native object
+    rule_addresses: HashMap<usize, u32>,
+    /// Number of rate rules of the model that have been indexed
+    indexed_rate_rules: usize,
+    /// Number of assignment rules of the model that have been indexed
+    indexed_assignment_rules: usize,
+    /// Species references per reaction
+    participants: Csr<(u32, SpeciesRole)>,
+    /// Symbols referenced by the kinetic law of each reaction
+    kinetic_law_references: Csr<u32>,
+    /// Symbols referenced by the math of each rule
+    rule_references: Csr<u32>,
+    /// Reactions and roles per species
+    species_reactions: Csr<(u32, SpeciesRole)>,
+    /// Reactions whose kinetic law references each symbol
+    symbol_kinetic_laws: Csr<u32>,
+    /// Rules whose math references each symbol
+    symbol_rules: Csr<u32>,
+    /// Whether the reverse edges need to be repacked
+    stale: bool,
+}
+
+/// A reaction of the dependency graph.
+#[derive(Debug)]
+struct ReactionNode {
+    id: String,
+}
+
+/// A rule of the dependency graph.
+#[derive(Debug)]
+struct RuleNode {
+    variable: u32,
+    rule_type: RuleType,
+    /// Position of the rule within the rate or assignment rules of the model
+    position: usize,
+}
+
+impl DependencyGraph {
+    /// Returns the ids of all reactions that consume the given species.
+    ///
+    /// # Arguments
+    /// * `species` - The id of the species
+    pub fn reactions_consuming<'g>(&'g self, species: &str) -> impl Iterator<Item = &'g str> + 'g {
+        self.reactions_with_role(species, SpeciesRole::Reactant)
+    }
+
+    /// Returns the ids of all reactions that produce the given species.
+    ///
+    /// # Arguments
+    /// * `species` - The id of the species
+    pub fn reactions_producing<'g>(&'g self, species: &str) -> impl Iterator<Item = &'g str> + 'g {
+        self.reactions_with_role(species, SpeciesRole::Product)
+    }
+
+    /// Returns the ids of all reactions that the given species modifies.
+    ///
+    /// # Arguments
+    /// * `species` - The id of the species
+    pub fn reactions_modified_by<'g>(
+        &'g self,
+        species: &str,
+    ) -> impl Iterator<Item = &'g str> + 'g {
+        self.reactions_with_role(species, SpeciesRole::Modifier)
+    }
+
+    /// Returns the ids of all reactions in which the given species plays a role.
+    ///
+    /// # Arguments
+    /// * `species` - The id of the species
+    /// * `role` - The role of the species in the reactions
+    pub fn reactions_with_role<'g>(
+        &'g self,
+        species: &str,
+        role: SpeciesRole,
+    ) -> impl Iterator<Item = &'g str> + 'g {
+        self.reverse_row(&self.species_reactions, species)
+            .iter()
+            .filter(move |(_, current)| *current == role)
+            .map(move |&(reaction, _)| self.reactions[reaction as usize].id.as_str())
+    }
+
+    /// Returns the species references of a reaction.
+    ///
+    /// # Arguments
+    /// * `reaction` - The id of the reaction
+    ///
+    /// # Returns
+    /// The id and role of every species reference, in the order reactants, products,
+    /// modifiers. Unknown reactions yield nothing.
+    pub fn participants<'g>(
+        &'g self,
+        reaction: &str,
+    ) -> impl Iterator<Item = (&'g str, SpeciesRole)> + 'g {
+        self.forward_row(&self.participants, reaction)
+            .iter()
+            .map(move |&(species, role)| (self.symbols[species as usize].as_str(), role))
+    }
+
+    /// Returns the ids of all reactions whose kinetic law references the given symbol.
+    ///
+    /// Local parameters shadow global symbols of the same id and are not reported.
+    ///
+    /// # Arguments
+    /// * `symbol` - The id of a species, parameter, compartment or reaction
+    pub fn kinetic_laws_referencing<'g>(
+        &'g self,
+        symbol: &str,
+    ) -> impl Iterator<Item = &'g str> + 'g {
+        self.reverse_row(&self.symbol_kinetic_laws, symbol)
+            .iter()
+            .map(move |&reaction| self.reactions[reaction as usize].id.as_str())
+    }
+
+    /// Returns the symbols referenced by the kinetic law of a reaction.
+    ///
+    /// # Arguments
+    /// * `reaction` - The id of the reaction
+    pub fn kinetic_law_references<'g>(
+        &'g self,
+        reaction: &str,
+    ) -> impl Iterator<Item = &'g str> + 'g {
+        self.forward_row(&self.kinetic_law_references, reaction)
+            .iter()
+            .map(move |&symbol| self.symbols[symbol as usize].as_str())
+    }
+
+    /// Returns the rules whose math references the given symbol.
+    ///
+    /// # Arguments
+    /// * `symbol` - The id of a species, parameter, compartment or reaction
+    ///
+    /// # Returns
+    /// The variable and type of every referencing rule
+    pub fn rules_referencing<'g>(
+        &'g self,
+        symbol: &str,
+    ) -> impl Iterator<Item = (&'g str, RuleType)> + 'g {
+        self.reverse_row(&self.symbol_rules, symbol)
+            .iter()
+            .map(move |&rule| {
+                let rule = &self.rules[rule as usize];
+                (
+                    self.symbols[rule.variable as usize].as_str(),
+                    rule.rule_type.clone(),
+                )
+            })
+    }
+
+    /// Returns the variables of the assignment rules in evaluation order.
+    ///
+    /// Every rule comes after the rules defining the symbols its math references.
+    /// Rules without mutual dependencies keep their order within the model.
+    ///
+    /// # Errors
+    /// Returns `LibSBMLError::InvalidArgument` if the assignment rules depend on each
+    /// other cyclically
+    pub fn assignment_rule_order(&self) -> Result<Vec<&str>, LibSBMLError> {
+        let is_assignment = |rule: &&RuleNode| matches!(rule.rule_type, RuleType::AssignmentRule);
+        let defining: HashMap<u32, u32> = self
+            .rules
+            .iter()
+            .enumerate()
+            .filter(|(_, rule)| is_assignment(rule))
+            .map(|(index, rule)| (rule.variable, index as u32))
+            .collect();
+
+        let mut pending = vec![0usize; self.rules.len()];
+        let mut dependents = vec![Vec::new(); self.rules.len()];
+        for &rule in defining.values() {
+            for symbol in self.rule_references.row(rule as usize) {
+                if let Some(&dependency) = defining.get(symbol) {
+                    pending[rule as usize] += 1;
+                    dependents[dependency as usize].push(rule);
+                }
+            }
+        }
+
+        let mut ready: BinaryHeap<Reverse<u32>> = defining
+            .values()
+            .filter(|&&rule| pending[rule as usize] == 0)
+            .map(|&rule| Reverse(rule))
+            .collect();
+        let mut order = Vec::with_capacity(defining.len());
+        while let Some(Reverse(rule)) = ready.pop() {
+            order.push(self.symbols[self.rules[rule as usize].variable as usize].as_str());
+            for &dependent in &dependents[rule as usize] {
+                pending[dependent as usize] -= 1;
+                if pending[dependent as usize] == 0 {
+                    ready.push(Reverse(dependent));
+                }
+            }
+        }
+
+        if order.len() < defining.len() {
+            let mut cyclic: Vec<&str> = self
+                .rules
+                .iter()
+                .enumerate()
+                .filter(|(index, rule)| is_assignment(rule) && pending[*index] > 0)
+                .map(|(_, rule)| self.symbols[rule.variable as usize].as_str())
+                .collect();
+            cyclic.sort_unstable();
+            return Err(LibSBMLError::InvalidArgument(format!(
+                "Assignment rules for {} are part of or depend on a cycle",
+                cyclic.join(", ")
+            )));
+        }
+
+        Ok(order)
+    }
+
+    /// Returns the number of indexed reactions.
+    pub fn num_reactions(&self) -> usize {
+        self.reactions.len()
+    }
+
+    /// Returns the number of indexed rate and assignment rules.
+    pub fn num_rules(&self) -> usize {
+        self.rules.len()
+    }
+
+    /// Returns the reverse row of a symbol, or an empty row if it is unknown.
+    fn reverse_row<'g, T: Copy>(&self, csr: &'g Csr<T>, symbol: &str) -> &'g [T] {
+        self.symbol_index
+            .get(symbol)
+            .map_or(&[], |&symbol| csr.row(symbol as usize))
+    }
+
+    /// Returns the forward row of a reaction, or an empty row if it is unknown.
+    fn forward_row<'g, T: Copy>(&self, csr: &'g Csr<T>, reaction: &str) -> &'g [T] {
+        self.reaction_index
+            .get(reaction)
+            .map_or(&[], |&reaction| csr.row(reaction as usize))
+    }
+
+    /// Brings the graph up to date with the given lists of the model.
+    ///
+    /// Changed elements are read again and elements appended since the last update
+    /// are indexed. The reverse edges are repacked if anything changed.
+    fn update(
+        &mut self,
+        changes: &[Change],
+        reactions: &[Rc<Reaction<'_>>],
+        rate_rules: &[Rc<Rule<'_>>],
+        assignment_rules: &[Rc<Rule<'_>>],
+    ) {
+        for change in changes {
+            match *change {
+                Change::Reaction(address) => {
+                    let Some(&index) = self.reaction_addresses.get(&address) else {
+                        continue;
+                    };
+                    if let Some(reaction) = reactions.get(index as usize) {
+                        if address_of(reaction.inner()) == address {
+                            self.index_reaction(index as usize, reaction);
+                        }
+                    }
+                }
+                Change::Rule(address) => {
+                    let Some(&index) = self.rule_addresses.get(&address) else {
+                        continue;
+                    };
+                    let node = &self.rules[index as usize];
+                    let (rule_type, position) = (node.rule_type.clone(), node.position);
+                    let rules = match rule_type {
+                        RuleType::RateRule => rate_rules,
+                        RuleType::AssignmentRule => assignment_rules,
+                    };
+                    if let Some(rule) = rules.get(position) {
+                        if address_of(rule.inner()) == address {
+                            self.index_rule(index as usize, rule, rule_type);
+                        }
+                    }
+                }
+            }
+        }
+
+        for reaction in reactions.iter().skip(self.reactions.len()) {
+            self.index_reaction(self.reactions.len(), reaction);
+        }
+        for rule in rate_rules.iter().skip(self.indexed_rate_rules) {
+            self.index_rule(self.rules.len(), rule, RuleType::RateRule);
+        }
+        for rule in assignment_rules.iter().skip(self.indexed_assignment_rules) {
+            self.index_rule(self.rules.len(), rule, RuleType::AssignmentRule);
+        }
+
+        if self.stale {
+            self.repack();
+        }
+    }
+
+    /// Reads the species references and kinetic law of a reaction into row `index`,
+    /// appending the row if `index` is one past the last reaction.
+    fn index_reaction(&mut self, index: usize, reaction: &Reaction<'_>) {
+        let mut participants = Vec::new();
+        for reactant in reaction.reactants().borrow().iter() {
+            let species = reactant.with_species(|species| self.symbol(species));
+            participants.push((species, SpeciesRole::Reactant));
+        }
+        for product in reaction.products().borrow().iter() {
+            let species = product.with_species(|species| self.symbol(species));
+            participants.push((species, SpeciesRole::Product));
+        }
+        for modifier in reaction.modifiers().borrow().iter() {
+            let species = modifier.with_species(|species| self.symbol(species));
+            participants.push((species, SpeciesRole::Modifier));
+        }
+
+        let mut references = Vec::new();
+        if let Some(kinetic_law) = reaction.kinetic_law() {
+            let local_parameters: Vec<String> = kinetic_law
+                .local_parameters_iter()
+                .map(|parameter| parameter.id())
+                .collect();
+            let mut names = Vec::new();
+            kinetic_law.with_math(|math| {
+                if let Some(math) = math {
+                    collect_names(&math, &mut names);
+                }
+            });
+            references = names
+                .iter()
+                .filter(|name| !local_parameters.contains(name))
+                .map(|name| self.symbol(name))
+                .collect();
+            references.sort_unstable();
+            references.dedup();
+        }
+
+        let id = reaction.id();
+        let address = address_of(reaction.inner());
+        if index == self.reactions.len() {
+            self.participants.push_row(participants);
+            self.kinetic_law_references.push_row(references);
+            self.reactions.push(ReactionNode { id: String::new() });
+        } else {
+            self.participants.replace_row(index, participants);
+            self.kinetic_law_references.replace_row(index, references);
+        }
+
+        let node = &mut self.reactions[index];
+        if node.id != id {
+            if self.reaction_index.get(&node.id) == Some(&(index as u32)) {
+                self.reaction_index.remove(&node.id);
+            }
+            self.reaction_index.insert(id.clone(), index as u32);
+            node.id = id;
+        }
+        self.reaction_addresses.insert(address, index as u32);
+        self.stale = true;
+    }
+
+    /// Reads the variable and math of a rule into row `index`, appending the row if
+    /// `index` is one past the last rule.
+    fn index_rule(&mut self, index: usize, rule: &Rule<'_>, rule_type: RuleType) {
+        let variable = rule.with_variable(|variable| self.symbol(variable));
+
+        let mut names = Vec::new();
+        rule.with_math(|math| {
+            if let Some(math) = math {
+                collect_names(&math, &mut names);
+            }
+        });
+        let mut references: Vec<u32> = names.iter().map(|name| self.symbol(name)).collect();
+        references.sort_unstable();
+        references.dedup();
+
+        let address = address_of(rule.inner());
+        if index == self.rules.len() {
+            let position = match rule_type {
+                RuleType::RateRule => &mut self.indexed_rate_rules,
+                RuleType::AssignmentRule => &mut self.indexed_assignment_rules,
+            };
+            self.rules.push(RuleNode {
+                variable,
+                rule_type,
+                position: *position,
+            });
+            *position += 1;
+            self.rule_references.push_row(references);
+        } else {
+            self.rules[index].variable = variable;
+            self.rule_references.replace_row(index, references);
+        }
+
+        self.rule_addresses.insert(address, index as u32);
+        self.stale = true;
+    }
+
+    /// Returns the index of a symbol, adding it if it is new.
+    fn symbol(&mut self, id: &str) -> u32 {
+        if let Some(&index) = self.symbol_index.get(id) {
+            return index;
+        }
+
+        let index = self.symbols.len() as u32;
+        self.symbols.push(id.to_string());
+        self.symbol_index.insert(id.to_string(), index);
+        index
+    }
+
+    /// Rebuilds the reverse edges from the forward edges.
+    fn repack(&mut self) {
+        let n_symbols = self.symbols.len();
+        self.species_reactions = self
+            .participants
+            .transpose(n_symbols, |row, &(species, role)| (species, (row, role)));
+        self.symbol_kinetic_laws = self
+            .kinetic_law_references
+            .transpose(n_symbols, |row, &symbol| (symbol, row));
+        self.symbol_rules = self
+            .rule_references
+            .transpose(n_symbols, |row, &symbol| (symbol, row));
+        self.stale = false;
+    }
+}
+
+/// Adjacency lists in compressed sparse row layout.
+///
+/// Row `i` holds `values[offsets[i]..offsets[i + 1]]`.
+#[derive(Debug)]
+struct Csr<T> {
+    offsets: Vec<usize>,
+    values: Vec<T>,
+}
+
+impl<T> Default for Csr<T> {
+    fn default() -> Self {
+        Self {
+            offsets: vec![0],
+            values: Vec::new(),
+        }
+    }
+}
+
+impl<T: Copy> Csr<T> {
+    /// Returns the values of a row, or an empty slice if the row does not exist.
+    fn row(&self, row: usize) -> &[T] {
+        match self.offsets.get(row + 1) {
+            Some(&end) => &self.values[self.offsets[row]..end],
+            None => &[],
+        }
+    }
+
+    /// Appends a row.
+    fn push_row(&mut self, values: Vec<T>) {
+        self.values.extend(values);
+        self.offsets.push(self.values.len());
+    }
+
+    /// Replaces the values of an existing row, shifting the rows after it.
+    fn replace_row(&mut self, row: usize, values: Vec<T>) {
+        let (start, end) = (self.offsets[row], self.offsets[row + 1]);
+        let (removed, added) = (end - start, values.len());
+        self.values.splice(start..end, values);
+
+        if added != removed {
+            for offset in &mut self.offsets[row + 1..] {
+                *offset = *offset + added - removed;
+            }
+        }
+    }
+
+    /// Builds the transposed adjacency with `columns` rows.
+    ///
+    /// `entry` maps a row index and one of its values to the target row and the value
+    /// stored there. Within every target row, values keep the order of their source rows.
+    fn transpose<U: Copy>(&self, columns: usize, entry: impl Fn(u32, &T) -> (u32, U)) -> Csr<U> {
+        let mut entries = Vec::with_capacity(self.values.len());
+        for row in 0..self.offsets.len() - 1 {
+            for value in self.row(row) {
+                entries.push(entry(row as u32, value));
+            }
+        }
+        entries.sort_by_key(|&(column, _)| column);
+
+        let mut offsets = vec![0; columns + 1];
+        for &(column, _) in &entries {
+            offsets[column as usize + 1] += 1;
+        }
+        for column in 0..columns {
+            offsets[column + 1] += offsets[column];
+        }
+
+        Csr {
+            offsets,
+            values: entries.into_iter().map(|(_, value)| value).collect(),
+        }
+    }
+}
+
+/// Collects the identifiers referenced by a math tree.
+fn collect_names(node: &ASTNode<'_>, names: &mut Vec<String>) {
+    if node.node_type() == ASTNodeType::Name {
+        if let Some(name) = node.name() {
+            names.push(name);
+        }
+    }
+    for child in node.children() {
+        collect_names(&child, names);
+    }
+}
+
+/// Returns the address of the native object behind a wrapper, which identifies the
+/// element independent of how often it has been wrapped.
+pub(crate) fn address_of<T>(inner: &RefCell<std::pin::Pin<&mut T>>) -> usize {
+    &**inner.borrow() as *const T as usize
+}
+
+/// An element of the model whose dependencies changed, identified by the address of
+/// its native object.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, PartialOrd, Ord)]
+pub(crate) enum Change {
+    Reaction(usize),
+    Rule(usize),
+}
+
+/// Collects changes reported by wrappers while a graph exists.
+#[derive(Debug, Default)]
+struct DependencyTracker {
+    active: Cell<bool>,
+    changes: RefCell<Vec<Change>>,
+}
+
+/// Reports changes of one element to the dependency index of its model.
+#[derive(Debug, Clone)]
+pub(crate) struct ChangeHook {
+    tracker: Rc<DependencyTracker>,
+    change: Change,
+}
+
+impl ChangeHook {
+    /// Marks the element as changed.
+    pub(crate) fn notify(&self) {
+        if self.tracker.active.get() {
+            self.tracker.changes.borrow_mut().push(self.change);
+        }
+    }
+}
+
+/// The dependency graph of a model together with the changes reported since it was
+/// last updated.
+#[derive(Debug, Default)]
+pub(crate) struct DependencyIndex {
+    tracker: Rc<DependencyTracker>,
+    graph: RefCell<Option<DependencyGraph>>,
+}
+
+impl Clone for DependencyIndex {
+    /// A clone belongs to a separate native model, so it starts without a graph.
+    fn clone(&self) -> Self {
+        Self::default()
+    }
+}
+
+impl DependencyIndex {
+    /// Returns a hook through which an element reports its changes.
+    pub(crate) fn hook(&self, change: Change) -> ChangeHook {
+        ChangeHook {
+            tracker: Rc::clone(&self.tracker),
+            change,
+        }
+    }
+
+    /// Returns the graph, building it on first use and applying pending changes.
+    ///
+    /// # Panics
+    /// Panics if a reference returned by a previous call is still alive.
+    pub(crate) fn graph(
+        &self,
+        reactions: &[Rc<Reaction<'_>>],
+        rate_rules: &[Rc<Rule<'_>>],
+        assignment_rules: &[Rc<Rule<'_>>],
+    ) -> Ref<'_, DependencyGraph> {
+        {
+            let mut graph = self.graph.borrow_mut();
+            let graph = graph.get_or_insert_with(|| {
+                self.tracker.active.set(true);
+                DependencyGraph::default()
+            });
+
+            let mut changes = self.tracker.changes.take();
+            changes.sort_unstable();
+            changes.dedup();
+            graph.update(&changes, reactions, rate_rules, assignment_rules);
+        }
+
+        Ref::map(self.graph.borrow(), |graph| {
+            graph.as_ref().expect("dependency graph was just built")
+        })
+    }
+
+    /// Drops the graph so that the next request builds it from scratch.
+    pub(crate) fn invalidate(&self) {
+        self.graph.replace(None);
+        self.tracker.active.set(false);
+        self.tracker.changes.take();
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::prelude::*;
+
+    fn collect<'g>(iter: impl Iterator<Item = &'g str>) -> Vec<&'g str> {
+        iter.collect()
+    }
+
+    #[test]
+    fn test_species_queries() {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("test");
+        let r1 = model.create_reaction("r1");
+        r1.create_reactant("glucose", 1.0);
+        r1.create_product("g6p", 1.0);
+        r1.create_modifier("hexokinase");
+        let r2 = model.create_reaction("r2");
+        r2.create_reactant("g6p", 1.0);
+        r2.create_product("f6p", 1.0);
+
+        let graph = model.dependency_graph();
+        assert_eq!(collect(graph.reactions_consuming("glucose")), vec!["r1"]);
+        assert_eq!(collect(graph.reactions_producing("g6p")), vec!["r1"]);
+        assert_eq!(collect(graph.reactions_consuming("g6p")), vec!["r2"]);
+        assert_eq!(
+            collect(graph.reactions_modified_by("hexokinase")),
+            vec!["r1"]
+        );
+        assert!(collect(graph.reactions_consuming("unknown")).is_empty());
+        assert_eq!(
+            graph.participants("r2").collect::<Vec<_>>(),
+            vec![
+                ("g6p", SpeciesRole::Reactant),
+                ("f6p", SpeciesRole::Product)
+            ]
+        );
+    }
+
+    #[test]
+    fn test_incremental_updates() {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("test");
+        let r1 = model.create_reaction("r1");
+        r1.create_reactant("a", 1.0);
+        assert_eq!(model.dependency_graph().num_reactions(), 1);
+
+        // Changes to indexed and new reactions are picked up on the next request
+        r1.create_product("b", 1.0);
+        let kinetic_law = r1.create_kinetic_law("k1 * a");
+        let r2 = model.create_reaction("r2");
+        r2.create_reactant("b", 1.0);
+        {
+            let graph = model.dependency_graph();
+            assert_eq!(collect(graph.reactions_producing("b")), vec!["r1"]);
+            assert_eq!(collect(graph.reactions_consuming("b")), vec!["r2"]);
+            assert_eq!(collect(graph.kinetic_laws_referencing("k1")), vec!["r1"]);
+        }
+
+        kinetic_law.set_formula("k2 * a");
+        {
+            let graph = model.dependency_graph();
+            assert!(collect(graph.kinetic_laws_referencing("k1")).is_empty());
+            assert_eq!(collect(graph.kinetic_laws_referencing("k2")), vec!["r1"]);
+        }
+
+        // Local parameters shadow global symbols
+        kinetic_law.add_local_parameter("k2", Some(1.0));
+        assert!(collect(model.dependency_graph().kinetic_laws_referencing("k2")).is_empty());
+
+        // Existing species references report a new species
+        r2.reactants().borrow()[0].set_species("c");
+        {
+            let graph = model.dependency_graph();
+            assert!(collect(graph.reactions_consuming("b")).is_empty());
+            assert_eq!(collect(graph.reactions_consuming("c")), vec!["r2"]);
+        }
+    }
+
+    #[test]
+    fn test_renames() {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("test");
+        let species = model.create_species("a");
+        let reaction = model.create_reaction("r1");
+        reaction.create_reactant("a", 1.0);
+        assert_eq!(
+            collect(model.dependency_graph().reactions_consuming("a")),
+            vec!["r1"]
+        );
+
+        // Renamed reactions are reported under their new id
+        reaction.set_id("r2");
+        {
+            let graph = model.dependency_graph();
+            assert_eq!(collect(graph.reactions_consuming("a")), vec!["r2"]);
+            assert_eq!(graph.participants("r2").count(), 1);
+            assert_eq!(graph.participants("r1").count(), 0);
+        }
+
+        // Renaming a species leaves the references to it, and thus the graph, as is
+        species.set_id("b");
+        let graph = model.dependency_graph();
+        assert_eq!(collect(graph.reactions_consuming("a")), vec!["r2"]);
+        assert!(collect(graph.reactions_consuming("b")).is_empty());
+    }
+
+    #[test]
+    fn test_species_reference_updates_from_document() {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("test");
+        let reaction = model.create_reaction("r1");
+        reaction.create_reactant("a", 1.0);
+        reaction.create_modifier("e1");
+        let xml = doc.to_xml_string();
+
+        // Wrappers loaded from the native model are tracked as well
+        let doc = SBMLReader::from_xml_string(&xml);
+        let model = doc.model().unwrap();
+        assert_eq!(
+            collect(model.dependency_graph().reactions_consuming("a")),
+            vec!["r1"]
+        );
+
+        let reaction = model.get_reaction("r1").unwrap();
+        reaction.reactants().borrow()[0].set_species("b");
+        reaction.modifiers().borrow()[0].set_species("e2");
+        let graph = model.dependency_graph();
+        assert!(collect(graph.reactions_consuming("a")).is_empty());
+        assert_eq!(collect(graph.reactions_consuming("b")), vec!["r1"]);
+        assert_eq!(collect(graph.reactions_modified_by("e2")), vec!["r1"]);
+    }
+
+    #[test]
+    fn test_rules_referencing() {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("test");
+        model.create_rate_rule("s1", "k * s2");
+        let rule = model.create_assignment_rule("x", "k + 1");
+
+        {
+            let graph = model.dependency_graph();
+            assert_eq!(
+                graph.rules_referencing("k").collect::<Vec<_>>(),
+                vec![("s1", RuleType::RateRule), ("x", RuleType::AssignmentRule)]
+            );
+        }
+
+        rule.set_formula("s2 + 1");
+        let graph = model.dependency_graph();
+        assert_eq!(
+            graph.rules_referencing("k").collect::<Vec<_>>(),
+            vec![("s1", RuleType::RateRule)]
+        );
+        assert_eq!(graph.rules_referencing("s2").count(), 2);
+    }
+
+    #[test]
+    fn test_assignment_rule_order() {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("test");
+        model.create_assignment_rule("total", "x + y");
+        model.create_assignment_rule("y", "x * 2");
+        model.create_assignment_rule("x", "k");
+        model.create_assignment_rule("z", "1");
+
+        assert_eq!(
+            model.dependency_graph().assignment_rule_order().unwrap(),
+            vec!["x", "y", "total", "z"]
+        );
+
+        model.create_assignment_rule("k", "total");
+        let order = model.dependency_graph().assignment_rule_order();
+        assert!(matches!(order, Err(LibSBMLError::InvalidArgument(_))));
+    }
+
+    #[test]
+    fn test_dependency_graph_from_document() {
+        let doc = SBMLReader::from_file("tests/data/example.xml").unwrap();
+        let model = doc.model().unwrap();
+        let graph = model.dependency_graph();
+
+        assert_eq!(graph.num_reactions(), model.list_of_reactions().len());
+        for reaction in model.reactions_iter() {
+            for reactant in reaction.reactants().borrow().iter() {
+                let consumers = collect(graph.reactions_consuming(&reactant.species()));
+                assert!(consumers.contains(&reaction.id().as_str()));
+            }
+        }
+    }
+
+    #[test]
+    fn test_csr_replace_row() {
+        let mut csr = Csr::default();
+        csr.push_row(vec![1, 2]);
+        csr.push_row(vec![3]);
+        csr.push_row(vec![]);
+        csr.replace_row(0, vec![4]);
+        csr.replace_row(2, vec![5, 6]);
+
+        assert_eq!(csr.row(0), &[4]);
+        assert_eq!(csr.row(1), &[3]);
+        assert_eq!(csr.row(2), &[5, 6]);
+        assert!(csr.row(3).is_empty());
+
+        let transposed = csr.transpose(7, |row, &value| (value, row));
+        assert_eq!(transposed.row(3), &[1]);
+        assert_eq!(transposed.row(6), &[2]);
+        assert!(transposed.row(0).is_empty());
+    }
+}
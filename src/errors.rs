@@ -1,7 +1,17 @@
+/// Errors reported by the safe wrappers around libSBML.
+///
+/// New variants may be added in minor releases, so matches need a wildcard arm.
 #[derive(Debug, thiserror::Error)]
+#[non_exhaustive]
 pub enum LibSBMLError {
     #[error("Plugin not found: {0}")]
     PluginNotFound(String),
     #[error("Invalid argument: {0}")]
     InvalidArgument(String),
+    #[error("Unsupported: {0}")]
+    Unsupported(String),
+    #[error("I/O error: {0}")]
+    Io(#[from] std::io::Error),
+    #[error("XML error: {0}")]
+    Xml(#[from] quick_xml::Error),
 }
@@ -0,0 +1,299 @@
+//! Batched in-place updates of FBC flux bounds and objective coefficients.
+//!
+//! Iterative FBC workflows such as flux variability analysis, knock-out screens or
+//! dynamic FBA change thousands of bounds between two solver runs. Looking up every
+//! flux bound by id and calling [`FluxBound::set_value`](super::FluxBound::set_value)
+//! costs one FFI round trip per value. Instead, [`FluxBoundHandle`] and
+//! [`FluxObjectiveHandle`] address elements by their position in the native lists,
+//! and [`Model::update_flux_bounds`] and [`Model::update_objective_coefficients`]
+//! write a whole slice of new values through a single call into `src/shim.h`.
+//!
+//! Handles stay valid for the lifetime of the model, since flux bounds and
+//! objectives can only be appended to it.
+//!
+//! ```no_run
+//! use sbml::prelude::*;
+//!
+//! let doc = SBMLReader::from_file("model.xml")?;
+//! let model = doc.model().unwrap();
+//!
+//! let knock_out = model.flux_bound_handle("ub_pgi").unwrap();
+//! model.update_flux_bounds(&[(knock_out, 0.0)], Validation::Checked)?;
+//! # Ok::<(), Box<dyn std::error::Error>>(())
+//! ```
+//!
+//! [`Model::update_flux_bounds`]: crate::model::Model::update_flux_bounds
+//! [`Model::update_objective_coefficients`]: crate::model::Model::update_objective_coefficients
+
+use autocxx::c_uint;
+
+use crate::{errors::LibSBMLError, incremental::Tracked, model::Model, sbmlcxx};
+
+/// Position of a flux bound within the flux bounds of a model.
+///
+/// Obtained from [`Model::flux_bound_handle`](crate::model::Model::flux_bound_handle).
+#[derive(Debug, Clone, Copy, PartialEq, Eq, PartialOrd, Ord, Hash)]
+pub struct FluxBoundHandle(u32);
+
+impl FluxBoundHandle {
+    /// Creates a handle for the flux bound at the given position.
+    pub fn from_index(index: usize) -> Self {
+        Self(index as u32)
+    }
+
+    /// Returns the position of the flux bound within the flux bounds of the model.
+    pub fn index(self) -> usize {
+        self.0 as usize
+    }
+}
+
+/// Position of a flux objective, given by the position of its objective within the
+/// model and its position within that objective.
+///
+/// Obtained from
+/// [`Model::flux_objective_handle`](crate::model::Model::flux_objective_handle).
+#[derive(Debug, Clone, Copy, PartialEq, Eq, PartialOrd, Ord, Hash)]
+pub struct FluxObjectiveHandle {
+    objective: u32,
+    flux_objective: u32,
+}
+
+impl FluxObjectiveHandle {
+    /// Creates a handle for a flux objective from its positions.
+    pub fn from_indices(objective: usize, flux_objective: usize) -> Self {
+        Self {
+            objective: objective as u32,
+            flux_objective: flux_objective as u32,
+        }
+    }
+
+    /// Returns the position of the objective within the objectives of the model.
+    pub fn objective_index(self) -> usize {
+        self.objective as usize
+    }
+
+    /// Returns the position of the flux objective within its objective.
+    pub fn flux_objective_index(self) -> usize {
+        self.flux_objective as usize
+    }
+}
+
+/// How thoroughly a batched update is checked.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub enum Validation {
+    /// All handles and values are checked before anything is written, and the update
+    /// fails as a whole if one of them is invalid. If libSBML rejects a value, the
+    /// values written before it are restored.
+    #[default]
+    Checked,
+    /// Values are written without checks. Handles that do not refer to an element are
+    /// skipped, and NaN values are written as given.
+    Unchecked,
+}
+
+/// Writes new values into the flux bounds of a model, see
+/// [`Model::update_flux_bounds`](crate::model::Model::update_flux_bounds).
+pub(crate) fn update_flux_bounds(
+    model: &Model<'_>,
+    updates: &[(FluxBoundHandle, f64)],
+    validation: Validation,
+) -> Result<(), LibSBMLError> {
+    if validation == Validation::Checked {
+        let n_flux_bounds = model.loaded_flux_bounds().borrow().len();
+        for (position, &(handle, value)) in updates.iter().enumerate() {
+            if handle.index() >= n_flux_bounds {
+                return Err(LibSBMLError::InvalidArgument(format!(
+                    "Update {position} refers to flux bound {}, but the model has {n_flux_bounds}",
+                    handle.index()
+                )));
+            }
+            check_value(position, value)?;
+        }
+    }
+
+    let positions: Vec<c_uint> = updates.iter().map(|(handle, _)| c_uint(handle.0)).collect();
+    let values: Vec<f64> = updates.iter().map(|&(_, value)| value).collect();
+
+    // SAFETY: Both buffers hold `updates.len()` elements and outlive the call
+    let applied = unsafe {
+        sbmlcxx::sbmlrs::setFluxBoundValues(
+            model.inner().borrow_mut().as_mut(),
+            positions.as_ptr(),
+            values.as_ptr(),
+            updates.len(),
+            validation == Validation::Checked,
+        )
+    };
+    if let Some(flux_bound) = model.loaded_flux_bounds().borrow().first() {
+        flux_bound.mark_dirty();
+    }
+
+    check_applied(validation, applied, updates.len(), "flux bound values")
+}
+
+/// Writes new coefficients into the flux objectives of a model, see
+/// [`Model::update_objective_coefficients`](crate::model::Model::update_objective_coefficients).
+pub(crate) fn update_objective_coefficients(
+    model: &Model<'_>,
+    updates: &[(FluxObjectiveHandle, f64)],
+    validation: Validation,
+) -> Result<(), LibSBMLError> {
+    if validation == Validation::Checked {
+        let objectives = model.loaded_objectives().borrow();
+        for (position, &(handle, value)) in updates.iter().enumerate() {
+            let n_flux_objectives = objectives
+                .get(handle.objective_index())
+                .map(|objective| objective.num_flux_objectives());
+            if n_flux_objectives.map_or(true, |n| handle.flux_objective_index() >= n) {
+                return Err(LibSBMLError::InvalidArgument(format!(
+                    "Update {position} refers to flux objective {} of objective {}, which does not exist",
+                    handle.flux_objective_index(),
+                    handle.objective_index()
+                )));
+            }
+            check_value(position, value)?;
+        }
+    }
+
+    let objectives: Vec<c_uint> = updates
+        .iter()
+        .map(|(handle, _)| c_uint(handle.objective))
+        .collect();
+    let flux_objectives: Vec<c_uint> = updates
+        .iter()
+        .map(|(handle, _)| c_uint(handle.flux_objective))
+        .collect();
+    let values: Vec<f64> = updates.iter().map(|&(_, value)| value).collect();
+
+    // SAFETY: All buffers hold `updates.len()` elements and outlive the call
+    let applied = unsafe {
+        sbmlcxx::sbmlrs::setFluxObjectiveCoefficients(
+            model.inner().borrow_mut().as_mut(),
+            objectives.as_ptr(),
+            flux_objectives.as_ptr(),
+            values.as_ptr(),
+            updates.len(),
+            validation == Validation::Checked,
+        )
+    };
+    if let Some(objective) = model.loaded_objectives().borrow().first() {
+        objective.mark_dirty();
+    }
+
+    check_applied(validation, applied, updates.len(), "objective coefficients")
+}
+
+/// Rejects NaN values in checked updates.
+fn check_value(position: usize, value: f64) -> Result<(), LibSBMLError> {
+    if value.is_nan() {
+        return Err(LibSBMLError::InvalidArgument(format!(
+            "Update {position} sets a NaN value"
+        )));
+    }
+    Ok(())
+}
+
+/// Verifies in checked updates that libSBML accepted every value.
+///
+/// Checked updates are written all or nothing, so `applied` is either `expected` or
+/// the position of the update that libSBML rejected.
+fn check_applied(
+    validation: Validation,
+    applied: usize,
+    expected: usize,
+    what: &str,
+) -> Result<(), LibSBMLError> {
+    if validation == Validation::Checked && applied != expected {
+        return Err(LibSBMLError::InvalidArgument(format!(
+            "libSBML rejected update {applied} of {expected} {what}, no values were changed"
+        )));
+    }
+    Ok(())
+}
+
+#[cfg(test)]
+mod tests {
+    use crate::prelude::*;
+
+    fn fbc_document() -> SBMLDocument {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("fbc");
+        for id in ["r1", "r2", "r3"] {
+            model.create_reaction(id);
+            let flux_bound = model
+                .create_flux_bound(&format!("ub_{id}"), id, FluxBoundOperation::LessEqual)
+                .unwrap();
+            flux_bound.set_value(1000.0);
+        }
+        let objective = model
+            .create_objective("obj", ObjectiveType::Maximize)
+            .unwrap();
+        objective.create_flux_objective("fo1", "r1", 1.0).unwrap();
+        objective.create_flux_objective("fo3", "r3", 0.0).unwrap();
+        doc
+    }
+
+    #[test]
+    fn test_update_flux_bounds() {
+        let doc = fbc_document();
+        let model = doc.model().unwrap();
+        let r2 = model.flux_bound_handle("ub_r2").unwrap();
+        let r3 = model.flux_bound_handle("ub_r3").unwrap();
+        assert_eq!(r2.index(), 1);
+        assert!(model.flux_bound_handle("unknown").is_none());
+
+        model
+            .update_flux_bounds(&[(r2, 0.0), (r3, 5.0)], Validation::Checked)
+            .unwrap();
+
+        assert_eq!(model.get_flux_bound("ub_r1").unwrap().value(), Some(1000.0));
+        assert_eq!(model.get_flux_bound("ub_r2").unwrap().value(), Some(0.0));
+        assert_eq!(model.get_flux_bound("ub_r3").unwrap().value(), Some(5.0));
+    }
+
+    #[test]
+    fn test_update_flux_bounds_checked_is_atomic() {
+        let doc = fbc_document();
+        let model = doc.model().unwrap();
+        let r1 = model.flux_bound_handle("ub_r1").unwrap();
+        let stale = FluxBoundHandle::from_index(10);
+
+        let result = model.update_flux_bounds(&[(r1, 0.0), (stale, 0.0)], Validation::Checked);
+        assert!(matches!(result, Err(LibSBMLError::InvalidArgument(_))));
+        assert_eq!(model.get_flux_bound("ub_r1").unwrap().value(), Some(1000.0));
+
+        let result = model.update_flux_bounds(&[(r1, 0.0), (r1, f64::NAN)], Validation::Checked);
+        assert!(result.is_err());
+        assert_eq!(model.get_flux_bound("ub_r1").unwrap().value(), Some(1000.0));
+
+        // Unchecked updates skip handles without a flux bound
+        model
+            .update_flux_bounds(&[(r1, 0.0), (stale, 0.0)], Validation::Unchecked)
+            .unwrap();
+        assert_eq!(model.get_flux_bound("ub_r1").unwrap().value(), Some(0.0));
+    }
+
+    #[test]
+    fn test_update_objective_coefficients() {
+        let doc = fbc_document();
+        let model = doc.model().unwrap();
+        let fo3 = model.flux_objective_handle("obj", "fo3").unwrap();
+        assert_eq!(fo3.objective_index(), 0);
+        assert_eq!(fo3.flux_objective_index(), 1);
+        assert!(model.flux_objective_handle("obj", "unknown").is_none());
+        assert!(model.flux_objective_handle("unknown", "fo3").is_none());
+
+        model
+            .update_objective_coefficients(&[(fo3, 2.5)], Validation::Checked)
+            .unwrap();
+        let objective = model.get_objective("obj").unwrap();
+        assert_eq!(
+            objective.get_flux_objective("fo3").unwrap().coefficient(),
+            Some(2.5)
+        );
+
+        let stale = FluxObjectiveHandle::from_indices(0, 5);
+        let result = model.update_objective_coefficients(&[(stale, 1.0)], Validation::Checked);
+        assert!(result.is_err());
+    }
+}
@@ -14,7 +14,8 @@ use cxx::let_cxx_string;
 use crate::{
     clone,
     errors::LibSBMLError,
-    inner,
+    incremental::ChangeTracker,
+    index_key, inner,
     model::Model,
     optional_property, pin_ptr,
     plugin::get_plugin,
@@ -32,12 +33,15 @@ use super::fluxboundop::FluxBoundOperation;
 /// - An identifier (optional)
 /// - A reaction identifier that this bound applies to
 /// - An operation (less than, greater than, equal to, etc.)
-/// - A value (handled separately in the FBC plugin)
+/// - A value the flux is compared against
 ///
 /// This struct maintains a reference to the underlying C++ FluxBound object
 /// through a RefCell and Pin to ensure memory safety while allowing interior mutability.
 pub struct FluxBound<'a> {
     inner: RefCell<Pin<&'a mut sbmlcxx::FluxBound>>,
+    annotation_cache: AnnotationCache,
+    /// Marks the section of the document that contains this element
+    changes: ChangeTracker<'a>,
 }
 
 inner!(sbmlcxx::FluxBound, FluxBound<'a>);
@@ -46,6 +50,8 @@ upcast_annotation!(FluxBound<'a>, sbmlcxx::FluxBound, sbmlcxx::SBase);
 
 clone!(FluxBound<'a>, sbmlcxx::FluxBound);
 
+index_key!(FluxBound<'_>, getId);
+
 impl<'a> FluxBound<'a> {
     /// Creates a new FluxBound instance within the given Model.
     ///
@@ -91,11 +97,21 @@ impl<'a> FluxBound<'a> {
 
         Ok(Self {
             inner: RefCell::new(flux_bound),
+            annotation_cache: AnnotationCache::default(),
+            changes: model.changes(),
         })
     }
 
     // Getter and setter for id
-    optional_property!(FluxBound<'a>, id, String, getId, setId, isSetId);
+    optional_property!(
+        FluxBound<'a>,
+        id,
+        String,
+        getId,
+        setId,
+        isSetId,
+        after_set = key_changed
+    );
 
     // Getter and setter for reaction
     optional_property!(
@@ -115,6 +131,9 @@ impl<'a> FluxBound<'a> {
         getFluxBoundOperation,
         setOperation1
     );
+
+    // Getter and setter for value
+    optional_property!(FluxBound<'a>, value, f64, getValue, setValue, isSetValue);
 }
 
 impl<'a> FromPtr<sbmlcxx::FluxBound> for FluxBound<'a> {
@@ -123,6 +142,8 @@ impl<'a> FromPtr<sbmlcxx::FluxBound> for FluxBound<'a> {
 
         Self {
             inner: RefCell::new(flux_bound),
+            annotation_cache: AnnotationCache::default(),
+            changes: ChangeTracker::default(),
         }
     }
 }
@@ -133,6 +154,7 @@ impl<'a> std::fmt::Debug for FluxBound<'a> {
         ds.field("id", &self.id());
         ds.field("reaction", &self.reaction());
         ds.field("operation", &self.operation());
+        ds.field("value", &self.value());
         ds.finish()
     }
 }
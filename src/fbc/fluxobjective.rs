@@ -15,6 +15,7 @@ use cxx::let_cxx_string;
 use crate::{
     clone,
     errors::LibSBMLError,
+    incremental::ChangeTracker,
     inner, optional_property, pin_ptr, sbmlcxx,
     traits::{fromptr::FromPtr, intoid::IntoId},
     upcast_annotation,
@@ -34,6 +35,9 @@ use super::objective::Objective;
 /// through a RefCell and Pin to ensure memory safety while allowing interior mutability.
 pub struct FluxObjective<'a> {
     inner: RefCell<Pin<&'a mut sbmlcxx::FluxObjective>>,
+    annotation_cache: AnnotationCache,
+    /// Marks the section of the document that contains this element
+    changes: ChangeTracker<'a>,
 }
 
 inner!(sbmlcxx::FluxObjective, FluxObjective<'a>);
@@ -87,6 +91,8 @@ impl<'a> FluxObjective<'a> {
 
         Ok(Self {
             inner: RefCell::new(flux_objective),
+            annotation_cache: AnnotationCache::default(),
+            changes: objective.changes(),
         })
     }
 
@@ -120,6 +126,8 @@ impl<'a> FromPtr<sbmlcxx::FluxObjective> for FluxObjective<'a> {
 
         Self {
             inner: RefCell::new(flux_objective),
+            annotation_cache: AnnotationCache::default(),
+            changes: ChangeTracker::default(),
         }
     }
 }
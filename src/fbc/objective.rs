@@ -13,8 +13,19 @@ use std::{cell::RefCell, pin::Pin, rc::Rc};
 use cxx::let_cxx_string;
 
 use crate::{
-    clone, errors::LibSBMLError, inner, model::Model, pin_ptr, plugin::get_plugin, prelude::IntoId,
-    required_property, sbmlcxx, traits::fromptr::FromPtr, upcast_annotation,
+    clone,
+    errors::LibSBMLError,
+    incremental::{ChangeTracker, Tracked},
+    index_key, inner,
+    lazy::{LazyList, ListIter},
+    memory::{self, MemoryUsage},
+    model::Model,
+    pin_ptr,
+    plugin::get_plugin,
+    prelude::IntoId,
+    required_property, sbmlcxx,
+    traits::fromptr::FromPtr,
+    upcast_annotation,
 };
 
 use super::{fluxobjective::FluxObjective, objectivetype::ObjectiveType};
@@ -31,7 +42,10 @@ use super::{fluxobjective::FluxObjective, objectivetype::ObjectiveType};
 /// It also maintains a collection of FluxObjective instances associated with this objective.
 pub struct Objective<'a> {
     inner: RefCell<Pin<&'a mut sbmlcxx::Objective>>,
-    list_of_flux_objective: RefCell<Vec<Rc<FluxObjective<'a>>>>,
+    annotation_cache: AnnotationCache,
+    /// Marks the section of the document that contains this element
+    changes: ChangeTracker<'a>,
+    list_of_flux_objective: LazyList<FluxObjective<'a>>,
 }
 
 // Set the inner trait for the Compartment struct
@@ -43,6 +57,9 @@ upcast_annotation!(Objective<'a>, sbmlcxx::Objective, sbmlcxx::SBase);
 // Implement the Clone trait for the Compartment struct
 clone!(Objective<'a>, sbmlcxx::Objective, list_of_flux_objective);
 
+// Index Objective collections by id
+index_key!(Objective<'_>, getId);
+
 impl<'a> Objective<'a> {
     /// Creates a new Objective instance within the given Model.
     ///
@@ -83,12 +100,21 @@ impl<'a> Objective<'a> {
 
         Ok(Self {
             inner: RefCell::new(objective),
-            list_of_flux_objective: RefCell::new(vec![]),
+            annotation_cache: AnnotationCache::default(),
+            changes: model.changes(),
+            list_of_flux_objective: LazyList::new(),
         })
     }
 
     // Setter and getter for id
-    required_property!(Objective<'a>, id, String, getId, setId);
+    required_property!(
+        Objective<'a>,
+        id,
+        String,
+        getId,
+        setId,
+        after_set = key_changed
+    );
 
     // Setter and getter for name
     required_property!(
@@ -119,9 +145,8 @@ impl<'a> Objective<'a> {
     ) -> Result<Rc<FluxObjective<'a>>, LibSBMLError> {
         let flux_objective = Rc::new(FluxObjective::new(self, id, reaction_id, coefficient)?);
 
-        self.list_of_flux_objective
-            .borrow_mut()
-            .push(Rc::clone(&flux_objective));
+        self.list_of_flux_objective.push(Rc::clone(&flux_objective));
+        flux_objective.mark_dirty();
         Ok(flux_objective)
     }
 
@@ -130,7 +155,14 @@ impl<'a> Objective<'a> {
     /// # Returns
     /// A vector containing Rc references to all FluxObjectives in this objective
     pub fn flux_objectives(&self) -> Vec<Rc<FluxObjective<'a>>> {
-        self.list_of_flux_objective.borrow().clone()
+        self.loaded_flux_objectives().borrow().clone()
+    }
+
+    /// Returns an iterator over the flux objectives of this objective.
+    ///
+    /// Unlike [`Objective::flux_objectives`], this does not copy the list.
+    pub fn flux_objectives_iter(&self) -> ListIter<'_, FluxObjective<'a>> {
+        ListIter::new(self.loaded_flux_objectives())
     }
 
     /// Retrieves a flux objective from this objective by its identifier.
@@ -141,29 +173,56 @@ impl<'a> Objective<'a> {
     /// # Returns
     /// Some(`Rc<FluxObjective>`) if found, None if not found
     pub fn get_flux_objective(&self, id: &str) -> Option<Rc<FluxObjective<'a>>> {
-        self.list_of_flux_objective
+        self.loaded_flux_objectives()
             .borrow()
             .iter()
-            .find(|flux_objective| (*flux_objective).id() == Some(id.to_string()))
+            .find(|flux_objective| flux_objective.with_id(|fid| fid == Some(id)))
             .map(Rc::clone)
     }
+
+    /// Returns the number of flux objectives of this objective.
+    pub fn num_flux_objectives(&self) -> usize {
+        self.loaded_flux_objectives().borrow().len()
+    }
+
+    /// Returns the position of the flux objective with the given identifier.
+    pub(crate) fn flux_objective_position(&self, id: &str) -> Option<usize> {
+        self.loaded_flux_objectives()
+            .borrow()
+            .iter()
+            .position(|flux_objective| flux_objective.with_id(|fid| fid == Some(id)))
+    }
+
+    /// Returns the flux objectives, wrapping them on first access.
+    fn loaded_flux_objectives(&self) -> &RefCell<Vec<Rc<FluxObjective<'a>>>> {
+        self.list_of_flux_objective.get_or_load(|| {
+            let n_flux_objectives = self.inner.borrow_mut().as_mut().getNumFluxObjectives().0;
+            (0..n_flux_objectives)
+                .map(|i| {
+                    let flux_objective =
+                        self.inner.borrow_mut().as_mut().getFluxObjective(i.into());
+                    Rc::new(FluxObjective::from_ptr(flux_objective).with_changes(self.changes))
+                })
+                .collect()
+        })
+    }
+
+    /// Reports the flux objective wrappers held by this objective.
+    pub(crate) fn wrapper_usage(&self) -> MemoryUsage {
+        self.list_of_flux_objective.memory_usage(memory::leaf)
+    }
 }
 
 impl<'a> FromPtr<sbmlcxx::Objective> for Objective<'a> {
     fn from_ptr(ptr: *mut sbmlcxx::Objective) -> Self {
-        let mut objective = pin_ptr!(ptr, sbmlcxx::Objective);
-        let n_flux_objectives = objective.as_mut().getNumFluxObjectives().0;
-        let list_of_flux_objectives: Vec<_> = (0..n_flux_objectives)
-            .map(|i| {
-                let flux_objective = objective.as_mut().getFluxObjective(i.into());
-                let flux_objective = Rc::new(FluxObjective::from_ptr(flux_objective));
-                Rc::clone(&flux_objective)
-            })
-            .collect();
+        let objective = pin_ptr!(ptr, sbmlcxx::Objective);
 
+        // Flux objectives are wrapped on first access
         Self {
             inner: RefCell::new(objective),
-            list_of_flux_objective: RefCell::new(list_of_flux_objectives),
+            annotation_cache: AnnotationCache::default(),
+            changes: ChangeTracker::default(),
+            list_of_flux_objective: LazyList::deferred(),
         }
     }
 }
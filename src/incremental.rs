@@ -0,0 +1,555 @@
+//! Dirty tracking and incremental serialization of documents.
+//!
+//! Editors that write a document after every small change spend most of the time
+//! serializing parts of the model that did not change. An [`IncrementalWriter`] keeps
+//! the output of its last write and the byte ranges of every `ListOf*` section of the
+//! model in it. Property setters, `set_annotation` and the `create_*` methods of all
+//! wrappers mark the section that contains their element, and the next write only
+//! serializes the marked sections again and copies everything else from the cached
+//! output. The result is byte-identical to [`SBMLDocument::to_xml_string`].
+//!
+//! ```no_run
+//! use sbml::prelude::*;
+//! use sbml::incremental::IncrementalWriter;
+//!
+//! let doc = SBMLReader::from_file("model.xml")?;
+//! let mut writer = IncrementalWriter::new(&doc);
+//! let _full = writer.to_xml_string();
+//!
+//! // Only the listOfParameters section is serialized again
+//! doc.model().unwrap().get_parameter("k1").unwrap().set_value(2.0);
+//! let _xml = writer.to_xml_string();
+//! # Ok::<(), Box<dyn std::error::Error>>(())
+//! ```
+//!
+//! Every document keeps one change counter per section of its model, and the
+//! wrappers obtained from it share a reference to these counters. Marking a section
+//! is a single increment of a counter, without any lookup or lock, and a writer only
+//! compares the counters with those of its last write. Any number of writers can
+//! follow the same document. Changes that do not go through the wrappers of this
+//! crate, such as level and version conversions, or through wrappers of detached
+//! elements, such as clones, are not tracked; call [`IncrementalWriter::invalidate`]
+//! after them.
+
+use std::{cell::Cell, ops::Range};
+
+use autocxx::c_uint;
+use cxx::let_cxx_string;
+use quick_xml::{events::Event, Reader};
+
+use crate::{instrument::trace_span, sbmlcxx, sbmldoc::SBMLDocument};
+
+/// Indentation level of the `ListOf*` children of the model, below `sbml` and `model`
+const SECTION_INDENT: u32 = 2;
+
+/// Number of [`ModelSection`]s
+const SECTIONS: usize = 9;
+
+/// All [`ModelSection`]s, in the order of their counters
+const ALL_SECTIONS: [ModelSection; SECTIONS] = [
+    ModelSection::Document,
+    ModelSection::UnitDefinitions,
+    ModelSection::Compartments,
+    ModelSection::Species,
+    ModelSection::Parameters,
+    ModelSection::Rules,
+    ModelSection::Reactions,
+    ModelSection::FluxBounds,
+    ModelSection::Objectives,
+];
+
+/// A part of a document that the wrappers mark as changed.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub(crate) enum ModelSection {
+    /// Everything outside of the model's lists, which requires a full write
+    Document,
+    UnitDefinitions,
+    Compartments,
+    Species,
+    Parameters,
+    Rules,
+    Reactions,
+    FluxBounds,
+    Objectives,
+}
+
+impl ModelSection {
+    /// Returns the section written as the list with the given qualified name.
+    fn from_list_name(name: &str) -> Option<Self> {
+        match name.rsplit(':').next()? {
+            "listOfUnitDefinitions" => Some(Self::UnitDefinitions),
+            "listOfCompartments" => Some(Self::Compartments),
+            "listOfSpecies" => Some(Self::Species),
+            "listOfParameters" => Some(Self::Parameters),
+            "listOfRules" => Some(Self::Rules),
+            "listOfReactions" => Some(Self::Reactions),
+            "listOfFluxBounds" => Some(Self::FluxBounds),
+            "listOfObjectives" => Some(Self::Objectives),
+            _ => None,
+        }
+    }
+}
+
+/// Native types whose changes mark a fixed section of the model.
+pub(crate) trait InSection {
+    /// The section that contains elements of this type
+    const SECTION: ModelSection;
+}
+
+macro_rules! in_section {
+    ($($cxx_type:ty => $section:ident),+ $(,)?) => {
+        $(
+            impl InSection for $cxx_type {
+                const SECTION: ModelSection = ModelSection::$section;
+            }
+        )+
+    };
+}
+
+in_section!(
+    sbmlcxx::Model => Document,
+    sbmlcxx::ListOfUnitDefinitions => UnitDefinitions,
+    sbmlcxx::UnitDefinition => UnitDefinitions,
+    sbmlcxx::Unit => UnitDefinitions,
+    sbmlcxx::ListOfCompartments => Compartments,
+    sbmlcxx::Compartment => Compartments,
+    sbmlcxx::ListOfSpecies => Species,
+    sbmlcxx::Species => Species,
+    sbmlcxx::ListOfParameters => Parameters,
+    sbmlcxx::Parameter => Parameters,
+    sbmlcxx::ListOfRules => Rules,
+    sbmlcxx::Rule => Rules,
+    sbmlcxx::ListOfReactions => Reactions,
+    sbmlcxx::Reaction => Reactions,
+    sbmlcxx::SpeciesReference => Reactions,
+    sbmlcxx::ModifierSpeciesReference => Reactions,
+    sbmlcxx::KineticLaw => Reactions,
+    sbmlcxx::LocalParameter => Reactions,
+    sbmlcxx::FluxBound => FluxBounds,
+    sbmlcxx::Objective => Objectives,
+    sbmlcxx::FluxObjective => Objectives,
+);
+
+/// Change counters of a document, one per [`ModelSection`].
+///
+/// Owned by the [`SBMLDocument`] and shared with its wrappers through
+/// [`ChangeTracker`]s.
+#[derive(Debug, Default)]
+pub(crate) struct ChangeLog {
+    generations: [Cell<u64>; SECTIONS],
+    /// Counts changes of the keys that collections index their elements by, see
+    /// [`IndexKey::key_generation`](crate::lazy::IndexKey::key_generation)
+    keys: Cell<u64>,
+}
+
+impl ChangeLog {
+    /// Returns a tracker that records changes in this log.
+    pub(crate) fn tracker(&self) -> ChangeTracker<'_> {
+        ChangeTracker(Some(self))
+    }
+
+    /// Returns the current counter of every section.
+    fn generations(&self) -> [u64; SECTIONS] {
+        std::array::from_fn(|i| self.generations[i].get())
+    }
+}
+
+/// Handle through which a wrapper marks its section of the document as changed.
+///
+/// Wrappers of elements that are not part of a document, or that were created
+/// from a raw pointer without a parent, hold an empty tracker that records nothing.
+#[derive(Debug, Clone, Copy, Default)]
+pub(crate) struct ChangeTracker<'a>(Option<&'a ChangeLog>);
+
+impl ChangeTracker<'_> {
+    /// Records a change in the given section.
+    #[inline]
+    pub(crate) fn mark(self, section: ModelSection) {
+        if let Some(log) = self.0 {
+            let generation = &log.generations[section as usize];
+            generation.set(generation.get().wrapping_add(1));
+        }
+    }
+
+    /// Records a change of the key of an element, such as its id.
+    #[inline]
+    pub(crate) fn mark_key(self) {
+        if let Some(log) = self.0 {
+            log.keys.set(log.keys.get().wrapping_add(1));
+        }
+    }
+
+    /// Returns the number of key changes recorded so far, or zero for an empty tracker.
+    #[inline]
+    pub(crate) fn key_generation(self) -> u64 {
+        self.0.map_or(0, |log| log.keys.get())
+    }
+}
+
+/// Wrappers whose changes mark the section of the model that contains them.
+///
+/// Implemented for all wrappers by [`upcast_annotation!`](crate::upcast_annotation).
+pub(crate) trait Tracked {
+    /// Marks the section of the model that contains this element as changed.
+    fn mark_dirty(&self);
+}
+
+/// A section of the cached output
+#[derive(Debug, Clone)]
+struct Section {
+    /// Qualified element name of the list, e.g. `listOfSpecies` or `fbc:listOfFluxBounds`
+    name: String,
+    /// The part of the model written in this list, if the wrappers mark it
+    section: Option<ModelSection>,
+    /// Byte range of the section, including the line break and indentation in front
+    range: Range<usize>,
+}
+
+/// Output of the last write, split into sections
+#[derive(Debug)]
+struct Cache {
+    xml: String,
+    sections: Vec<Section>,
+}
+
+/// Serializes a document, reusing the output of unchanged sections of its model.
+///
+/// The writer borrows the document for its lifetime and compares the document's
+/// change counters with those it saw at its last write.
+pub struct IncrementalWriter<'d> {
+    /// The document being written
+    document: &'d SBMLDocument,
+    /// Change counters of the document at the last write
+    seen: [u64; SECTIONS],
+    /// Output of the last write
+    cache: Option<Cache>,
+}
+
+impl<'d> IncrementalWriter<'d> {
+    /// Creates a writer for a document.
+    ///
+    /// The first write is always a full write.
+    pub fn new(document: &'d SBMLDocument) -> Self {
+        Self {
+            document,
+            seen: document.changes().generations(),
+            cache: None,
+        }
+    }
+
+    /// Serializes the document to an SBML XML string.
+    ///
+    /// Sections of the model that were not marked since the last write are copied from
+    /// the previous output, marked sections are serialized again. If the changes cannot
+    /// be confined to the model's lists, the whole document is written.
+    ///
+    /// # Returns
+    /// The document as XML, byte-identical to [`SBMLDocument::to_xml_string`]
+    pub fn to_xml_string(&mut self) -> String {
+        let dirty = self.take_dirty();
+        let xml = match self.cache.as_ref() {
+            Some(cache) if !dirty.contains(&ModelSection::Document) => self.rewrite(cache, &dirty),
+            _ => None,
+        };
+
+        let cache = match xml {
+            Some(cache) => cache,
+            None => {
+                trace_span!("incremental_full_write");
+                let xml = self.document.to_xml_string();
+                let sections = index_sections(&xml);
+                Cache { xml, sections }
+            }
+        };
+
+        let xml = cache.xml.clone();
+        self.cache = Some(cache);
+        xml
+    }
+
+    /// Discards the cached output, so that the next write is a full write.
+    ///
+    /// Use this after changing the document by means that are not tracked.
+    pub fn invalidate(&mut self) {
+        self.cache = None;
+    }
+
+    /// Returns whether changes to the document were recorded since the last write.
+    pub fn is_dirty(&self) -> bool {
+        self.document.changes().generations() != self.seen
+    }
+
+    /// Returns the sections changed since the last write and marks them as seen.
+    fn take_dirty(&mut self) -> Vec<ModelSection> {
+        let current = self.document.changes().generations();
+        let dirty = ALL_SECTIONS
+            .into_iter()
+            .filter(|&section| current[section as usize] != self.seen[section as usize])
+            .collect();
+        self.seen = current;
+        dirty
+    }
+
+    /// Builds the new output from the cache, serializing only the dirty sections.
+    ///
+    /// # Returns
+    /// The new output, or None if a dirty section is not part of the cached output
+    /// or can no longer be written on its own
+    fn rewrite(&self, cache: &Cache, dirty: &[ModelSection]) -> Option<Cache> {
+        if dirty.is_empty() {
+            return Some(Cache {
+                xml: cache.xml.clone(),
+                sections: cache.sections.clone(),
+            });
+        }
+        if !dirty.iter().all(|&marked| {
+            cache
+                .sections
+                .iter()
+                .any(|section| section.section == Some(marked))
+        }) {
+            return None;
+        }
+
+        trace_span!("incremental_write", sections = dirty.len());
+        let model = self.document.model()?;
+        let model = model.inner().borrow();
+
+        let mut xml = String::with_capacity(cache.xml.len());
+        let mut sections = Vec::with_capacity(cache.sections.len());
+        let mut copied = 0;
+        for section in &cache.sections {
+            xml.push_str(&cache.xml[copied..section.range.start]);
+            let start = xml.len();
+            if section
+                .section
+                .is_some_and(|marked| dirty.contains(&marked))
+            {
+                let_cxx_string!(name = &section.name);
+                let written =
+                    sbmlcxx::sbmlrs::writeModelSection(&model, &name, c_uint(SECTION_INDENT));
+                let written = written
+                    .to_str()
+                    .ok()
+                    .filter(|written| !written.is_empty())?;
+                xml.push_str(written);
+            } else {
+                xml.push_str(&cache.xml[section.range.clone()]);
+            }
+            sections.push(Section {
+                name: section.name.clone(),
+                section: section.section,
+                range: start..xml.len(),
+            });
+            copied = section.range.end;
+        }
+        xml.push_str(&cache.xml[copied..]);
+
+        Some(Cache { xml, sections })
+    }
+}
+
+impl std::fmt::Debug for IncrementalWriter<'_> {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        let mut ds = f.debug_struct("IncrementalWriter");
+        ds.field("cached", &self.cache.is_some());
+        ds.field("dirty", &self.is_dirty());
+        ds.finish()
+    }
+}
+
+/// Finds the byte ranges of the `ListOf*` children of the model in a written document.
+///
+/// Every range starts with the line break and indentation in front of the list's
+/// start tag, which is where the output of `sbmlrs::writeModelSection` starts. If the
+/// output does not have this layout, no sections are returned and every write is a
+/// full write.
+fn index_sections(xml: &str) -> Vec<Section> {
+    let mut reader = Reader::from_str(xml);
+    let mut sections = Vec::new();
+    let mut depth = 0usize;
+    let mut open: Option<(String, usize)> = None;
+
+    loop {
+        let before = reader.buffer_position() as usize;
+        let event = match reader.read_event() {
+            Ok(Event::Eof) | Err(_) => break,
+            Ok(event) => event,
+        };
+        let after = reader.buffer_position() as usize;
+
+        match event {
+            Event::Start(element) => {
+                depth += 1;
+                if depth == 3 && element.local_name().as_ref().starts_with(b"listOf") {
+                    let name = String::from_utf8_lossy(element.name().as_ref()).into_owned();
+                    open = Some((name, before));
+                }
+            }
+            Event::Empty(element) => {
+                if depth == 2 && element.local_name().as_ref().starts_with(b"listOf") {
+                    let name = String::from_utf8_lossy(element.name().as_ref()).into_owned();
+                    sections.push((name, before..after));
+                }
+            }
+            Event::End(_) => {
+                if depth == 3 {
+                    if let Some((name, start)) = open.take() {
+                        sections.push((name, start..after));
+                    }
+                }
+                depth = depth.saturating_sub(1);
+            }
+            _ => {}
+        }
+    }
+
+    let mut indexed = Vec::with_capacity(sections.len());
+    for (name, range) in sections {
+        let indent = xml[..range.start].len() - xml[..range.start].trim_end_matches(' ').len();
+        let start = range.start - indent;
+        if indent != 2 * SECTION_INDENT as usize || !xml[..start].ends_with('\n') {
+            return Vec::new();
+        }
+        indexed.push(Section {
+            section: ModelSection::from_list_name(&name),
+            name,
+            range: start - 1..range.end,
+        });
+    }
+    indexed
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::prelude::*;
+
+    fn document() -> SBMLDocument {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("incremental");
+        model.create_compartment("cytosol");
+        for id in ["glucose", "g6p"] {
+            model
+                .build_species(id)
+                .compartment("cytosol")
+                .initial_concentration(1.0)
+                .build();
+        }
+        model.build_parameter("k1").value(0.5).build();
+        let reaction = model.create_reaction("r1");
+        reaction.create_reactant("glucose", 1.0);
+        reaction.create_product("g6p", 1.0);
+        reaction.create_kinetic_law("k1 * glucose");
+        model
+            .create_flux_bound("fb", "r1", FluxBoundOperation::LessEqual)
+            .unwrap();
+        doc
+    }
+
+    #[test]
+    fn test_index_sections() {
+        let doc = document();
+        let xml = doc.to_xml_string();
+        let sections = index_sections(&xml);
+        let names: Vec<&str> = sections
+            .iter()
+            .map(|section| section.name.as_str())
+            .collect();
+        assert!(names.contains(&"listOfSpecies"));
+        assert!(names.contains(&"listOfReactions"));
+        assert!(names.contains(&"fbc:listOfFluxBounds"));
+        for section in &sections {
+            assert!(xml[section.range.clone()].starts_with("\n    <"));
+        }
+    }
+
+    #[test]
+    fn test_incremental_matches_full_write() {
+        let doc = document();
+        let model = doc.model().unwrap();
+        let mut writer = IncrementalWriter::new(&doc);
+        assert_eq!(writer.to_xml_string(), doc.to_xml_string());
+        assert!(!writer.is_dirty());
+
+        model
+            .get_species("glucose")
+            .unwrap()
+            .set_initial_concentration(2.0);
+        assert!(writer.is_dirty());
+        assert_eq!(writer.to_xml_string(), doc.to_xml_string());
+
+        model
+            .get_parameter("k1")
+            .unwrap()
+            .set_annotation("<data xmlns=\"https://example.org\">1</data>")
+            .unwrap();
+        model.create_species("atp");
+        assert_eq!(writer.to_xml_string(), doc.to_xml_string());
+
+        let reaction = model.get_reaction("r1").unwrap();
+        reaction.create_modifier("atp");
+        model.get_flux_bound("fb").unwrap().set_value(10.0);
+        assert_eq!(writer.to_xml_string(), doc.to_xml_string());
+
+        // Changes outside of the lists fall back to a full write
+        model.set_name("renamed");
+        assert!(writer.is_dirty());
+        assert_eq!(writer.to_xml_string(), doc.to_xml_string());
+        model.set_id("renamed_model");
+        assert!(writer.is_dirty());
+        assert_eq!(writer.to_xml_string(), doc.to_xml_string());
+
+        // A list written for the first time is not part of the cached output
+        model.create_rate_rule("g6p", "k1");
+        assert_eq!(writer.to_xml_string(), doc.to_xml_string());
+    }
+
+    #[test]
+    fn test_several_writers() {
+        let doc = document();
+        let model = doc.model().unwrap();
+        let species = model.get_species("glucose").unwrap();
+
+        // Changes before a writer exists are part of its first, full write
+        species.set_initial_concentration(3.0);
+
+        let mut first = IncrementalWriter::new(&doc);
+        let mut second = IncrementalWriter::new(&doc);
+        first.to_xml_string();
+        second.to_xml_string();
+
+        species.set_initial_concentration(4.0);
+        assert_eq!(first.to_xml_string(), doc.to_xml_string());
+        assert!(!first.is_dirty());
+        assert!(second.is_dirty());
+        drop(first);
+        assert_eq!(second.to_xml_string(), doc.to_xml_string());
+    }
+
+    #[test]
+    fn test_marks_stay_on_the_document() {
+        let doc = document();
+        let other = document();
+        let mut writer = IncrementalWriter::new(&doc);
+        writer.to_xml_string();
+
+        // Changes to another document or to a detached clone do not mark this one
+        other
+            .model()
+            .unwrap()
+            .get_parameter("k1")
+            .unwrap()
+            .set_value(2.0);
+        let parameter = doc.model().unwrap().get_parameter("k1").unwrap();
+        let clone = Parameter::clone(&parameter);
+        clone.set_value(3.0);
+        assert!(!writer.is_dirty());
+
+        // Wrappers reached through any path share the document's counters
+        let model = doc.model().unwrap();
+        model.list_of_reactions()[0].reactants().borrow()[0].set_stoichiometry(2.0);
+        assert!(writer.is_dirty());
+        assert_eq!(writer.to_xml_string(), doc.to_xml_string());
+    }
+}
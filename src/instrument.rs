@@ -0,0 +1,139 @@
+//! Optional instrumentation of the hot paths of the crate.
+//!
+//! With the `tracing` feature enabled, parsing, model wrapping, serialization,
+//! consistency checking, plugin lookups and COMBINE archive operations emit
+//! [`tracing`](https://docs.rs/tracing) spans at debug level under the `sbml` target.
+//! Spans carry the number of bytes read or written where applicable, so that
+//! subscribers such as `tracing-subscriber` or `tracing-timing` can report timings
+//! and throughput.
+//!
+//! In addition, the crate counts FFI calls made by property accessors and collection
+//! loaders, as well as the number of wrappers it allocates. The counters are global
+//! and can be read with [`metrics`]:
+//!
+//! ```ignore
+//! use sbml::{instrument, prelude::*};
+//!
+//! instrument::reset_metrics();
+//! let doc = SBMLReader::from_file("model.xml")?;
+//! let n_species = doc.model().map_or(0, |model| model.list_of_species().len());
+//! println!("{n_species} species, {:?}", instrument::metrics());
+//! ```
+//!
+//! Without the feature, all spans and counters compile to nothing.
+
+#[cfg(feature = "tracing")]
+use std::sync::atomic::{AtomicU64, Ordering};
+
+/// Enters a debug span that lasts until the end of the enclosing block.
+#[cfg(feature = "tracing")]
+macro_rules! trace_span {
+    ($name:literal $(, $($fields:tt)+)?) => {
+        let _span = ::tracing::debug_span!(target: "sbml", $name $(, $($fields)+)?).entered();
+    };
+}
+
+#[cfg(not(feature = "tracing"))]
+macro_rules! trace_span {
+    ($($tokens:tt)*) => {};
+}
+
+/// Emits a debug event within the current span.
+#[cfg(feature = "tracing")]
+macro_rules! trace_event {
+    ($($tokens:tt)+) => {
+        ::tracing::debug!(target: "sbml", $($tokens)+)
+    };
+}
+
+#[cfg(not(feature = "tracing"))]
+macro_rules! trace_event {
+    ($($tokens:tt)*) => {};
+}
+
+pub(crate) use trace_event;
+pub(crate) use trace_span;
+
+#[cfg(feature = "tracing")]
+static FFI_CALLS: AtomicU64 = AtomicU64::new(0);
+#[cfg(feature = "tracing")]
+static WRAPPERS: AtomicU64 = AtomicU64::new(0);
+
+/// A snapshot of the global instrumentation counters.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct Metrics {
+    /// Number of FFI calls made by property accessors and collection loaders
+    pub ffi_calls: u64,
+    /// Number of element wrappers allocated
+    pub wrappers: u64,
+}
+
+/// Returns the current values of the instrumentation counters.
+///
+/// Without the `tracing` feature, all counters are zero.
+pub fn metrics() -> Metrics {
+    #[cfg(feature = "tracing")]
+    {
+        Metrics {
+            ffi_calls: FFI_CALLS.load(Ordering::Relaxed),
+            wrappers: WRAPPERS.load(Ordering::Relaxed),
+        }
+    }
+    #[cfg(not(feature = "tracing"))]
+    {
+        Metrics::default()
+    }
+}
+
+/// Resets all instrumentation counters to zero.
+pub fn reset_metrics() {
+    #[cfg(feature = "tracing")]
+    {
+        FFI_CALLS.store(0, Ordering::Relaxed);
+        WRAPPERS.store(0, Ordering::Relaxed);
+    }
+}
+
+/// Records FFI calls into libSBML.
+///
+/// This is public because the property macros expand to calls of it.
+#[doc(hidden)]
+#[inline(always)]
+pub fn record_ffi_calls(_n: usize) {
+    #[cfg(feature = "tracing")]
+    FFI_CALLS.fetch_add(_n as u64, Ordering::Relaxed);
+}
+
+/// Records the allocation of element wrappers.
+#[inline(always)]
+pub(crate) fn record_wrappers(_n: usize) {
+    #[cfg(feature = "tracing")]
+    WRAPPERS.fetch_add(_n as u64, Ordering::Relaxed);
+}
+
+#[cfg(all(test, feature = "tracing"))]
+mod tests {
+    use super::*;
+    use crate::prelude::*;
+
+    #[test]
+    fn test_counters() {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("test");
+        model.create_species("s1");
+        model.create_species("s2");
+
+        let xml = doc.to_xml_string();
+        let doc = SBMLReader::from_xml_string(&xml);
+
+        let before = metrics();
+        let model = doc.model().unwrap();
+        let ids: Vec<String> = model.list_of_species().iter().map(|s| s.id()).collect();
+        let after = metrics();
+
+        // Tests run concurrently, so other tests may have bumped the counters as well
+        assert_eq!(ids, vec!["s1", "s2"]);
+        assert!(after.wrappers >= before.wrappers + 2);
+        assert!(after.ffi_calls >= before.ffi_calls + 2);
+    }
+}
@@ -18,7 +18,14 @@ use std::{cell::RefCell, pin::Pin, rc::Rc};
 use cxx::let_cxx_string;
 
 use crate::{
-    clone, inner, pin_ptr,
+    clone,
+    dependency::ChangeHook,
+    incremental::{ChangeTracker, Tracked},
+    inner,
+    lazy::{LazyList, ListIter},
+    math::ASTNode,
+    memory::{self, MemoryUsage},
+    pin_ptr,
     prelude::{LocalParameter, LocalParameterBuilder, Reaction},
     required_property, sbase, sbmlcxx, sbo_term,
     traits::fromptr::FromPtr,
@@ -35,7 +42,12 @@ use crate::{
 /// enzymatic rate laws.
 pub struct KineticLaw<'a> {
     inner: RefCell<Pin<&'a mut sbmlcxx::KineticLaw>>,
-    local_parameters: RefCell<Vec<Rc<LocalParameter<'a>>>>,
+    annotation_cache: AnnotationCache,
+    /// Marks the section of the document that contains this element
+    changes: ChangeTracker<'a>,
+    local_parameters: LazyList<LocalParameter<'a>>,
+    /// Reports changes to the dependency graph of the model of the parent reaction
+    dependencies: Option<ChangeHook>,
 }
 
 // Set the inner trait for the KineticLaw struct
@@ -48,7 +60,12 @@ sbase!(KineticLaw<'a>, sbmlcxx::KineticLaw);
 upcast_annotation!(KineticLaw<'a>, sbmlcxx::KineticLaw, sbmlcxx::SBase);
 
 // Implement the Clone trait for the KineticLaw struct
-clone!(KineticLaw<'a>, sbmlcxx::KineticLaw, local_parameters);
+clone!(
+    KineticLaw<'a>,
+    sbmlcxx::KineticLaw,
+    local_parameters,
+    dependencies
+);
 
 impl<'a> KineticLaw<'a> {
     /// Creates a new KineticLaw instance for the given Reaction.
@@ -73,12 +90,53 @@ impl<'a> KineticLaw<'a> {
 
         Self {
             inner: RefCell::new(kinetic_law),
-            local_parameters: RefCell::new(vec![]),
+            annotation_cache: AnnotationCache::default(),
+            changes: reaction.changes(),
+            local_parameters: LazyList::new(),
+            dependencies: reaction.dependency_hook(),
+        }
+    }
+
+    /// Attaches a kinetic law wrapped from the native model to the dependency graph
+    /// of the parent reaction's model.
+    pub(crate) fn tracked_by(mut self, reaction: &Reaction<'a>) -> Self {
+        self.dependencies = reaction.dependency_hook();
+        self
+    }
+
+    /// Reports a change of the math or the local parameters to the dependency graph.
+    fn notify_dependencies(&self) {
+        if let Some(hook) = &self.dependencies {
+            hook.notify();
         }
     }
 
     // Getter and setter for formula
-    required_property!(KineticLaw<'a>, formula, String, getFormula, setFormula);
+    required_property!(
+        KineticLaw<'a>,
+        formula,
+        String,
+        getFormula,
+        setFormula,
+        after_set = notify_dependencies
+    );
+
+    /// Runs `f` with a read-only view on the math of the kinetic law.
+    ///
+    /// The kinetic law stays borrowed while `f` runs, so the math tree cannot be replaced,
+    /// and thereby freed, while the view is in use. Calling a setter of the kinetic law
+    /// from within `f` panics.
+    ///
+    /// # Arguments
+    /// * `f` - The function to run with the root node of the math tree, or None if
+    ///   no math is set
+    ///
+    /// # Returns
+    /// The result of `f`
+    pub fn with_math<R>(&self, f: impl FnOnce(Option<ASTNode<'_>>) -> R) -> R {
+        let inner = self.inner.borrow();
+        f(ASTNode::from_ptr(inner.getMath()))
+    }
 
     /// Gets the local parameters of the kinetic law.
     ///
@@ -89,7 +147,31 @@ impl<'a> KineticLaw<'a> {
     /// # Returns
     /// A vector of LocalParameter instances representing the local parameters of the kinetic law.
     pub fn local_parameters(&self) -> Vec<Rc<LocalParameter<'a>>> {
-        self.local_parameters.borrow().to_vec()
+        self.loaded_local_parameters().borrow().to_vec()
+    }
+
+    /// Returns an iterator over the local parameters of the kinetic law.
+    ///
+    /// Unlike [`KineticLaw::local_parameters`], this does not copy the list.
+    pub fn local_parameters_iter(&self) -> ListIter<'_, LocalParameter<'a>> {
+        ListIter::new(self.loaded_local_parameters())
+    }
+
+    /// Returns the local parameters, wrapping them on first access.
+    fn loaded_local_parameters(&self) -> &RefCell<Vec<Rc<LocalParameter<'a>>>> {
+        self.local_parameters.get_or_load(|| {
+            let n_local_parameters = self.inner.borrow().getNumLocalParameters().0;
+            (0..n_local_parameters)
+                .map(|i| {
+                    let local_parameter = self
+                        .inner
+                        .borrow_mut()
+                        .as_mut()
+                        .getLocalParameter1(i.into());
+                    Rc::new(LocalParameter::from_ptr(local_parameter).with_changes(self.changes))
+                })
+                .collect()
+        })
     }
 
     /// Adds a local parameter to the kinetic law.
@@ -110,9 +192,9 @@ impl<'a> KineticLaw<'a> {
             local_parameter.set_value(value);
         }
 
-        self.local_parameters
-            .borrow_mut()
-            .push(Rc::clone(&local_parameter));
+        self.local_parameters.push(Rc::clone(&local_parameter));
+        local_parameter.mark_dirty();
+        self.notify_dependencies();
 
         local_parameter
     }
@@ -129,7 +211,19 @@ impl<'a> KineticLaw<'a> {
     /// # Returns
     /// A LocalParameterBuilder instance that can be used to configure and create the LocalParameter
     pub fn build_local_parameter(&self, id: &str) -> LocalParameterBuilder<'a> {
-        LocalParameterBuilder::new(self, id)
+        let builder = LocalParameterBuilder::new(self, id);
+        self.mark_dirty();
+        self.notify_dependencies();
+        builder
+    }
+
+    /// Reports the memory held by this kinetic law.
+    ///
+    /// Covers the native object tree of the kinetic law and the local parameter
+    /// wrappers it holds. See [`MemoryUsage`] for details.
+    pub fn memory_usage(&self) -> MemoryUsage {
+        let base = crate::upcast!(self, sbmlcxx::KineticLaw, sbmlcxx::SBase);
+        MemoryUsage::native(&base) + self.local_parameters.memory_usage(memory::leaf)
     }
 
     // SBO Term Methods generated by the `sbo_term` macro
@@ -148,18 +242,15 @@ impl FromPtr<sbmlcxx::KineticLaw> for KineticLaw<'_> {
     /// # Returns
     /// A new KineticLaw instance wrapping the provided pointer
     fn from_ptr(ptr: *mut sbmlcxx::KineticLaw) -> Self {
-        let mut kinetic_law = pin_ptr!(ptr, sbmlcxx::KineticLaw);
-        let n_local_parameters = kinetic_law.as_mut().getNumLocalParameters().0;
-        let local_parameters: Vec<_> = (0..n_local_parameters)
-            .map(|i| {
-                let local_parameter = kinetic_law.as_mut().getLocalParameter1(i.into());
-                Rc::new(LocalParameter::from_ptr(local_parameter))
-            })
-            .collect();
+        let kinetic_law = pin_ptr!(ptr, sbmlcxx::KineticLaw);
 
+        // Local parameters are wrapped on first access
         Self {
             inner: RefCell::new(kinetic_law),
-            local_parameters: RefCell::new(local_parameters),
+            annotation_cache: AnnotationCache::default(),
+            changes: ChangeTracker::default(),
+            local_parameters: LazyList::deferred(),
+            dependencies: None,
         }
     }
 }
@@ -0,0 +1,464 @@
+//! Lazily populated collections of wrapper types.
+//!
+//! Wrappers such as [`Model`](crate::model::Model) or [`Reaction`](crate::reaction::Reaction)
+//! keep their child elements in reference-counted vectors. Building all of them eagerly
+//! when a document is read means one FFI round trip and one allocation per element, even
+//! if the caller only ever looks at a handful of them. [`LazyList`] defers that work until
+//! the collection is first accessed.
+//!
+//! Collections of elements that carry an identifier additionally maintain an id→position
+//! index, so that lookups by id do not have to compare every element across the FFI
+//! boundary. Wrappers report changes of their id to the change log of their document,
+//! which lets a collection trust its index for ids that are absent.
+
+use std::{
+    cell::{Cell, RefCell},
+    collections::HashMap,
+    rc::Rc,
+};
+
+use crate::{
+    instrument::{self, trace_span},
+    memory::{self, MemoryUsage},
+};
+
+/// Elements that are identified by the native object they wrap.
+pub(crate) trait NativeAddress {
+    /// Returns the address of the native object, see
+    /// [`address_of`](crate::dependency::address_of).
+    fn native_address(&self) -> usize;
+}
+
+/// Elements that can be looked up by a string key, usually their SBML id.
+pub(crate) trait IndexKey {
+    /// Returns the key under which the element is indexed, or `None` if it has none.
+    fn index_key(&self) -> Option<String>;
+
+    /// Returns whether the element currently has the given key.
+    ///
+    /// Implementations compare against the native string directly, without allocating.
+    fn matches_key(&self, key: &str) -> bool;
+
+    /// Returns a counter that changes whenever the key of an element of the same
+    /// document changes.
+    fn key_generation(&self) -> u64;
+}
+
+/// A vector of wrappers that is filled from the native object on first access.
+///
+/// Lists created for freshly constructed elements start out loaded (and empty), while
+/// lists of elements wrapped from an existing native pointer start out unloaded and are
+/// populated by the loader passed to [`LazyList::get_or_load`]. Elements created while
+/// the list is unloaded are kept aside and take the place of the wrappers the loader
+/// builds for the same native objects, so that every element has a single wrapper.
+pub(crate) struct LazyList<T> {
+    loaded: Cell<bool>,
+    items: RefCell<Vec<Rc<T>>>,
+    /// Elements pushed before the list was populated
+    pending: RefCell<Vec<Rc<T>>>,
+    /// Maps keys to positions in `items`, see [`LazyList::find`]
+    index: RefCell<HashMap<String, usize>>,
+    /// Number of leading items that have been added to `index`
+    indexed: Cell<usize>,
+    /// Key generation of the items when `index` was built from scratch
+    key_generation: Cell<u64>,
+}
+
+impl<T> LazyList<T> {
+    /// Creates an empty list that is already considered loaded.
+    pub(crate) fn new() -> Self {
+        Self {
+            loaded: Cell::new(true),
+            items: RefCell::new(Vec::new()),
+            pending: RefCell::new(Vec::new()),
+            index: RefCell::new(HashMap::new()),
+            indexed: Cell::new(0),
+            key_generation: Cell::new(0),
+        }
+    }
+
+    /// Creates a list whose content will be fetched on first access.
+    pub(crate) fn deferred() -> Self {
+        Self {
+            loaded: Cell::new(false),
+            items: RefCell::new(Vec::new()),
+            pending: RefCell::new(Vec::new()),
+            index: RefCell::new(HashMap::new()),
+            indexed: Cell::new(0),
+            key_generation: Cell::new(0),
+        }
+    }
+
+    /// Returns whether the list has been populated.
+    #[allow(dead_code)]
+    pub(crate) fn is_loaded(&self) -> bool {
+        self.loaded.get()
+    }
+
+    /// Appends a newly created element.
+    ///
+    /// If the list has not been populated yet, the element is kept aside until the
+    /// loader picks up its native object together with all other elements.
+    pub(crate) fn push(&self, item: Rc<T>) {
+        instrument::record_wrappers(1);
+        if self.loaded.get() {
+            self.items.borrow_mut().push(item);
+        } else {
+            self.pending.borrow_mut().push(item);
+        }
+    }
+
+    /// Appends a batch of newly created elements, growing the vector at most once.
+    ///
+    /// Like [`LazyList::push`], the elements are kept aside if the list has not been
+    /// populated yet.
+    pub(crate) fn extend(&self, items: &[Rc<T>]) {
+        instrument::record_wrappers(items.len());
+        let mut stored = if self.loaded.get() {
+            self.items.borrow_mut()
+        } else {
+            self.pending.borrow_mut()
+        };
+        stored.reserve(items.len());
+        stored.extend(items.iter().cloned());
+    }
+
+    /// Reports the wrappers held by the list and the size of its vector and index.
+    ///
+    /// Does not populate the list. `children` reports the collections held by each
+    /// wrapper.
+    pub(crate) fn memory_usage(&self, children: impl Fn(&T) -> MemoryUsage) -> MemoryUsage {
+        let items = self.items.borrow();
+        let pending = self.pending.borrow();
+        let mut usage: MemoryUsage = items
+            .iter()
+            .chain(pending.iter())
+            .map(|item| MemoryUsage::wrapper::<T>() + children(item))
+            .sum();
+        usage.wrapper_bytes += memory::vec_bytes(&*items)
+            + memory::vec_bytes(&*pending)
+            + memory::string_map_bytes(&*self.index.borrow());
+        usage
+    }
+}
+
+/// An iterator over the elements of a collection that does not copy the collection.
+///
+/// The collection is borrowed only while an element is fetched, so elements may be
+/// added while iterating. Elements appended before the iterator reaches the end of the
+/// collection are yielded as well.
+pub struct ListIter<'l, T> {
+    items: &'l RefCell<Vec<Rc<T>>>,
+    position: usize,
+}
+
+impl<'l, T> ListIter<'l, T> {
+    /// Creates an iterator starting at the first element of `items`.
+    pub(crate) fn new(items: &'l RefCell<Vec<Rc<T>>>) -> Self {
+        Self { items, position: 0 }
+    }
+}
+
+impl<T> Iterator for ListIter<'_, T> {
+    type Item = Rc<T>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        let item = self.items.borrow().get(self.position).cloned()?;
+        self.position += 1;
+        Some(item)
+    }
+
+    fn size_hint(&self) -> (usize, Option<usize>) {
+        let remaining = self.items.borrow().len().saturating_sub(self.position);
+        (remaining, None)
+    }
+}
+
+impl<T: NativeAddress> LazyList<T> {
+    /// Returns the underlying vector, running `load` first if the list is not populated yet.
+    ///
+    /// Wrappers built by `load` for elements that were pushed before are replaced by
+    /// the pushed wrappers.
+    pub(crate) fn get_or_load(&self, load: impl FnOnce() -> Vec<Rc<T>>) -> &RefCell<Vec<Rc<T>>> {
+        if !self.loaded.get() {
+            trace_span!("wrap_collection", collection = std::any::type_name::<T>());
+            let mut items = load();
+            instrument::record_wrappers(items.len());
+            instrument::record_ffi_calls(items.len());
+
+            let pending = self.pending.take();
+            if !pending.is_empty() {
+                let mut pending: HashMap<usize, Rc<T>> = pending
+                    .into_iter()
+                    .map(|item| (item.native_address(), item))
+                    .collect();
+                for item in items.iter_mut() {
+                    if let Some(pushed) = pending.remove(&item.native_address()) {
+                        *item = pushed;
+                    }
+                }
+            }
+
+            self.items.replace(items);
+            self.index.borrow_mut().clear();
+            self.indexed.set(0);
+            self.loaded.set(true);
+        }
+        &self.items
+    }
+}
+
+impl<T: IndexKey + NativeAddress> LazyList<T> {
+    /// Looks up an element by key, running `load` first if the list is not populated yet.
+    ///
+    /// Elements are added to the index the first time a lookup is made after they were
+    /// pushed or loaded, so interleaving `push` and `find` stays linear overall. Since
+    /// an element's id may be changed after it has been indexed, every hit is verified
+    /// against the element. A miss is trusted as long as no key of the document has
+    /// changed since the index was built; otherwise the index is rebuilt once. If
+    /// several elements share a key, the first one wins.
+    pub(crate) fn find(&self, key: &str, load: impl FnOnce() -> Vec<Rc<T>>) -> Option<Rc<T>> {
+        let position = self.position(key, load)?;
+        self.items.borrow().get(position).cloned()
+    }
+
+    /// Returns the position of an element by key, like [`LazyList::find`].
+    pub(crate) fn position(&self, key: &str, load: impl FnOnce() -> Vec<Rc<T>>) -> Option<usize> {
+        let items = self.get_or_load(load).borrow();
+        self.update_index(&items);
+
+        let hit = self.index.borrow().get(key).copied();
+        match hit {
+            Some(position) if items[position].matches_key(key) => return Some(position),
+            None if Self::generation_of(&items) == self.key_generation.get() => return None,
+            _ => {}
+        }
+
+        self.rebuild_index(&items);
+        self.index.borrow().get(key).copied()
+    }
+
+    /// Returns the key generation of the document the items belong to.
+    fn generation_of(items: &[Rc<T>]) -> u64 {
+        items.first().map_or(0, |item| item.key_generation())
+    }
+
+    /// Adds all items that are not yet part of the index.
+    fn update_index(&self, items: &[Rc<T>]) {
+        let start = self.indexed.get();
+        if start == items.len() {
+            return;
+        }
+        if start > items.len() {
+            self.rebuild_index(items);
+            return;
+        }
+        if start == 0 {
+            self.key_generation.set(Self::generation_of(items));
+        }
+
+        let mut index = self.index.borrow_mut();
+        for (position, item) in items.iter().enumerate().skip(start) {
+            if let Some(key) = item.index_key() {
+                index.entry(key).or_insert(position);
+            }
+        }
+        self.indexed.set(items.len());
+    }
+
+    /// Discards the index and builds it again from scratch.
+    fn rebuild_index(&self, items: &[Rc<T>]) {
+        self.index.borrow_mut().clear();
+        self.indexed.set(0);
+        self.update_index(items);
+    }
+}
+
+impl<T> Clone for LazyList<T> {
+    fn clone(&self) -> Self {
+        Self {
+            loaded: Cell::new(self.loaded.get()),
+            items: RefCell::new(self.items.borrow().clone()),
+            pending: RefCell::new(self.pending.borrow().clone()),
+            index: RefCell::new(self.index.borrow().clone()),
+            indexed: Cell::new(self.indexed.get()),
+            key_generation: Cell::new(self.key_generation.get()),
+        }
+    }
+}
+
+impl<T> Default for LazyList<T> {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    thread_local! {
+        /// Key generation shared by all `Named` elements of a test
+        static KEYS: Cell<u64> = Cell::new(0);
+        /// Number of `matches_key` calls made by a test
+        static COMPARISONS: Cell<usize> = Cell::new(0);
+    }
+
+    struct Named(RefCell<String>);
+
+    impl Named {
+        fn new(id: &str) -> Rc<Self> {
+            Rc::new(Self(RefCell::new(id.to_string())))
+        }
+
+        /// Changes the key and reports it, like the id setters of the wrappers do.
+        fn rename(&self, id: &str) {
+            self.0.replace(id.to_string());
+            KEYS.with(|keys| keys.set(keys.get() + 1));
+        }
+    }
+
+    impl NativeAddress for Named {
+        fn native_address(&self) -> usize {
+            self as *const Self as usize
+        }
+    }
+
+    /// Numbers stand in for the native object they identify.
+    impl NativeAddress for u32 {
+        fn native_address(&self) -> usize {
+            *self as usize
+        }
+    }
+
+    impl IndexKey for Named {
+        fn index_key(&self) -> Option<String> {
+            Some(self.0.borrow().clone())
+        }
+
+        fn matches_key(&self, key: &str) -> bool {
+            COMPARISONS.with(|count| count.set(count.get() + 1));
+            *self.0.borrow() == key
+        }
+
+        fn key_generation(&self) -> u64 {
+            KEYS.with(Cell::get)
+        }
+    }
+
+    #[test]
+    fn test_new_list_is_loaded() {
+        let list: LazyList<u32> = LazyList::new();
+        assert!(list.is_loaded());
+
+        list.push(Rc::new(1));
+        let items = list.get_or_load(|| panic!("loader must not run"));
+        assert_eq!(items.borrow().len(), 1);
+    }
+
+    #[test]
+    fn test_deferred_list_loads_once() {
+        let list: LazyList<u32> = LazyList::deferred();
+        assert!(!list.is_loaded());
+
+        let calls = Cell::new(0);
+        let load = || {
+            calls.set(calls.get() + 1);
+            vec![Rc::new(1), Rc::new(2)]
+        };
+
+        assert_eq!(list.get_or_load(load).borrow().len(), 2);
+        assert_eq!(list.get_or_load(|| unreachable!()).borrow().len(), 2);
+        assert_eq!(calls.get(), 1);
+    }
+
+    #[test]
+    fn test_push_before_load_is_deferred() {
+        let list: LazyList<u32> = LazyList::deferred();
+        let pushed = Rc::new(3);
+        list.push(Rc::clone(&pushed));
+        list.extend(&[Rc::new(4)]);
+
+        // The loader picks up the pushed elements, which keep their wrappers
+        let items = list.get_or_load(|| (1..=4).map(Rc::new).collect());
+        assert_eq!(items.borrow().len(), 4);
+        assert!(Rc::ptr_eq(&items.borrow()[2], &pushed));
+        assert_eq!(Rc::strong_count(&pushed), 2);
+    }
+
+    #[test]
+    fn test_find_by_key() {
+        let list = LazyList::deferred();
+        let load = || vec![Named::new("a"), Named::new("b")];
+
+        assert_eq!(*list.find("b", load).unwrap().0.borrow(), "b");
+        assert!(list.find("c", || unreachable!()).is_none());
+
+        list.push(Named::new("c"));
+        assert_eq!(*list.find("c", || unreachable!()).unwrap().0.borrow(), "c");
+    }
+
+    #[test]
+    fn test_find_after_rename() {
+        let list = LazyList::new();
+        let a = Named::new("a");
+        list.push(Rc::clone(&a));
+        list.push(Named::new("b"));
+
+        assert!(list.find("a", || unreachable!()).is_some());
+
+        a.rename("renamed");
+        assert!(list.find("a", || unreachable!()).is_none());
+        assert!(Rc::ptr_eq(
+            &list.find("renamed", || unreachable!()).unwrap(),
+            &a
+        ));
+    }
+
+    #[test]
+    fn test_miss_does_not_scan() {
+        let list = LazyList::new();
+        let a = Named::new("a");
+        list.push(Rc::clone(&a));
+        list.push(Named::new("b"));
+        assert!(list.find("c", || unreachable!()).is_none());
+
+        COMPARISONS.with(|count| count.set(0));
+        assert!(list.find("c", || unreachable!()).is_none());
+        assert_eq!(COMPARISONS.with(Cell::get), 0);
+
+        // A renamed element is found after the index has been rebuilt once
+        a.rename("c");
+        assert!(Rc::ptr_eq(&list.find("c", || unreachable!()).unwrap(), &a));
+        COMPARISONS.with(|count| count.set(0));
+        assert!(list.find("d", || unreachable!()).is_none());
+        assert_eq!(COMPARISONS.with(Cell::get), 0);
+    }
+
+    #[test]
+    fn test_find_returns_first_duplicate() {
+        let list = LazyList::new();
+        let first = Named::new("a");
+        list.push(Rc::clone(&first));
+        list.push(Named::new("a"));
+
+        assert!(Rc::ptr_eq(
+            &list.find("a", || unreachable!()).unwrap(),
+            &first
+        ));
+    }
+
+    #[test]
+    fn test_list_iter_sees_pushed_items() {
+        let list = LazyList::new();
+        list.push(Named::new("a"));
+
+        let mut iter = ListIter::new(list.get_or_load(|| unreachable!()));
+        assert_eq!(*iter.next().unwrap().0.borrow(), "a");
+
+        list.push(Named::new("b"));
+        assert_eq!(iter.size_hint().0, 1);
+        assert_eq!(*iter.next().unwrap().0.borrow(), "b");
+        assert!(iter.next().is_none());
+    }
+}
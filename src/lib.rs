@@ -81,20 +81,49 @@ pub mod unit;
 /// Unit definitions composing multiple base units
 pub mod unitdef;
 
+/// Bulk construction of species, reactions and parameters
+pub mod batch;
+/// Compilation of math trees into evaluable programs
+pub mod compiledmath;
+/// Species, reaction and rule dependency graph of a model
+pub mod dependency;
+/// Dirty tracking and incremental serialization of documents
+pub mod incremental;
+/// Optional tracing spans and counters for hot paths
+pub mod instrument;
+/// Read-only views on math trees
+pub mod math;
+/// Memory footprint accounting for documents, models and archives
+pub mod memory;
 /// Packages for SBML models
 pub mod packages;
 /// Plugin fetcher
 pub mod plugin;
 /// Error handling for SBML models
 pub mod sbmlerror;
+/// Metadata scans of SBML files without building a document
+pub mod scan;
+/// Binary snapshots of parsed documents for fast reloading
+pub mod snapshot;
+/// Sparse stoichiometry and dense flux bound export for constraint-based models
+pub mod stoichiometry;
+/// Columnar export of species, parameter and compartment attributes
+pub mod table;
+/// Selective and parallel consistency checking
+pub mod validation;
+/// Copy-on-write variants of a shared base document
+pub mod variant;
 
 /// FBC package types
 pub mod fbc {
+    pub use crate::fbc::bulk::{FluxBoundHandle, FluxObjectiveHandle, Validation};
     pub use crate::fbc::fluxbound::FluxBound;
     pub use crate::fbc::fluxboundop::FluxBoundOperation;
     pub use crate::fbc::objective::Objective;
     pub use crate::fbc::objectivetype::ObjectiveType;
 
+    /// Batched updates of flux bounds and objective coefficients
+    pub mod bulk;
     /// Flux bound
     pub mod fluxbound;
     /// Flux bound operation types
@@ -115,10 +144,18 @@ pub mod property;
 
 /// File and model input/output operations
 pub mod reader;
+/// Serialization of documents with reusable native writers
+pub mod writer;
 
 /// Internal module containing the wrapper types for annotations
 pub(crate) mod wrapper;
 
+/// Internal module deserializing annotations from native XML trees
+pub(crate) mod xmlnode;
+
+/// Internal module containing lazily populated collections of wrappers
+pub(crate) mod lazy;
+
 /// Error handling for SBML models
 pub mod errors;
 
@@ -140,16 +177,22 @@ pub(crate) mod collections {
 }
 
 // Re-export commonly used types
+pub use lazy::ListIter;
 pub use sbmldoc::SBMLDocument;
 pub use traits::annotation::Annotation;
 
 /// Prelude module providing convenient imports of commonly used types
 pub mod prelude {
+    pub use crate::batch::*;
     pub use crate::combine::combinearchive::*;
     pub use crate::compartment::Compartment;
+    pub use crate::compiledmath::*;
+    pub use crate::dependency::{DependencyGraph, SpeciesRole};
     pub use crate::fbc::*;
     pub use crate::kineticlaw::*;
     pub use crate::localparameter::*;
+    pub use crate::math::*;
+    pub use crate::memory::MemoryUsage;
     pub use crate::model::*;
     pub use crate::modref::*;
     pub use crate::parameter::*;
@@ -160,15 +203,24 @@ pub mod prelude {
     pub use crate::sbmlerror::*;
     pub use crate::species::*;
     pub use crate::speciesref::*;
+    pub use crate::stoichiometry::*;
+    pub use crate::table::*;
     pub use crate::traits::annotation::*;
     pub use crate::traits::intoid::*;
     pub use crate::unit::*;
     pub use crate::unitdef::*;
+    pub use crate::validation::*;
+    pub use crate::variant::*;
+    pub use crate::writer::*;
 }
 
 pub mod combine {
+    #[cfg(feature = "async")]
+    pub use crate::combine::asyncarchive::AsyncCombineArchive;
     pub use crate::combine::combinearchive::*;
     pub use crate::combine::manifest::KnownFormats;
+    #[cfg(feature = "async")]
+    pub mod asyncarchive;
     pub mod combinearchive;
     pub mod error;
     pub mod manifest;
@@ -186,6 +238,7 @@ pub(crate) mod sbmlcxx {
         // Includes //
         #include "sbml/SBMLTypes.h"
         #include "sbml/packages/fbc/common/FbcExtensionTypes.h"
+        #include "src/shim.h"
         safety!(unsafe_ffi)
 
         // Base types
@@ -193,6 +246,8 @@ pub(crate) mod sbmlcxx {
         generate!("SBasePlugin")
         generate!("SBMLNamespaces")
         generate!("XMLNamespaces")
+        generate!("XMLNode")
+        generate!("XMLToken")
 
         // Root types
         generate!("SBMLDocument")
@@ -216,6 +271,10 @@ pub(crate) mod sbmlcxx {
         generate!("Rule")
         generate!("KineticLaw")
 
+        // Math types
+        generate!("ASTNode")
+        generate!("ASTNodeType_t")
+
         // FBC types
         generate!("FbcModelPlugin")
         generate!("ListOfFluxObjectives")
@@ -236,6 +295,27 @@ pub(crate) mod sbmlcxx {
         generate!("SBMLError")
         generate!("SBMLErrorLog")
         generate!("XMLError")
+        generate!("SBMLErrorCategory_t")
+
+        // Bulk construction and update helpers (src/shim.h)
+        generate!("sbmlrs::createSpeciesBatch")
+        generate!("sbmlrs::createParametersBatch")
+        generate!("sbmlrs::createReactionsBatch")
+        generate!("sbmlrs::setFluxBoundValues")
+        generate!("sbmlrs::setFluxObjectiveCoefficients")
+        generate!("sbmlrs::writeModelSection")
+        generate!("sbmlrs::countElements")
+        generate!("sbmlrs::mathMLOf")
+        generate!("sbmlrs::setMathML")
+        generate!("sbmlrs::metaIdOf")
+        generate!("sbmlrs::notesOf")
+        generate!("sbmlrs::annotationOf")
+        generate!("sbmlrs::setSBaseAttributes")
+        generate!("sbmlrs::snapshotUnsupportedContent")
+        generate!("sbmlrs::namespaceAttrName")
+        generate!("sbmlrs::namespaceURI")
+        generate!("sbmlrs::writeSBMLInto")
+        generate!("sbmlrs::logError")
 
         // Container types
         generate!("ListOfParameters")
@@ -20,7 +20,9 @@ use std::{cell::RefCell, pin::Pin, rc::Rc};
 use cxx::let_cxx_string;
 
 use crate::{
-    clone, get_unit_definition, inner, into_id, pin_ptr,
+    clone, get_unit_definition,
+    incremental::ChangeTracker,
+    inner, into_id, pin_ptr,
     prelude::KineticLaw,
     sbase,
     sbmlcxx::{self},
@@ -37,6 +39,9 @@ use crate::{
 /// of that context.
 pub struct LocalParameter<'a> {
     inner: RefCell<Pin<&'a mut sbmlcxx::LocalParameter>>,
+    annotation_cache: AnnotationCache,
+    /// Marks the section of the document that contains this element
+    changes: ChangeTracker<'a>,
 }
 
 // Set the inner trait for the LocalParameter struct
@@ -82,6 +87,8 @@ impl<'a> LocalParameter<'a> {
 
         Self {
             inner: RefCell::new(local_parameter),
+            annotation_cache: AnnotationCache::default(),
+            changes: kinetic_law.changes(),
         }
     }
 
@@ -165,6 +172,8 @@ impl FromPtr<sbmlcxx::LocalParameter> for LocalParameter<'_> {
         let local_parameter = pin_ptr!(ptr, sbmlcxx::LocalParameter);
         Self {
             inner: RefCell::new(local_parameter),
+            annotation_cache: AnnotationCache::default(),
+            changes: ChangeTracker::default(),
         }
     }
 }
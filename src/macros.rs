@@ -132,6 +132,12 @@ macro_rules! inner {
                 &self.inner
             }
         }
+
+        impl<'a> $crate::lazy::NativeAddress for $type {
+            fn native_address(&self) -> usize {
+                $crate::dependency::address_of(&self.inner)
+            }
+        }
     };
 }
 /// Implements the Annotation trait for a wrapper type.
@@ -149,24 +155,55 @@ macro_rules! inner {
 /// - get_annotation() - Gets the raw XML annotation string
 /// - set_annotation() - Sets the XML annotation from a string
 /// - get_annotation_serde() - Gets the annotation deserialized into a specified type
+/// - get_annotation_serde_cached() - Like get_annotation_serde(), but cached on the element
 /// - set_annotation_serde() - Sets the annotation by serializing a type to XML
 ///
+/// It also implements dirty tracking (see [`crate::incremental`]) for the wrapper type, which
+/// setters use to mark the section of the model that contains the element.
+///
 /// The generated implementation ensures that:
 /// - XML annotations can be accessed and modified in a type-safe way
 /// - Serialization/deserialization is handled consistently
 /// - The C++ object is properly upcast to access base class annotation methods
 /// - Interior mutability is maintained through RefCell
+///
+/// The wrapper type must have an `annotation_cache: AnnotationCache` field and a
+/// `changes: ChangeTracker<'a>` field.
 #[macro_export]
 macro_rules! upcast_annotation {
     ($type:ty, $cxx_type:ty, $cxx_upcast:ty) => {
         // Import necessary modules
-        use $crate::traits::annotation::Annotation;
+        use $crate::traits::annotation::{Annotation, AnnotationCache};
         use $crate::wrapper::Wrapper;
 
-        use quick_xml::{de::from_str, se::to_string, DeError, SeError};
+        use quick_xml::{se::to_string, DeError, SeError};
         use serde::{Deserialize, Serialize};
         use std::error::Error;
 
+        impl<'a> $crate::incremental::Tracked for $type {
+            fn mark_dirty(&self) {
+                self.changes
+                    .mark(<$cxx_type as $crate::incremental::InSection>::SECTION);
+            }
+        }
+
+        impl<'a> $type {
+            /// Records the changes of this element in the document of `changes`.
+            pub(crate) fn with_changes(
+                mut self,
+                changes: $crate::incremental::ChangeTracker<'a>,
+            ) -> Self {
+                self.changes = changes;
+                self
+            }
+
+            /// Returns the tracker through which this element marks its changes, to be
+            /// shared with the elements created below it.
+            pub(crate) fn changes(&self) -> $crate::incremental::ChangeTracker<'a> {
+                self.changes
+            }
+        }
+
         impl<'a> Annotation for $type {
             /// Gets the annotation for the compartment.
             ///
@@ -179,6 +216,16 @@ macro_rules! upcast_annotation {
                 base.getAnnotationString().to_str().unwrap().to_string()
             }
 
+            /// Passes the annotation to a closure without copying it into a String.
+            ///
+            /// # Returns
+            /// The value returned by the closure
+            fn with_annotation<R>(&self, f: impl FnOnce(&str) -> R) -> R {
+                let base = $crate::upcast!(self, $cxx_type, $cxx_upcast);
+                let annotation = base.getAnnotationString();
+                f(annotation.to_str().unwrap())
+            }
+
             /// Sets the annotation for the compartment.
             ///
             /// We are using upcasting to access the base class's setAnnotation1 method.
@@ -189,9 +236,11 @@ macro_rules! upcast_annotation {
             /// # Returns
             /// Result indicating success or containing an error if the annotation is invalid
             fn set_annotation(&self, annotation: &str) -> Result<(), Box<dyn Error>> {
+                self.annotation_cache.invalidate();
                 let mut base = $crate::upcast!(self, $cxx_type, $cxx_upcast);
                 cxx::let_cxx_string!(annotation = annotation);
                 base.as_mut().setAnnotation1(&annotation);
+                $crate::incremental::Tracked::mark_dirty(self);
                 Ok(())
             }
 
@@ -216,11 +265,34 @@ macro_rules! upcast_annotation {
             ///
             /// # Returns
             /// Result containing the deserialized type or a deserialization error
+            ///
+            /// The annotation is read directly from libSBML's parsed XML tree, without
+            /// converting it to a string first.
             fn get_annotation_serde<T: for<'de> Deserialize<'de>>(&self) -> Result<T, DeError> {
-                let annotation = self.get_annotation();
-                let parsed: Wrapper<T> = from_str(&annotation)?;
+                let mut base = $crate::upcast!(self, $cxx_type, $cxx_upcast);
+                let node = $crate::xmlnode::XmlNode::from_ptr(base.as_mut().getAnnotation())
+                    .ok_or_else(|| DeError::Custom("Element has no annotation".to_string()))?;
+                let parsed: Wrapper<T> = $crate::xmlnode::from_node(node)?;
                 Ok(parsed.annotation)
             }
+
+            /// Gets the annotation as a deserialized type, caching it on this element.
+            ///
+            /// # Type Parameters
+            /// * `T` - The type to deserialize the annotation into
+            ///
+            /// # Returns
+            /// Result containing the shared deserialized type or a deserialization error
+            fn get_annotation_serde_cached<T: for<'de> Deserialize<'de> + 'static>(
+                &self,
+            ) -> Result<std::rc::Rc<T>, DeError> {
+                if let Some(cached) = self.annotation_cache.get::<T>() {
+                    return Ok(cached);
+                }
+                let value = std::rc::Rc::new(self.get_annotation_serde::<T>()?);
+                self.annotation_cache.set(std::rc::Rc::clone(&value));
+                Ok(value)
+            }
         }
     };
 }
@@ -275,6 +347,7 @@ macro_rules! sbo_term {
             let mut base = $crate::upcast!(self, $cxx_type, $cxx_upcast);
             cxx::let_cxx_string!(id = id);
             base.as_mut().setSBOTerm1(&id);
+            $crate::incremental::Tracked::mark_dirty(self);
         }
     };
 }
@@ -301,6 +374,45 @@ macro_rules! into_id {
     };
 }
 
+/// A macro for making a wrapper type indexable by one of its string attributes.
+///
+/// This macro generates an implementation of the internal `IndexKey` trait, which is
+/// used by the component collections to look up elements by id in constant time.
+///
+/// # Arguments
+/// * `$type` - The Rust wrapper type (e.g. Species<'_>)
+/// * `$cpp_getter` - The C++ getter returning the key (e.g. getId)
+///
+/// Elements whose key is empty are not indexed.
+#[macro_export]
+macro_rules! index_key {
+    ($type:ty, $cpp_getter:ident) => {
+        impl $crate::lazy::IndexKey for $type {
+            fn index_key(&self) -> Option<String> {
+                let inner = self.inner.borrow();
+                let key = inner.$cpp_getter().to_str().ok()?;
+                (!key.is_empty()).then(|| key.to_string())
+            }
+
+            fn matches_key(&self, key: &str) -> bool {
+                self.inner.borrow().$cpp_getter().as_bytes() == key.as_bytes()
+            }
+
+            fn key_generation(&self) -> u64 {
+                self.changes.key_generation()
+            }
+        }
+
+        impl $type {
+            /// Records that the key of this element changed, so that collections
+            /// holding it no longer trust their index for absent keys.
+            pub(crate) fn key_changed(&self) {
+                self.changes.mark_key();
+            }
+        }
+    };
+}
+
 /// A macro to implement the Clone trait for a wrapper type.
 ///
 /// This macro generates an implementation of the Clone trait for a wrapper type,
@@ -322,6 +434,8 @@ macro_rules! clone {
                 let inner_ptr = pin_ptr!(raw_ptr, $cxx_type);
                 Self {
                     inner: RefCell::new(inner_ptr),
+                    annotation_cache: Default::default(),
+                    changes: Default::default(),
                 }
             }
         }
@@ -335,6 +449,8 @@ macro_rules! clone {
                 let inner_ptr = pin_ptr!(raw_ptr, $cxx_type);
                 Self {
                     inner: RefCell::new(inner_ptr),
+                    annotation_cache: Default::default(),
+                    changes: Default::default(),
                     $(
                         $field: self.$field.clone(),
                     )+
@@ -443,7 +559,8 @@ macro_rules! get_unit_definition {
     ($property:ident) => {
         pub fn unit_definition(&self) -> Option<Rc<$crate::unitdef::UnitDefinition<'a>>> {
             let model_ptr = self.base().getModel();
-            let model = $crate::model::Model::from_ptr(model_ptr as *mut $crate::sbmlcxx::Model);
+            let model = $crate::model::Model::from_ptr(model_ptr as *mut $crate::sbmlcxx::Model)
+                .with_changes(self.changes);
 
             if let Some(unit) = self.$property() {
                 model.get_unit_definition(&unit)
@@ -0,0 +1,364 @@
+//! This module provides a read-only Rust view on the libSBML ASTNode class.
+//!
+//! libSBML stores the mathematics of kinetic laws, rules and other elements as an
+//! abstract syntax tree of ASTNode objects. While the `formula` properties expose this
+//! tree as an infix string, [`ASTNode`] allows walking it directly, without having to
+//! re-parse the formula on the Rust side. See [`crate::compiledmath`] for compiling a
+//! math tree into an efficiently evaluable program.
+
+use std::{ffi::CStr, pin::Pin};
+
+use crate::{pin_const_ptr, sbmlcxx};
+
+/// The type of a node within a math tree.
+///
+/// This mirrors libSBML's `ASTNodeType_t`. Rarely used node types, such as the
+/// reciprocal trigonometric functions or MathML qualifiers, are reported as
+/// [`ASTNodeType::Unknown`].
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub enum ASTNodeType {
+    /// Addition of all children
+    Plus,
+    /// Subtraction, or negation if the node has a single child
+    Minus,
+    /// Multiplication of all children
+    Times,
+    /// Division of the first by the second child
+    Divide,
+    /// Exponentiation, written as `^` in infix notation
+    Power,
+    /// Integer literal
+    Integer,
+    /// Real number literal, including e-notation
+    Real,
+    /// Rational number literal
+    Rational,
+    /// Reference to a model component or local parameter
+    Name,
+    /// The simulation time
+    Time,
+    /// Avogadro's constant
+    Avogadro,
+    /// Euler's number
+    ConstantE,
+    /// The constant pi
+    ConstantPi,
+    /// Boolean true
+    True,
+    /// Boolean false
+    False,
+    /// Lambda expression of a function definition
+    Lambda,
+    /// Call of a user-defined function
+    Function,
+    /// Absolute value
+    Abs,
+    /// Arc cosine
+    ArcCos,
+    /// Inverse hyperbolic cosine
+    ArcCosh,
+    /// Arc sine
+    ArcSin,
+    /// Inverse hyperbolic sine
+    ArcSinh,
+    /// Arc tangent
+    ArcTan,
+    /// Inverse hyperbolic tangent
+    ArcTanh,
+    /// Smallest integer not less than the argument
+    Ceiling,
+    /// Cosine
+    Cos,
+    /// Hyperbolic cosine
+    Cosh,
+    /// Delayed value of an expression
+    Delay,
+    /// Exponential function
+    Exp,
+    /// Factorial
+    Factorial,
+    /// Largest integer not greater than the argument
+    Floor,
+    /// Natural logarithm
+    Ln,
+    /// Logarithm, to base 10 or to the base given as first child
+    Log,
+    /// Piecewise function of value/condition pairs and an optional otherwise value
+    Piecewise,
+    /// Exponentiation, written as `pow` in infix notation
+    Pow,
+    /// Square root, or the root of the degree given as first child
+    Root,
+    /// Sine
+    Sin,
+    /// Hyperbolic sine
+    Sinh,
+    /// Tangent
+    Tan,
+    /// Hyperbolic tangent
+    Tanh,
+    /// Maximum of all children
+    Max,
+    /// Minimum of all children
+    Min,
+    /// Integer quotient of the first and second child
+    Quotient,
+    /// Remainder of the division of the first by the second child
+    Rem,
+    /// Logical conjunction
+    And,
+    /// Logical negation
+    Not,
+    /// Logical disjunction
+    Or,
+    /// Logical exclusive disjunction
+    Xor,
+    /// Logical implication
+    Implies,
+    /// Equality
+    Eq,
+    /// Greater than or equal
+    Geq,
+    /// Greater than
+    Gt,
+    /// Less than or equal
+    Leq,
+    /// Less than
+    Lt,
+    /// Inequality
+    Neq,
+    /// Any other node type
+    Unknown,
+}
+
+impl From<sbmlcxx::ASTNodeType_t> for ASTNodeType {
+    /// Converts a C++ SBML ASTNodeType_t enum to the Rust equivalent
+    fn from(value: sbmlcxx::ASTNodeType_t) -> Self {
+        match value {
+            sbmlcxx::ASTNodeType_t::AST_PLUS => ASTNodeType::Plus,
+            sbmlcxx::ASTNodeType_t::AST_MINUS => ASTNodeType::Minus,
+            sbmlcxx::ASTNodeType_t::AST_TIMES => ASTNodeType::Times,
+            sbmlcxx::ASTNodeType_t::AST_DIVIDE => ASTNodeType::Divide,
+            sbmlcxx::ASTNodeType_t::AST_POWER => ASTNodeType::Power,
+            sbmlcxx::ASTNodeType_t::AST_INTEGER => ASTNodeType::Integer,
+            sbmlcxx::ASTNodeType_t::AST_REAL | sbmlcxx::ASTNodeType_t::AST_REAL_E => {
+                ASTNodeType::Real
+            }
+            sbmlcxx::ASTNodeType_t::AST_RATIONAL => ASTNodeType::Rational,
+            sbmlcxx::ASTNodeType_t::AST_NAME => ASTNodeType::Name,
+            sbmlcxx::ASTNodeType_t::AST_NAME_TIME => ASTNodeType::Time,
+            sbmlcxx::ASTNodeType_t::AST_NAME_AVOGADRO => ASTNodeType::Avogadro,
+            sbmlcxx::ASTNodeType_t::AST_CONSTANT_E => ASTNodeType::ConstantE,
+            sbmlcxx::ASTNodeType_t::AST_CONSTANT_PI => ASTNodeType::ConstantPi,
+            sbmlcxx::ASTNodeType_t::AST_CONSTANT_TRUE => ASTNodeType::True,
+            sbmlcxx::ASTNodeType_t::AST_CONSTANT_FALSE => ASTNodeType::False,
+            sbmlcxx::ASTNodeType_t::AST_LAMBDA => ASTNodeType::Lambda,
+            sbmlcxx::ASTNodeType_t::AST_FUNCTION => ASTNodeType::Function,
+            sbmlcxx::ASTNodeType_t::AST_FUNCTION_ABS => ASTNodeType::Abs,
+            sbmlcxx::ASTNodeType_t::AST_FUNCTION_ARCCOS => ASTNodeType::ArcCos,
+            sbmlcxx::ASTNodeType_t::AST_FUNCTION_ARCCOSH => ASTNodeType::ArcCosh,
+            sbmlcxx::ASTNodeType_t::AST_FUNCTION_ARCSIN => ASTNodeType::ArcSin,
+            sbmlcxx::ASTNodeType_t::AST_FUNCTION_ARCSINH => ASTNodeType::ArcSinh,
+            sbmlcxx::ASTNodeType_t::AST_FUNCTION_ARCTAN => ASTNodeType::ArcTan,
+            sbmlcxx::ASTNodeType_t::AST_FUNCTION_ARCTANH => ASTNodeType::ArcTanh,
+            sbmlcxx::ASTNodeType_t::AST_FUNCTION_CEILING => ASTNodeType::Ceiling,
+            sbmlcxx::ASTNodeType_t::AST_FUNCTION_COS => ASTNodeType::Cos,
+            sbmlcxx::ASTNodeType_t::AST_FUNCTION_COSH => ASTNodeType::Cosh,
+            sbmlcxx::ASTNodeType_t::AST_FUNCTION_DELAY => ASTNodeType::Delay,
+            sbmlcxx::ASTNodeType_t::AST_FUNCTION_EXP => ASTNodeType::Exp,
+            sbmlcxx::ASTNodeType_t::AST_FUNCTION_FACTORIAL => ASTNodeType::Factorial,
+            sbmlcxx::ASTNodeType_t::AST_FUNCTION_FLOOR => ASTNodeType::Floor,
+            sbmlcxx::ASTNodeType_t::AST_FUNCTION_LN => ASTNodeType::Ln,
+            sbmlcxx::ASTNodeType_t::AST_FUNCTION_LOG => ASTNodeType::Log,
+            sbmlcxx::ASTNodeType_t::AST_FUNCTION_PIECEWISE => ASTNodeType::Piecewise,
+            sbmlcxx::ASTNodeType_t::AST_FUNCTION_POWER => ASTNodeType::Pow,
+            sbmlcxx::ASTNodeType_t::AST_FUNCTION_ROOT => ASTNodeType::Root,
+            sbmlcxx::ASTNodeType_t::AST_FUNCTION_SIN => ASTNodeType::Sin,
+            sbmlcxx::ASTNodeType_t::AST_FUNCTION_SINH => ASTNodeType::Sinh,
+            sbmlcxx::ASTNodeType_t::AST_FUNCTION_TAN => ASTNodeType::Tan,
+            sbmlcxx::ASTNodeType_t::AST_FUNCTION_TANH => ASTNodeType::Tanh,
+            sbmlcxx::ASTNodeType_t::AST_FUNCTION_MAX => ASTNodeType::Max,
+            sbmlcxx::ASTNodeType_t::AST_FUNCTION_MIN => ASTNodeType::Min,
+            sbmlcxx::ASTNodeType_t::AST_FUNCTION_QUOTIENT => ASTNodeType::Quotient,
+            sbmlcxx::ASTNodeType_t::AST_FUNCTION_REM => ASTNodeType::Rem,
+            sbmlcxx::ASTNodeType_t::AST_LOGICAL_AND => ASTNodeType::And,
+            sbmlcxx::ASTNodeType_t::AST_LOGICAL_NOT => ASTNodeType::Not,
+            sbmlcxx::ASTNodeType_t::AST_LOGICAL_OR => ASTNodeType::Or,
+            sbmlcxx::ASTNodeType_t::AST_LOGICAL_XOR => ASTNodeType::Xor,
+            sbmlcxx::ASTNodeType_t::AST_LOGICAL_IMPLIES => ASTNodeType::Implies,
+            sbmlcxx::ASTNodeType_t::AST_RELATIONAL_EQ => ASTNodeType::Eq,
+            sbmlcxx::ASTNodeType_t::AST_RELATIONAL_GEQ => ASTNodeType::Geq,
+            sbmlcxx::ASTNodeType_t::AST_RELATIONAL_GT => ASTNodeType::Gt,
+            sbmlcxx::ASTNodeType_t::AST_RELATIONAL_LEQ => ASTNodeType::Leq,
+            sbmlcxx::ASTNodeType_t::AST_RELATIONAL_LT => ASTNodeType::Lt,
+            sbmlcxx::ASTNodeType_t::AST_RELATIONAL_NEQ => ASTNodeType::Neq,
+            _ => ASTNodeType::Unknown,
+        }
+    }
+}
+
+/// A read-only view on a node of a libSBML math tree.
+///
+/// Views are handed out by `with_math` of [`KineticLaw`](crate::kineticlaw::KineticLaw)
+/// and [`Rule`](crate::rule::Rule), which keep the owning element borrowed for as
+/// long as the view can be used, so the tree cannot be replaced underneath it.
+#[derive(Clone, Copy)]
+pub struct ASTNode<'a> {
+    inner: Pin<&'a sbmlcxx::ASTNode>,
+}
+
+impl<'a> ASTNode<'a> {
+    /// Creates a view from a pointer to a native node, returning `None` for null pointers.
+    pub(crate) fn from_ptr(ptr: *const sbmlcxx::ASTNode) -> Option<Self> {
+        if ptr.is_null() {
+            return None;
+        }
+
+        Some(Self {
+            inner: pin_const_ptr!(ptr, sbmlcxx::ASTNode),
+        })
+    }
+
+    /// Returns the type of this node.
+    pub fn node_type(&self) -> ASTNodeType {
+        self.inner.getType().into()
+    }
+
+    /// Returns the number of children of this node.
+    pub fn num_children(&self) -> usize {
+        self.inner.getNumChildren().0 as usize
+    }
+
+    /// Returns the child at the given position, if it exists.
+    pub fn child(&self, index: usize) -> Option<ASTNode<'a>> {
+        if index >= self.num_children() {
+            return None;
+        }
+
+        let child = self.inner.getChild((index as u32).into());
+        ASTNode::from_ptr(child)
+    }
+
+    /// Returns an iterator over the children of this node.
+    pub fn children(&self) -> impl Iterator<Item = ASTNode<'a>> + '_ {
+        (0..self.num_children()).filter_map(|i| self.child(i))
+    }
+
+    /// Returns the name of this node.
+    ///
+    /// For [`ASTNodeType::Name`] nodes this is the referenced identifier, for
+    /// [`ASTNodeType::Function`] nodes the name of the called function.
+    pub fn name(&self) -> Option<String> {
+        let name = self.inner.getName();
+        if name.is_null() {
+            return None;
+        }
+
+        // SAFETY: libSBML returns a NUL-terminated string owned by the node
+        let name = unsafe { CStr::from_ptr(name) };
+        Some(name.to_string_lossy().into_owned())
+    }
+
+    /// Returns the numeric value of a literal node.
+    ///
+    /// Integer, real and rational literals as well as the constants e, pi, true,
+    /// false and Avogadro's number yield their value, all other nodes yield `None`.
+    pub fn value(&self) -> Option<f64> {
+        match self.node_type() {
+            ASTNodeType::Integer => Some(self.inner.getInteger().0 as f64),
+            ASTNodeType::Real | ASTNodeType::Rational => Some(self.inner.getReal()),
+            ASTNodeType::ConstantE => Some(std::f64::consts::E),
+            ASTNodeType::ConstantPi => Some(std::f64::consts::PI),
+            ASTNodeType::True => Some(1.0),
+            ASTNodeType::False => Some(0.0),
+            ASTNodeType::Avogadro => Some(AVOGADRO),
+            _ => None,
+        }
+    }
+}
+
+/// Avogadro's constant as defined by SBML Level 3
+pub(crate) const AVOGADRO: f64 = 6.02214179e23;
+
+impl std::fmt::Debug for ASTNode<'_> {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        let mut ds = f.debug_struct("ASTNode");
+        ds.field("type", &self.node_type());
+        ds.field("name", &self.name());
+        ds.field("value", &self.value());
+        ds.field("children", &self.children().collect::<Vec<_>>());
+        ds.finish()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use crate::prelude::*;
+
+    #[test]
+    fn test_kinetic_law_math() {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("test");
+        let reaction = model.create_reaction("r1");
+        let kinetic_law = reaction.create_kinetic_law("k1 * S1 + 2");
+
+        kinetic_law.with_math(|math| {
+            let math = math.expect("math not set");
+            assert_eq!(math.node_type(), ASTNodeType::Plus);
+            assert_eq!(math.num_children(), 2);
+
+            let product = math.child(0).unwrap();
+            assert_eq!(product.node_type(), ASTNodeType::Times);
+            let names: Vec<_> = product.children().filter_map(|c| c.name()).collect();
+            assert_eq!(names, vec!["k1", "S1"]);
+
+            let literal = math.child(1).unwrap();
+            assert_eq!(literal.node_type(), ASTNodeType::Integer);
+            assert_eq!(literal.value(), Some(2.0));
+            assert!(math.child(2).is_none());
+        });
+    }
+
+    #[test]
+    fn test_rule_math() {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("test");
+        let rule = model.create_rate_rule("S1", "exp(k * S2) / 2.5");
+
+        rule.with_math(|math| {
+            let math = math.expect("math not set");
+            assert_eq!(math.node_type(), ASTNodeType::Divide);
+
+            let exp = math.child(0).unwrap();
+            assert_eq!(exp.node_type(), ASTNodeType::Exp);
+            assert_eq!(exp.child(0).unwrap().node_type(), ASTNodeType::Times);
+            assert_eq!(math.child(1).unwrap().value(), Some(2.5));
+        });
+    }
+
+    #[test]
+    #[should_panic]
+    fn test_set_formula_while_math_is_viewed() {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("test");
+        let reaction = model.create_reaction("r1");
+        let kinetic_law = reaction.create_kinetic_law("k1 * S1");
+
+        kinetic_law.with_math(|math| {
+            kinetic_law.set_formula("k2");
+            math.map(|math| math.num_children())
+        });
+    }
+
+    #[test]
+    fn test_math_after_set_formula() {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("test");
+        let reaction = model.create_reaction("r1");
+        let kinetic_law = reaction.create_kinetic_law("k1 * S1");
+
+        kinetic_law.set_formula("k2");
+        let node_type = kinetic_law.with_math(|math| math.map(|math| math.node_type()));
+        assert_eq!(node_type, Some(ASTNodeType::Name));
+    }
+}
@@ -0,0 +1,242 @@
+//! Memory footprint accounting for documents, models and archives.
+//!
+//! Services that keep many models loaded need to know what each of them costs in
+//! order to size caches and choose eviction policies. [`SBMLDocument::memory_usage`],
+//! [`Model::memory_usage`] and [`CombineArchive::memory_usage`] report a
+//! [`MemoryUsage`] that breaks the footprint down into three parts:
+//!
+//! - the native libSBML object tree, estimated from the number of elements and the
+//!   size of their annotations, since libSBML does not track its allocations
+//! - the Rust wrappers held in the collections of models, reactions, unit definitions
+//!   and objectives, including the vectors and id indices of these collections
+//! - the buffers of an archive, i.e. pending entries, the manifest and the central
+//!   directory of the original archive
+//!
+//! All byte counts are estimates. They are meant to compare models with each other
+//! and to track trends, not to match the numbers reported by the allocator.
+//!
+//! ```no_run
+//! use sbml::prelude::*;
+//!
+//! let doc = SBMLReader::from_file("model.xml")?;
+//! let model = doc.model().unwrap();
+//! model.list_of_species();
+//!
+//! let usage = doc.memory_usage() + model.memory_usage().wrappers_only();
+//! println!("{} elements, ~{} bytes", usage.native_elements, usage.total_bytes());
+//! # Ok::<(), Box<dyn std::error::Error>>(())
+//! ```
+//!
+//! [`SBMLDocument::memory_usage`]: crate::sbmldoc::SBMLDocument::memory_usage
+//! [`Model::memory_usage`]: crate::model::Model::memory_usage
+//! [`CombineArchive::memory_usage`]: crate::combine::combinearchive::CombineArchive::memory_usage
+
+use std::{
+    collections::{HashMap, HashSet},
+    iter::Sum,
+    mem::size_of,
+    ops::{Add, AddAssign},
+    rc::Rc,
+};
+
+use crate::sbmlcxx;
+
+/// Estimated size of a native element without its annotation.
+///
+/// Every `SBase` carries strings for its id, name, meta id and SBO term, the notes and
+/// annotation pointers, its namespaces and its plugins, which puts even small elements
+/// at several hundred bytes.
+pub(crate) const NATIVE_ELEMENT_BYTES: usize = 512;
+
+/// Estimated size of the native XML tree per character of a serialized annotation
+pub(crate) const NATIVE_ANNOTATION_BYTES_PER_CHAR: usize = 4;
+
+/// Memory held by a document, model or archive, see the [module documentation](self).
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq, PartialOrd, Ord, Hash)]
+pub struct MemoryUsage {
+    /// Number of native libSBML elements, including list elements
+    pub native_elements: usize,
+    /// Number of native elements that carry an annotation
+    pub native_annotations: usize,
+    /// Estimated size of the native libSBML object tree in bytes
+    pub native_bytes: usize,
+    /// Number of wrappers held in the collections of the model
+    pub wrappers: usize,
+    /// Size of the wrappers, their collections and id indices in bytes
+    pub wrapper_bytes: usize,
+    /// Size of the pending entries, manifest and central directory of an archive in bytes
+    pub archive_bytes: usize,
+}
+
+impl MemoryUsage {
+    /// Returns the sum of all byte counts.
+    pub fn total_bytes(&self) -> usize {
+        self.native_bytes + self.wrapper_bytes + self.archive_bytes
+    }
+
+    /// Returns only the wrapper part of this report.
+    ///
+    /// Useful to combine the report of a document with that of its model, which both
+    /// include the native tree of the model.
+    pub fn wrappers_only(self) -> Self {
+        Self {
+            wrappers: self.wrappers,
+            wrapper_bytes: self.wrapper_bytes,
+            ..Self::default()
+        }
+    }
+
+    /// Estimates the native footprint of an element and everything below it.
+    pub(crate) fn native(element: &sbmlcxx::SBase) -> Self {
+        let mut annotations = 0usize;
+        let mut annotation_chars = 0usize;
+
+        // SAFETY: Both pointers refer to locals that outlive the call
+        let elements = unsafe {
+            sbmlcxx::sbmlrs::countElements(element, &mut annotations, &mut annotation_chars)
+        };
+
+        Self {
+            native_elements: elements,
+            native_annotations: annotations,
+            native_bytes: elements * NATIVE_ELEMENT_BYTES
+                + annotation_chars * NATIVE_ANNOTATION_BYTES_PER_CHAR,
+            ..Self::default()
+        }
+    }
+
+    /// Accounts for a single wrapper of type `T` held in an `Rc`.
+    pub(crate) fn wrapper<T>() -> Self {
+        Self {
+            wrappers: 1,
+            wrapper_bytes: rc_bytes::<T>(),
+            ..Self::default()
+        }
+    }
+}
+
+impl Add for MemoryUsage {
+    type Output = Self;
+
+    fn add(mut self, other: Self) -> Self {
+        self += other;
+        self
+    }
+}
+
+impl AddAssign for MemoryUsage {
+    fn add_assign(&mut self, other: Self) {
+        self.native_elements += other.native_elements;
+        self.native_annotations += other.native_annotations;
+        self.native_bytes += other.native_bytes;
+        self.wrappers += other.wrappers;
+        self.wrapper_bytes += other.wrapper_bytes;
+        self.archive_bytes += other.archive_bytes;
+    }
+}
+
+impl Sum for MemoryUsage {
+    fn sum<I: Iterator<Item = Self>>(iter: I) -> Self {
+        iter.fold(Self::default(), Add::add)
+    }
+}
+
+/// Size of the allocation behind an `Rc<T>`, including its reference counts.
+pub(crate) fn rc_bytes<T>() -> usize {
+    size_of::<Rc<T>>() * 2 + size_of::<T>()
+}
+
+/// Reports nothing for wrappers that hold no collections.
+pub(crate) fn leaf<T>(_: &T) -> MemoryUsage {
+    MemoryUsage::default()
+}
+
+/// Heap size of a vector, counting its capacity rather than its length.
+pub(crate) fn vec_bytes<T>(vec: &Vec<T>) -> usize {
+    vec.capacity() * size_of::<T>()
+}
+
+/// Heap size of a map with string keys, including the keys themselves.
+///
+/// Every bucket of the hash table holds one entry plus one control byte.
+pub(crate) fn string_map_bytes<V>(map: &HashMap<String, V>) -> usize {
+    map.capacity() * (size_of::<(String, V)>() + 1)
+        + map.keys().map(String::capacity).sum::<usize>()
+}
+
+/// Heap size of a set of strings, including the strings themselves.
+pub(crate) fn string_set_bytes(set: &HashSet<String>) -> usize {
+    set.capacity() * (size_of::<String>() + 1) + set.iter().map(String::capacity).sum::<usize>()
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::prelude::*;
+
+    fn document() -> SBMLDocument {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("memory");
+        model.create_compartment("cytosol");
+        for id in ["glucose", "g6p", "atp"] {
+            model.build_species(id).compartment("cytosol").build();
+        }
+        let reaction = model.create_reaction("hk");
+        reaction.create_reactant("glucose", 1.0);
+        reaction.create_product("g6p", 1.0);
+        reaction.create_modifier("atp");
+        model
+            .get_species("glucose")
+            .unwrap()
+            .set_annotation("<data xmlns=\"https://example.org\">glucose</data>")
+            .unwrap();
+        doc
+    }
+
+    #[test]
+    fn test_document_memory_usage() {
+        let doc = document();
+        let usage = doc.memory_usage();
+
+        // At least the document, the model, the compartment, three species, the
+        // reaction and its three species references
+        assert!(usage.native_elements >= 10);
+        assert_eq!(usage.native_annotations, 1);
+        assert!(usage.native_bytes > usage.native_elements * NATIVE_ELEMENT_BYTES);
+        assert_eq!(usage.wrappers, 0);
+        assert_eq!(usage.archive_bytes, 0);
+    }
+
+    #[test]
+    fn test_model_memory_usage() {
+        let doc = document();
+        let model = doc.model().unwrap();
+
+        // Collections of a model read from a document are not wrapped yet
+        let before = model.memory_usage();
+        assert_eq!(before.wrappers, 0);
+        assert!(before.native_elements < doc.memory_usage().native_elements);
+
+        model.list_of_species();
+        let reactions = model.list_of_reactions();
+        reactions[0].reactants();
+        let after = model.memory_usage();
+        assert_eq!(after.wrappers, 5);
+        assert!(after.wrapper_bytes > before.wrapper_bytes);
+        assert_eq!(after.native_bytes, before.native_bytes);
+    }
+
+    #[test]
+    fn test_memory_usage_sum() {
+        let usage = MemoryUsage {
+            native_bytes: 10,
+            wrappers: 1,
+            wrapper_bytes: 20,
+            archive_bytes: 30,
+            ..Default::default()
+        };
+        let total: MemoryUsage = [usage, usage.wrappers_only()].into_iter().sum();
+        assert_eq!(total.total_bytes(), 80);
+        assert_eq!(total.wrappers, 2);
+    }
+}
@@ -7,31 +7,47 @@
 //! This wrapper provides safe access to the underlying C++ libSBML Model class while
 //! maintaining Rust's safety guarantees through the use of RefCell and Pin.
 
-use std::{cell::RefCell, pin::Pin, rc::Rc};
+use std::{
+    cell::{Ref, RefCell},
+    pin::Pin,
+    rc::Rc,
+};
 
 use cxx::let_cxx_string;
 
 use crate::{
+    batch::{self, ParameterSpec, ReactionSpec, SpeciesSpec},
     clone,
     collections::*,
     compartment::{Compartment, CompartmentBuilder},
+    dependency::{Change, ChangeHook, DependencyGraph, DependencyIndex},
     errors::LibSBMLError,
     fbc::{
-        fluxbound::FluxBound, fluxboundop::FluxBoundOperation, objective::Objective,
+        bulk::{self, FluxBoundHandle, FluxObjectiveHandle, Validation},
+        fluxbound::FluxBound,
+        fluxboundop::FluxBoundOperation,
+        objective::Objective,
         objectivetype::ObjectiveType,
     },
+    incremental::{ChangeTracker, Tracked},
     inner,
+    instrument::{self, trace_span},
+    lazy::{LazyList, ListIter},
+    memory::{self, MemoryUsage},
     parameter::{Parameter, ParameterBuilder},
     pin_ptr,
     plugin::get_plugin,
     prelude::IntoId,
     reaction::{Reaction, ReactionBuilder},
+    required_property,
     rule::{AssignmentRuleBuilder, RateRuleBuilder, Rule, RuleType},
     sbase,
     sbmlcxx::{self},
     sbmldoc::SBMLDocument,
     sbo_term, set_collection_annotation,
     species::{Species, SpeciesBuilder},
+    stoichiometry::{self, FluxBoundVectors, StoichiometryMatrix},
+    table::{self, CompartmentTable, ParameterTable, SpeciesTable},
     traits::fromptr::FromPtr,
     unitdef::{UnitDefinition, UnitDefinitionBuilder},
     upcast_annotation,
@@ -48,27 +64,38 @@ use crate::{
 /// - Reactions (transformations between species)
 /// - Unit definitions (custom units)
 /// - Other SBML elements
+///
+/// Models wrapped from an existing document (e.g. via [`SBMLDocument::model`]) do not
+/// wrap their components up front. Each collection is populated from the native model
+/// the first time it is accessed through one of the `list_of_*`, `get_*` or `create_*`
+/// methods.
 pub struct Model<'a> {
     /// The underlying lib SBML Model pointer wrapped in RefCell and Pin
     inner: RefCell<Pin<&'a mut sbmlcxx::Model>>,
+    /// Cache of the most recently deserialized annotation
+    annotation_cache: AnnotationCache,
+    /// Marks the section of the document that contains this element
+    changes: ChangeTracker<'a>,
     /// List of all Species in the model
-    list_of_species: RefCell<Vec<Rc<Species<'a>>>>,
-    /// List of all Compartments in the model  
-    list_of_compartments: RefCell<Vec<Rc<Compartment<'a>>>>,
+    list_of_species: LazyList<Species<'a>>,
+    /// List of all Compartments in the model
+    list_of_compartments: LazyList<Compartment<'a>>,
     /// List of all UnitDefinitions in the model
-    list_of_unit_definitions: RefCell<Vec<Rc<UnitDefinition<'a>>>>,
+    list_of_unit_definitions: LazyList<UnitDefinition<'a>>,
     /// List of all Reactions in the model
-    list_of_reactions: RefCell<Vec<Rc<Reaction<'a>>>>,
+    list_of_reactions: LazyList<Reaction<'a>>,
     /// List of all Parameters in the model
-    list_of_parameters: RefCell<Vec<Rc<Parameter<'a>>>>,
+    list_of_parameters: LazyList<Parameter<'a>>,
     /// List of all RateRules in the model
-    list_of_rate_rules: RefCell<Vec<Rc<Rule<'a>>>>,
+    list_of_rate_rules: LazyList<Rule<'a>>,
     /// List of all AssignmentRules in the model
-    list_of_assignment_rules: RefCell<Vec<Rc<Rule<'a>>>>,
+    list_of_assignment_rules: LazyList<Rule<'a>>,
     /// List of all Objectives in the model
-    pub(crate) list_of_objectives: RefCell<Vec<Rc<Objective<'a>>>>,
+    pub(crate) list_of_objectives: LazyList<Objective<'a>>,
     /// List of all FluxBounds in the model
-    pub(crate) list_of_flux_bounds: RefCell<Vec<Rc<FluxBound<'a>>>>,
+    pub(crate) list_of_flux_bounds: LazyList<FluxBound<'a>>,
+    /// Dependency graph over reactions and rules, built on first use
+    dependencies: DependencyIndex,
 }
 
 // Set the inner trait for the Model struct
@@ -92,7 +119,8 @@ clone!(
     list_of_rate_rules,
     list_of_assignment_rules,
     list_of_objectives,
-    list_of_flux_bounds
+    list_of_flux_bounds,
+    dependencies
 );
 
 impl<'a> Model<'a> {
@@ -104,21 +132,24 @@ impl<'a> Model<'a> {
     ///
     /// # Returns
     /// A new Model instance initialized with the given ID and empty lists of components
-    pub fn new(document: &SBMLDocument, id: &str) -> Self {
+    pub fn new(document: &'a SBMLDocument, id: &str) -> Self {
         let model_ptr = document.inner().borrow_mut().pin_mut().createModel(id);
         let model = pin_ptr!(model_ptr, sbmlcxx::Model);
 
         Self {
             inner: RefCell::new(model),
-            list_of_species: RefCell::new(Vec::new()),
-            list_of_compartments: RefCell::new(Vec::new()),
-            list_of_unit_definitions: RefCell::new(Vec::new()),
-            list_of_reactions: RefCell::new(Vec::new()),
-            list_of_parameters: RefCell::new(Vec::new()),
-            list_of_rate_rules: RefCell::new(Vec::new()),
-            list_of_assignment_rules: RefCell::new(Vec::new()),
-            list_of_objectives: RefCell::new(Vec::new()),
-            list_of_flux_bounds: RefCell::new(Vec::new()),
+            annotation_cache: AnnotationCache::default(),
+            changes: document.changes().tracker(),
+            list_of_species: LazyList::new(),
+            list_of_compartments: LazyList::new(),
+            list_of_unit_definitions: LazyList::new(),
+            list_of_reactions: LazyList::new(),
+            list_of_parameters: LazyList::new(),
+            list_of_rate_rules: LazyList::new(),
+            list_of_assignment_rules: LazyList::new(),
+            list_of_objectives: LazyList::new(),
+            list_of_flux_bounds: LazyList::new(),
+            dependencies: DependencyIndex::default(),
         }
     }
 
@@ -130,38 +161,15 @@ impl<'a> Model<'a> {
         &self.inner
     }
 
-    /// Gets the model's identifier.
-    ///
-    /// # Returns
-    /// The model's ID as a String
-    pub fn id(&self) -> String {
-        self.inner.borrow().getId().to_str().unwrap().to_string()
-    }
+    // Getter and setter for id
+    required_property!(Model<'a>, id, String, getId, setId, after_set = id_changed);
 
-    /// Sets the model's identifier.
-    ///
-    /// # Arguments
-    /// * `id` - The new identifier to set for the model
-    pub fn set_id(&self, id: &str) {
-        let_cxx_string!(id = id);
-        self.inner.borrow_mut().as_mut().setId(&id);
-    }
+    // Getter and setter for name
+    required_property!(Model<'a>, name, String, getName, setName);
 
-    /// Gets the model's name.
-    ///
-    /// # Returns
-    /// The model's name as a String
-    pub fn name(&self) -> String {
-        self.inner.borrow().getName().to_str().unwrap().to_string()
-    }
-
-    /// Sets the model's name.
-    ///
-    /// # Arguments
-    /// * `name` - The new name to set for the model
-    pub fn set_name(&self, name: &str) {
-        let_cxx_string!(name = name);
-        self.inner.borrow_mut().as_mut().setName(&name);
+    /// Records a new model id as a key change, like the id setters of the components.
+    fn id_changed(&self) {
+        self.changes.mark_key();
     }
 
     /// Creates a new Species within this model.
@@ -173,7 +181,8 @@ impl<'a> Model<'a> {
     /// A new Species instance wrapped in an Rc
     pub fn create_species(&self, id: &str) -> Rc<Species<'a>> {
         let species = Rc::new(Species::new(self, id));
-        self.list_of_species.borrow_mut().push(Rc::clone(&species));
+        self.list_of_species.push(Rc::clone(&species));
+        species.mark_dirty();
         species
     }
 
@@ -192,12 +201,51 @@ impl<'a> Model<'a> {
         SpeciesBuilder::new(self, id)
     }
 
+    /// Creates and populates a batch of species.
+    ///
+    /// The whole batch is created through a single FFI call, which is considerably
+    /// faster than [`create_species`](Self::create_species) followed by individual
+    /// setters when building large models. See [`crate::batch`] for details.
+    ///
+    /// # Arguments
+    /// * `specs` - Descriptions of the species to create
+    ///
+    /// # Returns
+    /// The created species, in the order of `specs`
+    pub fn add_species_batch(&self, specs: &[SpeciesSpec]) -> Vec<Rc<Species<'a>>> {
+        let species = batch::create_species(self, specs);
+        self.list_of_species.extend(&species);
+        if let Some(first) = species.first() {
+            first.mark_dirty();
+        }
+        species
+    }
+
     /// Returns a vector of all species in the model.
     ///
     /// # Returns
     /// A vector containing Rc references to all Species in the model
     pub fn list_of_species(&self) -> Vec<Rc<Species<'a>>> {
-        self.list_of_species.borrow().to_vec()
+        self.loaded_species().borrow().to_vec()
+    }
+
+    /// Returns an iterator over all species in the model.
+    ///
+    /// Unlike [`Model::list_of_species`], this does not copy the list. Species
+    /// created while iterating are yielded as well.
+    pub fn species_iter(&self) -> ListIter<'_, Species<'a>> {
+        ListIter::new(self.loaded_species())
+    }
+
+    /// Exports the attributes of all species of this model as columns.
+    ///
+    /// The columns are filled in a single walk over the native species, without
+    /// wrapping them. See [`crate::table`] for how unset values are represented.
+    ///
+    /// # Returns
+    /// A SpeciesTable with one entry per species, in model order
+    pub fn species_table(&self) -> SpeciesTable {
+        table::species_table(self)
     }
 
     /// Retrieves a species from the model by its identifier.
@@ -208,11 +256,7 @@ impl<'a> Model<'a> {
     /// # Returns
     /// Some(`Rc<Species>`) if found, None if not found
     pub fn get_species(&self, id: &str) -> Option<Rc<Species<'a>>> {
-        self.list_of_species
-            .borrow()
-            .iter()
-            .find(|species| (*species).id() == id)
-            .map(Rc::clone)
+        self.list_of_species.find(id, || self.load_species())
     }
 
     /// Creates a new Compartment within this model.
@@ -224,9 +268,8 @@ impl<'a> Model<'a> {
     /// A new Compartment instance wrapped in an Rc
     pub fn create_compartment(&self, id: &str) -> Rc<Compartment<'a>> {
         let compartment = Rc::new(Compartment::new(self, id));
-        self.list_of_compartments
-            .borrow_mut()
-            .push(Rc::clone(&compartment));
+        self.list_of_compartments.push(Rc::clone(&compartment));
+        compartment.mark_dirty();
         compartment
     }
 
@@ -250,7 +293,26 @@ impl<'a> Model<'a> {
     /// # Returns
     /// A vector containing Rc references to all Compartments in the model
     pub fn list_of_compartments(&self) -> Vec<Rc<Compartment<'a>>> {
-        self.list_of_compartments.borrow().to_vec()
+        self.loaded_compartments().borrow().to_vec()
+    }
+
+    /// Returns an iterator over all compartments in the model.
+    ///
+    /// Unlike [`Model::list_of_compartments`], this does not copy the list. Compartments
+    /// created while iterating are yielded as well.
+    pub fn compartments_iter(&self) -> ListIter<'_, Compartment<'a>> {
+        ListIter::new(self.loaded_compartments())
+    }
+
+    /// Exports the attributes of all compartments of this model as columns.
+    ///
+    /// The columns are filled in a single walk over the native compartments, without
+    /// wrapping them. See [`crate::table`] for how unset values are represented.
+    ///
+    /// # Returns
+    /// A CompartmentTable with one entry per compartment, in model order
+    pub fn compartments_table(&self) -> CompartmentTable {
+        table::compartments_table(self)
     }
 
     /// Retrieves a compartment from the model by its identifier.
@@ -262,10 +324,7 @@ impl<'a> Model<'a> {
     /// Some(`Rc<Compartment>`) if found, None if not found
     pub fn get_compartment(&self, id: &str) -> Option<Rc<Compartment<'a>>> {
         self.list_of_compartments
-            .borrow()
-            .iter()
-            .find(|compartment| (*compartment).id() == id)
-            .map(Rc::clone)
+            .find(id, || self.load_compartments())
     }
 
     /// Creates a new UnitDefinition within this model.
@@ -279,8 +338,8 @@ impl<'a> Model<'a> {
     pub fn create_unit_definition(&self, id: &str, name: &str) -> Rc<UnitDefinition<'a>> {
         let unit_definition = Rc::new(UnitDefinition::new(self, id, name));
         self.list_of_unit_definitions
-            .borrow_mut()
             .push(Rc::clone(&unit_definition));
+        unit_definition.mark_dirty();
         unit_definition
     }
 
@@ -305,7 +364,15 @@ impl<'a> Model<'a> {
     /// # Returns
     /// A vector containing Rc references to all UnitDefinitions in the model
     pub fn list_of_unit_definitions(&self) -> Vec<Rc<UnitDefinition<'a>>> {
-        self.list_of_unit_definitions.borrow().to_vec()
+        self.loaded_unit_definitions().borrow().to_vec()
+    }
+
+    /// Returns an iterator over all unit definitions in the model.
+    ///
+    /// Unlike [`Model::list_of_unit_definitions`], this does not copy the list. Unit definitions
+    /// created while iterating are yielded as well.
+    pub fn unit_definitions_iter(&self) -> ListIter<'_, UnitDefinition<'a>> {
+        ListIter::new(self.loaded_unit_definitions())
     }
 
     /// Retrieves a unit definition from the model by its identifier.
@@ -317,10 +384,7 @@ impl<'a> Model<'a> {
     /// Some(`Rc<UnitDefinition>`) if found, None if not found
     pub fn get_unit_definition(&self, id: &str) -> Option<Rc<UnitDefinition<'a>>> {
         self.list_of_unit_definitions
-            .borrow()
-            .iter()
-            .find(|unit_definition| (*unit_definition).id() == id)
-            .map(Rc::clone)
+            .find(id, || self.load_unit_definitions())
     }
 
     /// Creates a new Reaction within this model.
@@ -332,9 +396,8 @@ impl<'a> Model<'a> {
     /// A new Reaction instance wrapped in an Rc
     pub fn create_reaction(&self, id: &str) -> Rc<Reaction<'a>> {
         let reaction = Rc::new(Reaction::new(self, id));
-        self.list_of_reactions
-            .borrow_mut()
-            .push(Rc::clone(&reaction));
+        self.list_of_reactions.push(Rc::clone(&reaction));
+        reaction.mark_dirty();
         reaction
     }
 
@@ -353,12 +416,40 @@ impl<'a> Model<'a> {
         ReactionBuilder::new(self, id)
     }
 
+    /// Creates and populates a batch of reactions, including their species references
+    /// and kinetic laws.
+    ///
+    /// The reactions and all of their participants are created through a single FFI
+    /// call. See [`crate::batch`] for details.
+    ///
+    /// # Arguments
+    /// * `specs` - Descriptions of the reactions to create
+    ///
+    /// # Returns
+    /// The created reactions, in the order of `specs`
+    pub fn add_reactions_batch(&self, specs: &[ReactionSpec]) -> Vec<Rc<Reaction<'a>>> {
+        let reactions = batch::create_reactions(self, specs);
+        self.list_of_reactions.extend(&reactions);
+        if let Some(first) = reactions.first() {
+            first.mark_dirty();
+        }
+        reactions
+    }
+
     /// Returns a vector of all reactions in the model.
     ///
     /// # Returns
     /// A vector containing Rc references to all Reactions in the model
     pub fn list_of_reactions(&self) -> Vec<Rc<Reaction<'a>>> {
-        self.list_of_reactions.borrow().to_vec()
+        self.loaded_reactions().borrow().to_vec()
+    }
+
+    /// Returns an iterator over all reactions in the model.
+    ///
+    /// Unlike [`Model::list_of_reactions`], this does not copy the list. Reactions
+    /// created while iterating are yielded as well.
+    pub fn reactions_iter(&self) -> ListIter<'_, Reaction<'a>> {
+        ListIter::new(self.loaded_reactions())
     }
 
     /// Retrieves a reaction from the model by its identifier.
@@ -369,11 +460,7 @@ impl<'a> Model<'a> {
     /// # Returns
     /// Some(`Rc<Reaction>`) if found, None if not found
     pub fn get_reaction(&self, id: &str) -> Option<Rc<Reaction<'a>>> {
-        self.list_of_reactions
-            .borrow()
-            .iter()
-            .find(|reaction| (*reaction).id() == id)
-            .map(Rc::clone)
+        self.list_of_reactions.find(id, || self.load_reactions())
     }
 
     /// Creates a new Parameter within this model.
@@ -385,9 +472,8 @@ impl<'a> Model<'a> {
     /// A new Parameter instance wrapped in an Rc
     pub fn create_parameter(&self, id: &str) -> Rc<Parameter<'a>> {
         let parameter = Rc::new(Parameter::new(self, id));
-        self.list_of_parameters
-            .borrow_mut()
-            .push(Rc::clone(&parameter));
+        self.list_of_parameters.push(Rc::clone(&parameter));
+        parameter.mark_dirty();
         parameter
     }
 
@@ -406,12 +492,50 @@ impl<'a> Model<'a> {
         ParameterBuilder::new(self, id)
     }
 
+    /// Creates and populates a batch of parameters.
+    ///
+    /// The whole batch is created through a single FFI call. See [`crate::batch`] for
+    /// details.
+    ///
+    /// # Arguments
+    /// * `specs` - Descriptions of the parameters to create
+    ///
+    /// # Returns
+    /// The created parameters, in the order of `specs`
+    pub fn add_parameters_batch(&self, specs: &[ParameterSpec]) -> Vec<Rc<Parameter<'a>>> {
+        let parameters = batch::create_parameters(self, specs);
+        self.list_of_parameters.extend(&parameters);
+        if let Some(first) = parameters.first() {
+            first.mark_dirty();
+        }
+        parameters
+    }
+
     /// Returns a vector of all parameters in the model.
     ///
     /// # Returns
     /// A vector containing Rc references to all Parameters in the model
     pub fn list_of_parameters(&self) -> Vec<Rc<Parameter<'a>>> {
-        self.list_of_parameters.borrow().to_vec()
+        self.loaded_parameters().borrow().to_vec()
+    }
+
+    /// Returns an iterator over all parameters in the model.
+    ///
+    /// Unlike [`Model::list_of_parameters`], this does not copy the list. Parameters
+    /// created while iterating are yielded as well.
+    pub fn parameters_iter(&self) -> ListIter<'_, Parameter<'a>> {
+        ListIter::new(self.loaded_parameters())
+    }
+
+    /// Exports the attributes of all parameters of this model as columns.
+    ///
+    /// The columns are filled in a single walk over the native parameters, without
+    /// wrapping them. See [`crate::table`] for how unset values are represented.
+    ///
+    /// # Returns
+    /// A ParameterTable with one entry per parameter, in model order
+    pub fn parameters_table(&self) -> ParameterTable {
+        table::parameters_table(self)
     }
 
     /// Retrieves a parameter from the model by its identifier.
@@ -422,11 +546,7 @@ impl<'a> Model<'a> {
     /// # Returns
     /// Some(`Rc<Parameter>`) if found, None if not found
     pub fn get_parameter(&self, id: &str) -> Option<Rc<Parameter<'a>>> {
-        self.list_of_parameters
-            .borrow()
-            .iter()
-            .find(|parameter| (*parameter).id() == id)
-            .map(Rc::clone)
+        self.list_of_parameters.find(id, || self.load_parameters())
     }
 
     /// Creates a new RateRule within this model.
@@ -439,9 +559,8 @@ impl<'a> Model<'a> {
     /// A new RateRule instance wrapped in an Rc
     pub fn create_rate_rule(&self, variable: impl IntoId, formula: &str) -> Rc<Rule<'a>> {
         let rate_rule = Rc::new(Rule::new_rate_rule(self, variable, formula));
-        self.list_of_rate_rules
-            .borrow_mut()
-            .push(Rc::clone(&rate_rule));
+        self.list_of_rate_rules.push(Rc::clone(&rate_rule));
+        rate_rule.mark_dirty();
         rate_rule
     }
 
@@ -466,7 +585,15 @@ impl<'a> Model<'a> {
     /// # Returns
     /// A vector containing Rc references to all RateRules in the model
     pub fn list_of_rate_rules(&self) -> Vec<Rc<Rule<'a>>> {
-        self.list_of_rate_rules.borrow().to_vec()
+        self.loaded_rate_rules().borrow().to_vec()
+    }
+
+    /// Returns an iterator over all rate rules in the model.
+    ///
+    /// Unlike [`Model::list_of_rate_rules`], this does not copy the list. Rate rules
+    /// created while iterating are yielded as well.
+    pub fn rate_rules_iter(&self) -> ListIter<'_, Rule<'a>> {
+        ListIter::new(self.loaded_rate_rules())
     }
 
     /// Retrieves a rate rule from the model by its identifier.
@@ -478,10 +605,7 @@ impl<'a> Model<'a> {
     /// Some(`Rc<Rule>`) if found, None if not found
     pub fn get_rate_rule(&self, variable: &str) -> Option<Rc<Rule<'a>>> {
         self.list_of_rate_rules
-            .borrow()
-            .iter()
-            .find(|rule| (*rule).variable() == variable)
-            .map(Rc::clone)
+            .find(variable, || self.load_rules(RuleType::RateRule))
     }
 
     /// Creates a new AssignmentRule within this model.
@@ -495,8 +619,8 @@ impl<'a> Model<'a> {
     pub fn create_assignment_rule(&self, variable: impl IntoId, formula: &str) -> Rc<Rule<'a>> {
         let assignment_rule = Rc::new(Rule::new_assignment_rule(self, variable, formula));
         self.list_of_assignment_rules
-            .borrow_mut()
             .push(Rc::clone(&assignment_rule));
+        assignment_rule.mark_dirty();
         assignment_rule
     }
 
@@ -525,7 +649,15 @@ impl<'a> Model<'a> {
     /// # Returns
     /// A vector containing Rc references to all AssignmentRules in the model
     pub fn list_of_assignment_rules(&self) -> Vec<Rc<Rule<'a>>> {
-        self.list_of_assignment_rules.borrow().to_vec()
+        self.loaded_assignment_rules().borrow().to_vec()
+    }
+
+    /// Returns an iterator over all assignment rules in the model.
+    ///
+    /// Unlike [`Model::list_of_assignment_rules`], this does not copy the list. Assignment rules
+    /// created while iterating are yielded as well.
+    pub fn assignment_rules_iter(&self) -> ListIter<'_, Rule<'a>> {
+        ListIter::new(self.loaded_assignment_rules())
     }
 
     /// Retrieves an assignment rule from the model by its variable identifier.
@@ -537,10 +669,7 @@ impl<'a> Model<'a> {
     /// Some(`Rc<Rule>`) if found, None if not found
     pub fn get_assignment_rule(&self, variable: &str) -> Option<Rc<Rule<'a>>> {
         self.list_of_assignment_rules
-            .borrow()
-            .iter()
-            .find(|rule| (*rule).variable() == variable)
-            .map(Rc::clone)
+            .find(variable, || self.load_rules(RuleType::AssignmentRule))
     }
 
     /// Returns a vector of all objectives in the model.
@@ -548,7 +677,15 @@ impl<'a> Model<'a> {
     /// # Returns
     /// A vector containing Rc references to all Objectives in the model
     pub fn list_of_objectives(&self) -> Vec<Rc<Objective<'a>>> {
-        self.list_of_objectives.borrow().to_vec()
+        self.loaded_objectives().borrow().to_vec()
+    }
+
+    /// Returns an iterator over all objectives in the model.
+    ///
+    /// Unlike [`Model::list_of_objectives`], this does not copy the list. Objectives
+    /// created while iterating are yielded as well.
+    pub fn objectives_iter(&self) -> ListIter<'_, Objective<'a>> {
+        ListIter::new(self.loaded_objectives())
     }
 
     /// Creates a new Objective within this model.
@@ -565,9 +702,8 @@ impl<'a> Model<'a> {
         obj_type: impl Into<ObjectiveType>,
     ) -> Result<Rc<Objective<'a>>, LibSBMLError> {
         let objective = Rc::new(Objective::new(self, id, obj_type)?);
-        self.list_of_objectives
-            .borrow_mut()
-            .push(Rc::clone(&objective));
+        self.list_of_objectives.push(Rc::clone(&objective));
+        objective.mark_dirty();
         Ok(objective)
     }
 
@@ -579,11 +715,7 @@ impl<'a> Model<'a> {
     /// # Returns
     /// Some(`Rc<Objective>`) if found, None if not found
     pub fn get_objective(&self, id: &str) -> Option<Rc<Objective<'a>>> {
-        self.list_of_objectives
-            .borrow()
-            .iter()
-            .find(|objective| (*objective).id() == id)
-            .map(Rc::clone)
+        self.list_of_objectives.find(id, || self.load_objectives())
     }
 
     /// Returns a vector of all flux bounds in the model.
@@ -591,7 +723,15 @@ impl<'a> Model<'a> {
     /// # Returns
     /// A vector containing Rc references to all FluxBounds in the model
     pub fn list_of_flux_bounds(&self) -> Vec<Rc<FluxBound<'a>>> {
-        self.list_of_flux_bounds.borrow().to_vec()
+        self.loaded_flux_bounds().borrow().to_vec()
+    }
+
+    /// Returns an iterator over all flux bounds in the model.
+    ///
+    /// Unlike [`Model::list_of_flux_bounds`], this does not copy the list. Flux bounds
+    /// created while iterating are yielded as well.
+    pub fn flux_bounds_iter(&self) -> ListIter<'_, FluxBound<'a>> {
+        ListIter::new(self.loaded_flux_bounds())
     }
 
     /// Creates a new FluxBound within this model.
@@ -610,9 +750,8 @@ impl<'a> Model<'a> {
         operation: impl Into<FluxBoundOperation>,
     ) -> Result<Rc<FluxBound<'a>>, LibSBMLError> {
         let flux_bound = Rc::new(FluxBound::new(self, id, reaction_id, operation)?);
-        self.list_of_flux_bounds
-            .borrow_mut()
-            .push(Rc::clone(&flux_bound));
+        self.list_of_flux_bounds.push(Rc::clone(&flux_bound));
+        flux_bound.mark_dirty();
         Ok(flux_bound)
     }
 
@@ -625,10 +764,181 @@ impl<'a> Model<'a> {
     /// Some(`Rc<FluxBound>`) if found, None if not found
     pub fn get_flux_bound(&self, id: &str) -> Option<Rc<FluxBound<'a>>> {
         self.list_of_flux_bounds
-            .borrow()
-            .iter()
-            .find(|flux_bound| (*flux_bound).id() == Some(id.to_string()))
-            .map(Rc::clone)
+            .find(id, || self.load_flux_bounds())
+    }
+
+    /// Returns a handle for the flux bound with the given identifier, for use with
+    /// [`Model::update_flux_bounds`].
+    ///
+    /// # Arguments
+    /// * `id` - The identifier of the flux bound
+    ///
+    /// # Returns
+    /// Some(`FluxBoundHandle`) if found, None if not found
+    pub fn flux_bound_handle(&self, id: &str) -> Option<FluxBoundHandle> {
+        self.list_of_flux_bounds
+            .position(id, || self.load_flux_bounds())
+            .map(FluxBoundHandle::from_index)
+    }
+
+    /// Returns a handle for a flux objective, for use with
+    /// [`Model::update_objective_coefficients`].
+    ///
+    /// # Arguments
+    /// * `objective_id` - The identifier of the objective
+    /// * `flux_objective_id` - The identifier of the flux objective within the objective
+    ///
+    /// # Returns
+    /// Some(`FluxObjectiveHandle`) if found, None if not found
+    pub fn flux_objective_handle(
+        &self,
+        objective_id: &str,
+        flux_objective_id: &str,
+    ) -> Option<FluxObjectiveHandle> {
+        let objective = self
+            .list_of_objectives
+            .position(objective_id, || self.load_objectives())?;
+        let flux_objective = self.loaded_objectives().borrow()[objective]
+            .flux_objective_position(flux_objective_id)?;
+        Some(FluxObjectiveHandle::from_indices(objective, flux_objective))
+    }
+
+    /// Sets the values of many flux bounds through a single native call.
+    ///
+    /// See [`crate::fbc::bulk`] for details.
+    ///
+    /// # Arguments
+    /// * `updates` - Pairs of flux bound handles and their new values
+    /// * `validation` - Whether handles and values are checked before writing
+    ///
+    /// # Errors
+    /// With [`Validation::Checked`], returns `LibSBMLError::InvalidArgument` without
+    /// changing any value if a handle does not refer to a flux bound or a value is NaN
+    pub fn update_flux_bounds(
+        &self,
+        updates: &[(FluxBoundHandle, f64)],
+        validation: Validation,
+    ) -> Result<(), LibSBMLError> {
+        bulk::update_flux_bounds(self, updates, validation)
+    }
+
+    /// Sets the coefficients of many flux objectives through a single native call.
+    ///
+    /// See [`crate::fbc::bulk`] for details.
+    ///
+    /// # Arguments
+    /// * `updates` - Pairs of flux objective handles and their new coefficients
+    /// * `validation` - Whether handles and values are checked before writing
+    ///
+    /// # Errors
+    /// With [`Validation::Checked`], returns `LibSBMLError::InvalidArgument` without
+    /// changing any coefficient if a handle does not refer to a flux objective or a
+    /// value is NaN
+    pub fn update_objective_coefficients(
+        &self,
+        updates: &[(FluxObjectiveHandle, f64)],
+        validation: Validation,
+    ) -> Result<(), LibSBMLError> {
+        bulk::update_objective_coefficients(self, updates, validation)
+    }
+
+    /// Builds the stoichiometric matrix of the model in compressed sparse column format.
+    ///
+    /// Rows correspond to species and columns to reactions, in model order. The native
+    /// model is traversed once, without wrapping any of its components.
+    ///
+    /// # Returns
+    /// The matrix together with id→index tables for species and reactions
+    ///
+    /// # Errors
+    /// Returns `LibSBMLError::InvalidArgument` if a species reference refers to a
+    /// species that does not exist
+    pub fn stoichiometry_csc(&self) -> Result<StoichiometryMatrix, LibSBMLError> {
+        stoichiometry::stoichiometry_csc(self)
+    }
+
+    /// Folds the FBC flux bounds of the model into dense lower and upper bound vectors,
+    /// indexed like the reactions of the model.
+    ///
+    /// # Errors
+    /// Returns `LibSBMLError::InvalidArgument` if a flux bound refers to a reaction
+    /// that does not exist
+    pub fn flux_bounds_vectors(&self) -> Result<FluxBoundVectors, LibSBMLError> {
+        stoichiometry::flux_bounds_vectors(self)
+    }
+
+    /// Builds the dense coefficient vector of the active FBC objective, indexed like
+    /// the reactions of the model.
+    ///
+    /// If no objective is marked as active, the first objective is used.
+    ///
+    /// # Returns
+    /// The objective coefficients, or None if the model has no objectives
+    ///
+    /// # Errors
+    /// Returns `LibSBMLError::InvalidArgument` if a flux objective refers to a reaction
+    /// that does not exist
+    pub fn objective_vector(&self) -> Result<Option<Vec<f64>>, LibSBMLError> {
+        stoichiometry::objective_vector(self)
+    }
+
+    /// Returns the species–reaction–rule dependency graph of the model.
+    ///
+    /// The graph is built on first use. Afterwards, reactions and rules created on this
+    /// model, species references and kinetic laws created on its reactions, and formula
+    /// and variable changes made through its wrappers are applied incrementally on the
+    /// next call. See [`crate::dependency`] for details.
+    ///
+    /// # Panics
+    /// Panics if a graph returned by a previous call is still borrowed.
+    pub fn dependency_graph(&self) -> Ref<'_, DependencyGraph> {
+        self.dependencies.graph(
+            &self.loaded_reactions().borrow(),
+            &self.loaded_rate_rules().borrow(),
+            &self.loaded_assignment_rules().borrow(),
+        )
+    }
+
+    /// Discards the dependency graph, so that the next call to
+    /// [`Model::dependency_graph`] rebuilds it from the native model.
+    ///
+    /// This is only needed after changes the graph cannot observe, such as renaming a
+    /// reaction or changing the species of an existing species reference.
+    pub fn invalidate_dependency_graph(&self) {
+        self.dependencies.invalidate();
+    }
+
+    /// Returns a hook through which a reaction or rule of this model reports changes to
+    /// the dependency graph.
+    pub(crate) fn dependency_hook(&self, change: Change) -> ChangeHook {
+        self.dependencies.hook(change)
+    }
+
+    /// Reports the memory held by this model.
+    ///
+    /// Covers the native object tree of the model and the wrappers held in its
+    /// collections, down to the species references of reactions, the units of unit
+    /// definitions and the flux objectives of objectives. Collections that were never
+    /// accessed hold no wrappers, so the report does not populate them. See
+    /// [`MemoryUsage`] for details.
+    pub fn memory_usage(&self) -> MemoryUsage {
+        let base = crate::upcast!(self, sbmlcxx::Model, sbmlcxx::SBase);
+        let mut usage = MemoryUsage::native(&base);
+        usage.wrapper_bytes += std::mem::size_of::<Self>();
+        usage += self.list_of_species.memory_usage(memory::leaf);
+        usage += self.list_of_compartments.memory_usage(memory::leaf);
+        usage += self
+            .list_of_unit_definitions
+            .memory_usage(UnitDefinition::wrapper_usage);
+        usage += self.list_of_reactions.memory_usage(Reaction::wrapper_usage);
+        usage += self.list_of_parameters.memory_usage(memory::leaf);
+        usage += self.list_of_rate_rules.memory_usage(memory::leaf);
+        usage += self.list_of_assignment_rules.memory_usage(memory::leaf);
+        usage += self
+            .list_of_objectives
+            .memory_usage(Objective::wrapper_usage);
+        usage += self.list_of_flux_bounds.memory_usage(memory::leaf);
+        usage
     }
 
     // Implement the set_annotation method for the Model type
@@ -648,15 +958,24 @@ impl<'a> std::fmt::Debug for Model<'a> {
         let mut ds = f.debug_struct("Model");
         ds.field("id", &self.id());
         ds.field("name", &self.name());
-        ds.field("list_of_species", &self.list_of_species());
-        ds.field("list_of_compartments", &self.list_of_compartments());
-        ds.field("list_of_unit_definitions", &self.list_of_unit_definitions());
-        ds.field("list_of_reactions", &self.list_of_reactions());
-        ds.field("list_of_parameters", &self.list_of_parameters());
-        ds.field("list_of_rate_rules", &self.list_of_rate_rules());
-        ds.field("list_of_assignment_rules", &self.list_of_assignment_rules());
-        ds.field("list_of_objectives", &self.list_of_objectives());
-        ds.field("list_of_flux_bounds", &self.list_of_flux_bounds());
+        ds.field("list_of_species", &*self.loaded_species().borrow());
+        ds.field(
+            "list_of_compartments",
+            &*self.loaded_compartments().borrow(),
+        );
+        ds.field(
+            "list_of_unit_definitions",
+            &*self.loaded_unit_definitions().borrow(),
+        );
+        ds.field("list_of_reactions", &*self.loaded_reactions().borrow());
+        ds.field("list_of_parameters", &*self.loaded_parameters().borrow());
+        ds.field("list_of_rate_rules", &*self.loaded_rate_rules().borrow());
+        ds.field(
+            "list_of_assignment_rules",
+            &*self.loaded_assignment_rules().borrow(),
+        );
+        ds.field("list_of_objectives", &*self.loaded_objectives().borrow());
+        ds.field("list_of_flux_bounds", &*self.loaded_flux_bounds().borrow());
         ds.finish()
     }
 }
@@ -675,115 +994,205 @@ impl<'a> std::fmt::Debug for Model<'a> {
 /// A new Model instance
 impl<'a> FromPtr<sbmlcxx::Model> for Model<'a> {
     fn from_ptr(ptr: *mut sbmlcxx::Model) -> Self {
-        let model = RefCell::new(pin_ptr!(ptr, sbmlcxx::Model));
+        trace_span!("model_from_ptr");
+        instrument::record_wrappers(1);
+        let model = pin_ptr!(ptr, sbmlcxx::Model);
+
+        // Components are wrapped on first access, see the `loaded_*` methods
+        Self {
+            inner: RefCell::new(model),
+            annotation_cache: AnnotationCache::default(),
+            changes: ChangeTracker::default(),
+            list_of_species: LazyList::deferred(),
+            list_of_compartments: LazyList::deferred(),
+            list_of_unit_definitions: LazyList::deferred(),
+            list_of_reactions: LazyList::deferred(),
+            list_of_parameters: LazyList::deferred(),
+            list_of_rate_rules: LazyList::deferred(),
+            list_of_assignment_rules: LazyList::deferred(),
+            list_of_objectives: LazyList::deferred(),
+            list_of_flux_bounds: LazyList::deferred(),
+            dependencies: DependencyIndex::default(),
+        }
+    }
+}
 
-        // Fetch all species
-        let n_species = model.borrow().getNumSpecies().0;
-        let list_of_species: Vec<_> = (0..n_species)
+/// Accessors that populate the component collections from the native model on demand.
+impl<'a> Model<'a> {
+    /// Returns the species of the model, wrapping them on first access.
+    fn loaded_species(&self) -> &RefCell<Vec<Rc<Species<'a>>>> {
+        self.list_of_species.get_or_load(|| self.load_species())
+    }
+
+    /// Returns the compartments of the model, wrapping them on first access.
+    fn loaded_compartments(&self) -> &RefCell<Vec<Rc<Compartment<'a>>>> {
+        self.list_of_compartments
+            .get_or_load(|| self.load_compartments())
+    }
+
+    /// Returns the unit definitions of the model, wrapping them on first access.
+    fn loaded_unit_definitions(&self) -> &RefCell<Vec<Rc<UnitDefinition<'a>>>> {
+        self.list_of_unit_definitions
+            .get_or_load(|| self.load_unit_definitions())
+    }
+
+    /// Returns the reactions of the model, wrapping them on first access.
+    fn loaded_reactions(&self) -> &RefCell<Vec<Rc<Reaction<'a>>>> {
+        self.list_of_reactions.get_or_load(|| self.load_reactions())
+    }
+
+    /// Returns the parameters of the model, wrapping them on first access.
+    fn loaded_parameters(&self) -> &RefCell<Vec<Rc<Parameter<'a>>>> {
+        self.list_of_parameters
+            .get_or_load(|| self.load_parameters())
+    }
+
+    /// Returns the rate rules of the model, wrapping them on first access.
+    fn loaded_rate_rules(&self) -> &RefCell<Vec<Rc<Rule<'a>>>> {
+        self.list_of_rate_rules
+            .get_or_load(|| self.load_rules(RuleType::RateRule))
+    }
+
+    /// Returns the assignment rules of the model, wrapping them on first access.
+    fn loaded_assignment_rules(&self) -> &RefCell<Vec<Rc<Rule<'a>>>> {
+        self.list_of_assignment_rules
+            .get_or_load(|| self.load_rules(RuleType::AssignmentRule))
+    }
+
+    /// Returns the FBC objectives of the model, wrapping them on first access.
+    pub(crate) fn loaded_objectives(&self) -> &RefCell<Vec<Rc<Objective<'a>>>> {
+        self.list_of_objectives
+            .get_or_load(|| self.load_objectives())
+    }
+
+    /// Returns the FBC flux bounds of the model, wrapping them on first access.
+    pub(crate) fn loaded_flux_bounds(&self) -> &RefCell<Vec<Rc<FluxBound<'a>>>> {
+        self.list_of_flux_bounds
+            .get_or_load(|| self.load_flux_bounds())
+    }
+
+    /// Wraps all native species.
+    fn load_species(&self) -> Vec<Rc<Species<'a>>> {
+        let n_species = self.inner.borrow().getNumSpecies().0;
+        (0..n_species)
             .map(|i| {
-                let species = model.borrow_mut().as_mut().getSpecies1(i.into());
-                let species = Rc::new(Species::from_ptr(species));
-                Rc::clone(&species)
+                let species = self.inner.borrow_mut().as_mut().getSpecies1(i.into());
+                Rc::new(Species::from_ptr(species).with_changes(self.changes))
             })
-            .collect();
+            .collect()
+    }
 
-        // Fetch all compartments
-        let n_compartments = model.borrow().getNumCompartments().0;
-        let list_of_compartments: Vec<_> = (0..n_compartments)
+    /// Wraps all native compartments.
+    fn load_compartments(&self) -> Vec<Rc<Compartment<'a>>> {
+        let n_compartments = self.inner.borrow().getNumCompartments().0;
+        (0..n_compartments)
             .map(|i| {
-                let compartment = model.borrow_mut().as_mut().getCompartment1(i.into());
-                let compartment = Rc::new(Compartment::from_ptr(compartment));
-                Rc::clone(&compartment)
+                let compartment = self.inner.borrow_mut().as_mut().getCompartment1(i.into());
+                Rc::new(Compartment::from_ptr(compartment).with_changes(self.changes))
             })
-            .collect();
+            .collect()
+    }
 
-        // Fetch all unit definitions
-        let n_unit_definitions = model.borrow().getNumUnitDefinitions().0;
-        let list_of_unit_definitions: Vec<_> = (0..n_unit_definitions)
+    /// Wraps all native unit definitions.
+    fn load_unit_definitions(&self) -> Vec<Rc<UnitDefinition<'a>>> {
+        let n_unit_definitions = self.inner.borrow().getNumUnitDefinitions().0;
+        (0..n_unit_definitions)
             .map(|i| {
-                let unit_definition = model.borrow_mut().as_mut().getUnitDefinition1(i.into());
-                let unit_definition = Rc::new(UnitDefinition::from_ptr(unit_definition));
-                Rc::clone(&unit_definition)
+                let unit_definition = self
+                    .inner
+                    .borrow_mut()
+                    .as_mut()
+                    .getUnitDefinition1(i.into());
+                Rc::new(UnitDefinition::from_ptr(unit_definition).with_changes(self.changes))
             })
-            .collect();
+            .collect()
+    }
 
-        // Fetch all reactions
-        let n_reactions = model.borrow().getNumReactions().0;
-        let list_of_reactions: Vec<_> = (0..n_reactions)
+    /// Wraps all native reactions.
+    fn load_reactions(&self) -> Vec<Rc<Reaction<'a>>> {
+        let n_reactions = self.inner.borrow().getNumReactions().0;
+        (0..n_reactions)
             .map(|i| {
-                let reaction = model.borrow_mut().as_mut().getReaction1(i.into());
-                let reaction = Rc::new(Reaction::from_ptr(reaction));
-                Rc::clone(&reaction)
+                let reaction = self.inner.borrow_mut().as_mut().getReaction1(i.into());
+                Rc::new(
+                    Reaction::from_ptr(reaction)
+                        .tracked_by(self)
+                        .with_changes(self.changes),
+                )
             })
-            .collect();
+            .collect()
+    }
 
-        // Fetch all parameters
-        let n_parameters = model.borrow().getNumParameters().0;
-        let list_of_parameters: Vec<_> = (0..n_parameters)
+    /// Wraps all native parameters.
+    fn load_parameters(&self) -> Vec<Rc<Parameter<'a>>> {
+        let n_parameters = self.inner.borrow().getNumParameters().0;
+        (0..n_parameters)
             .map(|i| {
-                let parameter = model.borrow_mut().as_mut().getParameter1(i.into());
-                let parameter = Rc::new(Parameter::from_ptr(parameter));
-                Rc::clone(&parameter)
+                let parameter = self.inner.borrow_mut().as_mut().getParameter1(i.into());
+                Rc::new(Parameter::from_ptr(parameter).with_changes(self.changes))
             })
-            .collect();
+            .collect()
+    }
 
-        // Fetch all rate rules
-        let n_rate_rules = model.borrow().getNumRules().0;
-        let mut list_of_rate_rules: Vec<_> = Vec::new();
-        let mut list_of_assignment_rules: Vec<_> = Vec::new();
+    /// Wraps all native rules of the given type.
+    ///
+    /// Rate and assignment rules share a single native list, so both collections
+    /// are populated by filtering it.
+    fn load_rules(&self, rule_type: RuleType) -> Vec<Rc<Rule<'a>>> {
+        let n_rules = self.inner.borrow().getNumRules().0;
+        let mut rules = Vec::new();
 
-        for i in 0..n_rate_rules {
-            let mut model_mut = model.borrow_mut();
-            let rule = model_mut.as_mut().getRule1(i.into());
-            let rule = Rc::new(Rule::from_ptr(rule));
+        for i in 0..n_rules {
+            let rule = self.inner.borrow_mut().as_mut().getRule1(i.into());
+            let rule = Rule::from_ptr(rule)
+                .tracked_by(self)
+                .with_changes(self.changes);
             match rule.rule_type() {
-                Ok(RuleType::RateRule) => list_of_rate_rules.push(Rc::clone(&rule)),
-                Ok(RuleType::AssignmentRule) => list_of_assignment_rules.push(Rc::clone(&rule)),
+                Ok(current) if current == rule_type => rules.push(Rc::new(rule)),
+                Ok(_) => {}
                 Err(e) => println!("{e}"),
             }
         }
 
-        let model = Self {
-            inner: model,
-            list_of_species: RefCell::new(list_of_species),
-            list_of_compartments: RefCell::new(list_of_compartments),
-            list_of_unit_definitions: RefCell::new(list_of_unit_definitions),
-            list_of_reactions: RefCell::new(list_of_reactions),
-            list_of_parameters: RefCell::new(list_of_parameters),
-            list_of_rate_rules: RefCell::new(list_of_rate_rules),
-            list_of_assignment_rules: RefCell::new(list_of_assignment_rules),
-            list_of_objectives: RefCell::new(Vec::new()),
-            list_of_flux_bounds: RefCell::new(Vec::new()),
-        };
-
-        // Fetch all plugins
+        rules
+    }
+
+    /// Wraps all native FBC objectives, or none if the FBC package is not enabled.
+    fn load_objectives(&self) -> Vec<Rc<Objective<'a>>> {
         let fbc_plugin =
-            get_plugin::<sbmlcxx::FbcModelPlugin, Model<'a>, sbmlcxx::Model>(&model, "fbc");
-
-        if let Ok(mut fbc_plugin) = fbc_plugin {
-            let n_objectives = fbc_plugin.as_mut().getNumObjectives().0;
-            let list_of_objectives: Vec<_> = (0..n_objectives)
-                .map(|i| {
-                    let objective = fbc_plugin.as_mut().getObjective(i.into());
-                    let objective = Rc::new(Objective::from_ptr(objective));
-                    Rc::clone(&objective)
-                })
-                .collect();
-
-            let n_flux_bounds = fbc_plugin.as_mut().getNumFluxBounds().0;
-            let list_of_flux_bounds: Vec<_> = (0..n_flux_bounds)
-                .map(|i| {
-                    let flux_bound = fbc_plugin.as_mut().getFluxBound1(i.into());
-                    let flux_bound = Rc::new(FluxBound::from_ptr(flux_bound));
-                    Rc::clone(&flux_bound)
-                })
-                .collect();
-
-            model.list_of_objectives.replace(list_of_objectives);
-            model.list_of_flux_bounds.replace(list_of_flux_bounds);
+            get_plugin::<sbmlcxx::FbcModelPlugin, Model<'a>, sbmlcxx::Model>(self, "fbc");
+
+        match fbc_plugin {
+            Ok(mut fbc_plugin) => {
+                let n_objectives = fbc_plugin.as_mut().getNumObjectives().0;
+                (0..n_objectives)
+                    .map(|i| {
+                        let objective = fbc_plugin.as_mut().getObjective(i.into());
+                        Rc::new(Objective::from_ptr(objective).with_changes(self.changes))
+                    })
+                    .collect()
+            }
+            Err(_) => Vec::new(),
         }
+    }
 
-        model
+    /// Wraps all native FBC flux bounds, or none if the FBC package is not enabled.
+    fn load_flux_bounds(&self) -> Vec<Rc<FluxBound<'a>>> {
+        let fbc_plugin =
+            get_plugin::<sbmlcxx::FbcModelPlugin, Model<'a>, sbmlcxx::Model>(self, "fbc");
+
+        match fbc_plugin {
+            Ok(mut fbc_plugin) => {
+                let n_flux_bounds = fbc_plugin.as_mut().getNumFluxBounds().0;
+                (0..n_flux_bounds)
+                    .map(|i| {
+                        let flux_bound = fbc_plugin.as_mut().getFluxBound1(i.into());
+                        Rc::new(FluxBound::from_ptr(flux_bound).with_changes(self.changes))
+                    })
+                    .collect()
+            }
+            Err(_) => Vec::new(),
+        }
     }
 }
 
@@ -803,6 +1212,39 @@ mod tests {
         assert_eq!(model.name(), "test2");
     }
 
+    #[test]
+    fn test_model_from_ptr_is_lazy() {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("test");
+        model.create_species("glucose");
+        model.create_reaction("r1");
+
+        let model = doc.model().expect("Model not found");
+        assert!(!model.list_of_species.is_loaded());
+        assert!(!model.list_of_reactions.is_loaded());
+
+        assert_eq!(model.list_of_species().len(), 1);
+        assert!(model.list_of_species.is_loaded());
+        assert!(!model.list_of_reactions.is_loaded());
+    }
+
+    #[test]
+    fn test_model_from_ptr_create_before_load() {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("test");
+        model.create_species("glucose");
+
+        // Creating components on a model that has not been loaded yet
+        // must neither lose nor duplicate existing components
+        let model = doc.model().expect("Model not found");
+        model.create_species("fructose");
+
+        let species = model.list_of_species();
+        assert_eq!(species.len(), 2);
+        assert!(model.get_species("glucose").is_some());
+        assert!(model.get_species("fructose").is_some());
+    }
+
     #[test]
     fn test_model_build_species() {
         let doc = SBMLDocument::default();
@@ -837,6 +1279,63 @@ mod tests {
         assert!(extracted.is_none());
     }
 
+    #[test]
+    fn test_get_species_interleaved_with_create() {
+        let doc = SBMLDocument::default();
+        let model = Model::new(&doc, "test");
+
+        for i in 0..100 {
+            model.create_species(&format!("s{i}"));
+            let species = model
+                .get_species(&format!("s{i}"))
+                .expect("Species not found");
+            assert_eq!(species.id(), format!("s{i}"));
+        }
+
+        assert_eq!(model.get_species("s42").unwrap().id(), "s42");
+    }
+
+    #[test]
+    fn test_created_wrappers_are_reused_after_read() {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("test");
+        model.create_species("glucose");
+        model.create_reaction("r1").create_reactant("glucose", 1.0);
+        let doc = crate::reader::SBMLReader::from_xml_string(&doc.to_xml_string());
+        let model = doc.model().unwrap();
+
+        // Elements created before their collection is loaded keep their wrapper
+        let species = model.create_species("a");
+        assert!(Rc::ptr_eq(&species, &model.get_species("a").unwrap()));
+        assert_eq!(model.list_of_species().len(), 2);
+
+        let reaction = model.get_reaction("r1").unwrap();
+        let product = reaction.create_product("a", 2.0);
+        assert!(Rc::ptr_eq(&product, &reaction.products().borrow()[0]));
+    }
+
+    #[test]
+    fn test_get_species_after_rename() {
+        let doc = SBMLDocument::default();
+        let model = Model::new(&doc, "test");
+        let species = model.create_species("glucose");
+        model.create_species("fructose");
+        assert!(model.get_species("glucose").is_some());
+
+        species.set_id("galactose");
+        assert!(model.get_species("glucose").is_none());
+        assert!(Rc::ptr_eq(
+            &model.get_species("galactose").unwrap(),
+            &species
+        ));
+
+        // Renaming an element that was never looked up invalidates the index as well
+        model.get_species("fructose").unwrap().set_id("sucrose");
+        assert!(model.get_species("fructose").is_none());
+        assert_eq!(model.get_species("sucrose").unwrap().id(), "sucrose");
+        assert!(model.get_species("lactose").is_none());
+    }
+
     #[test]
     fn test_list_of_species() {
         let doc = SBMLDocument::default();
@@ -846,6 +1345,26 @@ mod tests {
         assert_eq!(model.list_of_species().len(), 2);
     }
 
+    #[test]
+    fn test_species_iter() {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("test");
+        model.create_species("glucose");
+        model.create_species("fructose");
+
+        let doc = crate::reader::SBMLReader::from_xml_string(&doc.to_xml_string());
+        let model = doc.model().unwrap();
+        let ids: Vec<String> = model.species_iter().map(|species| species.id()).collect();
+        assert_eq!(ids, vec!["glucose", "fructose"]);
+
+        // Species created while iterating are picked up
+        let mut iter = model.species_iter();
+        iter.next();
+        model.create_species("ribose");
+        assert_eq!(iter.count(), 2);
+        assert_eq!(model.list_of_species().len(), 3);
+    }
+
     #[test]
     fn test_model_build_compartment() {
         let doc = SBMLDocument::default();
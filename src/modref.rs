@@ -10,8 +10,9 @@
 use std::{cell::RefCell, pin::Pin};
 
 use crate::{
-    clone, inner, pin_ptr, prelude::IntoId, reaction::Reaction, sbase, sbmlcxx, sbo_term,
-    traits::fromptr::FromPtr, upcast, upcast_annotation, upcast_pin, upcast_required_property,
+    clone, dependency::ChangeHook, incremental::ChangeTracker, inner, pin_ptr, prelude::IntoId,
+    reaction::Reaction, sbase, sbmlcxx, sbo_term, traits::fromptr::FromPtr, upcast,
+    upcast_annotation, upcast_pin, upcast_required_property,
 };
 use cxx::let_cxx_string;
 
@@ -21,6 +22,11 @@ use cxx::let_cxx_string;
 /// through a RefCell and Pin to ensure memory safety while allowing interior mutability.
 pub struct ModifierSpeciesReference<'a> {
     inner: RefCell<Pin<&'a mut sbmlcxx::ModifierSpeciesReference>>,
+    annotation_cache: AnnotationCache,
+    /// Marks the section of the document that contains this element
+    changes: ChangeTracker<'a>,
+    /// Reports changes to the dependency graph of the model of the parent reaction
+    dependencies: Option<ChangeHook>,
 }
 
 // Set the inner trait for the ModifierSpeciesReference struct
@@ -45,7 +51,8 @@ upcast_annotation!(
 // Implement the Clone trait for the ModifierSpeciesReference struct
 clone!(
     ModifierSpeciesReference<'a>,
-    sbmlcxx::ModifierSpeciesReference
+    sbmlcxx::ModifierSpeciesReference,
+    dependencies
 );
 
 impl<'a> ModifierSpeciesReference<'a> {
@@ -75,6 +82,23 @@ impl<'a> ModifierSpeciesReference<'a> {
 
         Self {
             inner: RefCell::new(modifier_reference),
+            annotation_cache: AnnotationCache::default(),
+            changes: reaction.changes(),
+            dependencies: reaction.dependency_hook(),
+        }
+    }
+
+    /// Attaches a modifier wrapped from the native model to the dependency graph of
+    /// the parent reaction's model.
+    pub(crate) fn tracked_by(mut self, reaction: &Reaction<'a>) -> Self {
+        self.dependencies = reaction.dependency_hook();
+        self
+    }
+
+    /// Reports a change of the species to the dependency graph.
+    fn notify_dependencies(&self) {
+        if let Some(hook) = &self.dependencies {
+            hook.notify();
         }
     }
 
@@ -86,7 +110,8 @@ impl<'a> ModifierSpeciesReference<'a> {
         getSpecies,
         setSpecies,
         sbmlcxx::ModifierSpeciesReference,
-        sbmlcxx::SimpleSpeciesReference
+        sbmlcxx::SimpleSpeciesReference,
+        after_set = notify_dependencies
     );
 
     // SBO Term Methods generated by the `sbo_term` macro
@@ -104,6 +129,9 @@ impl FromPtr<sbmlcxx::ModifierSpeciesReference> for ModifierSpeciesReference<'_>
         let modifier_reference = pin_ptr!(ptr, sbmlcxx::ModifierSpeciesReference);
         Self {
             inner: RefCell::new(modifier_reference),
+            annotation_cache: AnnotationCache::default(),
+            changes: ChangeTracker::default(),
+            dependencies: None,
         }
     }
 }
@@ -127,6 +155,7 @@ impl<'a> ModifierSpeciesReferenceBuilder<'a> {
     /// A new ModifierSpeciesReferenceBuilder instance
     pub fn new(reaction: &Reaction<'a>, sid: impl IntoId) -> Self {
         let modifier_reference = ModifierSpeciesReference::new(reaction, &sid.into_id());
+        reaction.notify_dependencies();
         Self { modifier_reference }
     }
 
@@ -13,7 +13,9 @@ use std::{cell::RefCell, pin::Pin, rc::Rc};
 use cxx::let_cxx_string;
 
 use crate::{
-    clone, get_unit_definition, inner, into_id,
+    clone, get_unit_definition,
+    incremental::ChangeTracker,
+    index_key, inner, into_id,
     model::Model,
     optional_property, pin_ptr, required_property, sbase,
     sbmlcxx::{self},
@@ -28,6 +30,9 @@ use crate::{
 /// through a RefCell and Pin to ensure memory safety while allowing interior mutability.
 pub struct Parameter<'a> {
     inner: RefCell<Pin<&'a mut sbmlcxx::Parameter>>,
+    annotation_cache: AnnotationCache,
+    /// Marks the section of the document that contains this element
+    changes: ChangeTracker<'a>,
 }
 
 // Set the inner trait for the Parameter struct
@@ -45,6 +50,9 @@ clone!(Parameter<'a>, sbmlcxx::Parameter);
 // Set the into_id trait for the Compartment struct
 into_id!(&Rc<Parameter<'_>>, id);
 
+// Index Parameter collections by id
+index_key!(Parameter<'_>, getId);
+
 impl<'a> Parameter<'a> {
     /// Creates a new Parameter instance within the given Model.
     ///
@@ -67,6 +75,8 @@ impl<'a> Parameter<'a> {
 
         Self {
             inner: RefCell::new(parameter),
+            annotation_cache: AnnotationCache::default(),
+            changes: model.changes(),
         }
     }
 
@@ -74,7 +84,14 @@ impl<'a> Parameter<'a> {
     get_unit_definition!(units);
 
     // Getter and setter for id
-    required_property!(Parameter<'a>, id, String, getId, setId);
+    required_property!(
+        Parameter<'a>,
+        id,
+        String,
+        getId,
+        setId,
+        after_set = key_changed
+    );
 
     // Getter and setter for name
     optional_property!(Parameter<'a>, name, String, getName, setName, isSetName);
@@ -134,6 +151,8 @@ impl FromPtr<sbmlcxx::Parameter> for Parameter<'_> {
         let parameter = pin_ptr!(ptr, sbmlcxx::Parameter);
         Self {
             inner: RefCell::new(parameter),
+            annotation_cache: AnnotationCache::default(),
+            changes: ChangeTracker::default(),
         }
     }
 }
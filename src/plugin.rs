@@ -7,7 +7,10 @@ use std::pin::Pin;
 
 use cxx::let_cxx_string;
 
-use crate::{errors::LibSBMLError, pin_ptr, sbmlcxx, traits::sbase::SBase, upcast_pin};
+use crate::{
+    errors::LibSBMLError, instrument::trace_span, pin_ptr, sbmlcxx, traits::sbase::SBase,
+    upcast_pin,
+};
 
 /// Retrieves a plugin from an SBML object by name and casts it to the specified type.
 ///
@@ -33,6 +36,7 @@ pub(crate) fn get_plugin<'a, T, H, U>(
 where
     H: SBase<'a, U> + 'a,
 {
+    trace_span!("get_plugin", plugin = plugin_name);
     let_cxx_string!(pkg = plugin_name);
 
     // Upcast the model to SBase d
@@ -8,6 +8,10 @@
 //! - `upcast_property!`: For properties that require upcasting to a parent class before access
 //! - `upcast_optional_property!`: Combines upcasting with optional property handling
 //!
+//! For string properties, every macro additionally generates a `with_<prop>` method that
+//! passes the native string to a closure as `&str`. Read-heavy traversals can use it to
+//! compare or hash values without allocating a `String` per read.
+//!
 //! The macros ensure consistent behavior across the library by:
 //! 1. Properly checking if a property is set before returning its value (using isSet methods)
 //! 2. Handling type conversions between C++ and Rust types
@@ -46,6 +50,7 @@ macro_rules! optional_property {
             /// # Returns
             #[doc = "The " $prop " as a String, or None if not set"]
             pub fn [<$prop>](&self) -> Option<String> {
+                $crate::instrument::record_ffi_calls(1);
                 let inner = self.inner.borrow();
                 if inner.$cpp_isset() {
                     Some(inner.$cpp_getter().to_str().unwrap().to_string())
@@ -54,14 +59,80 @@ macro_rules! optional_property {
                 }
             }
 
+            #[doc = "Passes the " $prop " of this object to a closure without allocating."]
+            ///
+            /// The closure borrows the native string directly and receives None if the
+            /// property is not set. Modifying this object from within the closure panics.
+            ///
+            /// # Returns
+            /// The value returned by the closure
+            pub fn [<with_ $prop>]<R>(&self, f: impl FnOnce(Option<&str>) -> R) -> R {
+                $crate::instrument::record_ffi_calls(1);
+                let inner = self.inner.borrow();
+                let value = inner
+                    .$cpp_isset()
+                    .then(|| inner.$cpp_getter().to_str().unwrap());
+                f(value)
+            }
+
             #[doc = "Sets the " $prop " of this object."]
             ///
             /// # Arguments
             #[doc = "* `" $prop "` - The new " $prop " to set"]
             pub fn [<set_ $prop>](&self, $prop: impl Into<String>) {
+                $crate::instrument::record_ffi_calls(1);
                 let $prop = $prop.into();
                 let_cxx_string!($prop = $prop);
                 self.inner.borrow_mut().as_mut().$cpp_setter(&$prop);
+                $crate::incremental::Tracked::mark_dirty(self);
+            }
+        }
+    };
+
+    // String variant that calls a method of the object after every change
+    ($type:ty, $prop:ident, String, $cpp_getter:ident, $cpp_setter:ident, $cpp_isset:ident, after_set = $hook:ident) => {
+        paste::paste! {
+            #[doc = "Gets the " $prop " of this object."]
+            ///
+            /// # Returns
+            #[doc = "The " $prop " as a String, or None if not set"]
+            pub fn [<$prop>](&self) -> Option<String> {
+                $crate::instrument::record_ffi_calls(1);
+                let inner = self.inner.borrow();
+                if inner.$cpp_isset() {
+                    Some(inner.$cpp_getter().to_str().unwrap().to_string())
+                } else {
+                    None
+                }
+            }
+
+            #[doc = "Passes the " $prop " of this object to a closure without allocating."]
+            ///
+            /// The closure borrows the native string directly and receives None if the
+            /// property is not set. Modifying this object from within the closure panics.
+            ///
+            /// # Returns
+            /// The value returned by the closure
+            pub fn [<with_ $prop>]<R>(&self, f: impl FnOnce(Option<&str>) -> R) -> R {
+                $crate::instrument::record_ffi_calls(1);
+                let inner = self.inner.borrow();
+                let value = inner
+                    .$cpp_isset()
+                    .then(|| inner.$cpp_getter().to_str().unwrap());
+                f(value)
+            }
+
+            #[doc = "Sets the " $prop " of this object."]
+            ///
+            /// # Arguments
+            #[doc = "* `" $prop "` - The new " $prop " to set"]
+            pub fn [<set_ $prop>](&self, $prop: impl Into<String>) {
+                $crate::instrument::record_ffi_calls(1);
+                let $prop = $prop.into();
+                let_cxx_string!($prop = $prop);
+                self.inner.borrow_mut().as_mut().$cpp_setter(&$prop);
+                self.$hook();
+                $crate::incremental::Tracked::mark_dirty(self);
             }
         }
     };
@@ -74,6 +145,7 @@ macro_rules! optional_property {
             /// # Returns
             #[doc = "The " $prop " as a String, or None if not set"]
             pub fn [<$prop>](&self) -> Option<String> {
+                $crate::instrument::record_ffi_calls(1);
                 let inner = self.inner.borrow();
                 if inner.$cpp_isset() {
                     Some(inner.$cpp_getter().to_str().unwrap().to_string())
@@ -82,14 +154,32 @@ macro_rules! optional_property {
                 }
             }
 
+            #[doc = "Passes the " $prop " of this object to a closure without allocating."]
+            ///
+            /// The closure borrows the native string directly and receives None if the
+            /// property is not set. Modifying this object from within the closure panics.
+            ///
+            /// # Returns
+            /// The value returned by the closure
+            pub fn [<with_ $prop>]<R>(&self, f: impl FnOnce(Option<&str>) -> R) -> R {
+                $crate::instrument::record_ffi_calls(1);
+                let inner = self.inner.borrow();
+                let value = inner
+                    .$cpp_isset()
+                    .then(|| inner.$cpp_getter().to_str().unwrap());
+                f(value)
+            }
+
             #[doc = "Sets the " $prop " of this object."]
             ///
             /// # Arguments
             #[doc = "* `" $prop "` - The new " $prop " to set"]
             pub fn [<set_ $prop>](&self, $prop: $input_type) {
+                $crate::instrument::record_ffi_calls(1);
                 let id_str = $prop.into_id();
                 let_cxx_string!(id_str = id_str);
                 self.inner.borrow_mut().as_mut().$cpp_setter(&id_str);
+                $crate::incremental::Tracked::mark_dirty(self);
             }
         }
     };
@@ -102,6 +192,7 @@ macro_rules! optional_property {
             /// # Returns
             #[doc = "The " $prop " as a " $return_type ", or None if not set"]
             pub fn [<$prop>](&self) -> Option<$return_type> {
+                $crate::instrument::record_ffi_calls(1);
                 let inner = self.inner.borrow();
                 if inner.$cpp_isset() {
                     Some(inner.$cpp_getter().into())
@@ -115,8 +206,10 @@ macro_rules! optional_property {
             /// # Arguments
             #[doc = "* `" $prop "` - The new " $prop " to set"]
             pub fn [<set_ $prop>](&self, $prop: impl Into<$return_type>) {
+                $crate::instrument::record_ffi_calls(1);
                 let $prop = $prop.into();
                 self.inner.borrow_mut().as_mut().$cpp_setter($prop.into());
+                $crate::incremental::Tracked::mark_dirty(self);
             }
         }
     };
@@ -145,18 +238,75 @@ macro_rules! required_property {
             /// # Returns
             #[doc = "The " $prop " as a String"]
             pub fn [<$prop>](&self) -> String {
+                $crate::instrument::record_ffi_calls(1);
+                let inner = self.inner.borrow();
+                inner.$cpp_getter().to_str().unwrap().to_string()
+            }
+
+            #[doc = "Passes the " $prop " of this object to a closure without allocating."]
+            ///
+            /// The closure borrows the native string directly. Modifying this object from
+            /// within the closure panics.
+            ///
+            /// # Returns
+            /// The value returned by the closure
+            pub fn [<with_ $prop>]<R>(&self, f: impl FnOnce(&str) -> R) -> R {
+                $crate::instrument::record_ffi_calls(1);
+                let inner = self.inner.borrow();
+                f(inner.$cpp_getter().to_str().unwrap())
+            }
+
+            #[doc = "Sets the " $prop " of this object."]
+            ///
+            /// # Arguments
+            #[doc = "* `" $prop "` - The new " $prop " to set"]
+            pub fn [<set_ $prop>](&self, $prop: impl Into<String>) {
+                $crate::instrument::record_ffi_calls(1);
+                let $prop = $prop.into();
+                let_cxx_string!($prop = $prop);
+                self.inner.borrow_mut().as_mut().$cpp_setter(&$prop);
+                $crate::incremental::Tracked::mark_dirty(self);
+            }
+        }
+    };
+
+    // String variant that calls a method of the object after every change
+    ($type:ty, $prop:ident, String, $cpp_getter:ident, $cpp_setter:ident, after_set = $hook:ident) => {
+        paste::paste! {
+            #[doc = "Gets the " $prop " of this object."]
+            ///
+            /// # Returns
+            #[doc = "The " $prop " as a String"]
+            pub fn [<$prop>](&self) -> String {
+                $crate::instrument::record_ffi_calls(1);
                 let inner = self.inner.borrow();
                 inner.$cpp_getter().to_str().unwrap().to_string()
             }
 
+            #[doc = "Passes the " $prop " of this object to a closure without allocating."]
+            ///
+            /// The closure borrows the native string directly. Modifying this object from
+            /// within the closure panics.
+            ///
+            /// # Returns
+            /// The value returned by the closure
+            pub fn [<with_ $prop>]<R>(&self, f: impl FnOnce(&str) -> R) -> R {
+                $crate::instrument::record_ffi_calls(1);
+                let inner = self.inner.borrow();
+                f(inner.$cpp_getter().to_str().unwrap())
+            }
+
             #[doc = "Sets the " $prop " of this object."]
             ///
             /// # Arguments
             #[doc = "* `" $prop "` - The new " $prop " to set"]
             pub fn [<set_ $prop>](&self, $prop: impl Into<String>) {
+                $crate::instrument::record_ffi_calls(1);
                 let $prop = $prop.into();
                 let_cxx_string!($prop = $prop);
                 self.inner.borrow_mut().as_mut().$cpp_setter(&$prop);
+                self.$hook();
+                $crate::incremental::Tracked::mark_dirty(self);
             }
         }
     };
@@ -169,18 +319,34 @@ macro_rules! required_property {
             /// # Returns
             #[doc = "The " $prop " as a String"]
             pub fn [<$prop>](&self) -> String {
+                $crate::instrument::record_ffi_calls(1);
                 let inner = self.inner.borrow();
                 inner.$cpp_getter().to_str().unwrap().to_string()
             }
 
+            #[doc = "Passes the " $prop " of this object to a closure without allocating."]
+            ///
+            /// The closure borrows the native string directly. Modifying this object from
+            /// within the closure panics.
+            ///
+            /// # Returns
+            /// The value returned by the closure
+            pub fn [<with_ $prop>]<R>(&self, f: impl FnOnce(&str) -> R) -> R {
+                $crate::instrument::record_ffi_calls(1);
+                let inner = self.inner.borrow();
+                f(inner.$cpp_getter().to_str().unwrap())
+            }
+
             #[doc = "Sets the " $prop " of this object."]
             ///
             /// # Arguments
             #[doc = "* `" $prop "` - The new " $prop " to set"]
             pub fn [<set_ $prop>](&self, $prop: $input_type) {
+                $crate::instrument::record_ffi_calls(1);
                 let id_str = $prop.into_id();
                 let_cxx_string!(id_str = id_str);
                 self.inner.borrow_mut().as_mut().$cpp_setter(&id_str);
+                $crate::incremental::Tracked::mark_dirty(self);
             }
         }
     };
@@ -193,6 +359,7 @@ macro_rules! required_property {
             /// # Returns
             #[doc = "The " $prop " as a " $return_type]
             pub fn [<$prop>](&self) -> $return_type {
+                $crate::instrument::record_ffi_calls(1);
                 let inner = self.inner.borrow();
                 inner.$cpp_getter().into()
             }
@@ -202,8 +369,10 @@ macro_rules! required_property {
             /// # Arguments
             #[doc = "* `" $prop "` - The new " $prop " to set"]
             pub fn [<set_ $prop>](&self, $prop: impl Into<$return_type>) {
+                $crate::instrument::record_ffi_calls(1);
                 let $prop = $prop.into();
                 self.inner.borrow_mut().as_mut().$cpp_setter($prop.into());
+                $crate::incremental::Tracked::mark_dirty(self);
             }
         }
     };
@@ -234,6 +403,7 @@ macro_rules! upcast_optional_property {
             /// # Returns
             #[doc = "The " $prop " as a String, or None if not set"]
             pub fn [<$prop>](&self) -> Option<String> {
+                $crate::instrument::record_ffi_calls(1);
                 let upcast_obj = upcast!(self, $from_type, $to_type);
                 if upcast_obj.$cpp_isset() {
                     Some(upcast_obj.$cpp_getter().to_str().unwrap().to_string())
@@ -242,15 +412,35 @@ macro_rules! upcast_optional_property {
                 }
             }
 
+            #[doc = "Passes the " $prop " of this object to a closure without allocating."]
+            ///
+            /// The closure borrows the native string directly and receives None if the
+            /// property is not set. Modifying this object from within the closure panics.
+            ///
+            /// # Returns
+            /// The value returned by the closure
+            pub fn [<with_ $prop>]<R>(&self, f: impl FnOnce(Option<&str>) -> R) -> R {
+                $crate::instrument::record_ffi_calls(1);
+                // Keep the object borrowed while the closure holds the string
+                let inner = self.inner.borrow();
+                let base: &$to_type = unsafe { &*(&**inner as *const $from_type).cast::<$to_type>() };
+                let value = base
+                    .$cpp_isset()
+                    .then(|| base.$cpp_getter().to_str().unwrap());
+                f(value)
+            }
+
             #[doc = "Sets the " $prop " of this object."]
             ///
             /// # Arguments
             #[doc = "* `" $prop "` - The new " $prop " to set"]
             pub fn [<set_ $prop>](&self, $prop: impl Into<String>) {
+                $crate::instrument::record_ffi_calls(1);
                 let $prop = $prop.into();
                 let_cxx_string!($prop = $prop);
                 let upcast_obj = upcast!(self, $from_type, $to_type);
                 upcast_obj.$cpp_setter(&$prop);
+                $crate::incremental::Tracked::mark_dirty(self);
             }
         }
     };
@@ -263,6 +453,7 @@ macro_rules! upcast_optional_property {
             /// # Returns
             #[doc = "The " $prop " as a " $return_type ", or None if not set"]
             pub fn [<$prop>](&self) -> Option<$return_type> {
+                $crate::instrument::record_ffi_calls(1);
                 let upcast_obj = upcast!(self, $from_type, $to_type);
                 if upcast_obj.$cpp_isset() {
                     Some(upcast_obj.$cpp_getter())
@@ -276,9 +467,11 @@ macro_rules! upcast_optional_property {
             /// # Arguments
             #[doc = "* `" $prop "` - The new " $prop " to set"]
             pub fn [<set_ $prop>](&self, $prop: impl Into<$return_type>) {
+                $crate::instrument::record_ffi_calls(1);
                 let $prop = $prop.into();
                 let upcast_obj = upcast!(self, $from_type, $to_type);
                 upcast_obj.$cpp_setter($prop);
+                $crate::incremental::Tracked::mark_dirty(self);
             }
         }
     };
@@ -308,19 +501,81 @@ macro_rules! upcast_required_property {
             /// # Returns
             #[doc = "The " $prop " as a String"]
             pub fn [<$prop>](&self) -> String {
+                $crate::instrument::record_ffi_calls(1);
                 let upcast_obj = upcast!(self, $from_type, $to_type);
                 upcast_obj.$cpp_getter().to_str().unwrap().to_string()
             }
 
+            #[doc = "Passes the " $prop " of this object to a closure without allocating."]
+            ///
+            /// The closure borrows the native string directly. Modifying this object from
+            /// within the closure panics.
+            ///
+            /// # Returns
+            /// The value returned by the closure
+            pub fn [<with_ $prop>]<R>(&self, f: impl FnOnce(&str) -> R) -> R {
+                $crate::instrument::record_ffi_calls(1);
+                // Keep the object borrowed while the closure holds the string
+                let inner = self.inner.borrow();
+                let base: &$to_type = unsafe { &*(&**inner as *const $from_type).cast::<$to_type>() };
+                f(base.$cpp_getter().to_str().unwrap())
+            }
+
+            #[doc = "Sets the " $prop " of this object."]
+            ///
+            /// # Arguments
+            #[doc = "* `" $prop "` - The new " $prop " to set"]
+            pub fn [<set_ $prop>](&self, $prop: impl Into<String>) {
+                $crate::instrument::record_ffi_calls(1);
+                let $prop = $prop.into();
+                let_cxx_string!($prop = $prop);
+                let upcast_obj = upcast!(self, $from_type, $to_type);
+                upcast_obj.$cpp_setter(&$prop);
+                $crate::incremental::Tracked::mark_dirty(self);
+            }
+        }
+    };
+
+    // String variant with upcast that calls a method of the object after every change
+    ($type:ty, $prop:ident, String, $cpp_getter:ident, $cpp_setter:ident, $from_type:ty, $to_type:ty, after_set = $hook:ident) => {
+        paste::paste! {
+            #[doc = "Gets the " $prop " of this object."]
+            ///
+            /// # Returns
+            #[doc = "The " $prop " as a String"]
+            pub fn [<$prop>](&self) -> String {
+                $crate::instrument::record_ffi_calls(1);
+                let upcast_obj = upcast!(self, $from_type, $to_type);
+                upcast_obj.$cpp_getter().to_str().unwrap().to_string()
+            }
+
+            #[doc = "Passes the " $prop " of this object to a closure without allocating."]
+            ///
+            /// The closure borrows the native string directly. Modifying this object from
+            /// within the closure panics.
+            ///
+            /// # Returns
+            /// The value returned by the closure
+            pub fn [<with_ $prop>]<R>(&self, f: impl FnOnce(&str) -> R) -> R {
+                $crate::instrument::record_ffi_calls(1);
+                // Keep the object borrowed while the closure holds the string
+                let inner = self.inner.borrow();
+                let base: &$to_type = unsafe { &*(&**inner as *const $from_type).cast::<$to_type>() };
+                f(base.$cpp_getter().to_str().unwrap())
+            }
+
             #[doc = "Sets the " $prop " of this object."]
             ///
             /// # Arguments
             #[doc = "* `" $prop "` - The new " $prop " to set"]
             pub fn [<set_ $prop>](&self, $prop: impl Into<String>) {
+                $crate::instrument::record_ffi_calls(1);
                 let $prop = $prop.into();
                 let_cxx_string!($prop = $prop);
                 let upcast_obj = upcast!(self, $from_type, $to_type);
                 upcast_obj.$cpp_setter(&$prop);
+                self.$hook();
+                $crate::incremental::Tracked::mark_dirty(self);
             }
         }
     };
@@ -333,6 +588,7 @@ macro_rules! upcast_required_property {
             /// # Returns
             #[doc = "The " $prop " as a " $return_type]
             pub fn [<$prop>](&self) -> $return_type {
+                $crate::instrument::record_ffi_calls(1);
                 let upcast_obj = upcast!(self, $from_type, $to_type);
                 upcast_obj.$cpp_getter()
             }
@@ -342,9 +598,11 @@ macro_rules! upcast_required_property {
             /// # Arguments
             #[doc = "* `" $prop "` - The new " $prop " to set"]
             pub fn [<set_ $prop>](&self, $prop: impl Into<$return_type>) {
+                $crate::instrument::record_ffi_calls(1);
                 let $prop = $prop.into();
                 let upcast_obj = upcast!(self, $from_type, $to_type);
                 upcast_obj.$cpp_setter($prop);
+                $crate::incremental::Tracked::mark_dirty(self);
             }
         }
     };
@@ -13,7 +13,12 @@ use std::{cell::RefCell, pin::Pin, rc::Rc};
 use cxx::let_cxx_string;
 
 use crate::{
-    clone, inner, into_id,
+    clone,
+    dependency::{self, Change, ChangeHook},
+    incremental::{ChangeTracker, Tracked},
+    index_key, inner, into_id,
+    lazy::LazyList,
+    memory::{self, MemoryUsage},
     model::Model,
     modref::{ModifierSpeciesReference, ModifierSpeciesReferenceBuilder},
     optional_property, pin_ptr,
@@ -30,12 +35,18 @@ use crate::{
 ///
 /// This struct maintains a reference to the underlying C++ Reaction object
 /// through a RefCell and Pin to ensure memory safety while allowing interior mutability.
-/// It also maintains vectors of reactants and products associated with the reaction.
+/// It also maintains vectors of reactants and products associated with the reaction,
+/// which are wrapped on first access when the reaction was read from a document.
 pub struct Reaction<'a> {
     inner: RefCell<Pin<&'a mut sbmlcxx::Reaction>>,
-    reactants: RefCell<Vec<Rc<SpeciesReference<'a>>>>,
-    products: RefCell<Vec<Rc<SpeciesReference<'a>>>>,
-    modifiers: RefCell<Vec<Rc<ModifierSpeciesReference<'a>>>>,
+    annotation_cache: AnnotationCache,
+    /// Marks the section of the document that contains this element
+    changes: ChangeTracker<'a>,
+    reactants: LazyList<SpeciesReference<'a>>,
+    products: LazyList<SpeciesReference<'a>>,
+    modifiers: LazyList<ModifierSpeciesReference<'a>>,
+    /// Reports changes to the dependency graph of the parent model
+    dependencies: Option<ChangeHook>,
 }
 
 // Set the inner trait for the Reaction struct
@@ -50,13 +61,17 @@ upcast_annotation!(Reaction<'a>, sbmlcxx::Reaction, sbmlcxx::SBase);
 // Set the into_id trait for the Reaction struct
 into_id!(&Rc<Reaction<'_>>, id);
 
+// Index Reaction collections by id
+index_key!(Reaction<'_>, getId);
+
 // Implement the Clone trait for the Reaction struct
 clone!(
     Reaction<'a>,
     sbmlcxx::Reaction,
     reactants,
     products,
-    modifiers
+    modifiers,
+    dependencies
 );
 
 impl<'a> Reaction<'a> {
@@ -78,14 +93,53 @@ impl<'a> Reaction<'a> {
 
         Self {
             inner: RefCell::new(reaction),
-            reactants: RefCell::new(Vec::new()),
-            products: RefCell::new(Vec::new()),
-            modifiers: RefCell::new(Vec::new()),
+            annotation_cache: AnnotationCache::default(),
+            changes: model.changes(),
+            reactants: LazyList::new(),
+            products: LazyList::new(),
+            modifiers: LazyList::new(),
+            dependencies: Some(model.dependency_hook(Change::Reaction(reaction_ptr as usize))),
+        }
+    }
+
+    /// Attaches a reaction wrapped from the native model to the dependency graph of
+    /// the model.
+    pub(crate) fn tracked_by(mut self, model: &Model<'a>) -> Self {
+        let change = Change::Reaction(dependency::address_of(&self.inner));
+        self.dependencies = Some(model.dependency_hook(change));
+        self
+    }
+
+    /// Returns the hook through which the reaction and its kinetic law report changes
+    /// to the dependency graph of the model.
+    pub(crate) fn dependency_hook(&self) -> Option<ChangeHook> {
+        self.dependencies.clone()
+    }
+
+    /// Reports a change of the species references or the kinetic law to the
+    /// dependency graph of the model.
+    pub(crate) fn notify_dependencies(&self) {
+        if let Some(hook) = &self.dependencies {
+            hook.notify();
         }
     }
 
+    /// Reports a new id, which is both the key the reaction is indexed by and the
+    /// name the dependency graph of the model reports it under.
+    fn id_changed(&self) {
+        self.notify_dependencies();
+        self.key_changed();
+    }
+
     // Getter and setter for id
-    required_property!(Reaction<'a>, id, String, getId, setId);
+    required_property!(
+        Reaction<'a>,
+        id,
+        String,
+        getId,
+        setId,
+        after_set = id_changed
+    );
 
     // Getter and setter for name
     optional_property!(Reaction<'a>, name, String, getName, setName, isSetName);
@@ -125,7 +179,8 @@ impl<'a> Reaction<'a> {
             SpeciesReferenceType::Product,
         ));
         product.set_stoichiometry(stoichiometry);
-        self.products.borrow_mut().push(Rc::clone(&product));
+        self.products.push(Rc::clone(&product));
+        self.notify_dependencies();
         product
     }
 
@@ -145,7 +200,19 @@ impl<'a> Reaction<'a> {
     /// # Returns
     /// A reference to the RefCell containing the vector of products
     pub fn products(&self) -> &RefCell<Vec<Rc<SpeciesReference<'a>>>> {
-        &self.products
+        self.products.get_or_load(|| {
+            let n_products = self.inner.borrow().getNumProducts().0;
+            (0..n_products)
+                .map(|i| {
+                    let product = self.inner.borrow_mut().as_mut().getProduct1(i.into());
+                    Rc::new(
+                        SpeciesReference::from_ptr(product)
+                            .tracked_by(self)
+                            .with_changes(self.changes),
+                    )
+                })
+                .collect()
+        })
     }
 
     /// Returns a reference to the product with the given species id.
@@ -156,10 +223,10 @@ impl<'a> Reaction<'a> {
     /// # Returns
     /// An Option containing a reference-counted pointer to the SpeciesReference if found
     pub fn get_product(&self, sid: &str) -> Option<Rc<SpeciesReference<'a>>> {
-        self.products
+        self.products()
             .borrow()
             .iter()
-            .find(|product| (*product).species() == sid)
+            .find(|product| product.with_species(|species| species == sid))
             .map(Rc::clone)
     }
 
@@ -182,7 +249,8 @@ impl<'a> Reaction<'a> {
             SpeciesReferenceType::Reactant,
         ));
         reactant.set_stoichiometry(stoichiometry);
-        self.reactants.borrow_mut().push(Rc::clone(&reactant));
+        self.reactants.push(Rc::clone(&reactant));
+        self.notify_dependencies();
         reactant
     }
 
@@ -202,7 +270,19 @@ impl<'a> Reaction<'a> {
     /// # Returns
     /// A reference to the RefCell containing the vector of reactants
     pub fn reactants(&self) -> &RefCell<Vec<Rc<SpeciesReference<'a>>>> {
-        &self.reactants
+        self.reactants.get_or_load(|| {
+            let n_reactants = self.inner.borrow().getNumReactants().0;
+            (0..n_reactants)
+                .map(|i| {
+                    let reactant = self.inner.borrow_mut().as_mut().getReactant1(i.into());
+                    Rc::new(
+                        SpeciesReference::from_ptr(reactant)
+                            .tracked_by(self)
+                            .with_changes(self.changes),
+                    )
+                })
+                .collect()
+        })
     }
 
     /// Returns a reference to the reactant with the given species id.
@@ -213,10 +293,10 @@ impl<'a> Reaction<'a> {
     /// # Returns
     /// An Option containing a reference-counted pointer to the SpeciesReference if found
     pub fn get_reactant(&self, sid: &str) -> Option<Rc<SpeciesReference<'a>>> {
-        self.reactants
+        self.reactants()
             .borrow()
             .iter()
-            .find(|reactant| (*reactant).species() == sid)
+            .find(|reactant| reactant.with_species(|species| species == sid))
             .map(Rc::clone)
     }
 
@@ -229,7 +309,9 @@ impl<'a> Reaction<'a> {
     /// A reference-counted pointer to the new ModifierSpeciesReference
     pub fn create_modifier(&self, sid: &str) -> Rc<ModifierSpeciesReference<'a>> {
         let modifier = Rc::new(ModifierSpeciesReference::new(self, sid));
-        self.modifiers.borrow_mut().push(Rc::clone(&modifier));
+        self.modifiers.push(Rc::clone(&modifier));
+        modifier.mark_dirty();
+        self.notify_dependencies();
         modifier
     }
 
@@ -248,7 +330,19 @@ impl<'a> Reaction<'a> {
     /// # Returns
     /// A reference to the RefCell containing the vector of modifiers
     pub fn modifiers(&self) -> &RefCell<Vec<Rc<ModifierSpeciesReference<'a>>>> {
-        &self.modifiers
+        self.modifiers.get_or_load(|| {
+            let n_modifiers = self.inner.borrow().getNumModifiers().0;
+            (0..n_modifiers)
+                .map(|i| {
+                    let modifier = self.inner.borrow_mut().as_mut().getModifier1(i.into());
+                    Rc::new(
+                        ModifierSpeciesReference::from_ptr(modifier)
+                            .tracked_by(self)
+                            .with_changes(self.changes),
+                    )
+                })
+                .collect()
+        })
     }
 
     /// Returns a reference to the modifier with the given species id.
@@ -259,10 +353,10 @@ impl<'a> Reaction<'a> {
     /// # Returns
     /// An Option containing a reference-counted pointer to the ModifierSpeciesReference if found
     pub fn get_modifier(&self, sid: &str) -> Option<Rc<ModifierSpeciesReference<'a>>> {
-        self.modifiers
+        self.modifiers()
             .borrow()
             .iter()
-            .find(|modifier| (*modifier).species() == sid)
+            .find(|modifier| modifier.with_species(|species| species == sid))
             .map(Rc::clone)
     }
 
@@ -274,7 +368,10 @@ impl<'a> Reaction<'a> {
     /// # Returns
     /// A reference-counted pointer to the new KineticLaw
     pub fn create_kinetic_law(&self, formula: &str) -> Rc<KineticLaw<'a>> {
-        Rc::new(KineticLaw::new(self, formula))
+        let kinetic_law = Rc::new(KineticLaw::new(self, formula));
+        kinetic_law.mark_dirty();
+        self.notify_dependencies();
+        kinetic_law
     }
 
     /// Returns a reference to the kinetic law of this reaction.
@@ -285,12 +382,31 @@ impl<'a> Reaction<'a> {
         let has_kinetic_law = self.inner.borrow().isSetKineticLaw();
         if has_kinetic_law {
             let kinetic_law = self.inner.borrow_mut().as_mut().getKineticLaw1();
-            Some(Rc::new(KineticLaw::from_ptr(kinetic_law)))
+            let kinetic_law = KineticLaw::from_ptr(kinetic_law)
+                .tracked_by(self)
+                .with_changes(self.changes);
+            Some(Rc::new(kinetic_law))
         } else {
             None
         }
     }
 
+    /// Reports the memory held by this reaction.
+    ///
+    /// Covers the native object tree of the reaction, including its kinetic law, and
+    /// the species reference wrappers it holds. See [`MemoryUsage`] for details.
+    pub fn memory_usage(&self) -> MemoryUsage {
+        let base = crate::upcast!(self, sbmlcxx::Reaction, sbmlcxx::SBase);
+        MemoryUsage::native(&base) + self.wrapper_usage()
+    }
+
+    /// Reports the species reference wrappers held by this reaction.
+    pub(crate) fn wrapper_usage(&self) -> MemoryUsage {
+        self.reactants.memory_usage(memory::leaf)
+            + self.products.memory_usage(memory::leaf)
+            + self.modifiers.memory_usage(memory::leaf)
+    }
+
     // SBO Term Methods generated by the `sbo_term` macro
     sbo_term!(sbmlcxx::Reaction, sbmlcxx::SBase);
 }
@@ -307,40 +423,17 @@ impl FromPtr<sbmlcxx::Reaction> for Reaction<'_> {
     /// # Returns
     /// A new Reaction instance
     fn from_ptr(ptr: *mut sbmlcxx::Reaction) -> Self {
-        let reaction = RefCell::new(pin_ptr!(ptr, sbmlcxx::Reaction));
-
-        // Get the list of reactants
-        let n_reactants = reaction.borrow().getNumReactants().0;
-        let reactants = (0..n_reactants)
-            .map(|i| {
-                let reactant = reaction.borrow_mut().as_mut().getReactant1(i.into());
-                Rc::new(SpeciesReference::from_ptr(reactant))
-            })
-            .collect::<Vec<_>>();
-
-        // Get the list of products
-        let n_products = reaction.borrow().getNumProducts().0;
-        let products = (0..n_products)
-            .map(|i| {
-                let product = reaction.borrow_mut().as_mut().getProduct1(i.into());
-                Rc::new(SpeciesReference::from_ptr(product))
-            })
-            .collect::<Vec<_>>();
-
-        // Get the list of modifiers
-        let n_modifiers = reaction.borrow().getNumModifiers().0;
-        let modifiers = (0..n_modifiers)
-            .map(|i| {
-                let modifier = reaction.borrow_mut().as_mut().getModifier1(i.into());
-                Rc::new(ModifierSpeciesReference::from_ptr(modifier))
-            })
-            .collect::<Vec<_>>();
+        let reaction = pin_ptr!(ptr, sbmlcxx::Reaction);
 
+        // Species references are wrapped on first access
         Self {
-            inner: reaction,
-            reactants: RefCell::new(reactants),
-            products: RefCell::new(products),
-            modifiers: RefCell::new(modifiers),
+            inner: RefCell::new(reaction),
+            annotation_cache: AnnotationCache::default(),
+            changes: ChangeTracker::default(),
+            reactants: LazyList::deferred(),
+            products: LazyList::deferred(),
+            modifiers: LazyList::deferred(),
+            dependencies: None,
         }
     }
 }
@@ -4,22 +4,69 @@
 //! It provides functionality to parse SBML documents and create in-memory representations
 //! that can be manipulated using the rest of the library.
 //!
+//! Documents can be read from a file path, a string, a byte slice or any [`std::io::Read`]
+//! source. Reading from a path lets libSBML open the file itself, including compressed
+//! `.gz` files when libSBML has been built with zlib support. All other entry points hand
+//! the document to libSBML as a single native string, which is filled without keeping an
+//! additional copy on the Rust side.
+//!
+//! A reader can be kept around and used for many documents through its instance
+//! methods ([`SBMLReader::read_file`], [`SBMLReader::read_bytes`], ...), which reuse
+//! the native reader and its input buffer. The associated functions
+//! ([`SBMLReader::from_file`], [`SBMLReader::from_bytes`], ...) use a reader owned by
+//! the current thread, see [`SBMLReader::with_thread_local`], so that parallel batch
+//! reads only pay for the parse itself.
+//!
 //! This wrapper provides safe access to the underlying C++ libSBML SBMLReader class while
 //! maintaining Rust's safety guarantees through the use of RefCell and Pin.
 
-use std::{cell::RefCell, pin::Pin};
+use std::{cell::RefCell, io::Read, path::Path, pin::Pin};
 
 use autocxx::WithinBox;
-use cxx::{let_cxx_string, UniquePtr};
+use cxx::{let_cxx_string, CxxString, UniquePtr};
+
+use crate::{
+    errors::LibSBMLError,
+    instrument::{trace_event, trace_span},
+    sbmlcxx,
+    sbmldoc::SBMLDocument,
+    snapshot,
+};
+
+/// Size of the chunks in which [`SBMLReader::from_reader`] consumes its source
+const READ_CHUNK_SIZE: usize = 64 * 1024;
+
+/// Size in bytes of the largest document whose native buffer an [`SBMLReader`] or
+/// [`SBMLWriter`](crate::writer::SBMLWriter) keeps for the next document.
+///
+/// Buffers that held a larger document are released after use, so that a single
+/// large document does not keep its size allocated for the lifetime of the thread
+/// that owns the reader or writer.
+pub const MAX_RETAINED_BUFFER_BYTES: usize = 16 * 1024 * 1024;
 
-use crate::{sbmlcxx, sbmldoc::SBMLDocument};
+thread_local! {
+    /// Reader used by the associated functions of [`SBMLReader`] on this thread
+    static THREAD_READER: SBMLReader = SBMLReader::new();
+}
 
 /// A safe wrapper around the libSBML SBMLReader class.
 ///
 /// This struct maintains a reference to the underlying C++ SBMLReader object
 /// through a RefCell and Pin to ensure memory safety while allowing interior mutability.
 /// It provides methods to read SBML documents from various sources.
-pub struct SBMLReader(RefCell<Pin<Box<sbmlcxx::SBMLReader>>>);
+///
+/// The native reader, the native string handed to libSBML and the chunk buffer of
+/// [`SBMLReader::read_from`] are reused for every document read through the same
+/// instance. The native string is only kept for documents of up to
+/// [`MAX_RETAINED_BUFFER_BYTES`]. A reader is not `Sync`, use one reader per thread.
+pub struct SBMLReader {
+    /// The underlying libSBML reader
+    inner: RefCell<Pin<Box<sbmlcxx::SBMLReader>>>,
+    /// Native input buffer, kept between documents up to [`MAX_RETAINED_BUFFER_BYTES`]
+    buffer: RefCell<UniquePtr<CxxString>>,
+    /// Buffer for the chunks consumed from [`Read`] sources, allocated on first use
+    chunk: RefCell<Vec<u8>>,
+}
 
 impl SBMLReader {
     /// Creates a new SBMLReader instance.
@@ -27,8 +74,94 @@ impl SBMLReader {
     /// # Returns
     /// A new SBMLReader instance ready to parse SBML documents
     pub fn new() -> Self {
-        let reader = sbmlcxx::SBMLReader::new().within_box();
-        Self(RefCell::new(reader))
+        Self {
+            inner: RefCell::new(sbmlcxx::SBMLReader::new().within_box()),
+            buffer: RefCell::new(sbmlcxx::make_string("")),
+            chunk: RefCell::new(Vec::new()),
+        }
+    }
+
+    /// Runs `f` with the reader owned by the current thread.
+    ///
+    /// Every thread, including the worker threads of a rayon pool, lazily creates one
+    /// reader that is reused for all documents it reads. If the thread is shutting
+    /// down and its reader is gone, or if the reader is in use further up the stack,
+    /// e.g. by a [`Read`] source that reads another document, a temporary reader is
+    /// used instead.
+    ///
+    /// # Arguments
+    /// * `f` - The function to run with the reader
+    ///
+    /// # Returns
+    /// The result of `f`
+    pub fn with_thread_local<R>(f: impl FnOnce(&SBMLReader) -> R) -> R {
+        let mut f = Some(f);
+        THREAD_READER
+            .try_with(|reader| {
+                if reader.buffer.try_borrow_mut().is_ok() {
+                    Some((f.take().expect("called at most once"))(reader))
+                } else {
+                    None
+                }
+            })
+            .ok()
+            .flatten()
+            .unwrap_or_else(|| (f.take().expect("called at most once"))(&SBMLReader::new()))
+    }
+
+    /// Reads an SBML document from a file.
+    ///
+    /// The file is opened and parsed by libSBML directly, so its content is never
+    /// copied into Rust memory. Files ending in `.gz`, `.zip` or `.bz2` are
+    /// decompressed on the fly if libSBML has been built with the respective
+    /// compression support.
+    ///
+    /// # Arguments
+    /// * `path` - Path to the SBML file
+    ///
+    /// # Returns
+    /// An SBMLDocument instance containing the parsed model, or an error if the file
+    /// does not exist or its path is not valid UTF-8
+    pub fn from_file(path: impl AsRef<Path>) -> Result<SBMLDocument, LibSBMLError> {
+        Self::with_thread_local(|reader| reader.read_file(path))
+    }
+
+    /// Reads an SBML document from a file, using a binary snapshot if it is current.
+    ///
+    /// The file's content is hashed and compared against the snapshot at
+    /// `snapshot_path`. If the snapshot matches, the document is rebuilt from it
+    /// without parsing any XML. Otherwise, the file is parsed and the snapshot is
+    /// (re)written for the next call. Unreadable or corrupt snapshots are treated as
+    /// stale. If the snapshot cannot be written, e.g. because the document has
+    /// content that snapshots cannot represent or the directory is read-only, the
+    /// document is returned as parsed. See [`crate::snapshot`] for what snapshots
+    /// cover.
+    ///
+    /// # Arguments
+    /// * `path` - Path to the SBML file
+    /// * `snapshot_path` - Path of the snapshot file to use and refresh
+    ///
+    /// # Returns
+    /// An SBMLDocument instance, or an error if the SBML file cannot be read
+    pub fn from_file_with_snapshot(
+        path: impl AsRef<Path>,
+        snapshot_path: impl AsRef<Path>,
+    ) -> Result<SBMLDocument, LibSBMLError> {
+        let xml = std::fs::read(path)?;
+        let hash = snapshot::source_hash(&xml);
+
+        if let Ok(Some(doc)) = SBMLDocument::load_snapshot(&snapshot_path, hash) {
+            return Ok(doc);
+        }
+
+        // The snapshot only speeds up the next read, so failing to write it, e.g. on
+        // a read-only file system or for documents that snapshots cannot represent,
+        // does not fail this one
+        let doc = Self::from_bytes(&xml);
+        if let Err(_error) = doc.save_snapshot(snapshot_path, hash) {
+            trace_event!(snapshot_error = %_error);
+        }
+        Ok(doc)
     }
 
     /// Reads an SBML document from an XML string.
@@ -39,23 +172,188 @@ impl SBMLReader {
     /// # Returns
     /// An SBMLDocument instance containing the parsed model
     pub fn from_xml_string(xml: &str) -> SBMLDocument {
-        let reader = Self::new();
-        // Create an owned String to ensure the data persists
-        let owned_xml = xml.to_string();
-        let_cxx_string!(xml_cxx = owned_xml);
+        Self::from_bytes(xml.as_bytes())
+    }
+
+    /// Reads an SBML document from a byte slice containing SBML XML.
+    ///
+    /// The bytes are copied once into the native string handed to libSBML. The
+    /// encoding is determined by the parser from the XML declaration.
+    ///
+    /// # Arguments
+    /// * `xml` - The raw bytes of an SBML document
+    ///
+    /// # Returns
+    /// An SBMLDocument instance containing the parsed model
+    pub fn from_bytes(xml: &[u8]) -> SBMLDocument {
+        Self::with_thread_local(|reader| reader.read_bytes(xml))
+    }
+
+    /// Reads an SBML document from any source implementing [`Read`].
+    ///
+    /// The source is consumed in fixed-size chunks that are appended directly to the
+    /// native string handed to libSBML, so the document is held in memory only once.
+    ///
+    /// # Arguments
+    /// * `reader` - The source to read the SBML XML from
+    ///
+    /// # Returns
+    /// An SBMLDocument instance containing the parsed model, or an error if reading
+    /// from the source fails
+    pub fn from_reader(reader: impl Read) -> Result<SBMLDocument, LibSBMLError> {
+        Self::with_thread_local(|sbml_reader| sbml_reader.read_from(reader))
+    }
+
+    /// Reads many SBML files in parallel.
+    ///
+    /// Every file is parsed on a worker thread of the global rayon pool, using the
+    /// reader of that thread. Since [`SBMLDocument`] is `Send` but not `Sync`, each
+    /// document is confined to the thread that currently processes it. Validation and
+    /// extraction can be chained onto the returned iterator so that they run on the
+    /// same worker:
+    ///
+    /// ```no_run
+    /// use rayon::prelude::*;
+    /// use sbml::prelude::*;
+    ///
+    /// let paths = vec!["model_a.xml", "model_b.xml"];
+    /// let species_counts: Vec<usize> = SBMLReader::read_many(paths)
+    ///     .filter_map(Result::ok)
+    ///     .filter(|doc| doc.check_consistency().valid)
+    ///     .map(|doc| doc.model().map_or(0, |model| model.list_of_species().len()))
+    ///     .collect();
+    /// ```
+    ///
+    /// # Arguments
+    /// * `paths` - Paths of the SBML files to read
+    ///
+    /// # Returns
+    /// A parallel iterator yielding one result per path, see [`SBMLReader::from_file`]
+    #[cfg(feature = "parallel")]
+    pub fn read_many<I, P>(
+        paths: I,
+    ) -> impl rayon::iter::ParallelIterator<Item = Result<SBMLDocument, LibSBMLError>>
+    where
+        I: rayon::iter::IntoParallelIterator<Item = P>,
+        P: AsRef<Path>,
+    {
+        use rayon::iter::ParallelIterator;
+
+        paths.into_par_iter().map(Self::from_file)
+    }
+
+    /// Reads an SBML document from a file with this reader.
+    ///
+    /// See [`SBMLReader::from_file`].
+    pub fn read_file(&self, path: impl AsRef<Path>) -> Result<SBMLDocument, LibSBMLError> {
+        let path = path.as_ref();
+
+        // libSBML reports unreadable files only through the document's error log
+        if !path.is_file() {
+            return Err(std::io::Error::new(
+                std::io::ErrorKind::NotFound,
+                format!("SBML file not found: {}", path.display()),
+            )
+            .into());
+        }
+
+        let path = path.to_str().ok_or_else(|| {
+            LibSBMLError::InvalidArgument(format!("Path is not valid UTF-8: {}", path.display()))
+        })?;
+
+        trace_span!("read_file", path);
+        let_cxx_string!(path_cxx = path);
         let ptr = unsafe {
-            UniquePtr::from_raw(reader.0.borrow_mut().as_mut().readSBMLFromString(&xml_cxx))
+            UniquePtr::from_raw(self.inner.borrow_mut().as_mut().readSBMLFromFile(&path_cxx))
         };
+        Ok(SBMLDocument::from_unique_ptr(ptr))
+    }
+
+    /// Reads an SBML document from an XML string with this reader.
+    ///
+    /// See [`SBMLReader::from_xml_string`].
+    pub fn read_string(&self, xml: &str) -> SBMLDocument {
+        self.read_bytes(xml.as_bytes())
+    }
+
+    /// Reads an SBML document from a byte slice with this reader.
+    ///
+    /// The bytes are copied into the reused native input buffer, see
+    /// [`SBMLReader::from_bytes`].
+    pub fn read_bytes(&self, xml: &[u8]) -> SBMLDocument {
+        trace_span!("read_bytes", bytes_in = xml.len());
+        let mut buffer = self.buffer.borrow_mut();
+        buffer.pin_mut().clear();
+        buffer.pin_mut().push_bytes(xml);
+        self.read_buffer(&mut buffer)
+    }
+
+    /// Reads an SBML document from any source implementing [`Read`] with this reader.
+    ///
+    /// See [`SBMLReader::from_reader`].
+    pub fn read_from(&self, mut reader: impl Read) -> Result<SBMLDocument, LibSBMLError> {
+        let mut buffer = self.buffer.borrow_mut();
+        let mut chunk = self.chunk.borrow_mut();
+        chunk.resize(READ_CHUNK_SIZE, 0);
+        buffer.pin_mut().clear();
+
+        loop {
+            match reader.read(&mut chunk) {
+                Ok(0) => break,
+                Ok(n) => buffer.pin_mut().push_bytes(&chunk[..n]),
+                Err(e) if e.kind() == std::io::ErrorKind::Interrupted => continue,
+                Err(e) => {
+                    recycle_buffer(&mut buffer);
+                    return Err(e.into());
+                }
+            }
+        }
+
+        trace_span!("read_reader", bytes_in = buffer.len());
+        Ok(self.read_buffer(&mut buffer))
+    }
+
+    /// Parses the document held by the input buffer and empties the buffer again.
+    ///
+    /// The buffer keeps its capacity for the next document, see [`recycle_buffer`].
+    fn read_buffer(&self, buffer: &mut UniquePtr<CxxString>) -> SBMLDocument {
+        let ptr = unsafe {
+            UniquePtr::from_raw(
+                self.inner
+                    .borrow_mut()
+                    .as_mut()
+                    .readSBMLFromString(&**buffer),
+            )
+        };
+        recycle_buffer(buffer);
         SBMLDocument::from_unique_ptr(ptr)
     }
 }
 
+/// Empties a reused native buffer for the next document.
+///
+/// A buffer that held more than [`MAX_RETAINED_BUFFER_BYTES`] is replaced by a new,
+/// empty one, which releases its memory.
+pub(crate) fn recycle_buffer(buffer: &mut UniquePtr<CxxString>) {
+    if buffer.len() > MAX_RETAINED_BUFFER_BYTES {
+        *buffer = sbmlcxx::make_string("");
+    } else {
+        buffer.pin_mut().clear();
+    }
+}
+
 impl Default for SBMLReader {
     fn default() -> Self {
         Self::new()
     }
 }
 
+impl std::fmt::Debug for SBMLReader {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("SBMLReader").finish_non_exhaustive()
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use std::path::PathBuf;
@@ -93,6 +391,24 @@ mod tests {
         assert_eq!(list_of_parameters.len(), 0);
     }
 
+    #[test]
+    fn test_large_buffer_is_released() {
+        let xml = include_str!("../tests/data/example.xml");
+        let large = format!("{xml}<!--{}-->", " ".repeat(MAX_RETAINED_BUFFER_BYTES));
+        let reader = SBMLReader::new();
+
+        reader.read_string(xml);
+        let retained = reader.buffer.borrow().as_ptr();
+        reader.read_string(xml);
+        assert_eq!(reader.buffer.borrow().as_ptr(), retained);
+
+        // The buffer of a document above the limit is replaced after the read
+        let doc = reader.read_string(&large);
+        assert_eq!(doc.model().expect("Model not found").id(), "example");
+        assert_ne!(reader.buffer.borrow().as_ptr(), retained);
+        assert!(reader.buffer.borrow().is_empty());
+    }
+
     #[test]
     fn test_read_sbml_file_rules_only() {
         // This test uses an "external" function to ensure that returning an SBMLDocument
@@ -130,6 +446,216 @@ mod tests {
         assert_eq!(list_of_assignment_rules.len(), 0);
     }
 
+    #[test]
+    fn test_read_sbml_from_file() {
+        let doc = SBMLReader::from_file("tests/data/example.xml").unwrap();
+        let model = doc.model().expect("Model not found");
+        assert_eq!(model.id(), "example");
+        assert_eq!(model.list_of_species().len(), 2);
+    }
+
+    #[test]
+    fn test_read_sbml_from_file_with_snapshot() {
+        let dir = tempfile::tempdir().unwrap();
+        let xml_path = dir.path().join("model.xml");
+        let snapshot_path = dir.path().join("model.snapshot");
+        std::fs::copy("tests/data/example.xml", &xml_path).unwrap();
+
+        // The first read parses the XML and writes the snapshot
+        let parsed = SBMLReader::from_file_with_snapshot(&xml_path, &snapshot_path).unwrap();
+        assert!(snapshot_path.is_file());
+
+        let restored = SBMLReader::from_file_with_snapshot(&xml_path, &snapshot_path).unwrap();
+        let model = restored.model().expect("Model not found");
+        assert_eq!(model.id(), "example");
+        assert_eq!(model.list_of_species().len(), 2);
+        assert_eq!(
+            restored.model().unwrap().list_of_reactions().len(),
+            parsed.model().unwrap().list_of_reactions().len()
+        );
+
+        // A changed source invalidates the snapshot
+        let xml = std::fs::read_to_string(&xml_path).unwrap();
+        std::fs::write(&xml_path, xml.replace("id=\"example\"", "id=\"changed\"")).unwrap();
+        let changed = SBMLReader::from_file_with_snapshot(&xml_path, &snapshot_path).unwrap();
+        assert_eq!(changed.model().unwrap().id(), "changed");
+    }
+
+    #[test]
+    fn test_read_sbml_from_file_with_unsupported_snapshot() {
+        let dir = tempfile::tempdir().unwrap();
+        let xml_path = dir.path().join("model.xml");
+        let snapshot_path = dir.path().join("model.snapshot");
+        let xml = std::fs::read_to_string("tests/data/example.xml").unwrap();
+        let event = r#"<listOfEvents>
+            <event id="pulse" useValuesFromTriggerTime="true">
+                <trigger initialValue="false" persistent="true">
+                    <math xmlns="http://www.w3.org/1998/Math/MathML">
+                        <apply><gt/><csymbol encoding="text" definitionURL="http://www.sbml.org/sbml/symbols/time"> t </csymbol><cn> 10 </cn></apply>
+                    </math>
+                </trigger>
+            </event>
+        </listOfEvents>
+    </model>"#;
+        std::fs::write(&xml_path, xml.replace("</model>", event)).unwrap();
+
+        // Events are not part of snapshots, so the XML is parsed on every read
+        for _ in 0..2 {
+            let doc = SBMLReader::from_file_with_snapshot(&xml_path, &snapshot_path).unwrap();
+            assert_eq!(doc.model().unwrap().id(), "example");
+            assert!(doc.to_xml_string().contains("pulse"));
+            assert!(!snapshot_path.exists());
+        }
+    }
+
+    #[test]
+    fn test_read_sbml_from_file_with_unwritable_snapshot() {
+        let dir = tempfile::tempdir().unwrap();
+        let snapshot_path = dir.path().join("missing").join("model.snapshot");
+
+        // Failing to write the snapshot does not fail the read
+        let doc =
+            SBMLReader::from_file_with_snapshot("tests/data/example.xml", &snapshot_path).unwrap();
+        assert_eq!(doc.model().unwrap().id(), "example");
+        assert!(!snapshot_path.exists());
+    }
+
+    #[test]
+    fn test_read_sbml_from_file_with_concurrent_snapshots() {
+        let dir = tempfile::tempdir().unwrap();
+        let snapshot_path = dir.path().join("model.snapshot");
+
+        // Threads refreshing the same snapshot write to temporary files of their own
+        std::thread::scope(|scope| {
+            for _ in 0..4 {
+                scope.spawn(|| {
+                    let doc = SBMLReader::from_file("tests/data/example.xml").unwrap();
+                    for _ in 0..8 {
+                        doc.save_snapshot(&snapshot_path, 0).unwrap();
+                    }
+                });
+            }
+        });
+
+        let doc = SBMLDocument::load_snapshot(&snapshot_path, 0)
+            .unwrap()
+            .expect("Snapshot is stale");
+        assert_eq!(doc.model().unwrap().id(), "example");
+        let entries = std::fs::read_dir(dir.path()).unwrap().count();
+        assert_eq!(entries, 1);
+    }
+
+    #[test]
+    fn test_read_sbml_from_missing_file() {
+        let result = SBMLReader::from_file("tests/data/does_not_exist.xml");
+        assert!(matches!(result, Err(LibSBMLError::Io(_))));
+    }
+
+    #[test]
+    fn test_read_sbml_from_bytes() {
+        let doc = SBMLReader::from_bytes(include_bytes!("../tests/data/example.xml"));
+        let model = doc.model().expect("Model not found");
+        assert_eq!(model.id(), "example");
+        assert_eq!(model.list_of_reactions().len(), 1);
+    }
+
+    #[test]
+    fn test_read_sbml_from_reader() {
+        let file = std::fs::File::open("tests/data/odes_example_test.xml").unwrap();
+        let doc = SBMLReader::from_reader(file).unwrap();
+        let model = doc.model().expect("Model not found");
+        assert_eq!(model.list_of_species().len(), 4);
+        assert_eq!(model.list_of_rate_rules().len(), 1);
+    }
+
+    #[test]
+    fn test_read_sbml_from_reader_small_chunks() {
+        // Deliver the document a few bytes at a time to exercise chunk boundaries
+        struct Trickle<'a>(&'a [u8]);
+
+        impl Read for Trickle<'_> {
+            fn read(&mut self, buf: &mut [u8]) -> std::io::Result<usize> {
+                let n = buf.len().min(7).min(self.0.len());
+                buf[..n].copy_from_slice(&self.0[..n]);
+                self.0 = &self.0[n..];
+                Ok(n)
+            }
+        }
+
+        let xml = include_bytes!("../tests/data/example.xml");
+        let doc = SBMLReader::from_reader(Trickle(xml)).unwrap();
+        assert_eq!(
+            doc.to_xml_string(),
+            SBMLReader::from_bytes(xml).to_xml_string()
+        );
+    }
+
+    #[test]
+    fn test_reader_reuse() {
+        let reader = SBMLReader::new();
+        let large = reader
+            .read_file("tests/data/odes_example_test.xml")
+            .unwrap();
+        let small = reader.read_bytes(include_bytes!("../tests/data/example.xml"));
+        let small_again = reader.read_string(include_str!("../tests/data/example.xml"));
+
+        assert_eq!(large.model().unwrap().list_of_species().len(), 4);
+        assert_eq!(small.model().unwrap().id(), "example");
+        assert_eq!(small.to_xml_string(), small_again.to_xml_string());
+
+        let file = std::fs::File::open("tests/data/odes_example_test.xml").unwrap();
+        let read = reader.read_from(file).unwrap();
+        assert_eq!(read.to_xml_string(), large.to_xml_string());
+    }
+
+    #[test]
+    fn test_thread_local_reader_reentrant() {
+        // A source that reads another document while it is being consumed
+        struct Nested<'a>(&'a [u8]);
+
+        impl Read for Nested<'_> {
+            fn read(&mut self, buf: &mut [u8]) -> std::io::Result<usize> {
+                let nested = SBMLReader::from_bytes(include_bytes!("../tests/data/example.xml"));
+                assert_eq!(nested.model().unwrap().id(), "example");
+                self.0.read(buf)
+            }
+        }
+
+        let xml = include_bytes!("../tests/data/odes_example_test.xml");
+        let doc = SBMLReader::from_reader(Nested(xml)).unwrap();
+        assert_eq!(doc.model().unwrap().list_of_species().len(), 4);
+    }
+
+    #[cfg(feature = "parallel")]
+    #[test]
+    fn test_read_many() {
+        use rayon::iter::ParallelIterator;
+
+        let paths = vec![
+            "tests/data/example.xml",
+            "tests/data/odes_example_test.xml",
+            "tests/data/does_not_exist.xml",
+        ];
+
+        let mut results: Vec<_> = SBMLReader::read_many(paths)
+            .map(|doc| {
+                doc.map(|doc| {
+                    let n_species = doc
+                        .model()
+                        .expect("Model not found")
+                        .list_of_species()
+                        .len();
+                    n_species
+                })
+            })
+            .collect();
+        results.sort_by_key(|result| result.as_ref().ok().copied());
+
+        assert!(results[0].is_err());
+        assert_eq!(results[1].as_ref().unwrap(), &2);
+        assert_eq!(results[2].as_ref().unwrap(), &4);
+    }
+
     fn read_sbml_file(path: &PathBuf) -> Result<SBMLDocument, LibSBMLError> {
         let xml = std::fs::read_to_string(path).unwrap();
         Ok(SBMLReader::from_xml_string(&xml))
@@ -11,7 +11,11 @@ use std::{cell::RefCell, pin::Pin, rc::Rc};
 use cxx::let_cxx_string;
 
 use crate::{
-    clone, inner,
+    clone,
+    dependency::{self, Change, ChangeHook},
+    incremental::ChangeTracker,
+    index_key, inner,
+    math::ASTNode,
     model::Model,
     pin_ptr,
     prelude::IntoId,
@@ -37,6 +41,11 @@ pub enum RuleType {
 /// through a RefCell and Pin to ensure memory safety while allowing interior mutability.
 pub struct Rule<'a> {
     inner: RefCell<Pin<&'a mut sbmlcxx::Rule>>,
+    annotation_cache: AnnotationCache,
+    /// Marks the section of the document that contains this element
+    changes: ChangeTracker<'a>,
+    /// Reports changes to the dependency graph of the parent model
+    dependencies: Option<ChangeHook>,
 }
 
 // Set the inner trait for the Rule struct
@@ -49,7 +58,10 @@ sbase!(Rule<'a>, sbmlcxx::Rule);
 upcast_annotation!(Rule<'a>, sbmlcxx::Rule, sbmlcxx::SBase);
 
 // Implement the Clone trait for the Rule struct
-clone!(Rule<'a>, sbmlcxx::Rule);
+clone!(Rule<'a>, sbmlcxx::Rule, dependencies);
+
+// Index Rule collections by the variable they define
+index_key!(Rule<'_>, getVariable);
 
 impl<'a> Rule<'a> {
     /// Creates a new RateRule instance within the given Model.
@@ -73,8 +85,12 @@ impl<'a> Rule<'a> {
         let_cxx_string!(formula = formula);
         rule.as_mut().setFormula(&formula);
 
+        let change = Change::Rule(&*rule as *const sbmlcxx::Rule as usize);
         Self {
             inner: RefCell::new(rule),
+            annotation_cache: AnnotationCache::default(),
+            changes: model.changes(),
+            dependencies: Some(model.dependency_hook(change)),
         }
     }
 
@@ -98,11 +114,36 @@ impl<'a> Rule<'a> {
         let_cxx_string!(formula = formula);
         rule.as_mut().setFormula(&formula);
 
+        let change = Change::Rule(&*rule as *const sbmlcxx::Rule as usize);
         Self {
             inner: RefCell::new(rule),
+            annotation_cache: AnnotationCache::default(),
+            changes: model.changes(),
+            dependencies: Some(model.dependency_hook(change)),
         }
     }
 
+    /// Attaches a rule wrapped from the native model to the dependency graph of the
+    /// model.
+    pub(crate) fn tracked_by(mut self, model: &Model<'a>) -> Self {
+        let change = Change::Rule(dependency::address_of(&self.inner));
+        self.dependencies = Some(model.dependency_hook(change));
+        self
+    }
+
+    /// Reports a change of the variable or math to the dependency graph of the model.
+    fn notify_dependencies(&self) {
+        if let Some(hook) = &self.dependencies {
+            hook.notify();
+        }
+    }
+
+    /// Reports a new variable, which is also the key the rule is indexed by.
+    fn variable_changed(&self) {
+        self.notify_dependencies();
+        self.key_changed();
+    }
+
     /// Returns a reference to the inner RefCell containing the RateRule pointer.
     ///
     /// This is primarily used internally by other parts of the library.
@@ -112,10 +153,41 @@ impl<'a> Rule<'a> {
     }
 
     // Getter and setter for variable
-    required_property!(Rule<'a>, variable, String, getVariable, setVariable);
+    required_property!(
+        Rule<'a>,
+        variable,
+        String,
+        getVariable,
+        setVariable,
+        after_set = variable_changed
+    );
 
     // Getter and setter for formula
-    required_property!(Rule<'a>, formula, String, getFormula, setFormula);
+    required_property!(
+        Rule<'a>,
+        formula,
+        String,
+        getFormula,
+        setFormula,
+        after_set = notify_dependencies
+    );
+
+    /// Runs `f` with a read-only view on the math of the rule.
+    ///
+    /// The rule stays borrowed while `f` runs, so the math tree cannot be replaced,
+    /// and thereby freed, while the view is in use. Calling a setter of the rule
+    /// from within `f` panics.
+    ///
+    /// # Arguments
+    /// * `f` - The function to run with the root node of the math tree, or None if
+    ///   no math is set
+    ///
+    /// # Returns
+    /// The result of `f`
+    pub fn with_math<R>(&self, f: impl FnOnce(Option<ASTNode<'_>>) -> R) -> R {
+        let inner = self.inner.borrow();
+        f(ASTNode::from_ptr(inner.getMath()))
+    }
 
     /// Returns the type of the rule.
     ///
@@ -160,6 +232,9 @@ impl FromPtr<sbmlcxx::Rule> for Rule<'_> {
         let rule = pin_ptr!(ptr, sbmlcxx::Rule);
         Self {
             inner: RefCell::new(rule),
+            annotation_cache: AnnotationCache::default(),
+            changes: ChangeTracker::default(),
+            dependencies: None,
         }
     }
 }
@@ -5,7 +5,7 @@
 //! computational models in systems biology. An SBMLDocument is the root container
 //! for all SBML content.
 
-use std::{cell::RefCell, collections::HashMap, rc::Rc};
+use std::{cell::RefCell, collections::HashMap, io::Write, path::Path, rc::Rc};
 
 use autocxx::WithinUniquePtr;
 use cxx::{let_cxx_string, UniquePtr};
@@ -13,24 +13,54 @@ use std::pin::Pin;
 
 use crate::{
     cast::upcast,
+    errors::LibSBMLError,
+    incremental::ChangeLog,
+    instrument::trace_span,
+    memory::MemoryUsage,
     model::Model,
     namespaces::SBMLNamespaces,
     packages::{Package, PackageSpec},
     pin_const_ptr, pin_ptr,
-    prelude::SBMLErrorLog,
-    sbmlcxx,
+    prelude::{LazyErrorLog, SBMLErrorLog},
+    sbmlcxx, snapshot,
     traits::fromptr::FromPtr,
+    validation::{self, ValidationOptions, ValidationReport},
+    variant::DocumentVariant,
+    writer::{self, SBMLWriter},
 };
 
 /// A wrapper around libSBML's SBMLDocument class that provides a safe Rust interface.
 ///
 /// The SBMLDocument is the top-level container for an SBML model and associated data.
 /// It maintains the SBML level and version, and contains a single optional Model.
+///
+/// An SBMLDocument is [`Send`], so it can be handed to another thread, for instance
+/// to process many documents in parallel. It is not [`Sync`]: all wrappers obtained from
+/// a document (models, species, ...) borrow it and are confined to the thread that owns
+/// the document at that point.
 pub struct SBMLDocument {
     /// The underlying libSBML document, wrapped in RefCell to allow interior mutability
     document: RefCell<UniquePtr<sbmlcxx::SBMLDocument>>,
+    /// Change counters shared with the wrappers, read by incremental writers
+    changes: ChangeLog,
 }
 
+// SAFETY: The document exclusively owns its libSBML object tree, and every wrapper that
+// points into that tree (`Model<'a>`, `Species<'a>`, ...) borrows the document for `'a`.
+// The document can therefore only be moved to another thread once all wrappers are gone,
+// and it is never accessed from two threads at once since it is not `Sync`. The same
+// holds for the change counters, which wrappers reference for `'a`.
+//
+// Documents on different threads do share libSBML's process-global tables: the package
+// extension registry, the converter registry and the error tables. The registries are
+// created and filled while the library is loaded, by the static initializers of the
+// built-in packages and converters, and the error tables are constant. This crate never
+// registers, enables or disables packages or converters at run time, so documents only
+// read these globals. Validators and converters are owned by the document or created
+// for a single call. Code that changes the registries through other bindings while
+// documents are in use on other threads is not covered by this argument.
+unsafe impl Send for SBMLDocument {}
+
 impl SBMLDocument {
     /// Creates a new SBMLDocument with the specified SBML level and version.
     ///
@@ -62,6 +92,7 @@ impl SBMLDocument {
 
         Self {
             document: RefCell::new(document),
+            changes: ChangeLog::default(),
         }
     }
 
@@ -80,7 +111,10 @@ impl SBMLDocument {
         // Wrap the pointer in a RefCell
         let document = RefCell::new(ptr);
 
-        SBMLDocument { document }
+        SBMLDocument {
+            document,
+            changes: ChangeLog::default(),
+        }
     }
 
     /// Returns a reference to the underlying libSBML document.
@@ -90,6 +124,11 @@ impl SBMLDocument {
         &self.document
     }
 
+    /// Returns the change counters that the wrappers of this document mark.
+    pub(crate) fn changes(&self) -> &ChangeLog {
+        &self.changes
+    }
+
     /// Returns the XML namespaces defined in this SBML document.
     ///
     /// This method retrieves all namespace prefix-URI pairs that are defined
@@ -175,6 +214,24 @@ impl SBMLDocument {
         base.getVersion().0
     }
 
+    /// Reports the memory held by the native object tree of the document.
+    ///
+    /// Wrappers are not owned by the document, so the report only covers native
+    /// elements. Add the wrapper part of [`Model::memory_usage`] to account for the
+    /// wrappers of a model that is kept around. See [`MemoryUsage`] for details.
+    pub fn memory_usage(&self) -> MemoryUsage {
+        if self.document.borrow().is_null() {
+            return MemoryUsage::default();
+        }
+
+        let base = unsafe {
+            upcast::<sbmlcxx::SBMLDocument, sbmlcxx::SBase>(self.document.borrow_mut().as_mut_ptr())
+        };
+        let mut usage = MemoryUsage::native(&base);
+        usage.wrapper_bytes += std::mem::size_of::<Self>();
+        usage
+    }
+
     /// Returns the number of plugins in the document.
     pub fn plugins(&self) -> Vec<String> {
         let base = unsafe {
@@ -212,34 +269,75 @@ impl SBMLDocument {
         let has_model = self.document.borrow_mut().as_mut()?.isSetModel();
 
         if has_model {
-            Some(Rc::new(Model::from_ptr(
-                self.document.borrow_mut().as_mut()?.getModel1(),
-            )))
+            Some(Rc::new(
+                Model::from_ptr(self.document.borrow_mut().as_mut()?.getModel1())
+                    .with_changes(self.changes.tracker()),
+            ))
         } else {
             None
         }
     }
 
+    /// Creates a copy-on-write variant of this document.
+    ///
+    /// The variant records value changes without touching this document and only
+    /// builds a native document when it is materialized. See [`crate::variant`].
+    pub fn variant(&self) -> DocumentVariant<'_> {
+        DocumentVariant::new(self)
+    }
+
     /// Converts the SBML document to an XML string representation.
     ///
-    /// This function uses the SBMLWriter to serialize the current state of the
-    /// SBML document into an XML string. If the document is not available,
-    /// an empty string is returned.
+    /// This function uses the SBMLWriter of the current thread to serialize the
+    /// current state of the SBML document into an XML string, see
+    /// [`SBMLWriter::with_thread_local`]. If the document is not available, an empty
+    /// string is returned.
     ///
     /// # Returns
     /// A String containing the XML representation of the SBML document, or
     /// an empty String if the document is not available.
     pub fn to_xml_string(&self) -> String {
-        let mut writer = sbmlcxx::SBMLWriter::new().within_unique_ptr();
+        trace_span!("to_xml_string");
+        SBMLWriter::with_thread_local(|writer| writer.write_string(self))
+    }
 
-        if let Some(doc) = self.document.borrow_mut().as_mut() {
-            let raw_ptr: *mut sbmlcxx::SBMLDocument = unsafe { doc.get_unchecked_mut() as *mut _ };
-            let string_ptr = unsafe { writer.pin_mut().writeSBMLToString(raw_ptr) };
-            let string = unsafe { std::ffi::CStr::from_ptr(string_ptr) };
-            string.to_string_lossy().into_owned()
-        } else {
-            String::new()
-        }
+    /// Writes the SBML document to a file.
+    ///
+    /// The file is written by libSBML directly. If the file name ends in `.gz`,
+    /// `.zip` or `.bz2`, the output is compressed accordingly, which requires
+    /// libSBML to be built with the respective compression support.
+    ///
+    /// # Arguments
+    /// * `path` - Path of the file to write
+    ///
+    /// # Returns
+    /// Ok(()) if the document was written, or an error if compression is not
+    /// available or the file could not be written
+    pub fn write_to_file(&self, path: impl AsRef<Path>) -> Result<(), LibSBMLError> {
+        SBMLWriter::with_thread_local(|writer| writer.write_file(self, path))
+    }
+
+    /// Writes the XML representation of the SBML document to a writer.
+    ///
+    /// The document is serialized into the native buffer of the current thread's
+    /// SBMLWriter, which is written out directly, without an intermediate Rust
+    /// `String`.
+    ///
+    /// # Arguments
+    /// * `writer` - The destination to write the SBML XML to
+    ///
+    /// # Returns
+    /// Ok(()) if the document was written, or the error returned by the writer
+    pub fn write_to(&self, writer: impl Write) -> Result<(), LibSBMLError> {
+        SBMLWriter::with_thread_local(|sbml_writer| sbml_writer.write_to(self, writer))
+    }
+
+    /// Returns a raw pointer to the underlying libSBML document, if available.
+    pub(crate) fn document_ptr(&self) -> Option<*const sbmlcxx::SBMLDocument> {
+        self.document
+            .borrow()
+            .as_ref()
+            .map(|doc| doc as *const sbmlcxx::SBMLDocument)
     }
 
     /// Checks the consistency of the SBML document.
@@ -255,6 +353,7 @@ impl SBMLDocument {
     /// # Returns
     /// A [`SBMLErrorLog`] containing the validation status and errors of the document.
     pub fn check_consistency(&self) -> SBMLErrorLog {
+        trace_span!("check_consistency");
         self.inner()
             .borrow_mut()
             .as_mut()
@@ -263,6 +362,135 @@ impl SBMLDocument {
 
         SBMLErrorLog::new(self)
     }
+
+    /// Checks the consistency of the SBML document without converting its errors.
+    ///
+    /// This runs the same checks as [`SBMLDocument::check_consistency`], but returns a
+    /// [`LazyErrorLog`] that only converts errors when they are requested. Use this if
+    /// you are mainly interested in whether the document is valid or in a few errors.
+    ///
+    /// # Returns
+    /// A [`LazyErrorLog`] on the document's error log
+    pub fn check_consistency_lazy(&self) -> LazyErrorLog<'_> {
+        trace_span!("check_consistency");
+        self.inner()
+            .borrow_mut()
+            .as_mut()
+            .unwrap()
+            .checkConsistency();
+
+        LazyErrorLog::new(self)
+    }
+
+    /// Returns a lazy view on the document's current error log.
+    ///
+    /// The log contains the errors encountered while reading the document as well as
+    /// those of previous consistency checks.
+    pub fn error_log(&self) -> LazyErrorLog<'_> {
+        LazyErrorLog::new(self)
+    }
+
+    /// Encodes the document into a binary snapshot.
+    ///
+    /// See [`crate::snapshot`] for the format and what it covers.
+    ///
+    /// # Arguments
+    /// * `source_hash` - Hash of the XML source, see [`snapshot::source_hash`]
+    ///
+    /// # Returns
+    /// The encoded snapshot, or [`LibSBMLError::Unsupported`] if the document has
+    /// content that snapshots cannot represent
+    pub fn to_snapshot(&self, source_hash: u64) -> Result<Vec<u8>, LibSBMLError> {
+        snapshot::encode(self, source_hash)
+    }
+
+    /// Rebuilds a document from a binary snapshot.
+    ///
+    /// The bytes are decoded in place, so they may come from a memory-mapped file.
+    ///
+    /// # Arguments
+    /// * `bytes` - The snapshot, as produced by [`SBMLDocument::to_snapshot`]
+    /// * `source_hash` - Hash of the XML source the snapshot is expected to match
+    ///
+    /// # Returns
+    /// The rebuilt document, `None` if the snapshot is stale, or an error if the
+    /// bytes are not a valid snapshot
+    pub fn from_snapshot(
+        bytes: &[u8],
+        source_hash: u64,
+    ) -> Result<Option<SBMLDocument>, LibSBMLError> {
+        snapshot::decode(bytes, source_hash)
+    }
+
+    /// Writes a binary snapshot of the document to a file.
+    ///
+    /// The snapshot is written next to the target and moved into place afterwards,
+    /// so that concurrent readers never see a partially written snapshot.
+    ///
+    /// # Arguments
+    /// * `path` - Path of the snapshot file
+    /// * `source_hash` - Hash of the XML source, see [`snapshot::source_hash`]
+    ///
+    /// # Returns
+    /// Ok(()) if the snapshot was written, [`LibSBMLError::Unsupported`] if the
+    /// document cannot be snapshotted, or an error if writing the file fails
+    pub fn save_snapshot(
+        &self,
+        path: impl AsRef<Path>,
+        source_hash: u64,
+    ) -> Result<(), LibSBMLError> {
+        let path = path.as_ref();
+        let bytes = self.to_snapshot(source_hash)?;
+
+        let temp_path = writer::temp_path_for(path)
+            .map_err(|e| LibSBMLError::InvalidArgument(e.to_string()))?;
+
+        let result = std::fs::File::create(&temp_path)
+            .and_then(|mut file| {
+                file.write_all(&bytes)?;
+                file.sync_all()
+            })
+            .and_then(|_| std::fs::rename(&temp_path, path));
+
+        if let Err(e) = result {
+            let _ = std::fs::remove_file(&temp_path);
+            return Err(e.into());
+        }
+        Ok(())
+    }
+
+    /// Reads a document from a binary snapshot file.
+    ///
+    /// # Arguments
+    /// * `path` - Path of the snapshot file
+    /// * `source_hash` - Hash of the XML source the snapshot is expected to match
+    ///
+    /// # Returns
+    /// The rebuilt document, `None` if the snapshot is stale, or an error if the
+    /// file cannot be read or is not a valid snapshot
+    pub fn load_snapshot(
+        path: impl AsRef<Path>,
+        source_hash: u64,
+    ) -> Result<Option<SBMLDocument>, LibSBMLError> {
+        let bytes = std::fs::read(path)?;
+        Self::from_snapshot(&bytes, source_hash)
+    }
+
+    /// Checks the consistency of the SBML document using a selection of checks.
+    ///
+    /// In contrast to [`SBMLDocument::check_consistency`], only the categories enabled
+    /// in `options` are run, optionally concurrently on copies of the document. The
+    /// returned report contains the merged error log as well as the time spent in
+    /// each category.
+    ///
+    /// # Arguments
+    /// * `options` - The checks to run and how to run them
+    ///
+    /// # Returns
+    /// A [`ValidationReport`] containing the errors and timings of the checks
+    pub fn check_consistency_with(&self, options: &ValidationOptions) -> ValidationReport {
+        validation::check_consistency(self, options)
+    }
 }
 
 impl std::fmt::Debug for SBMLDocument {
@@ -275,6 +503,22 @@ impl std::fmt::Debug for SBMLDocument {
     }
 }
 
+impl Clone for SBMLDocument {
+    /// Creates an independent deep copy of this document using libSBML's
+    /// `SBMLDocument::clone`.
+    ///
+    /// The copy owns its own libSBML object tree, so it can be moved to and worked on
+    /// in another thread without affecting this document. Its model is wrapped lazily
+    /// on access, like the model of a document that was read from a file.
+    fn clone(&self) -> Self {
+        let ptr = match self.document.borrow().as_ref() {
+            Some(doc) => unsafe { UniquePtr::from_raw(sbmlcxx::SBMLDocument::clone(doc)) },
+            None => UniquePtr::null(),
+        };
+        SBMLDocument::from_unique_ptr(ptr)
+    }
+}
+
 impl Default for SBMLDocument {
     /// Creates a new SBMLDocument with the default SBML level and version, and FBC package.
     ///
@@ -287,9 +531,10 @@ impl Default for SBMLDocument {
 
 #[cfg(test)]
 mod tests {
-    use crate::prelude::SBMLErrorSeverity;
+    use crate::prelude::{SBMLErrorSeverity, SBMLReader};
 
     use super::*;
+    use autocxx::c_uint;
 
     #[test]
     fn test_sbmldoc_new() {
@@ -323,6 +568,78 @@ mod tests {
         assert!(!xml_string.is_empty());
     }
 
+    #[test]
+    fn test_sbmldoc_is_send() {
+        fn assert_send<T: Send>() {}
+        assert_send::<SBMLDocument>();
+
+        let doc = SBMLDocument::default();
+        doc.create_model("test").create_species("glucose");
+
+        // Move the document to a worker thread and work with it there
+        let handle = std::thread::spawn(move || {
+            {
+                let model = doc.model().expect("Model not found");
+                model.create_species("fructose");
+            }
+            doc
+        });
+
+        let doc = handle.join().unwrap();
+        let model = doc.model().expect("Model not found");
+        assert_eq!(model.list_of_species().len(), 2);
+    }
+
+    #[test]
+    fn test_sbmldoc_write_to() {
+        let doc = SBMLDocument::default();
+        doc.create_model("test").create_species("glucose");
+
+        let mut buffer = Vec::new();
+        doc.write_to(&mut buffer).unwrap();
+        assert_eq!(String::from_utf8(buffer).unwrap(), doc.to_xml_string());
+    }
+
+    #[test]
+    fn test_sbmldoc_write_to_file() {
+        let doc = SBMLDocument::default();
+        doc.create_model("test").create_species("glucose");
+
+        let dir = tempfile::tempdir().unwrap();
+        let path = dir.path().join("model.xml");
+        doc.write_to_file(&path).unwrap();
+
+        let read = SBMLReader::from_file(&path).unwrap();
+        let model = read.model().expect("Model not found");
+        assert_eq!(model.id(), "test");
+        assert!(model.get_species("glucose").is_some());
+    }
+
+    #[test]
+    fn test_sbmldoc_write_to_file_gzip() {
+        if !sbmlcxx::SBMLWriter::hasZlib() {
+            return;
+        }
+
+        let doc = SBMLDocument::default();
+        doc.create_model("test").create_species("glucose");
+
+        let dir = tempfile::tempdir().unwrap();
+        let path = dir.path().join("model.xml.gz");
+        doc.write_to_file(&path).unwrap();
+
+        // The output must be gzip compressed
+        let bytes = std::fs::read(&path).unwrap();
+        assert_eq!(&bytes[..2], &[0x1f, 0x8b]);
+
+        let read = SBMLReader::from_file(&path).unwrap();
+        assert!(read
+            .model()
+            .expect("Model not found")
+            .get_species("glucose")
+            .is_some());
+    }
+
     #[test]
     fn test_sbmldoc_check_consistency() {
         let doc = SBMLDocument::default();
@@ -354,6 +671,91 @@ mod tests {
         // Check that the error log contains the correct number of errors
     }
 
+    #[test]
+    fn test_lazy_error_log_fatal_of_any_category() {
+        let doc = SBMLDocument::default();
+
+        // libSBML files UnknownError as an internal and XMLOutOfMemory as a system
+        // error, both of fatal severity.
+        for (id, category) in [(10000, 0), (1, 1)] {
+            sbmlcxx::sbmlrs::logError(
+                doc.inner().borrow_mut().pin_mut(),
+                c_uint::from(id),
+                c_uint::from(3),
+                c_uint::from(category),
+            );
+        }
+
+        let log = doc.error_log();
+        let counts = log.count_by_severity();
+        assert_eq!(counts.fatals, 2);
+        assert!(!log.is_valid());
+        assert!(log.first_fatal().is_some());
+        assert_eq!(
+            log.with_severity(SBMLErrorSeverity::Fatal).count(),
+            counts.fatals
+        );
+    }
+
+    #[test]
+    fn test_sbmldoc_check_consistency_lazy() {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("model");
+        model
+            .build_species("some")
+            .initial_concentration(-10.0)
+            .build();
+        model.build_parameter("test").build();
+
+        let eager = doc.clone().check_consistency();
+        let lazy = doc.check_consistency_lazy();
+
+        assert_eq!(lazy.is_valid(), eager.valid);
+        assert_eq!(lazy.len(), eager.errors.len());
+
+        let counts = lazy.count_by_severity();
+        let n_errors = eager
+            .errors
+            .iter()
+            .filter(|e| e.severity == SBMLErrorSeverity::Error)
+            .count();
+        assert_eq!(counts.errors, n_errors);
+        assert_eq!(
+            lazy.with_severity(SBMLErrorSeverity::Error).count(),
+            n_errors
+        );
+        assert!(lazy.first_fatal().is_none());
+
+        // Iteration, paging and random access agree with the eager log
+        let messages: Vec<_> = lazy.iter().map(|e| e.message).collect();
+        let eager_messages: Vec<_> = eager.errors.iter().map(|e| e.message.clone()).collect();
+        assert_eq!(messages, eager_messages);
+        assert_eq!(lazy.iter().len(), lazy.len());
+        assert_eq!(
+            lazy.page(1, 2)
+                .iter()
+                .map(|e| &e.message)
+                .collect::<Vec<_>>(),
+            eager_messages.iter().skip(1).take(2).collect::<Vec<_>>()
+        );
+        assert_eq!(
+            lazy.get(lazy.len() - 1).map(|e| e.message),
+            lazy.iter().next_back().map(|e| e.message)
+        );
+        assert!(lazy.get(lazy.len()).is_none());
+    }
+
+    #[test]
+    fn test_sbmldoc_error_log_valid_document() {
+        let doc = SBMLDocument::default();
+        doc.create_model("model");
+
+        let log = doc.check_consistency_lazy();
+        assert!(log.is_valid());
+        assert_eq!(log.count_by_severity().errors, 0);
+        assert!(doc.error_log().first_fatal().is_none());
+    }
+
     #[test]
     fn test_sbmldoc_check_consistency_warning() {
         let doc = SBMLDocument::default();
@@ -408,6 +810,27 @@ mod tests {
         assert!(!_xml.is_empty());
     }
 
+    #[test]
+    fn test_sbmldoc_clone() {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("test");
+        model.build_parameter("k1").value(1.0).build();
+
+        let copy = doc.clone();
+        copy.model()
+            .unwrap()
+            .get_parameter("k1")
+            .unwrap()
+            .set_value(2.0);
+
+        assert_eq!(copy.model().unwrap().id(), "test");
+        assert_eq!(
+            copy.model().unwrap().get_parameter("k1").unwrap().value(),
+            Some(2.0)
+        );
+        assert_eq!(model.get_parameter("k1").unwrap().value(), Some(1.0));
+    }
+
     #[test]
     fn test_retrieve_namespaces() {
         let doc = SBMLDocument::default();
@@ -7,13 +7,33 @@
 //!
 //! The main types in this module are:
 //! - `SBMLErrorLog`: A collection of validation errors from an SBML document
+//! - `LazyErrorLog`: A view on a document's error log that converts errors on demand
 //! - `SBMLError`: An individual validation error with detailed information
 //! - `SBMLErrorSeverity`: The severity level of an error (Error, Warning, etc.)
 
-use std::pin::Pin;
+use std::{ops::Range, pin::Pin};
+
+use autocxx::c_uint;
 
 use crate::{pin_ptr, sbmlcxx, SBMLDocument};
 
+/// Numeric values of libSBML's `XMLErrorSeverity_t`
+const LIBSBML_SEV_INFO: u32 = 0;
+const LIBSBML_SEV_WARNING: u32 = 1;
+const LIBSBML_SEV_ERROR: u32 = 2;
+const LIBSBML_SEV_FATAL: u32 = 3;
+
+/// Returns the native `XMLErrorSeverity_t` code of a severity, if it has one.
+fn native_severity(severity: SBMLErrorSeverity) -> Option<u32> {
+    match severity {
+        SBMLErrorSeverity::Info => Some(LIBSBML_SEV_INFO),
+        SBMLErrorSeverity::Warning => Some(LIBSBML_SEV_WARNING),
+        SBMLErrorSeverity::Error => Some(LIBSBML_SEV_ERROR),
+        SBMLErrorSeverity::Fatal => Some(LIBSBML_SEV_FATAL),
+        _ => None,
+    }
+}
+
 /// Represents a collection of SBML validation errors from a document.
 ///
 /// This struct contains the validation status of an SBML document and
@@ -39,29 +59,257 @@ impl SBMLErrorLog {
     /// # Returns
     /// A new `SBMLErrorLog` containing all errors and validation status
     pub fn new(document: &SBMLDocument) -> Self {
-        // Get the amount of errors for extraction
         let n_errors = document.inner().borrow().getNumErrors().0;
+        Self::from_errors(Self::collect_errors(document, 0..n_errors))
+    }
 
+    /// Creates a new error log from a list of errors.
+    ///
+    /// The log is considered valid if none of the errors has severity level
+    /// Error or Fatal.
+    ///
+    /// # Arguments
+    /// * `errors` - The errors making up the log
+    ///
+    /// # Returns
+    /// A new `SBMLErrorLog` containing the errors and validation status
+    pub fn from_errors(errors: Vec<SBMLError>) -> Self {
+        // Document is invalid if it contains any Error or Fatal severity errors
+        let has_errors = errors.iter().any(|error| {
+            error.severity == SBMLErrorSeverity::Error || error.severity == SBMLErrorSeverity::Fatal
+        });
+
+        Self {
+            valid: !has_errors,
+            errors,
+        }
+    }
+
+    /// Extracts a range of errors from a document's internal error log.
+    ///
+    /// # Arguments
+    /// * `document` - Reference to the SBML document to extract errors from
+    /// * `range` - Indices of the errors to extract
+    ///
+    /// # Returns
+    /// The extracted errors
+    pub(crate) fn collect_errors(document: &SBMLDocument, range: Range<u32>) -> Vec<SBMLError> {
         // Pin the error log to extract all errors
         let errorlog_ptr = document.inner().borrow_mut().pin_mut().getErrorLog();
         let errorlog = pin_ptr!(errorlog_ptr, sbmlcxx::SBMLErrorLog);
 
         // Convert the errors to a Vec with pre-allocated capacity for efficiency
-        let mut errors = Vec::with_capacity(n_errors as usize);
-        for i in 0..n_errors {
+        let mut errors = Vec::with_capacity(range.len());
+        for i in range {
             errors.push(SBMLError::new(errorlog.as_ref().getError(i.into())));
         }
 
-        // Document is invalid if it contains any Error or Fatal severity errors
-        let has_errors = errors.iter().any(|error| {
-            error.severity == SBMLErrorSeverity::Error || error.severity == SBMLErrorSeverity::Fatal
-        });
+        errors
+    }
+}
 
-        Self {
-            valid: !has_errors,
-            errors,
+/// A lazy view on the error log of an SBML document.
+///
+/// In contrast to [`SBMLErrorLog`], no error is converted into an owned [`SBMLError`]
+/// until it is requested. Counting errors by severity and checking validity are done
+/// entirely by libSBML, so they stay cheap even for documents with hundreds of
+/// thousands of messages.
+pub struct LazyErrorLog<'a> {
+    document: &'a SBMLDocument,
+}
+
+impl<'a> LazyErrorLog<'a> {
+    /// Creates a lazy view on the error log of a document.
+    ///
+    /// # Arguments
+    /// * `document` - Reference to the SBML document whose errors should be viewed
+    pub fn new(document: &'a SBMLDocument) -> Self {
+        Self { document }
+    }
+
+    /// Returns the total number of errors, warnings and other messages in the log.
+    pub fn len(&self) -> usize {
+        self.document.inner().borrow().getNumErrors().0 as usize
+    }
+
+    /// Returns whether the log is empty.
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    /// Returns whether the document is valid, i.e. has no errors of severity
+    /// Error or Fatal.
+    pub fn is_valid(&self) -> bool {
+        let counts = self.count_by_severity();
+        counts.errors == 0 && counts.fatals == 0
+    }
+
+    /// Counts the messages in the log per severity without converting them.
+    pub fn count_by_severity(&self) -> SeverityCounts {
+        SeverityCounts {
+            infos: self.count_with_severity(LIBSBML_SEV_INFO),
+            warnings: self.count_with_severity(LIBSBML_SEV_WARNING),
+            errors: self.count_with_severity(LIBSBML_SEV_ERROR),
+            fatals: self.count_with_severity(LIBSBML_SEV_FATAL),
         }
     }
+
+    /// Returns the error at the given position, if any.
+    ///
+    /// # Arguments
+    /// * `index` - Position of the error in the log
+    pub fn get(&self, index: usize) -> Option<SBMLError> {
+        (index < self.len()).then(|| SBMLError::new(self.native_error(index)))
+    }
+
+    /// Returns the first error of severity Fatal, if any.
+    ///
+    /// The log is only scanned if libSBML reports at least one fatal error, and the
+    /// scan stops at the first hit.
+    pub fn first_fatal(&self) -> Option<SBMLError> {
+        if self.count_with_severity(LIBSBML_SEV_FATAL) == 0 {
+            return None;
+        }
+        self.with_severity(SBMLErrorSeverity::Fatal).next()
+    }
+
+    /// Returns an iterator converting the errors of the log one at a time.
+    pub fn iter(&self) -> LazyErrorIter<'_> {
+        LazyErrorIter {
+            log: self,
+            index: 0,
+            end: self.len(),
+        }
+    }
+
+    /// Converts a page of errors.
+    ///
+    /// # Arguments
+    /// * `offset` - Position of the first error of the page
+    /// * `limit` - Maximum number of errors on the page
+    pub fn page(&self, offset: usize, limit: usize) -> Vec<SBMLError> {
+        self.iter().skip(offset).take(limit).collect()
+    }
+
+    /// Returns an iterator over the errors of the given severity.
+    ///
+    /// The severity of each error is checked on the native object, so only matching
+    /// errors are converted. Info, Warning, Error and Fatal are compared against the
+    /// native severity, like [`LazyErrorLog::count_by_severity`] does, regardless of
+    /// the category of the error. The converted errors report their severity as
+    /// [`SBMLErrorSeverity::from`] maps it, so a fatal error of the internal category
+    /// is returned for Fatal but reports Internal. Internal, System and Unknown have
+    /// no native severity and are matched by that mapping.
+    ///
+    /// # Arguments
+    /// * `severity` - The severity to filter by
+    pub fn with_severity(
+        &self,
+        severity: SBMLErrorSeverity,
+    ) -> impl Iterator<Item = SBMLError> + '_ {
+        let native = native_severity(severity);
+        (0..self.len())
+            .filter(move |&index| {
+                let error = self.xml_error(index);
+                match native {
+                    Some(code) => error.getSeverity().0 == code,
+                    None => SBMLErrorSeverity::from(error) == severity,
+                }
+            })
+            .map(|index| SBMLError::new(self.native_error(index)))
+    }
+
+    /// Converts all errors into an eager [`SBMLErrorLog`].
+    pub fn to_error_log(&self) -> SBMLErrorLog {
+        SBMLErrorLog::new(self.document)
+    }
+
+    /// Counts the messages with the given native severity.
+    fn count_with_severity(&self, severity: u32) -> usize {
+        self.document
+            .inner()
+            .borrow()
+            .getNumErrors1(c_uint::from(severity))
+            .0 as usize
+    }
+
+    /// Returns a pointer to the native error at the given position.
+    fn native_error(&self, index: usize) -> *const sbmlcxx::SBMLError {
+        let errorlog_ptr = self.document.inner().borrow_mut().pin_mut().getErrorLog();
+        let errorlog = pin_ptr!(errorlog_ptr, sbmlcxx::SBMLErrorLog);
+        errorlog.as_ref().getError(c_uint::from(index as u32))
+    }
+
+    /// Returns the native error at the given position as an XMLError.
+    fn xml_error(&self, index: usize) -> &sbmlcxx::XMLError {
+        let xml_error = self.native_error(index) as *const sbmlcxx::XMLError;
+        unsafe { &*xml_error }
+    }
+}
+
+impl std::fmt::Debug for LazyErrorLog<'_> {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        let mut ds = f.debug_struct("LazyErrorLog");
+        ds.field("len", &self.len());
+        ds.field("counts", &self.count_by_severity());
+        ds.finish()
+    }
+}
+
+/// Iterator over the errors of a [`LazyErrorLog`], converting them on demand.
+pub struct LazyErrorIter<'a> {
+    log: &'a LazyErrorLog<'a>,
+    index: usize,
+    end: usize,
+}
+
+impl Iterator for LazyErrorIter<'_> {
+    type Item = SBMLError;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        if self.index >= self.end {
+            return None;
+        }
+        let error = SBMLError::new(self.log.native_error(self.index));
+        self.index += 1;
+        Some(error)
+    }
+
+    fn size_hint(&self) -> (usize, Option<usize>) {
+        let remaining = self.end - self.index;
+        (remaining, Some(remaining))
+    }
+
+    fn nth(&mut self, n: usize) -> Option<Self::Item> {
+        // Skip without converting the errors in between
+        self.index = self.index.saturating_add(n).min(self.end);
+        self.next()
+    }
+}
+
+impl DoubleEndedIterator for LazyErrorIter<'_> {
+    fn next_back(&mut self) -> Option<Self::Item> {
+        if self.index >= self.end {
+            return None;
+        }
+        self.end -= 1;
+        Some(SBMLError::new(self.log.native_error(self.end)))
+    }
+}
+
+impl ExactSizeIterator for LazyErrorIter<'_> {}
+
+/// Number of messages per severity in an error log.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct SeverityCounts {
+    /// Number of informational messages
+    pub infos: usize,
+    /// Number of warnings
+    pub warnings: usize,
+    /// Number of errors
+    pub errors: usize,
+    /// Number of fatal errors
+    pub fatals: usize,
 }
 
 /// Represents a single SBML validation error.
@@ -115,7 +363,7 @@ impl SBMLError {
 ///
 /// SBML errors can have different severity levels, ranging from
 /// informational messages to fatal errors that prevent document processing.
-#[derive(Debug, PartialEq, Eq)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
 pub enum SBMLErrorSeverity {
     /// Standard error that indicates a problem with the SBML document
     Error,
@@ -0,0 +1,306 @@
+//! Lightweight metadata scans of SBML files.
+//!
+//! Indexing large collections of SBML files usually only needs a few facts per file:
+//! the SBML level and version, the model's id and name, the declared namespaces and
+//! packages, and how many elements each `ListOf*` contains. [`ModelSummary`] gathers
+//! these in a single forward pass over the XML, without handing the file to libSBML.
+//!
+//! Memory use is independent of the file size: only the path of currently open
+//! elements is tracked, and annotation, notes and MathML subtrees are skipped
+//! without being decoded.
+//!
+//! ```no_run
+//! use sbml::scan::ModelSummary;
+//!
+//! let summary = ModelSummary::from_file("model.xml")?;
+//! println!(
+//!     "{} (L{}V{}): {} species",
+//!     summary.model_id.as_deref().unwrap_or("unnamed"),
+//!     summary.level.unwrap_or_default(),
+//!     summary.version.unwrap_or_default(),
+//!     summary.count("listOfSpecies"),
+//! );
+//! # Ok::<(), sbml::errors::LibSBMLError>(())
+//! ```
+
+use std::{
+    borrow::Cow,
+    collections::{BTreeMap, HashMap},
+    fs::File,
+    io::{BufReader, Read},
+    path::Path,
+};
+
+use quick_xml::{
+    encoding::Decoder,
+    events::{BytesStart, Event},
+    Reader,
+};
+
+use crate::errors::LibSBMLError;
+
+/// Prefix shared by the namespace URIs of all SBML Level 3 packages
+const LEVEL3_NAMESPACE: &str = "http://www.sbml.org/sbml/level3/version";
+
+/// Metadata of an SBML document gathered without parsing it into a DOM.
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct ModelSummary {
+    /// The SBML level declared on the `sbml` element
+    pub level: Option<u32>,
+    /// The SBML version declared on the `sbml` element
+    pub version: Option<u32>,
+    /// The id of the model, if there is a model with an id
+    pub model_id: Option<String>,
+    /// The name of the model, if there is a model with a name
+    pub model_name: Option<String>,
+    /// Namespace prefixes and URIs declared on the `sbml` element, like
+    /// [`SBMLDocument::namespaces`](crate::SBMLDocument::namespaces). The default
+    /// namespace has an empty prefix.
+    pub namespaces: HashMap<String, String>,
+    /// Names of the SBML Level 3 packages declared on the `sbml` element
+    pub plugins: Vec<String>,
+    /// Number of elements in all `ListOf*` elements, keyed by the list's element
+    /// name. Nested lists of the same kind, such as the `listOfReactants` of all
+    /// reactions, are summed up.
+    pub counts: BTreeMap<String, usize>,
+}
+
+impl ModelSummary {
+    /// Scans an SBML file.
+    ///
+    /// # Arguments
+    /// * `path` - Path to the SBML file
+    ///
+    /// # Returns
+    /// The summary of the file, or an error if it cannot be read or is not well-formed XML
+    pub fn from_file(path: impl AsRef<Path>) -> Result<Self, LibSBMLError> {
+        Self::from_reader(File::open(path)?)
+    }
+
+    /// Scans an SBML document from any source implementing [`Read`].
+    ///
+    /// The source is read once from start to end and is not validated against the
+    /// SBML specification. Scanning stops at the end of the `sbml` element.
+    ///
+    /// # Arguments
+    /// * `reader` - The source to read the SBML XML from
+    ///
+    /// # Returns
+    /// The summary of the document, or an error if reading fails or the source is not
+    /// well-formed XML
+    pub fn from_reader(reader: impl Read) -> Result<Self, LibSBMLError> {
+        let mut reader = Reader::from_reader(BufReader::new(reader));
+        let mut buf = Vec::new();
+        let mut skip_buf = Vec::new();
+        let mut summary = Self::default();
+
+        // One entry per open element, holding the name of the element if it is a list
+        let mut open: Vec<Option<String>> = Vec::new();
+
+        loop {
+            buf.clear();
+            let (element, is_empty) = match reader.read_event_into(&mut buf)? {
+                Event::Start(element) => (element, false),
+                Event::Empty(element) => (element, true),
+                Event::End(_) => {
+                    open.pop();
+                    if open.is_empty() {
+                        break;
+                    }
+                    continue;
+                }
+                Event::Eof => break,
+                _ => continue,
+            };
+
+            let name = element.local_name();
+            let name = name.as_ref();
+            let skipped = matches!(name, b"annotation" | b"notes" | b"math");
+
+            if let Some(Some(list)) = open.last() {
+                if !skipped {
+                    *summary.counts.entry(list.clone()).or_default() += 1;
+                }
+            }
+
+            match name {
+                b"sbml" if open.is_empty() => summary.read_sbml(&element, reader.decoder())?,
+                b"model" if open.len() == 1 => summary.read_model(&element, reader.decoder())?,
+                _ => {}
+            }
+
+            let list = name
+                .starts_with(b"listOf")
+                .then(|| String::from_utf8_lossy(name).into_owned());
+            if let Some(list) = &list {
+                summary.counts.entry(list.clone()).or_default();
+            }
+
+            if !is_empty {
+                if skipped {
+                    reader.read_to_end_into(element.name(), &mut skip_buf)?;
+                    skip_buf.clear();
+                } else {
+                    open.push(list);
+                }
+            }
+        }
+
+        Ok(summary)
+    }
+
+    /// Returns the number of elements in all lists with the given element name.
+    ///
+    /// # Arguments
+    /// * `list` - The element name of the list, e.g. `listOfSpecies`
+    ///
+    /// # Returns
+    /// The number of elements, or zero if there is no such list
+    pub fn count(&self, list: &str) -> usize {
+        self.counts.get(list).copied().unwrap_or_default()
+    }
+
+    /// Reads level, version and namespaces from the `sbml` element.
+    fn read_sbml(&mut self, element: &BytesStart, decoder: Decoder) -> Result<(), LibSBMLError> {
+        for_each_attribute(element, decoder, |key, value| match key {
+            b"level" => self.level = value.trim().parse().ok(),
+            b"version" => self.version = value.trim().parse().ok(),
+            b"xmlns" => {
+                self.namespaces.insert(String::new(), value.into_owned());
+            }
+            _ => {
+                if let Some(prefix) = key.strip_prefix(b"xmlns:") {
+                    if let Some(package) = package_name(&value) {
+                        self.plugins.push(package.to_string());
+                    }
+                    self.namespaces.insert(
+                        String::from_utf8_lossy(prefix).into_owned(),
+                        value.into_owned(),
+                    );
+                }
+            }
+        })
+    }
+
+    /// Reads id and name from the `model` element.
+    fn read_model(&mut self, element: &BytesStart, decoder: Decoder) -> Result<(), LibSBMLError> {
+        for_each_attribute(element, decoder, |key, value| match key {
+            b"id" => self.model_id = Some(value.into_owned()),
+            b"name" => self.model_name = Some(value.into_owned()),
+            _ => {}
+        })
+    }
+}
+
+/// Calls `f` with the key and unescaped value of every attribute of an element.
+fn for_each_attribute(
+    element: &BytesStart,
+    decoder: Decoder,
+    mut f: impl FnMut(&[u8], Cow<str>),
+) -> Result<(), LibSBMLError> {
+    for attribute in element.attributes() {
+        let attribute = attribute.map_err(quick_xml::Error::from)?;
+        let value = attribute.decode_and_unescape_value(decoder)?;
+        f(attribute.key.as_ref(), value);
+    }
+    Ok(())
+}
+
+/// Extracts the package name from an SBML Level 3 package namespace URI.
+///
+/// Package URIs have the form `http://www.sbml.org/sbml/level3/version1/fbc/version2`,
+/// while the core namespace ends in `/core` and yields `None`.
+fn package_name(uri: &str) -> Option<&str> {
+    let mut segments = uri.strip_prefix(LEVEL3_NAMESPACE)?.split('/');
+    let _core_version = segments.next()?;
+    let package = segments.next()?;
+    let package_version = segments.next()?;
+    package_version
+        .starts_with("version")
+        .then_some(package)
+        .filter(|package| *package != "core")
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::prelude::*;
+
+    #[test]
+    fn test_scan_matches_full_parse() {
+        let summary = ModelSummary::from_file("tests/data/example.xml").unwrap();
+        let doc = SBMLReader::from_file("tests/data/example.xml").unwrap();
+        let model = doc.model().unwrap();
+
+        assert_eq!(summary.level, Some(doc.level()));
+        assert_eq!(summary.version, Some(doc.version()));
+        assert_eq!(summary.model_id, Some(model.id()));
+        assert_eq!(summary.namespaces, doc.namespaces());
+        assert_eq!(
+            summary.count("listOfSpecies"),
+            model.list_of_species().len()
+        );
+        assert_eq!(
+            summary.count("listOfReactions"),
+            model.list_of_reactions().len()
+        );
+        assert_eq!(
+            summary.count("listOfParameters"),
+            model.list_of_parameters().len()
+        );
+    }
+
+    #[test]
+    fn test_scan_counts_and_packages() {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("scan");
+        model.set_name("Scan & count");
+        model.create_compartment("cytosol");
+        model.create_species("glucose");
+        model.create_species("g6p");
+        let reaction = model.create_reaction("r1");
+        reaction.create_reactant("glucose", 1.0);
+        reaction.create_product("g6p", 1.0);
+        reaction.create_kinetic_law("glucose * 2");
+        let reaction = model.create_reaction("r2");
+        reaction.create_reactant("g6p", 1.0);
+        model
+            .create_flux_bound("fb", "r1", FluxBoundOperation::LessEqual)
+            .unwrap();
+
+        let xml = doc.to_xml_string();
+        let summary = ModelSummary::from_reader(xml.as_bytes()).unwrap();
+
+        assert_eq!(summary.level, Some(3));
+        assert_eq!(summary.version, Some(2));
+        assert_eq!(summary.model_id.as_deref(), Some("scan"));
+        assert_eq!(summary.model_name.as_deref(), Some("Scan & count"));
+        assert_eq!(summary.plugins, vec!["fbc"]);
+        assert_eq!(summary.count("listOfCompartments"), 1);
+        assert_eq!(summary.count("listOfSpecies"), 2);
+        assert_eq!(summary.count("listOfReactions"), 2);
+        assert_eq!(summary.count("listOfReactants"), 2);
+        assert_eq!(summary.count("listOfProducts"), 1);
+        assert_eq!(summary.count("listOfFluxBounds"), 1);
+        assert_eq!(summary.count("listOfRules"), 0);
+    }
+
+    #[test]
+    fn test_scan_malformed() {
+        let result = ModelSummary::from_reader("<sbml><model></sbml>".as_bytes());
+        assert!(result.is_err());
+    }
+
+    #[test]
+    fn test_package_name() {
+        assert_eq!(
+            package_name("http://www.sbml.org/sbml/level3/version1/fbc/version2"),
+            Some("fbc")
+        );
+        assert_eq!(
+            package_name("http://www.sbml.org/sbml/level3/version2/core"),
+            None
+        );
+        assert_eq!(package_name("http://www.w3.org/1999/xhtml"), None);
+    }
+}
@@ -0,0 +1,590 @@
+// Thin C++ helpers that create, populate or update SBML elements in a single call.
+//
+// Going through the generated bindings, every setter is a separate FFI round trip
+// that converts its arguments on the way. The bulk construction helpers (see
+// src/batch.rs) take a whole batch of elements as packed arrays of numbers and a
+// single string arena, so that building a batch crosses the boundary once. The FBC
+// update helpers (see src/fbc/bulk.rs) likewise take whole arrays of values and
+// cross it once per batch.
+// The serialization helpers (see src/incremental.rs) locate and write single
+// sections of a model, and the accounting helper (see src/memory.rs) measures the
+// object tree below an element in a single walk. The snapshot helpers (see
+// src/snapshot.rs) move math and the attributes common to all elements in and
+// out of snapshots. The writer helper (see src/writer.rs) serializes documents
+// into a reusable buffer.
+//
+// Optional arguments are encoded as follows:
+// - strings: empty means unset
+// - doubles: NaN means unset
+// - booleans: passed as int, negative means unset, zero false, positive true
+
+#pragma once
+
+#include <cmath>
+#include <ostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sbml/SBMLTypes.h"
+#include "sbml/math/MathML.h"
+#include "sbml/xml/XMLOutputStream.h"
+#include "sbml/packages/fbc/common/FbcExtensionTypes.h"
+
+LIBSBML_CPP_NAMESPACE_USE
+
+namespace sbmlrs {
+
+namespace detail {
+
+// Grants access to the item vector of a ListOf, which libSBML does not expose, so
+// that room for a whole batch can be reserved up front
+struct ListOfItems : ListOf {
+  static std::vector<SBase *> ListOf::*items() { return &ListOfItems::mItems; }
+};
+
+// Reserves room for `additional` more items in a list
+inline void reserve(ListOf &list, size_t additional) {
+  std::vector<SBase *> &items = list.*ListOfItems::items();
+  items.reserve(items.size() + additional);
+}
+
+// Reads the strings of a packed batch in order. The strings are stored back to
+// back in `arena`, string i spans the bytes from offsets[i] to offsets[i + 1].
+class StringArena {
+public:
+  StringArena(const char *arena, const size_t *offsets)
+      : arena_(arena), offsets_(offsets) {}
+
+  // Returns the next string. The result is valid until the next call.
+  const std::string &next() {
+    current_.assign(arena_ + offsets_[index_],
+                    offsets_[index_ + 1] - offsets_[index_]);
+    ++index_;
+    return current_;
+  }
+
+private:
+  const char *arena_;
+  const size_t *offsets_;
+  size_t index_ = 0;
+  std::string current_;
+};
+
+} // namespace detail
+
+// Creates `count` species with default values from a packed batch (see
+// src/batch.rs) and stores their addresses in `created`. Every species takes four
+// strings (id, name, compartment, units), two values (initial amount, initial
+// concentration) and three flags (boundary condition, constant, has only
+// substance units).
+inline void createSpeciesBatch(Model &model, size_t count, const char *arena,
+                               const size_t *offsets, const double *values,
+                               const int *flags, size_t *created) {
+  detail::reserve(*model.getListOfSpecies(), count);
+  detail::StringArena strings(arena, offsets);
+
+  for (size_t i = 0; i < count; ++i) {
+    Species *species = model.createSpecies();
+    species->initDefaults();
+    species->setId(strings.next());
+
+    const std::string &name = strings.next();
+    if (!name.empty())
+      species->setName(name);
+    const std::string &compartment = strings.next();
+    if (!compartment.empty())
+      species->setCompartment(compartment);
+    const std::string &units = strings.next();
+    if (!units.empty())
+      species->setUnits(units);
+
+    if (!std::isnan(values[2 * i]))
+      species->setInitialAmount(values[2 * i]);
+    if (!std::isnan(values[2 * i + 1]))
+      species->setInitialConcentration(values[2 * i + 1]);
+    if (flags[3 * i] >= 0)
+      species->setBoundaryCondition(flags[3 * i] > 0);
+    if (flags[3 * i + 1] >= 0)
+      species->setConstant(flags[3 * i + 1] > 0);
+    if (flags[3 * i + 2] >= 0)
+      species->setHasOnlySubstanceUnits(flags[3 * i + 2] > 0);
+
+    created[i] = reinterpret_cast<size_t>(species);
+  }
+}
+
+// Creates `count` parameters with default values from a packed batch (see
+// src/batch.rs) and stores their addresses in `created`. Every parameter takes
+// three strings (id, name, units), one value and one flag (constant).
+inline void createParametersBatch(Model &model, size_t count, const char *arena,
+                                  const size_t *offsets, const double *values,
+                                  const int *flags, size_t *created) {
+  detail::reserve(*model.getListOfParameters(), count);
+  detail::StringArena strings(arena, offsets);
+
+  for (size_t i = 0; i < count; ++i) {
+    Parameter *parameter = model.createParameter();
+    parameter->initDefaults();
+    parameter->setId(strings.next());
+
+    const std::string &name = strings.next();
+    if (!name.empty())
+      parameter->setName(name);
+    const std::string &units = strings.next();
+    if (!units.empty())
+      parameter->setUnits(units);
+
+    if (!std::isnan(values[i]))
+      parameter->setValue(values[i]);
+    if (flags[i] >= 0)
+      parameter->setConstant(flags[i] > 0);
+
+    created[i] = reinterpret_cast<size_t>(parameter);
+  }
+}
+
+// Creates `count` reactions from a packed batch (see src/batch.rs), including their
+// species references and kinetic laws, and stores their addresses in `created`.
+// Every reaction takes three strings (id, name, kinetic law formula), followed by
+// the species of its reactants, products and modifiers, three counts (reactants,
+// products, modifiers) and two flags (reversible, has a kinetic law). The
+// stoichiometries of all reactants and products are read from `stoichiometries`
+// in the same order as their species.
+inline void createReactionsBatch(Model &model, size_t count, const char *arena,
+                                 const size_t *offsets, const size_t *counts,
+                                 const double *stoichiometries, const int *flags,
+                                 size_t *created) {
+  detail::reserve(*model.getListOfReactions(), count);
+  detail::StringArena strings(arena, offsets);
+
+  for (size_t i = 0; i < count; ++i) {
+    Reaction *reaction = model.createReaction();
+    reaction->setId(strings.next());
+
+    const std::string &name = strings.next();
+    if (!name.empty())
+      reaction->setName(name);
+    if (flags[2 * i] >= 0)
+      reaction->setReversible(flags[2 * i] > 0);
+    const std::string &formula = strings.next();
+    if (flags[2 * i + 1] > 0)
+      reaction->createKineticLaw()->setFormula(formula);
+
+    const size_t reactants = counts[3 * i];
+    const size_t products = counts[3 * i + 1];
+    const size_t modifiers = counts[3 * i + 2];
+    detail::reserve(*reaction->getListOfReactants(), reactants);
+    detail::reserve(*reaction->getListOfProducts(), products);
+    detail::reserve(*reaction->getListOfModifiers(), modifiers);
+
+    for (size_t j = 0; j < reactants + products; ++j) {
+      SpeciesReference *reference =
+          j < reactants ? reaction->createReactant() : reaction->createProduct();
+      reference->initDefaults();
+      reference->setSpecies(strings.next());
+      reference->setStoichiometry(*stoichiometries++);
+    }
+    for (size_t j = 0; j < modifiers; ++j)
+      reaction->createModifier()->setSpecies(strings.next());
+
+    created[i] = reinterpret_cast<size_t>(reaction);
+  }
+}
+
+namespace detail {
+
+// Sets the value of every target, restoring the previous values in reverse order
+// if libSBML rejects one of them. Returns `targets.size()` if all values were set,
+// otherwise the position of the rejected value.
+template <typename T>
+size_t setAllOrNothing(const std::vector<T *> &targets, const double *values,
+                       bool (T::*isSet)() const, double (T::*get)() const,
+                       int (T::*set)(double), int (T::*unset)()) {
+  std::vector<std::pair<bool, double>> previous;
+  previous.reserve(targets.size());
+  for (size_t i = 0; i < targets.size(); ++i) {
+    T *target = targets[i];
+    previous.emplace_back((target->*isSet)(), (target->*get)());
+    if ((target->*set)(values[i]) == LIBSBML_OPERATION_SUCCESS)
+      continue;
+
+    for (size_t j = i; j-- > 0;) {
+      if (previous[j].first)
+        (targets[j]->*set)(previous[j].second);
+      else
+        (targets[j]->*unset)();
+    }
+    return i;
+  }
+  return targets.size();
+}
+
+} // namespace detail
+
+// Sets the values of the flux bounds at the given positions of the model's FBC
+// plugin. Positions without a flux bound are skipped. Returns the number of values
+// that were set.
+//
+// With `atomic`, either all values are set or none: the update stops at the first
+// position without a flux bound or value rejected by libSBML, restores the values
+// written so far and returns that position.
+inline size_t setFluxBoundValues(Model &model, const unsigned int *positions,
+                                 const double *values, size_t count,
+                                 bool atomic) {
+  FbcModelPlugin *plugin =
+      dynamic_cast<FbcModelPlugin *>(model.getPlugin("fbc"));
+  if (plugin == nullptr)
+    return 0;
+
+  if (atomic) {
+    std::vector<FluxBound *> bounds(count);
+    for (size_t i = 0; i < count; ++i) {
+      bounds[i] = plugin->getFluxBound(positions[i]);
+      if (bounds[i] == nullptr)
+        return i;
+    }
+    return detail::setAllOrNothing(bounds, values, &FluxBound::isSetValue,
+                                   &FluxBound::getValue, &FluxBound::setValue,
+                                   &FluxBound::unsetValue);
+  }
+
+  size_t applied = 0;
+  for (size_t i = 0; i < count; ++i) {
+    FluxBound *bound = plugin->getFluxBound(positions[i]);
+    if (bound != nullptr &&
+        bound->setValue(values[i]) == LIBSBML_OPERATION_SUCCESS)
+      ++applied;
+  }
+
+  return applied;
+}
+
+// Sets the coefficients of flux objectives, each addressed by the position of its
+// objective in the model's FBC plugin and its position within that objective.
+// Positions without a flux objective are skipped. Returns the number of
+// coefficients that were set. `atomic` works as for setFluxBoundValues.
+inline size_t setFluxObjectiveCoefficients(Model &model,
+                                           const unsigned int *objectives,
+                                           const unsigned int *fluxObjectives,
+                                           const double *values, size_t count,
+                                           bool atomic) {
+  FbcModelPlugin *plugin =
+      dynamic_cast<FbcModelPlugin *>(model.getPlugin("fbc"));
+  if (plugin == nullptr)
+    return 0;
+
+  auto resolve = [&](size_t i) -> FluxObjective * {
+    Objective *objective = plugin->getObjective(objectives[i]);
+    return objective != nullptr ? objective->getFluxObjective(fluxObjectives[i])
+                                : nullptr;
+  };
+
+  if (atomic) {
+    std::vector<FluxObjective *> targets(count);
+    for (size_t i = 0; i < count; ++i) {
+      targets[i] = resolve(i);
+      if (targets[i] == nullptr)
+        return i;
+    }
+    return detail::setAllOrNothing(
+        targets, values, &FluxObjective::isSetCoefficient,
+        &FluxObjective::getCoefficient, &FluxObjective::setCoefficient,
+        &FluxObjective::unsetCoefficient);
+  }
+
+  size_t applied = 0;
+  for (size_t i = 0; i < count; ++i) {
+    FluxObjective *fluxObjective = resolve(i);
+    if (fluxObjective != nullptr &&
+        fluxObjective->setCoefficient(values[i]) == LIBSBML_OPERATION_SUCCESS)
+      ++applied;
+  }
+
+  return applied;
+}
+
+// Returns the attribute name of the namespace declaration at the given index of
+// an XML element, i.e. "xmlns" for the default namespace and "xmlns:prefix"
+// otherwise
+inline std::string namespaceAttrName(const XMLToken &token, int index) {
+  std::string prefix = token.getNamespacePrefix(index);
+  if (prefix.empty())
+    return "xmlns";
+  return "xmlns:" + prefix;
+}
+
+// Returns the URI of the namespace declaration at the given index of an XML
+// element
+inline std::string namespaceURI(const XMLToken &token, int index) {
+  return token.getNamespaceURI(index);
+}
+
+// Returns the element name of an element including its namespace prefix, as it
+// appears in the serialized document
+inline std::string qualifiedName(const SBase &element) {
+  std::string prefix = element.getPrefix();
+  if (prefix.empty())
+    return element.getElementName();
+  return prefix + ":" + element.getElementName();
+}
+
+// Returns all ListOf* children of a model that can be serialized on their own
+inline std::vector<const ListOf *> modelSections(const Model &model) {
+  std::vector<const ListOf *> sections = {
+      model.getListOfFunctionDefinitions(), model.getListOfUnitDefinitions(),
+      model.getListOfCompartmentTypes(),    model.getListOfSpeciesTypes(),
+      model.getListOfCompartments(),        model.getListOfSpecies(),
+      model.getListOfParameters(),          model.getListOfInitialAssignments(),
+      model.getListOfRules(),               model.getListOfConstraints(),
+      model.getListOfReactions(),           model.getListOfEvents()};
+
+  const FbcModelPlugin *plugin =
+      dynamic_cast<const FbcModelPlugin *>(model.getPlugin("fbc"));
+  if (plugin != nullptr) {
+    sections.push_back(plugin->getListOfFluxBounds());
+    sections.push_back(plugin->getListOfObjectives());
+    sections.push_back(plugin->getListOfGeneProducts());
+  }
+
+  return sections;
+}
+
+// Serializes the ListOf* child of a model with the given qualified name exactly as
+// a full document write does, starting with the line break and indentation in
+// front of its start tag. Returns an empty string if there is no such list or it is
+// empty, since empty lists are not written.
+inline std::string writeModelSection(const Model &model, const std::string &name,
+                                     unsigned int indent) {
+  for (const ListOf *section : modelSections(model)) {
+    if (section->size() == 0 || qualifiedName(*section) != name)
+      continue;
+
+    std::ostringstream os;
+    XMLOutputStream stream(os, "UTF-8", false);
+    for (unsigned int i = 0; i < indent; ++i)
+      stream.upIndent();
+    section->write(stream);
+    return os.str();
+  }
+
+  return "";
+}
+
+// Returns the number of elements in the object tree of an element, including the
+// element itself, list elements and the elements of package plugins. The number of
+// annotated elements and the total length of their serialized annotations are
+// stored in `annotations` and `annotationChars`.
+inline size_t countElements(const SBase &root, size_t *annotations,
+                            size_t *annotationChars) {
+  *annotations = 0;
+  *annotationChars = 0;
+  auto account = [&](const SBase &element) {
+    if (!element.isSetAnnotation())
+      return;
+    ++*annotations;
+    *annotationChars += element.getAnnotationString().size();
+  };
+
+  // getAllElements does not modify the tree, but is not declared const
+  List *elements = const_cast<SBase &>(root).getAllElements();
+  size_t count = 1;
+  account(root);
+  if (elements != nullptr) {
+    count += elements->getSize();
+    for (unsigned int i = 0; i < elements->getSize(); ++i)
+      account(*static_cast<const SBase *>(elements->get(i)));
+    delete elements;
+  }
+
+  return count;
+}
+
+// Serializes the math of a kinetic law or rule as MathML. Returns an empty string
+// for other elements and for elements without math.
+inline std::string mathMLOf(const SBase &element) {
+  const ASTNode *math = nullptr;
+  if (const KineticLaw *kineticLaw = dynamic_cast<const KineticLaw *>(&element))
+    math = kineticLaw->getMath();
+  else if (const Rule *rule = dynamic_cast<const Rule *>(&element))
+    math = rule->getMath();
+  if (math == nullptr)
+    return "";
+
+  std::ostringstream os;
+  XMLOutputStream stream(os, "UTF-8", false);
+  writeMathML(math, stream, element.getSBMLNamespaces());
+  return os.str();
+}
+
+// Replaces the math of a kinetic law or rule by the given MathML. Returns whether
+// the MathML could be parsed and set.
+inline bool setMathML(SBase &element, const std::string &mathML) {
+  ASTNode *math = readMathMLFromString(mathML.c_str());
+  if (math == nullptr)
+    return false;
+
+  int result = LIBSBML_INVALID_OBJECT;
+  if (KineticLaw *kineticLaw = dynamic_cast<KineticLaw *>(&element))
+    result = kineticLaw->setMath(math);
+  else if (Rule *rule = dynamic_cast<Rule *>(&element))
+    result = rule->setMath(math);
+  delete math;
+
+  return result == LIBSBML_OPERATION_SUCCESS;
+}
+
+// Returns the meta id of an element, or an empty string if it has none
+inline std::string metaIdOf(const SBase &element) {
+  return element.getMetaId();
+}
+
+// Returns the notes of an element as XML, or an empty string if it has none
+inline std::string notesOf(const SBase &element) {
+  return element.isSetNotes() ? element.getNotesString() : "";
+}
+
+// Returns the annotation of an element as XML, or an empty string if it has none
+inline std::string annotationOf(const SBase &element) {
+  return element.isSetAnnotation() ? element.getAnnotationString() : "";
+}
+
+// Sets the meta id, SBO term, notes and annotation of an element, skipping empty
+// strings and negative SBO terms. Returns whether all given values were set.
+inline bool setSBaseAttributes(SBase &element, const std::string &metaId,
+                               int sboTerm, const std::string &notes,
+                               const std::string &annotation) {
+  bool success = true;
+  if (!metaId.empty())
+    success &= element.setMetaId(metaId) == LIBSBML_OPERATION_SUCCESS;
+  if (sboTerm >= 0)
+    success &= element.setSBOTerm(sboTerm) == LIBSBML_OPERATION_SUCCESS;
+  if (!notes.empty())
+    success &= element.setNotes(notes) == LIBSBML_OPERATION_SUCCESS;
+  if (!annotation.empty())
+    success &= element.setAnnotation(annotation) == LIBSBML_OPERATION_SUCCESS;
+  return success;
+}
+
+// Returns a description of the first part of a document that binary snapshots
+// (see src/snapshot.rs) cannot represent, or an empty string if there is none.
+// Attributes that snapshots do not store are caught by the round trip check of
+// the encoder instead.
+inline std::string snapshotUnsupportedContent(const SBMLDocument &document) {
+  if (document.isSetNotes() || document.isSetAnnotation())
+    return "notes or annotation of the document";
+  for (unsigned int i = 0; i < document.getNumPlugins(); ++i) {
+    const std::string package = document.getPlugin(i)->getPackageName();
+    if (package != "fbc")
+      return "package '" + package + "'";
+  }
+
+  // getAllElements does not modify the tree, but is not declared const
+  List *elements = const_cast<SBMLDocument &>(document).getAllElements();
+  if (elements == nullptr)
+    return "";
+
+  std::string unsupported;
+  for (unsigned int i = 0; i < elements->getSize() && unsupported.empty(); ++i) {
+    const SBase &element = *static_cast<const SBase *>(elements->get(i));
+    const int code = element.getTypeCode();
+    const std::string package = element.getPackageName();
+
+    bool supported = false;
+    if (package == "core") {
+      switch (code) {
+      case SBML_MODEL:
+      case SBML_UNIT_DEFINITION:
+      case SBML_UNIT:
+      case SBML_COMPARTMENT:
+      case SBML_SPECIES:
+      case SBML_PARAMETER:
+      case SBML_LOCAL_PARAMETER:
+      case SBML_REACTION:
+      case SBML_SPECIES_REFERENCE:
+      case SBML_MODIFIER_SPECIES_REFERENCE:
+      case SBML_KINETIC_LAW:
+      case SBML_RATE_RULE:
+      case SBML_ASSIGNMENT_RULE:
+        supported = true;
+        break;
+      case SBML_LIST_OF:
+        // Lists are rebuilt from their items, their own attributes are lost
+        supported = !element.isSetNotes() && !element.isSetAnnotation() &&
+                    !element.isSetMetaId() && !element.isSetSBOTerm();
+        break;
+      default:
+        break;
+      }
+    } else if (package == "fbc") {
+      supported = code == SBML_FBC_OBJECTIVE || code == SBML_FBC_FLUXOBJECTIVE ||
+                  code == SBML_FBC_FLUXBOUND || code == SBML_LIST_OF;
+    }
+    if (!supported) {
+      unsupported = "element '" + element.getElementName() + "'";
+      continue;
+    }
+
+    if (code == SBML_REACTION && package == "core") {
+      const FbcReactionPlugin *plugin = dynamic_cast<const FbcReactionPlugin *>(
+          element.getPlugin("fbc"));
+      if (plugin != nullptr &&
+          (plugin->isSetLowerFluxBound() || plugin->isSetUpperFluxBound()))
+        unsupported = "flux bounds of reaction '" + element.getId() + "'";
+    }
+  }
+  delete elements;
+
+  return unsupported;
+}
+
+namespace detail {
+
+// Stream buffer that appends everything written to it to a string
+class StringAppendBuf : public std::streambuf {
+public:
+  explicit StringAppendBuf(std::string &out) : out_(out) {}
+
+protected:
+  int_type overflow(int_type c) override {
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+      out_.push_back(traits_type::to_char_type(c));
+    return traits_type::not_eof(c);
+  }
+
+  std::streamsize xsputn(const char *s, std::streamsize n) override {
+    out_.append(s, static_cast<size_t>(n));
+    return n;
+  }
+
+private:
+  std::string &out_;
+};
+
+} // namespace detail
+
+// Appends an error to the error log of a document. libSBML takes the severity and
+// category of known error ids from its error tables, so this reproduces errors
+// such as running out of memory exactly as libSBML reports them.
+inline void logError(SBMLDocument &document, unsigned int errorId,
+                     unsigned int severity, unsigned int category) {
+  document.getErrorLog()->logError(errorId, document.getLevel(),
+                                   document.getVersion(), "", 0, 0, severity,
+                                   category);
+}
+
+// Serializes a document into `out`, replacing its content. The output is streamed
+// into the string directly, without the intermediate copy of
+// writeSBMLToStdString, and the capacity of `out` is kept for the next document.
+// Returns whether the document was written.
+inline bool writeSBMLInto(SBMLWriter &writer, const SBMLDocument *document,
+                          std::string &out) {
+  out.clear();
+  detail::StringAppendBuf buffer(out);
+  std::ostream stream(&buffer);
+  return writer.writeSBML(document, stream);
+}
+
+} // namespace sbmlrs
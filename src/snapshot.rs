@@ -0,0 +1,992 @@
+//! Compact binary snapshots of parsed SBML documents.
+//!
+//! Parsing a large SBML file means a full XML parse by libSBML. Services that load
+//! the same files over and over can instead store a snapshot of each parsed document
+//! and rebuild the document from it, which skips the XML layer entirely.
+//!
+//! A snapshot starts with a fixed header, followed by the document's components in
+//! model order:
+//!
+//! | Offset | Size | Content                                   |
+//! |--------|------|-------------------------------------------|
+//! | 0      | 8    | Magic bytes `SBMLSNAP`                    |
+//! | 8      | 4    | Format version, little endian             |
+//! | 12     | 8    | Hash of the XML source, see [`source_hash`] |
+//! | 20     | 8    | Length of the payload in bytes            |
+//!
+//! Since the payload is decoded directly from a byte slice, snapshots can be read
+//! from a memory-mapped file without copying them first.
+//!
+//! Snapshots cover the components wrapped by this crate: unit definitions,
+//! compartments, species, parameters, reactions with their species references,
+//! kinetic laws and local parameters, rate and assignment rules, as well as FBC
+//! objectives and flux bounds. Math is stored as MathML, and the meta ids, SBO
+//! terms, notes and annotations of all these components are kept. Documents with
+//! other content, such as events, function definitions, initial assignments,
+//! algebraic rules or FBC flux bounds on reactions, cannot be snapshotted, and
+//! encoding them fails with [`LibSBMLError::Unsupported`]. The error log of the
+//! original parse is not included.
+//!
+//! A snapshot whose format version or source hash does not match is considered
+//! stale. [`SBMLReader::from_file_with_snapshot`](crate::reader::SBMLReader::from_file_with_snapshot)
+//! falls back to parsing the XML in that case and refreshes the snapshot.
+
+use std::{pin::Pin, str::FromStr};
+
+use autocxx::c_int;
+use cxx::let_cxx_string;
+
+use crate::{
+    errors::LibSBMLError,
+    fbc::{FluxBoundOperation, ObjectiveType},
+    model::Model,
+    packages::{Package, PackageSpec},
+    plugin::get_plugin,
+    sbmlcxx,
+    sbmldoc::SBMLDocument,
+    traits::inner::Inner,
+    unit::UnitKind,
+};
+
+/// Magic bytes at the start of every snapshot
+const MAGIC: &[u8; 8] = b"SBMLSNAP";
+
+/// Version of the snapshot format, bumped whenever the layout changes
+const FORMAT_VERSION: u32 = 2;
+
+/// Size of the header preceding the payload
+const HEADER_LEN: usize = 28;
+
+/// Computes the hash of an XML source that snapshots are keyed by.
+///
+/// This is the 64-bit FNV-1a hash of the raw bytes, which is fast to compute and
+/// stable across platforms and releases.
+pub fn source_hash(source: &[u8]) -> u64 {
+    source.iter().fold(0xcbf2_9ce4_8422_2325, |hash, &byte| {
+        (hash ^ u64::from(byte)).wrapping_mul(0x0100_0000_01b3)
+    })
+}
+
+/// Encodes a document into a snapshot keyed by the given source hash.
+///
+/// Returns [`LibSBMLError::Unsupported`] if the document has content that snapshots
+/// cannot represent. Besides a scan for unsupported elements, the encoded snapshot
+/// is decoded again and the rebuilt document compared with the original, which
+/// catches attributes that are not part of the format.
+pub(crate) fn encode(document: &SBMLDocument, source_hash: u64) -> Result<Vec<u8>, LibSBMLError> {
+    if let Some(native) = document.inner().borrow().as_ref() {
+        let content = sbmlcxx::sbmlrs::snapshotUnsupportedContent(native);
+        if !content.is_empty() {
+            return Err(unsupported(&content.to_string_lossy()));
+        }
+    }
+
+    let mut payload = Encoder::default();
+    payload.u32(document.level());
+    payload.u32(document.version());
+
+    let mut namespaces: Vec<(String, String)> = document.namespaces().into_iter().collect();
+    namespaces.sort_unstable();
+    payload.len(namespaces.len());
+    for (prefix, uri) in &namespaces {
+        payload.str(prefix);
+        payload.str(uri);
+    }
+
+    match document.model() {
+        Some(model) => {
+            payload.bool(true);
+            encode_model(&mut payload, &model);
+        }
+        None => payload.bool(false),
+    }
+
+    let mut bytes = Vec::with_capacity(HEADER_LEN + payload.buf.len());
+    bytes.extend_from_slice(MAGIC);
+    bytes.extend_from_slice(&FORMAT_VERSION.to_le_bytes());
+    bytes.extend_from_slice(&source_hash.to_le_bytes());
+    bytes.extend_from_slice(&(payload.buf.len() as u64).to_le_bytes());
+    bytes.extend_from_slice(&payload.buf);
+
+    let restored = decode(&bytes, source_hash)?.expect("snapshot matches its own source hash");
+    if restored.to_xml_string() != document.to_xml_string() {
+        return Err(unsupported("attributes outside of the snapshot format"));
+    }
+
+    Ok(bytes)
+}
+
+/// Rebuilds a document from a snapshot.
+///
+/// Returns `None` if the snapshot was written by another format version or for a
+/// different source, and an error if the bytes are not a valid snapshot.
+pub(crate) fn decode(bytes: &[u8], source_hash: u64) -> Result<Option<SBMLDocument>, LibSBMLError> {
+    let mut header = Decoder::new(bytes);
+    if header.take(MAGIC.len())? != MAGIC {
+        return Err(invalid("missing magic bytes"));
+    }
+    if header.u32()? != FORMAT_VERSION || header.u64()? != source_hash {
+        return Ok(None);
+    }
+    let payload_len = usize::try_from(header.u64()?).map_err(|_| invalid("payload too large"))?;
+    let mut payload = Decoder::new(header.take(payload_len)?);
+
+    let level = payload.u32()?;
+    let version = payload.u32()?;
+    let n_namespaces = payload.len()?;
+    let mut namespaces = Vec::with_capacity(n_namespaces);
+    for _ in 0..n_namespaces {
+        namespaces.push((payload.str()?, payload.str()?));
+    }
+
+    let packages = namespaces
+        .iter()
+        .find_map(|(_, uri)| fbc_version(uri))
+        .map(|version| vec![PackageSpec::from(Package::Fbc(version))]);
+    let document = SBMLDocument::new(level, version, packages);
+
+    let declared = document.namespaces();
+    for (prefix, uri) in namespaces {
+        if !declared.contains_key(prefix) {
+            document.add_namespace(prefix, uri);
+        }
+    }
+
+    if payload.bool()? {
+        let model = document.create_model("");
+        decode_model(&mut payload, &model)?;
+    }
+
+    Ok(Some(document))
+}
+
+/// Extracts the package version from an FBC namespace URI.
+fn fbc_version(uri: &str) -> Option<u32> {
+    let (_, version) = uri.split_once("/fbc/version")?;
+    version.parse().ok()
+}
+
+fn encode_model(enc: &mut Encoder, model: &Model<'_>) {
+    model.with_id(|id| enc.str(id));
+    enc.str(&model.name());
+    encode_sbase(enc, model);
+
+    let unit_definitions = model.list_of_unit_definitions();
+    enc.len(unit_definitions.len());
+    for unit_definition in &unit_definitions {
+        unit_definition.with_id(|id| enc.str(id));
+        unit_definition.with_name(|name| enc.opt_str(name));
+        encode_sbase(enc, &**unit_definition);
+
+        let units = unit_definition.units();
+        enc.len(units.len());
+        for unit in &units {
+            enc.str(&unit.kind().to_string());
+            enc.i32(unit.exponent());
+            enc.f64(unit.multiplier());
+            enc.i32(unit.scale());
+            enc.f64(unit.offset());
+            encode_sbase(enc, &**unit);
+        }
+    }
+
+    let compartments = model.list_of_compartments();
+    enc.len(compartments.len());
+    for compartment in &compartments {
+        compartment.with_id(|id| enc.str(id));
+        compartment.with_name(|name| enc.opt_str(name));
+        enc.opt_u32(compartment.spatial_dimensions());
+        compartment.with_unit(|unit| enc.opt_str(unit));
+        enc.opt_f64(compartment.size());
+        enc.opt_bool(compartment.constant());
+        compartment.with_outside(|outside| enc.opt_str(outside));
+        encode_sbase(enc, &**compartment);
+    }
+
+    let species = model.list_of_species();
+    enc.len(species.len());
+    for species in &species {
+        species.with_id(|id| enc.str(id));
+        species.with_name(|name| enc.opt_str(name));
+        species.with_compartment(|compartment| enc.opt_str(compartment));
+        enc.opt_f64(species.initial_amount());
+        enc.opt_f64(species.initial_concentration());
+        species.with_units(|units| enc.opt_str(units));
+        enc.opt_bool(species.boundary_condition());
+        enc.bool(species.constant());
+        enc.opt_bool(species.has_only_substance_units());
+        encode_sbase(enc, &**species);
+    }
+
+    let parameters = model.list_of_parameters();
+    enc.len(parameters.len());
+    for parameter in &parameters {
+        parameter.with_id(|id| enc.str(id));
+        parameter.with_name(|name| enc.opt_str(name));
+        enc.opt_f64(parameter.value());
+        parameter.with_units(|units| enc.opt_str(units));
+        enc.opt_bool(parameter.constant());
+        encode_sbase(enc, &**parameter);
+    }
+
+    let reactions = model.list_of_reactions();
+    enc.len(reactions.len());
+    for reaction in &reactions {
+        reaction.with_id(|id| enc.str(id));
+        reaction.with_name(|name| enc.opt_str(name));
+        enc.opt_bool(reaction.reversible());
+        reaction.with_compartment(|compartment| enc.opt_str(compartment));
+        encode_sbase(enc, &**reaction);
+
+        for references in [reaction.reactants(), reaction.products()] {
+            let references = references.borrow();
+            enc.len(references.len());
+            for reference in references.iter() {
+                reference.with_species(|species| enc.str(species));
+                enc.f64(reference.stoichiometry());
+                let constant_set = reference.inner().borrow().isSetConstant();
+                enc.opt_bool(constant_set.then(|| reference.constant()));
+                encode_sbase(enc, &**reference);
+            }
+        }
+
+        let modifiers = reaction.modifiers().borrow();
+        enc.len(modifiers.len());
+        for modifier in modifiers.iter() {
+            modifier.with_species(|species| enc.str(species));
+            encode_sbase(enc, &**modifier);
+        }
+
+        match reaction.kinetic_law() {
+            Some(kinetic_law) => {
+                enc.bool(true);
+                encode_math(enc, &*kinetic_law);
+                encode_sbase(enc, &*kinetic_law);
+
+                let local_parameters = kinetic_law.local_parameters();
+                enc.len(local_parameters.len());
+                for local_parameter in &local_parameters {
+                    local_parameter.with_id(|id| enc.str(id));
+                    local_parameter.with_name(|name| enc.str(name));
+                    enc.opt_f64(local_parameter.value());
+                    local_parameter.with_units(|units| enc.opt_str(units));
+                    enc.opt_bool(local_parameter.constant());
+                    encode_sbase(enc, &**local_parameter);
+                }
+            }
+            None => enc.bool(false),
+        }
+    }
+
+    for rules in [model.list_of_rate_rules(), model.list_of_assignment_rules()] {
+        enc.len(rules.len());
+        for rule in &rules {
+            rule.with_variable(|variable| enc.str(variable));
+            encode_math(enc, &**rule);
+            encode_sbase(enc, &**rule);
+        }
+    }
+
+    let active_objective =
+        get_plugin::<sbmlcxx::FbcModelPlugin, Model<'_>, sbmlcxx::Model>(model, "fbc")
+            .map(|plugin| plugin.getActiveObjectiveId().to_string_lossy().into_owned())
+            .unwrap_or_default();
+    enc.str(&active_objective);
+
+    let objectives = model.list_of_objectives();
+    enc.len(objectives.len());
+    for objective in &objectives {
+        objective.with_id(|id| enc.str(id));
+        enc.u8(objective_type_code(objective.obj_type()));
+        encode_sbase(enc, &**objective);
+
+        let flux_objectives = objective.flux_objectives();
+        enc.len(flux_objectives.len());
+        for flux_objective in &flux_objectives {
+            flux_objective.with_id(|id| enc.opt_str(id));
+            flux_objective.with_reaction(|reaction| enc.opt_str(reaction));
+            enc.opt_f64(flux_objective.coefficient());
+            encode_sbase(enc, &**flux_objective);
+        }
+    }
+
+    let flux_bounds = model.list_of_flux_bounds();
+    enc.len(flux_bounds.len());
+    for flux_bound in &flux_bounds {
+        flux_bound.with_id(|id| enc.opt_str(id));
+        flux_bound.with_reaction(|reaction| enc.opt_str(reaction));
+        enc.u8(flux_bound_operation_code(flux_bound.operation()));
+        enc.opt_f64(flux_bound.value());
+        encode_sbase(enc, &**flux_bound);
+    }
+}
+
+fn decode_model(dec: &mut Decoder<'_>, model: &Model<'_>) -> Result<(), LibSBMLError> {
+    model.set_id(dec.str()?);
+    model.set_name(dec.str()?);
+    decode_sbase(dec, model)?;
+
+    for _ in 0..dec.len()? {
+        let id = dec.str()?;
+        let name = dec.opt_str()?;
+        let unit_definition = model.create_unit_definition(id, name.unwrap_or_default());
+        decode_sbase(dec, &*unit_definition)?;
+
+        for _ in 0..dec.len()? {
+            let kind = dec.str()?;
+            let kind = UnitKind::from_str(kind)
+                .map_err(|_| invalid(&format!("unknown unit kind '{kind}'")))?;
+            let unit = unit_definition.create_unit(kind);
+            unit.set_exponent(dec.i32()?);
+            unit.set_multiplier(dec.f64()?);
+            unit.set_scale(dec.i32()?);
+            unit.set_offset(dec.f64()?);
+            decode_sbase(dec, &*unit)?;
+        }
+    }
+
+    for _ in 0..dec.len()? {
+        let compartment = model.create_compartment(dec.str()?);
+        if let Some(name) = dec.opt_str()? {
+            compartment.set_name(name);
+        }
+        if let Some(spatial_dimensions) = dec.opt_u32()? {
+            compartment.set_spatial_dimensions(spatial_dimensions);
+        }
+        if let Some(unit) = dec.opt_str()? {
+            compartment.set_unit(unit);
+        }
+        if let Some(size) = dec.opt_f64()? {
+            compartment.set_size(size);
+        }
+        if let Some(constant) = dec.opt_bool()? {
+            compartment.set_constant(constant);
+        }
+        if let Some(outside) = dec.opt_str()? {
+            compartment.set_outside(outside);
+        }
+        decode_sbase(dec, &*compartment)?;
+    }
+
+    for _ in 0..dec.len()? {
+        let species = model.create_species(dec.str()?);
+        if let Some(name) = dec.opt_str()? {
+            species.set_name(name);
+        }
+        if let Some(compartment) = dec.opt_str()? {
+            species.set_compartment(compartment);
+        }
+        if let Some(initial_amount) = dec.opt_f64()? {
+            species.set_initial_amount(initial_amount);
+        }
+        if let Some(initial_concentration) = dec.opt_f64()? {
+            species.set_initial_concentration(initial_concentration);
+        }
+        if let Some(units) = dec.opt_str()? {
+            species.set_units(units);
+        }
+        if let Some(boundary_condition) = dec.opt_bool()? {
+            species.set_boundary_condition(boundary_condition);
+        }
+        species.set_constant(dec.bool()?);
+        if let Some(has_only_substance_units) = dec.opt_bool()? {
+            species.set_has_only_substance_units(has_only_substance_units);
+        }
+        decode_sbase(dec, &*species)?;
+    }
+
+    for _ in 0..dec.len()? {
+        let parameter = model.create_parameter(dec.str()?);
+        if let Some(name) = dec.opt_str()? {
+            parameter.set_name(name);
+        }
+        if let Some(value) = dec.opt_f64()? {
+            parameter.set_value(value);
+        }
+        if let Some(units) = dec.opt_str()? {
+            parameter.set_units(units);
+        }
+        if let Some(constant) = dec.opt_bool()? {
+            parameter.set_constant(constant);
+        }
+        decode_sbase(dec, &*parameter)?;
+    }
+
+    for _ in 0..dec.len()? {
+        let reaction = model.create_reaction(dec.str()?);
+        if let Some(name) = dec.opt_str()? {
+            reaction.set_name(name);
+        }
+        if let Some(reversible) = dec.opt_bool()? {
+            reaction.set_reversible(reversible);
+        }
+        if let Some(compartment) = dec.opt_str()? {
+            reaction.set_compartment(compartment);
+        }
+        decode_sbase(dec, &*reaction)?;
+
+        for _ in 0..dec.len()? {
+            let reactant = reaction.create_reactant(dec.str()?, dec.f64()?);
+            match dec.opt_bool()? {
+                Some(constant) => reactant.set_constant(constant),
+                None => {
+                    reactant.inner().borrow_mut().as_mut().unsetConstant();
+                }
+            }
+            decode_sbase(dec, &*reactant)?;
+        }
+        for _ in 0..dec.len()? {
+            let product = reaction.create_product(dec.str()?, dec.f64()?);
+            match dec.opt_bool()? {
+                Some(constant) => product.set_constant(constant),
+                None => {
+                    product.inner().borrow_mut().as_mut().unsetConstant();
+                }
+            }
+            decode_sbase(dec, &*product)?;
+        }
+        for _ in 0..dec.len()? {
+            let modifier = reaction.create_modifier(dec.str()?);
+            decode_sbase(dec, &*modifier)?;
+        }
+
+        if dec.bool()? {
+            let kinetic_law = reaction.create_kinetic_law("");
+            decode_math(dec, &*kinetic_law)?;
+            decode_sbase(dec, &*kinetic_law)?;
+            for _ in 0..dec.len()? {
+                let id = dec.str()?;
+                let name = dec.str()?;
+                let local_parameter = kinetic_law.add_local_parameter(id, dec.opt_f64()?);
+                if !name.is_empty() {
+                    local_parameter.set_name(name);
+                }
+                if let Some(units) = dec.opt_str()? {
+                    local_parameter.set_units(units);
+                }
+                if let Some(constant) = dec.opt_bool()? {
+                    local_parameter.set_constant(constant);
+                }
+                decode_sbase(dec, &*local_parameter)?;
+            }
+        }
+    }
+
+    for _ in 0..dec.len()? {
+        let rule = model.create_rate_rule(dec.str()?, "");
+        decode_math(dec, &*rule)?;
+        decode_sbase(dec, &*rule)?;
+    }
+    for _ in 0..dec.len()? {
+        let rule = model.create_assignment_rule(dec.str()?, "");
+        decode_math(dec, &*rule)?;
+        decode_sbase(dec, &*rule)?;
+    }
+
+    let active_objective = dec.str()?;
+    for _ in 0..dec.len()? {
+        let id = dec.str()?;
+        let obj_type = objective_type_from_code(dec.u8()?)?;
+        let objective = model.create_objective(id, obj_type)?;
+        decode_sbase(dec, &*objective)?;
+
+        for _ in 0..dec.len()? {
+            let id = dec.opt_str()?.unwrap_or_default();
+            let reaction = dec.opt_str()?.unwrap_or_default();
+            let flux_objective = objective.create_flux_objective(id, reaction, 0.0)?;
+            match dec.opt_f64()? {
+                Some(coefficient) => flux_objective.set_coefficient(coefficient),
+                None => {
+                    flux_objective
+                        .inner()
+                        .borrow_mut()
+                        .as_mut()
+                        .unsetCoefficient();
+                }
+            }
+            decode_sbase(dec, &*flux_objective)?;
+        }
+    }
+    if !active_objective.is_empty() {
+        let mut plugin =
+            get_plugin::<sbmlcxx::FbcModelPlugin, Model<'_>, sbmlcxx::Model>(model, "fbc")?;
+        let_cxx_string!(active_objective = active_objective);
+        plugin.as_mut().setActiveObjectiveId(&active_objective);
+    }
+
+    for _ in 0..dec.len()? {
+        let id = dec.opt_str()?.unwrap_or_default();
+        let reaction = dec.opt_str()?.unwrap_or_default();
+        let operation = flux_bound_operation_from_code(dec.u8()?)?;
+        let flux_bound = model.create_flux_bound(id, reaction, operation)?;
+        if let Some(value) = dec.opt_f64()? {
+            flux_bound.set_value(value);
+        }
+        decode_sbase(dec, &*flux_bound)?;
+    }
+
+    Ok(())
+}
+
+/// Returns the `SBase` part of a wrapped element.
+fn sbase<'e, 'a: 'e, T: 'a>(element: &'e impl Inner<'a, T>) -> Pin<&'e mut sbmlcxx::SBase> {
+    crate::upcast!(element, T, sbmlcxx::SBase)
+}
+
+/// Stores the meta id, SBO term, notes and annotation of an element.
+fn encode_sbase<'a, T: 'a>(enc: &mut Encoder, element: &impl Inner<'a, T>) {
+    let base = sbase(element);
+    enc.str(&sbmlcxx::sbmlrs::metaIdOf(&base).to_string_lossy());
+    enc.i32(base.getSBOTerm().0);
+    enc.str(&sbmlcxx::sbmlrs::notesOf(&base).to_string_lossy());
+    enc.str(&sbmlcxx::sbmlrs::annotationOf(&base).to_string_lossy());
+}
+
+/// Restores the attributes stored by [`encode_sbase`] on an element.
+fn decode_sbase<'a, T: 'a>(
+    dec: &mut Decoder<'_>,
+    element: &impl Inner<'a, T>,
+) -> Result<(), LibSBMLError> {
+    let_cxx_string!(meta_id = dec.str()?);
+    let sbo_term = dec.i32()?;
+    let_cxx_string!(notes = dec.str()?);
+    let_cxx_string!(annotation = dec.str()?);
+
+    let restored = sbmlcxx::sbmlrs::setSBaseAttributes(
+        sbase(element),
+        &meta_id,
+        c_int(sbo_term),
+        &notes,
+        &annotation,
+    );
+    if restored {
+        Ok(())
+    } else {
+        Err(invalid("invalid meta id, SBO term, notes or annotation"))
+    }
+}
+
+/// Stores the math of a kinetic law or rule as MathML.
+///
+/// Unlike formula strings, MathML keeps csymbols, units of numbers and the exact
+/// representation of numeric literals.
+fn encode_math<'a, T: 'a>(enc: &mut Encoder, element: &impl Inner<'a, T>) {
+    enc.str(&sbmlcxx::sbmlrs::mathMLOf(&sbase(element)).to_string_lossy());
+}
+
+/// Restores the math stored by [`encode_math`] on a kinetic law or rule.
+fn decode_math<'a, T: 'a>(
+    dec: &mut Decoder<'_>,
+    element: &impl Inner<'a, T>,
+) -> Result<(), LibSBMLError> {
+    let math = dec.str()?;
+    if math.is_empty() {
+        return Ok(());
+    }
+    let_cxx_string!(math = math);
+    if sbmlcxx::sbmlrs::setMathML(sbase(element), &math) {
+        Ok(())
+    } else {
+        Err(invalid("invalid MathML"))
+    }
+}
+
+fn objective_type_code(obj_type: ObjectiveType) -> u8 {
+    match obj_type {
+        ObjectiveType::Maximize => 0,
+        ObjectiveType::Minimize => 1,
+        ObjectiveType::Unknown => 2,
+    }
+}
+
+fn objective_type_from_code(code: u8) -> Result<ObjectiveType, LibSBMLError> {
+    match code {
+        0 => Ok(ObjectiveType::Maximize),
+        1 => Ok(ObjectiveType::Minimize),
+        2 => Ok(ObjectiveType::Unknown),
+        _ => Err(invalid(&format!("unknown objective type {code}"))),
+    }
+}
+
+fn flux_bound_operation_code(operation: FluxBoundOperation) -> u8 {
+    match operation {
+        FluxBoundOperation::LessEqual => 0,
+        FluxBoundOperation::GreaterEqual => 1,
+        FluxBoundOperation::Less => 2,
+        FluxBoundOperation::Greater => 3,
+        FluxBoundOperation::Equal => 4,
+        FluxBoundOperation::Unknown => 5,
+    }
+}
+
+fn flux_bound_operation_from_code(code: u8) -> Result<FluxBoundOperation, LibSBMLError> {
+    match code {
+        0 => Ok(FluxBoundOperation::LessEqual),
+        1 => Ok(FluxBoundOperation::GreaterEqual),
+        2 => Ok(FluxBoundOperation::Less),
+        3 => Ok(FluxBoundOperation::Greater),
+        4 => Ok(FluxBoundOperation::Equal),
+        5 => Ok(FluxBoundOperation::Unknown),
+        _ => Err(invalid(&format!("unknown flux bound operation {code}"))),
+    }
+}
+
+fn invalid(reason: &str) -> LibSBMLError {
+    LibSBMLError::InvalidArgument(format!("Invalid SBML snapshot: {reason}"))
+}
+
+fn unsupported(content: &str) -> LibSBMLError {
+    LibSBMLError::Unsupported(format!("SBML snapshots cannot represent {content}"))
+}
+
+/// Appends little endian values to a byte buffer.
+///
+/// Strings are stored with a `u32` length prefix, optional values with a leading
+/// presence byte.
+#[derive(Default)]
+struct Encoder {
+    buf: Vec<u8>,
+}
+
+impl Encoder {
+    fn u8(&mut self, value: u8) {
+        self.buf.push(value);
+    }
+
+    fn u32(&mut self, value: u32) {
+        self.buf.extend_from_slice(&value.to_le_bytes());
+    }
+
+    fn i32(&mut self, value: i32) {
+        self.buf.extend_from_slice(&value.to_le_bytes());
+    }
+
+    fn f64(&mut self, value: f64) {
+        self.buf.extend_from_slice(&value.to_le_bytes());
+    }
+
+    fn bool(&mut self, value: bool) {
+        self.u8(value.into());
+    }
+
+    fn len(&mut self, len: usize) {
+        self.u32(len as u32);
+    }
+
+    fn str(&mut self, value: &str) {
+        self.len(value.len());
+        self.buf.extend_from_slice(value.as_bytes());
+    }
+
+    fn opt_str(&mut self, value: Option<&str>) {
+        self.bool(value.is_some());
+        if let Some(value) = value {
+            self.str(value);
+        }
+    }
+
+    fn opt_u32(&mut self, value: Option<u32>) {
+        self.bool(value.is_some());
+        if let Some(value) = value {
+            self.u32(value);
+        }
+    }
+
+    fn opt_f64(&mut self, value: Option<f64>) {
+        self.bool(value.is_some());
+        if let Some(value) = value {
+            self.f64(value);
+        }
+    }
+
+    fn opt_bool(&mut self, value: Option<bool>) {
+        self.u8(match value {
+            None => 0,
+            Some(false) => 1,
+            Some(true) => 2,
+        });
+    }
+}
+
+/// Reads the values written by [`Encoder`] from a borrowed byte slice.
+struct Decoder<'b> {
+    bytes: &'b [u8],
+    position: usize,
+}
+
+impl<'b> Decoder<'b> {
+    fn new(bytes: &'b [u8]) -> Self {
+        Self { bytes, position: 0 }
+    }
+
+    fn take(&mut self, n: usize) -> Result<&'b [u8], LibSBMLError> {
+        let end = self
+            .position
+            .checked_add(n)
+            .filter(|&end| end <= self.bytes.len())
+            .ok_or_else(|| invalid("unexpected end of data"))?;
+        let bytes = &self.bytes[self.position..end];
+        self.position = end;
+        Ok(bytes)
+    }
+
+    fn array<const N: usize>(&mut self) -> Result<[u8; N], LibSBMLError> {
+        Ok(self.take(N)?.try_into().expect("slice has length N"))
+    }
+
+    fn u8(&mut self) -> Result<u8, LibSBMLError> {
+        Ok(self.take(1)?[0])
+    }
+
+    fn u32(&mut self) -> Result<u32, LibSBMLError> {
+        self.array().map(u32::from_le_bytes)
+    }
+
+    fn u64(&mut self) -> Result<u64, LibSBMLError> {
+        self.array().map(u64::from_le_bytes)
+    }
+
+    fn i32(&mut self) -> Result<i32, LibSBMLError> {
+        self.array().map(i32::from_le_bytes)
+    }
+
+    fn f64(&mut self) -> Result<f64, LibSBMLError> {
+        self.array().map(f64::from_le_bytes)
+    }
+
+    fn bool(&mut self) -> Result<bool, LibSBMLError> {
+        match self.u8()? {
+            0 => Ok(false),
+            1 => Ok(true),
+            value => Err(invalid(&format!("invalid boolean {value}"))),
+        }
+    }
+
+    fn len(&mut self) -> Result<usize, LibSBMLError> {
+        Ok(self.u32()? as usize)
+    }
+
+    fn str(&mut self) -> Result<&'b str, LibSBMLError> {
+        let len = self.len()?;
+        std::str::from_utf8(self.take(len)?).map_err(|_| invalid("string is not valid UTF-8"))
+    }
+
+    fn opt_str(&mut self) -> Result<Option<&'b str>, LibSBMLError> {
+        if self.bool()? {
+            self.str().map(Some)
+        } else {
+            Ok(None)
+        }
+    }
+
+    fn opt_u32(&mut self) -> Result<Option<u32>, LibSBMLError> {
+        if self.bool()? {
+            self.u32().map(Some)
+        } else {
+            Ok(None)
+        }
+    }
+
+    fn opt_f64(&mut self) -> Result<Option<f64>, LibSBMLError> {
+        if self.bool()? {
+            self.f64().map(Some)
+        } else {
+            Ok(None)
+        }
+    }
+
+    fn opt_bool(&mut self) -> Result<Option<bool>, LibSBMLError> {
+        match self.u8()? {
+            0 => Ok(None),
+            1 => Ok(Some(false)),
+            2 => Ok(Some(true)),
+            value => Err(invalid(&format!("invalid optional boolean {value}"))),
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::prelude::*;
+
+    fn create_document() -> SBMLDocument {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("snapshot");
+        model.set_name("Snapshot model");
+
+        let unit_definition = model.create_unit_definition("mM", "millimolar");
+        unit_definition.create_unit(UnitKind::Mole).set_scale(-3);
+        unit_definition
+            .create_unit(UnitKind::Litre)
+            .set_exponent(-1);
+
+        let compartment = model.create_compartment("cytosol");
+        compartment.set_size(1.0);
+        compartment.set_constant(true);
+
+        let glucose = model.create_species("glucose");
+        glucose.set_compartment("cytosol");
+        glucose.set_initial_concentration(10.0);
+        glucose.set_units("mM");
+        glucose
+            .set_annotation("<annotation><data xmlns=\"http://example.com\"/></annotation>")
+            .unwrap();
+        model.create_species("g6p").set_compartment("cytosol");
+
+        model.create_parameter("kcat").set_value(2.5);
+
+        let reaction = model.create_reaction("hexokinase");
+        reaction.set_reversible(false);
+        reaction.create_reactant("glucose", 1.0);
+        reaction.create_product("g6p", 2.0);
+        reaction.create_modifier("g6p");
+        let kinetic_law = reaction.create_kinetic_law("kcat * glucose / (km + glucose)");
+        kinetic_law.add_local_parameter("km", Some(0.1));
+
+        model.create_assignment_rule("g6p", "glucose * 2");
+
+        let objective = model
+            .create_objective("obj", ObjectiveType::Maximize)
+            .unwrap();
+        objective
+            .create_flux_objective("fobj", "hexokinase", 1.0)
+            .unwrap();
+        model
+            .create_flux_bound("fb", "hexokinase", FluxBoundOperation::LessEqual)
+            .unwrap()
+            .set_value(100.0);
+
+        doc
+    }
+
+    #[test]
+    fn test_snapshot_roundtrip() {
+        let doc = create_document();
+        let xml = doc.to_xml_string();
+        let hash = source_hash(xml.as_bytes());
+
+        let snapshot = encode(&doc, hash).unwrap();
+        let restored = decode(&snapshot, hash).unwrap().expect("snapshot is stale");
+
+        assert_eq!(restored.to_xml_string(), xml);
+    }
+
+    const MATH_MODEL: &str = r#"<?xml version="1.0" encoding="UTF-8"?>
+<sbml xmlns="http://www.sbml.org/sbml/level3/version2/core" level="3" version="2">
+  <model metaid="meta_model" id="math">
+    <notes>
+      <body xmlns="http://www.w3.org/1999/xhtml">
+        <p>Decay with a delayed start</p>
+      </body>
+    </notes>
+    <listOfCompartments>
+      <compartment id="cell" size="1" constant="true"/>
+    </listOfCompartments>
+    <listOfSpecies>
+      <species metaid="meta_s" sboTerm="SBO:0000247" id="s" compartment="cell" initialAmount="1" hasOnlySubstanceUnits="true" boundaryCondition="false" constant="false"/>
+    </listOfSpecies>
+    <listOfParameters>
+      <parameter id="k" value="0.1" constant="true"/>
+    </listOfParameters>
+    <listOfRules>
+      <assignmentRule variable="k">
+        <math xmlns="http://www.w3.org/1998/Math/MathML" xmlns:sbml="http://www.sbml.org/sbml/level3/version2/core">
+          <apply>
+            <times/>
+            <cn sbml:units="dimensionless" type="e-notation"> 1 <sep/> -1 </cn>
+            <csymbol encoding="text" definitionURL="http://www.sbml.org/sbml/symbols/time"> t </csymbol>
+          </apply>
+        </math>
+      </assignmentRule>
+    </listOfRules>
+    <listOfReactions>
+      <reaction id="decay" reversible="false">
+        <listOfReactants>
+          <speciesReference sboTerm="SBO:0000010" species="s" stoichiometry="1" constant="true"/>
+        </listOfReactants>
+        <kineticLaw>
+          <math xmlns="http://www.w3.org/1998/Math/MathML">
+            <apply>
+              <times/>
+              <ci> k </ci>
+              <ci> s </ci>
+            </apply>
+          </math>
+        </kineticLaw>
+      </reaction>
+    </listOfReactions>
+  </model>
+</sbml>
+"#;
+
+    #[test]
+    fn test_snapshot_keeps_math_and_sbase_attributes() {
+        let doc = SBMLReader::from_xml_string(MATH_MODEL);
+        let xml = doc.to_xml_string();
+        let hash = source_hash(MATH_MODEL.as_bytes());
+
+        let snapshot = encode(&doc, hash).unwrap();
+        let restored = decode(&snapshot, hash).unwrap().expect("snapshot is stale");
+        let restored_xml = restored.to_xml_string();
+
+        assert_eq!(restored_xml, xml);
+        assert!(restored_xml.contains("definitionURL=\"http://www.sbml.org/sbml/symbols/time\""));
+        assert!(restored_xml.contains("sbml:units=\"dimensionless\""));
+        assert!(restored_xml.contains("metaid=\"meta_s\""));
+        assert!(restored_xml.contains("Decay with a delayed start"));
+    }
+
+    #[test]
+    fn test_snapshot_unsupported_content() {
+        let event = r#"<listOfEvents>
+      <event id="pulse" useValuesFromTriggerTime="true">
+        <trigger initialValue="false" persistent="true">
+          <math xmlns="http://www.w3.org/1998/Math/MathML"><true/></math>
+        </trigger>
+      </event>
+    </listOfEvents>
+  </model>"#;
+        let doc = SBMLReader::from_xml_string(&MATH_MODEL.replace("</model>", event));
+        assert!(matches!(encode(&doc, 1), Err(LibSBMLError::Unsupported(_))));
+
+        // Attributes outside of the format are caught by the round trip check
+        let doc = SBMLReader::from_xml_string(&MATH_MODEL.replace(
+            "<model metaid=\"meta_model\" id=\"math\">",
+            "<model metaid=\"meta_model\" id=\"math\" timeUnits=\"second\">",
+        ));
+        assert!(matches!(encode(&doc, 1), Err(LibSBMLError::Unsupported(_))));
+    }
+
+    #[test]
+    fn test_snapshot_stale_hash() {
+        let doc = create_document();
+        let snapshot = encode(&doc, 1).unwrap();
+
+        assert!(decode(&snapshot, 2).unwrap().is_none());
+    }
+
+    #[test]
+    fn test_snapshot_truncated() {
+        let doc = create_document();
+        let snapshot = encode(&doc, 1).unwrap();
+
+        assert!(decode(&snapshot[..snapshot.len() - 1], 1).is_err());
+        assert!(decode(b"not a snapshot at all", 1).is_err());
+    }
+
+    #[test]
+    fn test_snapshot_without_model() {
+        let doc = SBMLDocument::default();
+        let snapshot = encode(&doc, 7).unwrap();
+        let restored = decode(&snapshot, 7).unwrap().unwrap();
+
+        assert!(restored.model().is_none());
+    }
+
+    #[test]
+    fn test_source_hash() {
+        assert_eq!(source_hash(b""), 0xcbf2_9ce4_8422_2325);
+        assert_ne!(source_hash(b"<sbml/>"), source_hash(b"<sbml />"));
+    }
+}
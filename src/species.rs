@@ -13,7 +13,9 @@ use std::{cell::RefCell, pin::Pin, rc::Rc};
 use cxx::let_cxx_string;
 
 use crate::{
-    clone, get_unit_definition, inner, into_id,
+    clone, get_unit_definition,
+    incremental::ChangeTracker,
+    index_key, inner, into_id,
     model::Model,
     optional_property, pin_ptr,
     prelude::IntoId,
@@ -30,6 +32,9 @@ use crate::{
 /// through a RefCell and Pin to ensure memory safety while allowing interior mutability.
 pub struct Species<'a> {
     inner: RefCell<Pin<&'a mut sbmlcxx::Species>>,
+    annotation_cache: AnnotationCache,
+    /// Marks the section of the document that contains this element
+    changes: ChangeTracker<'a>,
 }
 
 // Set the inner trait for the Species struct
@@ -47,6 +52,9 @@ clone!(Species<'a>, sbmlcxx::Species);
 // Set the into_id trait for the Species struct
 into_id!(&Rc<Species<'_>>, id);
 
+// Index Species collections by id
+index_key!(Species<'_>, getId);
+
 impl<'a> Species<'a> {
     /// Creates a new Species instance within the given Model.
     ///
@@ -69,6 +77,8 @@ impl<'a> Species<'a> {
 
         Self {
             inner: RefCell::new(species),
+            annotation_cache: AnnotationCache::default(),
+            changes: model.changes(),
         }
     }
 
@@ -81,7 +91,14 @@ impl<'a> Species<'a> {
     }
 
     // Setter and getter for id
-    required_property!(Species<'a>, id, String, getId, setId);
+    required_property!(
+        Species<'a>,
+        id,
+        String,
+        getId,
+        setId,
+        after_set = key_changed
+    );
 
     // Setter and getter for name
     optional_property!(Species<'a>, name, String, getName, setName, isSetName);
@@ -172,6 +189,8 @@ impl FromPtr<sbmlcxx::Species> for Species<'_> {
         let species = pin_ptr!(ptr, sbmlcxx::Species);
         Self {
             inner: RefCell::new(species),
+            annotation_cache: AnnotationCache::default(),
+            changes: ChangeTracker::default(),
         }
     }
 }
@@ -387,6 +406,19 @@ mod tests {
         assert_eq!(species.unit(), Some("mole".to_string()));
     }
 
+    #[test]
+    fn test_species_borrowed_accessors() {
+        let doc = SBMLDocument::default();
+        let model = Model::new(&doc, "test");
+        let species = Species::new(&model, "glucose");
+        species.set_name("Glucose");
+
+        assert!(species.with_id(|id| id == "glucose"));
+        assert_eq!(species.with_name(|name| name.map(str::len)), Some(7));
+        assert!(species.with_compartment(|compartment| compartment.is_none()));
+        assert_eq!(model.with_id(str::to_uppercase), "TEST");
+    }
+
     #[test]
     fn test_species_annotation() {
         let doc = SBMLDocument::default();
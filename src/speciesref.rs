@@ -11,7 +11,10 @@ use cxx::let_cxx_string;
 use std::{cell::RefCell, pin::Pin, rc::Rc};
 
 use crate::{
-    clone, inner, pin_ptr,
+    clone,
+    dependency::ChangeHook,
+    incremental::ChangeTracker,
+    inner, pin_ptr,
     prelude::IntoId,
     reaction::Reaction,
     required_property, sbase,
@@ -27,6 +30,11 @@ use crate::{
 /// through a RefCell and Pin to ensure memory safety while allowing interior mutability.
 pub struct SpeciesReference<'a> {
     inner: RefCell<Pin<&'a mut sbmlcxx::SpeciesReference>>,
+    annotation_cache: AnnotationCache,
+    /// Marks the section of the document that contains this element
+    changes: ChangeTracker<'a>,
+    /// Reports changes to the dependency graph of the model of the parent reaction
+    dependencies: Option<ChangeHook>,
 }
 
 // Set the inner trait for the SpeciesReference struct
@@ -43,7 +51,11 @@ upcast_annotation!(
 );
 
 // Implement the Clone trait for the SpeciesReference struct
-clone!(SpeciesReference<'a>, sbmlcxx::SpeciesReference);
+clone!(
+    SpeciesReference<'a>,
+    sbmlcxx::SpeciesReference,
+    dependencies
+);
 
 impl<'a> SpeciesReference<'a> {
     /// Creates a new SimpleSpeciesReference instance within the given Reaction.
@@ -83,6 +95,23 @@ impl<'a> SpeciesReference<'a> {
 
         Self {
             inner: RefCell::new(species_reference),
+            annotation_cache: AnnotationCache::default(),
+            changes: reaction.changes(),
+            dependencies: reaction.dependency_hook(),
+        }
+    }
+
+    /// Attaches a species reference wrapped from the native model to the dependency
+    /// graph of the parent reaction's model.
+    pub(crate) fn tracked_by(mut self, reaction: &Reaction<'a>) -> Self {
+        self.dependencies = reaction.dependency_hook();
+        self
+    }
+
+    /// Reports a change of the species to the dependency graph.
+    fn notify_dependencies(&self) {
+        if let Some(hook) = &self.dependencies {
+            hook.notify();
         }
     }
 
@@ -94,7 +123,8 @@ impl<'a> SpeciesReference<'a> {
         getSpecies,
         setSpecies,
         sbmlcxx::SpeciesReference,
-        sbmlcxx::SimpleSpeciesReference
+        sbmlcxx::SimpleSpeciesReference,
+        after_set = notify_dependencies
     );
 
     // Getter and setter for stoichiometry
@@ -140,6 +170,9 @@ impl FromPtr<sbmlcxx::SpeciesReference> for SpeciesReference<'_> {
         let species_reference = pin_ptr!(ptr, sbmlcxx::SpeciesReference);
         Self {
             inner: RefCell::new(species_reference),
+            annotation_cache: AnnotationCache::default(),
+            changes: ChangeTracker::default(),
+            dependencies: None,
         }
     }
 }
@@ -266,6 +299,7 @@ mod tests {
 
         // Check that the species reference is created correctly
         assert_eq!(species_reference.species(), "test_species");
+        assert!(species_reference.with_species(|species| species == "test_species"));
         assert!(species_reference.constant());
         assert_eq!(species_reference.stoichiometry(), 1.0);
     }
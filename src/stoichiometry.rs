@@ -0,0 +1,395 @@
+//! Export of reaction networks into the dense and sparse arrays used by LP solvers.
+//!
+//! Setting up a flux balance analysis through the wrapper types means walking every
+//! reaction and species reference individually and resolving species ids one by one.
+//! The functions in this module instead traverse the native model once and produce
+//! contiguous arrays:
+//!
+//! - [`StoichiometryMatrix`]: the stoichiometric matrix in compressed sparse column
+//!   (CSC) format, with one row per species and one column per reaction
+//! - [`FluxBoundVectors`]: dense lower and upper flux bounds per reaction, folded from
+//!   the FBC flux bounds of the model
+//! - [`Model::objective_vector`]: dense objective coefficients per reaction
+//!
+//! Rows and columns follow the order of [`Model::list_of_species`] and
+//! [`Model::list_of_reactions`].
+//!
+//! # Example
+//!
+//! ```no_run
+//! use sbml::prelude::*;
+//!
+//! let doc = SBMLReader::from_file("e_coli_core.xml").unwrap();
+//! let model = doc.model().unwrap();
+//!
+//! let matrix = model.stoichiometry_csc().unwrap();
+//! let bounds = model.flux_bounds_vectors().unwrap();
+//! let objective = model.objective_vector().unwrap();
+//! ```
+
+use std::collections::HashMap;
+
+use crate::{
+    errors::LibSBMLError,
+    fbc::fluxboundop::FluxBoundOperation,
+    model::Model,
+    plugin::get_plugin,
+    reaction::Reaction,
+    sbmlcxx,
+    species::Species,
+    speciesref::SpeciesReference,
+    traits::{fromptr::FromPtr, inner::Inner},
+};
+
+/// The stoichiometric matrix of a model in compressed sparse column format.
+///
+/// The entries of column `j` are stored at `indptr[j]..indptr[j + 1]` of `indices`
+/// (the row, i.e. species, indices) and `data` (the stoichiometric coefficients).
+/// Within a column, row indices are sorted and unique. Reactants contribute negative,
+/// products positive coefficients, and a species occurring on both sides of a
+/// reaction contributes the net coefficient.
+#[derive(Debug, Clone, PartialEq)]
+pub struct StoichiometryMatrix {
+    /// Column pointers, with one entry per reaction plus one
+    pub indptr: Vec<usize>,
+    /// Row index of every stored entry
+    pub indices: Vec<usize>,
+    /// Coefficient of every stored entry
+    pub data: Vec<f64>,
+    /// Species ids, indexed by row
+    pub species: Vec<String>,
+    /// Reaction ids, indexed by column
+    pub reactions: Vec<String>,
+    /// Whether the species of a row is a boundary species
+    pub boundary: Vec<bool>,
+    /// Maps species ids to row indices
+    pub species_index: HashMap<String, usize>,
+    /// Maps reaction ids to column indices
+    pub reaction_index: HashMap<String, usize>,
+}
+
+impl StoichiometryMatrix {
+    /// Returns the number of rows (species) and columns (reactions).
+    pub fn shape(&self) -> (usize, usize) {
+        (self.species.len(), self.reactions.len())
+    }
+
+    /// Returns the number of stored entries.
+    pub fn nnz(&self) -> usize {
+        self.data.len()
+    }
+
+    /// Returns the row indices and coefficients of a column.
+    ///
+    /// # Panics
+    /// Panics if `reaction` is out of bounds.
+    pub fn column(&self, reaction: usize) -> (&[usize], &[f64]) {
+        let range = self.indptr[reaction]..self.indptr[reaction + 1];
+        (&self.indices[range.clone()], &self.data[range])
+    }
+
+    /// Returns the coefficient of a species in a reaction, zero if it does not take part.
+    ///
+    /// # Panics
+    /// Panics if `reaction` is out of bounds.
+    pub fn get(&self, species: usize, reaction: usize) -> f64 {
+        let (rows, values) = self.column(reaction);
+        match rows.binary_search(&species) {
+            Ok(position) => values[position],
+            Err(_) => 0.0,
+        }
+    }
+}
+
+/// Dense flux bounds of all reactions of a model.
+///
+/// Reactions without a bound are unconstrained, i.e. have a lower bound of `-inf`
+/// and an upper bound of `inf`.
+#[derive(Debug, Clone, PartialEq)]
+pub struct FluxBoundVectors {
+    /// Lower bound per reaction
+    pub lower: Vec<f64>,
+    /// Upper bound per reaction
+    pub upper: Vec<f64>,
+}
+
+/// Builds the stoichiometric matrix in a single traversal of the native model.
+pub(crate) fn stoichiometry_csc(model: &Model<'_>) -> Result<StoichiometryMatrix, LibSBMLError> {
+    let n_species = model.inner().borrow().getNumSpecies().0;
+    let mut species = Vec::with_capacity(n_species as usize);
+    let mut boundary = Vec::with_capacity(n_species as usize);
+    for i in 0..n_species {
+        let ptr = model.inner().borrow_mut().as_mut().getSpecies1(i.into());
+        let native = Species::from_ptr(ptr);
+        species.push(native.id());
+        boundary.push(native.boundary_condition().unwrap_or(false));
+    }
+    let species_index = index_of(&species);
+
+    let (reactions, reaction_index) = reaction_ids(model);
+    let mut indptr = Vec::with_capacity(reactions.len() + 1);
+    let mut indices = Vec::new();
+    let mut data = Vec::new();
+    let mut column: Vec<(usize, f64)> = Vec::new();
+
+    indptr.push(0);
+    for j in 0..reactions.len() {
+        let reaction = native_reaction(model, j);
+        column.clear();
+
+        let n_reactants = reaction.inner().borrow().getNumReactants().0;
+        for i in 0..n_reactants {
+            let ptr = reaction
+                .inner()
+                .borrow_mut()
+                .as_mut()
+                .getReactant1(i.into());
+            let (row, stoichiometry) = resolve(&species_index, &reactions[j], ptr)?;
+            column.push((row, -stoichiometry));
+        }
+
+        let n_products = reaction.inner().borrow().getNumProducts().0;
+        for i in 0..n_products {
+            let ptr = reaction.inner().borrow_mut().as_mut().getProduct1(i.into());
+            let (row, stoichiometry) = resolve(&species_index, &reactions[j], ptr)?;
+            column.push((row, stoichiometry));
+        }
+
+        // Merge species occurring more than once into their net coefficient
+        column.sort_unstable_by_key(|&(row, _)| row);
+        for &(row, value) in &column {
+            if indices.len() > indptr[j] && indices.last() == Some(&row) {
+                *data.last_mut().expect("entry exists") += value;
+            } else {
+                indices.push(row);
+                data.push(value);
+            }
+        }
+        indptr.push(indices.len());
+    }
+
+    Ok(StoichiometryMatrix {
+        indptr,
+        indices,
+        data,
+        species,
+        reactions,
+        boundary,
+        species_index,
+        reaction_index,
+    })
+}
+
+/// Folds the FBC flux bounds of a model into dense vectors.
+///
+/// `LessEqual` and `Less` bounds tighten the upper bound, `GreaterEqual` and
+/// `Greater` bounds the lower bound, and `Equal` bounds fix both. Bounds without a
+/// value or with an unknown operation are ignored.
+pub(crate) fn flux_bounds_vectors(model: &Model<'_>) -> Result<FluxBoundVectors, LibSBMLError> {
+    let (reactions, reaction_index) = reaction_ids(model);
+    let mut lower = vec![f64::NEG_INFINITY; reactions.len()];
+    let mut upper = vec![f64::INFINITY; reactions.len()];
+
+    for flux_bound in model.list_of_flux_bounds() {
+        let Some(value) = flux_bound.value() else {
+            continue;
+        };
+        let reaction = flux_bound.reaction().unwrap_or_default();
+        let j = *reaction_index.get(&reaction).ok_or_else(|| {
+            LibSBMLError::InvalidArgument(format!(
+                "Flux bound refers to unknown reaction '{reaction}'"
+            ))
+        })?;
+
+        match flux_bound.operation() {
+            FluxBoundOperation::LessEqual | FluxBoundOperation::Less => {
+                upper[j] = upper[j].min(value)
+            }
+            FluxBoundOperation::GreaterEqual | FluxBoundOperation::Greater => {
+                lower[j] = lower[j].max(value)
+            }
+            FluxBoundOperation::Equal => {
+                lower[j] = value;
+                upper[j] = value;
+            }
+            FluxBoundOperation::Unknown => {}
+        }
+    }
+
+    Ok(FluxBoundVectors { lower, upper })
+}
+
+/// Builds the dense coefficient vector of the active objective of a model.
+///
+/// If no objective is marked as active, the first objective is used. Returns `None`
+/// if the model has no objectives.
+pub(crate) fn objective_vector(model: &Model<'_>) -> Result<Option<Vec<f64>>, LibSBMLError> {
+    let objectives = model.list_of_objectives();
+    let active_id = get_plugin::<sbmlcxx::FbcModelPlugin, Model<'_>, sbmlcxx::Model>(model, "fbc")
+        .map(|plugin| {
+            let active = plugin.getActiveObjectiveId();
+            active.to_str().unwrap_or_default().to_string()
+        })
+        .unwrap_or_default();
+
+    let Some(objective) = objectives
+        .iter()
+        .find(|objective| objective.with_id(|id| id == active_id))
+        .or_else(|| objectives.first())
+    else {
+        return Ok(None);
+    };
+
+    let (reactions, reaction_index) = reaction_ids(model);
+    let mut coefficients = vec![0.0; reactions.len()];
+    for flux_objective in objective.flux_objectives() {
+        let Some(coefficient) = flux_objective.coefficient() else {
+            continue;
+        };
+        let reaction = flux_objective.reaction().unwrap_or_default();
+        let j = *reaction_index.get(&reaction).ok_or_else(|| {
+            LibSBMLError::InvalidArgument(format!(
+                "Flux objective refers to unknown reaction '{reaction}'"
+            ))
+        })?;
+        coefficients[j] += coefficient;
+    }
+
+    Ok(Some(coefficients))
+}
+
+/// Collects the ids of all native reactions, in model order.
+fn reaction_ids(model: &Model<'_>) -> (Vec<String>, HashMap<String, usize>) {
+    let n_reactions = model.inner().borrow().getNumReactions().0 as usize;
+    let reactions: Vec<String> = (0..n_reactions)
+        .map(|j| native_reaction(model, j).id())
+        .collect();
+    let index = index_of(&reactions);
+    (reactions, index)
+}
+
+/// Wraps the native reaction at the given position without caching it.
+fn native_reaction<'a>(model: &Model<'a>, j: usize) -> Reaction<'a> {
+    let ptr = model
+        .inner()
+        .borrow_mut()
+        .as_mut()
+        .getReaction1((j as u32).into());
+    Reaction::from_ptr(ptr)
+}
+
+/// Resolves the species and stoichiometry of a native species reference.
+fn resolve(
+    species_index: &HashMap<String, usize>,
+    reaction: &str,
+    ptr: *mut sbmlcxx::SpeciesReference,
+) -> Result<(usize, f64), LibSBMLError> {
+    let reference = SpeciesReference::from_ptr(ptr);
+    let species = reference.species();
+    let row = *species_index.get(&species).ok_or_else(|| {
+        LibSBMLError::InvalidArgument(format!(
+            "Reaction '{reaction}' refers to unknown species '{species}'"
+        ))
+    })?;
+    Ok((row, reference.stoichiometry()))
+}
+
+/// Maps every id to its position, keeping the first position of duplicates.
+fn index_of(ids: &[String]) -> HashMap<String, usize> {
+    let mut index = HashMap::with_capacity(ids.len());
+    for (position, id) in ids.iter().enumerate() {
+        index.entry(id.clone()).or_insert(position);
+    }
+    index
+}
+
+#[cfg(test)]
+mod tests {
+    use crate::{errors::LibSBMLError, prelude::*};
+
+    fn create_network(doc: &SBMLDocument) -> std::rc::Rc<Model<'_>> {
+        let model = doc.create_model("network");
+        for id in ["A", "B", "C"] {
+            model.create_species(id);
+        }
+        model.get_species("C").unwrap().set_boundary_condition(true);
+
+        let r1 = model.create_reaction("r1");
+        r1.create_reactant("A", 1.0);
+        r1.create_product("B", 2.0);
+
+        let r2 = model.create_reaction("r2");
+        r2.create_reactant("B", 1.0);
+        r2.create_reactant("A", 1.0);
+        r2.create_product("A", 3.0);
+        r2.create_product("C", 1.0);
+
+        model.create_reaction("r3");
+        model
+    }
+
+    #[test]
+    fn test_stoichiometry_csc() {
+        let doc = SBMLDocument::default();
+        let model = create_network(&doc);
+
+        let matrix = model.stoichiometry_csc().unwrap();
+        assert_eq!(matrix.shape(), (3, 3));
+        assert_eq!(matrix.indptr, vec![0, 2, 5, 5]);
+        assert_eq!(matrix.indices, vec![0, 1, 0, 1, 2]);
+        assert_eq!(matrix.data, vec![-1.0, 2.0, 2.0, -1.0, 1.0]);
+        assert_eq!(matrix.boundary, vec![false, false, true]);
+        assert_eq!(matrix.species_index["B"], 1);
+        assert_eq!(matrix.reaction_index["r2"], 1);
+        assert_eq!(matrix.get(0, 1), 2.0);
+        assert_eq!(matrix.get(2, 0), 0.0);
+        assert_eq!(matrix.column(2), (&[][..], &[][..]));
+    }
+
+    #[test]
+    fn test_stoichiometry_unknown_species() {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("network");
+        model.create_reaction("r1").create_reactant("missing", 1.0);
+
+        assert!(matches!(
+            model.stoichiometry_csc(),
+            Err(LibSBMLError::InvalidArgument(_))
+        ));
+    }
+
+    #[test]
+    fn test_flux_bounds_and_objective() {
+        let doc = SBMLDocument::default();
+        let model = create_network(&doc);
+
+        model
+            .create_flux_bound("lb1", "r1", FluxBoundOperation::GreaterEqual)
+            .unwrap()
+            .set_value(0.0);
+        model
+            .create_flux_bound("ub1", "r1", FluxBoundOperation::LessEqual)
+            .unwrap()
+            .set_value(10.0);
+        model
+            .create_flux_bound("ub1b", "r1", FluxBoundOperation::LessEqual)
+            .unwrap()
+            .set_value(20.0);
+        model
+            .create_flux_bound("fix2", "r2", FluxBoundOperation::Equal)
+            .unwrap()
+            .set_value(1.5);
+
+        let bounds = model.flux_bounds_vectors().unwrap();
+        assert_eq!(bounds.lower, vec![0.0, 1.5, f64::NEG_INFINITY]);
+        assert_eq!(bounds.upper, vec![10.0, 1.5, f64::INFINITY]);
+
+        assert_eq!(model.objective_vector().unwrap(), None);
+
+        let objective = model
+            .create_objective("obj", ObjectiveType::Maximize)
+            .unwrap();
+        objective.create_flux_objective("fo", "r2", 2.0).unwrap();
+        assert_eq!(model.objective_vector().unwrap(), Some(vec![0.0, 2.0, 0.0]));
+    }
+}
@@ -0,0 +1,659 @@
+//! Columnar export of model components.
+//!
+//! Reading attributes through the wrapper types costs one FFI call per attribute and,
+//! for strings, one allocation per value. The tables in this module are filled in a
+//! single walk over the native model instead and store every attribute as a contiguous
+//! column:
+//!
+//! - numeric attributes as a [`NumberColumn`], i.e. a `Vec<f64>` plus a flag per value
+//!   telling whether it is set, so that a value set to `NaN` is kept apart from an
+//!   unset one. Unset values are stored as `NaN`.
+//! - flags as `Vec<bool>`, with unset flags reported as libSBML's default `false`
+//! - strings as a [`StringColumn`], i.e. one string arena plus offsets and a set flag
+//!   per string, with unset strings stored as empty strings
+//!
+//! With the `arrow` feature enabled, every table can be converted into an Arrow
+//! `RecordBatch`. The string arenas, offsets and numeric columns are moved into the
+//! Arrow buffers without copying their contents, and unset values become nulls.
+//!
+//! # Example
+//!
+//! ```no_run
+//! use sbml::prelude::*;
+//!
+//! let doc = SBMLReader::from_file("model.xml").unwrap();
+//! let model = doc.model().unwrap();
+//!
+//! let species = model.species_table();
+//! for (id, concentration) in species.id.iter().zip(&species.initial_concentration) {
+//!     println!("{id}: {concentration}");
+//! }
+//! ```
+
+use std::pin::Pin;
+
+use cxx::CxxString;
+
+use crate::{model::Model, pin_const_ptr, sbmlcxx, traits::inner::Inner};
+
+/// A column of strings stored in a single arena.
+///
+/// The string at position `i` is `data[offsets[i]..offsets[i + 1]]`, so a column of
+/// `n` strings holds `n + 1` offsets. The offsets are stored as `i64`, the offset type
+/// of Arrow's `LargeUtf8` arrays.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct StringColumn {
+    data: String,
+    offsets: Vec<i64>,
+    /// Whether the string at each position is set
+    set: Vec<bool>,
+}
+
+impl StringColumn {
+    /// Creates an empty column with room for `capacity` strings.
+    pub fn with_capacity(capacity: usize) -> Self {
+        let mut offsets = Vec::with_capacity(capacity + 1);
+        offsets.push(0);
+        Self {
+            data: String::new(),
+            offsets,
+            set: Vec::with_capacity(capacity),
+        }
+    }
+
+    /// Appends a string to the column.
+    pub fn push(&mut self, value: &str) {
+        self.data.push_str(value);
+        self.offsets.push(self.data.len() as i64);
+        self.set.push(true);
+    }
+
+    /// Appends an unset string, which reads as an empty string.
+    pub fn push_unset(&mut self) {
+        self.offsets.push(self.data.len() as i64);
+        self.set.push(false);
+    }
+
+    /// Returns the string at the given position, or None if out of bounds.
+    ///
+    /// Unset strings are returned as empty strings, see [`StringColumn::is_set`].
+    pub fn get(&self, index: usize) -> Option<&str> {
+        let start = *self.offsets.get(index)? as usize;
+        let end = *self.offsets.get(index + 1)? as usize;
+        Some(&self.data[start..end])
+    }
+
+    /// Returns whether the string at the given position is set.
+    pub fn is_set(&self, index: usize) -> bool {
+        self.set.get(index).copied().unwrap_or(false)
+    }
+
+    /// Returns the number of strings in the column.
+    pub fn len(&self) -> usize {
+        self.offsets.len() - 1
+    }
+
+    /// Returns true if the column holds no strings.
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    /// Returns an iterator over the strings of the column.
+    pub fn iter(&self) -> impl ExactSizeIterator<Item = &str> + '_ {
+        self.offsets
+            .windows(2)
+            .map(|window| &self.data[window[0] as usize..window[1] as usize])
+    }
+
+    /// Returns the arena holding all strings back to back.
+    pub fn data(&self) -> &str {
+        &self.data
+    }
+
+    /// Returns the offsets of the strings into the arena.
+    pub fn offsets(&self) -> &[i64] {
+        &self.offsets
+    }
+
+    /// Appends a native string, or an unset string if it is not set.
+    fn push_native(&mut self, is_set: bool, value: &CxxString) {
+        if is_set {
+            self.push(value.to_str().unwrap_or_default());
+        } else {
+            self.push_unset();
+        }
+    }
+}
+
+impl Default for StringColumn {
+    fn default() -> Self {
+        Self::with_capacity(0)
+    }
+}
+
+/// A column of numeric values with a set flag per value.
+///
+/// Unset values are stored as `NaN`. Since libSBML also accepts `NaN` as the value
+/// of an attribute, [`NumberColumn::get`] and [`NumberColumn::is_set`] tell the two
+/// cases apart. The column dereferences to the slice of all values.
+#[derive(Debug, Clone, Default, PartialEq)]
+pub struct NumberColumn {
+    values: Vec<f64>,
+    /// Whether the value at each position is set
+    set: Vec<bool>,
+}
+
+impl NumberColumn {
+    /// Creates an empty column with room for `capacity` values.
+    pub fn with_capacity(capacity: usize) -> Self {
+        Self {
+            values: Vec::with_capacity(capacity),
+            set: Vec::with_capacity(capacity),
+        }
+    }
+
+    /// Appends a value, or an unset value if `value` is None.
+    pub fn push(&mut self, value: Option<f64>) {
+        self.values.push(value.unwrap_or(f64::NAN));
+        self.set.push(value.is_some());
+    }
+
+    /// Returns the value at the given position, or None if it is unset or out of bounds.
+    pub fn get(&self, index: usize) -> Option<f64> {
+        self.is_set(index).then(|| self.values[index])
+    }
+
+    /// Returns whether the value at the given position is set.
+    pub fn is_set(&self, index: usize) -> bool {
+        self.set.get(index).copied().unwrap_or(false)
+    }
+
+    /// Returns all values, with `NaN` at unset positions.
+    pub fn values(&self) -> &[f64] {
+        &self.values
+    }
+
+    /// Appends a native value if it is set, or an unset value otherwise.
+    fn push_native(&mut self, is_set: bool, value: f64) {
+        self.push(is_set.then_some(value));
+    }
+}
+
+impl std::ops::Deref for NumberColumn {
+    type Target = [f64];
+
+    fn deref(&self) -> &[f64] {
+        &self.values
+    }
+}
+
+impl<'c> IntoIterator for &'c NumberColumn {
+    type Item = &'c f64;
+    type IntoIter = std::slice::Iter<'c, f64>;
+
+    fn into_iter(self) -> Self::IntoIter {
+        self.values.iter()
+    }
+}
+
+/// Attributes of all species of a model, one entry per species in model order.
+#[derive(Debug, Clone, Default, PartialEq)]
+pub struct SpeciesTable {
+    /// Identifiers
+    pub id: StringColumn,
+    /// Names
+    pub name: StringColumn,
+    /// Compartment identifiers
+    pub compartment: StringColumn,
+    /// Substance units
+    pub units: StringColumn,
+    /// Initial amounts
+    pub initial_amount: NumberColumn,
+    /// Initial concentrations
+    pub initial_concentration: NumberColumn,
+    /// Boundary condition flags
+    pub boundary_condition: Vec<bool>,
+    /// Constant flags
+    pub constant: Vec<bool>,
+    /// Has-only-substance-units flags
+    pub has_only_substance_units: Vec<bool>,
+}
+
+impl SpeciesTable {
+    /// Returns the number of species in the table.
+    pub fn len(&self) -> usize {
+        self.id.len()
+    }
+
+    /// Returns true if the table holds no species.
+    pub fn is_empty(&self) -> bool {
+        self.id.is_empty()
+    }
+}
+
+/// Attributes of all parameters of a model, one entry per parameter in model order.
+#[derive(Debug, Clone, Default, PartialEq)]
+pub struct ParameterTable {
+    /// Identifiers
+    pub id: StringColumn,
+    /// Names
+    pub name: StringColumn,
+    /// Units
+    pub units: StringColumn,
+    /// Values
+    pub value: NumberColumn,
+    /// Constant flags
+    pub constant: Vec<bool>,
+}
+
+impl ParameterTable {
+    /// Returns the number of parameters in the table.
+    pub fn len(&self) -> usize {
+        self.id.len()
+    }
+
+    /// Returns true if the table holds no parameters.
+    pub fn is_empty(&self) -> bool {
+        self.id.is_empty()
+    }
+}
+
+/// Attributes of all compartments of a model, one entry per compartment in model order.
+#[derive(Debug, Clone, Default, PartialEq)]
+pub struct CompartmentTable {
+    /// Identifiers
+    pub id: StringColumn,
+    /// Names
+    pub name: StringColumn,
+    /// Units
+    pub units: StringColumn,
+    /// Identifiers of the enclosing compartments
+    pub outside: StringColumn,
+    /// Sizes
+    pub size: NumberColumn,
+    /// Spatial dimensions
+    pub spatial_dimensions: NumberColumn,
+    /// Constant flags
+    pub constant: Vec<bool>,
+}
+
+impl CompartmentTable {
+    /// Returns the number of compartments in the table.
+    pub fn len(&self) -> usize {
+        self.id.len()
+    }
+
+    /// Returns true if the table holds no compartments.
+    pub fn is_empty(&self) -> bool {
+        self.id.is_empty()
+    }
+}
+
+/// Fills a species table in a single walk over the native species.
+pub(crate) fn species_table(model: &Model<'_>) -> SpeciesTable {
+    let n = model.inner().borrow().getNumSpecies().0;
+    let capacity = n as usize;
+    let mut table = SpeciesTable {
+        id: StringColumn::with_capacity(capacity),
+        name: StringColumn::with_capacity(capacity),
+        compartment: StringColumn::with_capacity(capacity),
+        units: StringColumn::with_capacity(capacity),
+        initial_amount: NumberColumn::with_capacity(capacity),
+        initial_concentration: NumberColumn::with_capacity(capacity),
+        boundary_condition: Vec::with_capacity(capacity),
+        constant: Vec::with_capacity(capacity),
+        has_only_substance_units: Vec::with_capacity(capacity),
+    };
+
+    for i in 0..n {
+        let ptr = model.inner().borrow_mut().as_mut().getSpecies1(i.into());
+        let species = pin_const_ptr!(ptr, sbmlcxx::Species);
+
+        table.id.push_native(true, species.getId());
+        table
+            .name
+            .push_native(species.isSetName(), species.getName());
+        table
+            .compartment
+            .push_native(species.isSetCompartment(), species.getCompartment());
+        table
+            .units
+            .push_native(species.isSetUnits(), species.getUnits());
+        table
+            .initial_amount
+            .push_native(species.isSetInitialAmount(), species.getInitialAmount());
+        table.initial_concentration.push_native(
+            species.isSetInitialConcentration(),
+            species.getInitialConcentration(),
+        );
+        table
+            .boundary_condition
+            .push(species.getBoundaryCondition());
+        table.constant.push(species.getConstant());
+        table
+            .has_only_substance_units
+            .push(species.getHasOnlySubstanceUnits());
+    }
+
+    table
+}
+
+/// Fills a parameter table in a single walk over the native parameters.
+pub(crate) fn parameters_table(model: &Model<'_>) -> ParameterTable {
+    let n = model.inner().borrow().getNumParameters().0;
+    let capacity = n as usize;
+    let mut table = ParameterTable {
+        id: StringColumn::with_capacity(capacity),
+        name: StringColumn::with_capacity(capacity),
+        units: StringColumn::with_capacity(capacity),
+        value: NumberColumn::with_capacity(capacity),
+        constant: Vec::with_capacity(capacity),
+    };
+
+    for i in 0..n {
+        let ptr = model.inner().borrow_mut().as_mut().getParameter1(i.into());
+        let parameter = pin_const_ptr!(ptr, sbmlcxx::Parameter);
+
+        table.id.push_native(true, parameter.getId());
+        table
+            .name
+            .push_native(parameter.isSetName(), parameter.getName());
+        table
+            .units
+            .push_native(parameter.isSetUnits(), parameter.getUnits());
+        table
+            .value
+            .push_native(parameter.isSetValue(), parameter.getValue());
+        table.constant.push(parameter.getConstant());
+    }
+
+    table
+}
+
+/// Fills a compartment table in a single walk over the native compartments.
+pub(crate) fn compartments_table(model: &Model<'_>) -> CompartmentTable {
+    let n = model.inner().borrow().getNumCompartments().0;
+    let capacity = n as usize;
+    let mut table = CompartmentTable {
+        id: StringColumn::with_capacity(capacity),
+        name: StringColumn::with_capacity(capacity),
+        units: StringColumn::with_capacity(capacity),
+        outside: StringColumn::with_capacity(capacity),
+        size: NumberColumn::with_capacity(capacity),
+        spatial_dimensions: NumberColumn::with_capacity(capacity),
+        constant: Vec::with_capacity(capacity),
+    };
+
+    for i in 0..n {
+        let ptr = model
+            .inner()
+            .borrow_mut()
+            .as_mut()
+            .getCompartment1(i.into());
+        let compartment = pin_const_ptr!(ptr, sbmlcxx::Compartment);
+
+        table.id.push_native(true, compartment.getId());
+        table
+            .name
+            .push_native(compartment.isSetName(), compartment.getName());
+        table
+            .units
+            .push_native(compartment.isSetUnits(), compartment.getUnits());
+        table
+            .outside
+            .push_native(compartment.isSetOutside(), compartment.getOutside());
+        table
+            .size
+            .push_native(compartment.isSetSize(), compartment.getSize());
+        table.spatial_dimensions.push_native(
+            compartment.isSetSpatialDimensions(),
+            compartment.getSpatialDimensionsAsDouble(),
+        );
+        table.constant.push(compartment.getConstant());
+    }
+
+    table
+}
+
+#[cfg(feature = "arrow")]
+mod record_batch {
+    //! Conversion of the tables into Arrow record batches.
+
+    use std::sync::Arc;
+
+    use arrow::{
+        array::{ArrayRef, BooleanArray, Float64Array, LargeStringArray},
+        buffer::{Buffer, NullBuffer, OffsetBuffer, ScalarBuffer},
+        error::ArrowError,
+        record_batch::RecordBatch,
+    };
+
+    use super::{CompartmentTable, NumberColumn, ParameterTable, SpeciesTable, StringColumn};
+
+    /// Builds the null bitmap of a column, or None if every value is set.
+    fn nulls(set: &[bool]) -> Option<NullBuffer> {
+        set.contains(&false)
+            .then(|| NullBuffer::from_iter(set.iter().copied()))
+    }
+
+    /// Moves a string column into a `LargeUtf8` array, reusing its arena and offsets.
+    fn strings(column: StringColumn) -> ArrayRef {
+        let nulls = nulls(&column.set);
+        Arc::new(LargeStringArray::new(
+            OffsetBuffer::new(ScalarBuffer::from(column.offsets)),
+            Buffer::from_vec(column.data.into_bytes()),
+            nulls,
+        ))
+    }
+
+    /// Moves a numeric column into a `Float64` array, marking unset entries as null.
+    ///
+    /// Values that are set to `NaN` stay `NaN`.
+    fn numbers(column: NumberColumn) -> ArrayRef {
+        let nulls = nulls(&column.set);
+        Arc::new(Float64Array::new(ScalarBuffer::from(column.values), nulls))
+    }
+
+    /// Packs a flag column into a `Boolean` array.
+    fn flags(column: Vec<bool>) -> ArrayRef {
+        Arc::new(BooleanArray::from(column))
+    }
+
+    impl SpeciesTable {
+        /// Converts the table into an Arrow record batch with one column per attribute.
+        ///
+        /// Unset strings and numeric values become nulls.
+        pub fn into_record_batch(self) -> Result<RecordBatch, ArrowError> {
+            RecordBatch::try_from_iter([
+                ("id", strings(self.id)),
+                ("name", strings(self.name)),
+                ("compartment", strings(self.compartment)),
+                ("units", strings(self.units)),
+                ("initial_amount", numbers(self.initial_amount)),
+                ("initial_concentration", numbers(self.initial_concentration)),
+                ("boundary_condition", flags(self.boundary_condition)),
+                ("constant", flags(self.constant)),
+                (
+                    "has_only_substance_units",
+                    flags(self.has_only_substance_units),
+                ),
+            ])
+        }
+    }
+
+    impl ParameterTable {
+        /// Converts the table into an Arrow record batch with one column per attribute.
+        ///
+        /// Unset strings and numeric values become nulls.
+        pub fn into_record_batch(self) -> Result<RecordBatch, ArrowError> {
+            RecordBatch::try_from_iter([
+                ("id", strings(self.id)),
+                ("name", strings(self.name)),
+                ("units", strings(self.units)),
+                ("value", numbers(self.value)),
+                ("constant", flags(self.constant)),
+            ])
+        }
+    }
+
+    impl CompartmentTable {
+        /// Converts the table into an Arrow record batch with one column per attribute.
+        ///
+        /// Unset strings and numeric values become nulls.
+        pub fn into_record_batch(self) -> Result<RecordBatch, ArrowError> {
+            RecordBatch::try_from_iter([
+                ("id", strings(self.id)),
+                ("name", strings(self.name)),
+                ("units", strings(self.units)),
+                ("outside", strings(self.outside)),
+                ("size", numbers(self.size)),
+                ("spatial_dimensions", numbers(self.spatial_dimensions)),
+                ("constant", flags(self.constant)),
+            ])
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::prelude::*;
+
+    #[test]
+    fn test_string_column() {
+        let mut column = StringColumn::default();
+        assert!(column.is_empty());
+
+        column.push("glc");
+        column.push("");
+        column.push_unset();
+        column.push("atp");
+
+        assert_eq!(column.len(), 4);
+        assert_eq!(column.get(0), Some("glc"));
+        assert_eq!(column.get(1), Some(""));
+        assert_eq!(column.get(2), Some(""));
+        assert_eq!(column.get(4), None);
+        assert!(column.is_set(1));
+        assert!(!column.is_set(2));
+        assert_eq!(column.data(), "glcatp");
+        assert_eq!(column.offsets(), &[0, 3, 3, 3, 6]);
+        assert_eq!(
+            column.iter().collect::<Vec<_>>(),
+            vec!["glc", "", "", "atp"]
+        );
+    }
+
+    #[test]
+    fn test_number_column() {
+        let mut column = NumberColumn::default();
+        column.push(Some(1.5));
+        column.push(Some(f64::NAN));
+        column.push(None);
+
+        assert_eq!(column.len(), 3);
+        assert_eq!(column.get(0), Some(1.5));
+        assert!(column.get(1).unwrap().is_nan());
+        assert_eq!(column.get(2), None);
+        assert_eq!(column.get(3), None);
+        assert!(column[2].is_nan());
+    }
+
+    #[test]
+    fn test_species_table() {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("model");
+        model.create_compartment("cytosol");
+
+        model
+            .build_species("glc")
+            .name("Glucose")
+            .compartment("cytosol")
+            .initial_concentration(10.0)
+            .boundary_condition(true)
+            .build();
+        model.create_species("atp");
+
+        let table = model.species_table();
+        assert_eq!(table.len(), 2);
+        assert_eq!(table.id.iter().collect::<Vec<_>>(), vec!["glc", "atp"]);
+        assert_eq!(table.name.get(0), Some("Glucose"));
+        assert_eq!(table.name.get(1), Some(""));
+        assert!(table.name.is_set(0));
+        assert!(!table.name.is_set(1));
+        assert_eq!(table.compartment.get(0), Some("cytosol"));
+        assert_eq!(table.initial_concentration[0], 10.0);
+        assert!(table.initial_concentration[1].is_nan());
+        assert_eq!(table.initial_concentration.get(1), None);
+        assert!(table.initial_amount[0].is_nan());
+        assert_eq!(table.boundary_condition, vec![true, false]);
+    }
+
+    #[test]
+    fn test_parameters_and_compartments_table() {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("model");
+        model
+            .build_parameter("kcat")
+            .value(2.5)
+            .constant(true)
+            .build();
+        model.create_parameter("km");
+        model.build_compartment("cytosol").size(1.0).build();
+
+        let parameters = model.parameters_table();
+        assert_eq!(parameters.len(), 2);
+        assert_eq!(parameters.id.get(1), Some("km"));
+        assert_eq!(parameters.value[0], 2.5);
+        assert!(parameters.value[1].is_nan());
+        assert!(parameters.constant[0]);
+
+        let compartments = model.compartments_table();
+        assert_eq!(compartments.len(), 1);
+        assert_eq!(compartments.id.get(0), Some("cytosol"));
+        assert_eq!(compartments.size.values(), [1.0]);
+    }
+
+    #[test]
+    fn test_tables_match_wrappers() {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("model");
+        for i in 0..20 {
+            model
+                .build_species(&format!("s{i}"))
+                .initial_amount(i as f64)
+                .build();
+        }
+
+        let table = model.species_table();
+        for (i, species) in model.list_of_species().iter().enumerate() {
+            assert_eq!(table.id.get(i), Some(species.id().as_str()));
+            assert_eq!(table.initial_amount.get(i), species.initial_amount());
+        }
+    }
+    #[cfg(feature = "arrow")]
+    #[test]
+    fn test_record_batch_nulls() {
+        use arrow::array::Array;
+
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("model");
+        model
+            .build_parameter("kcat")
+            .value(f64::NAN)
+            .build()
+            .set_name("Turnover");
+        model.create_parameter("km");
+
+        let batch = model.parameters_table().into_record_batch().unwrap();
+        let names = batch.column_by_name("name").unwrap();
+        assert_eq!(names.null_count(), 1);
+        assert!(names.is_null(1));
+
+        // A value set to NaN is not null, an unset value is
+        let values = batch.column_by_name("value").unwrap();
+        assert!(values.is_valid(0));
+        assert!(values.is_null(1));
+        assert_eq!(batch.column_by_name("id").unwrap().null_count(), 0);
+    }
+}
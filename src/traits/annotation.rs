@@ -32,7 +32,7 @@
 //! let retrieved: MyAnnotation = model.get_annotation_serde().unwrap();
 //! ```
 
-use std::error::Error;
+use std::{any::Any, cell::RefCell, error::Error, rc::Rc};
 
 use quick_xml::{DeError, SeError};
 use serde::{Deserialize, Serialize};
@@ -52,6 +52,15 @@ pub trait Annotation {
     /// The annotation as a String
     fn get_annotation(&self) -> String;
 
+    /// Passes the raw annotation string of this element to a closure.
+    ///
+    /// Unlike [`Annotation::get_annotation`], the string produced by libSBML is not
+    /// copied into a Rust `String`.
+    ///
+    /// # Returns
+    /// The value returned by the closure
+    fn with_annotation<R>(&self, f: impl FnOnce(&str) -> R) -> R;
+
     /// Sets a raw string annotation for this element.
     ///
     /// # Arguments
@@ -78,4 +87,57 @@ pub trait Annotation {
     /// # Returns
     /// A Result containing either the deserialized annotation or a deserialization error
     fn get_annotation_serde<T: for<'de> Deserialize<'de>>(&self) -> Result<T, DeError>;
+
+    /// Gets the annotation as a deserializable data structure, reusing the result of a
+    /// previous call.
+    ///
+    /// The deserialized value is cached on this element until the annotation is set
+    /// again through it, or a different type is requested. Changes made through other
+    /// wrappers of the same underlying element are not observed.
+    ///
+    /// The default implementation does not cache and deserializes the annotation on
+    /// every call.
+    ///
+    /// # Type Parameters
+    /// * `T` - The type to deserialize the annotation into
+    ///
+    /// # Returns
+    /// A Result containing either the shared deserialized annotation or a deserialization error
+    fn get_annotation_serde_cached<T: for<'de> Deserialize<'de> + 'static>(
+        &self,
+    ) -> Result<Rc<T>, DeError> {
+        self.get_annotation_serde().map(Rc::new)
+    }
+}
+
+/// Cache of the most recently deserialized annotation of an element.
+#[derive(Default)]
+pub(crate) struct AnnotationCache {
+    value: RefCell<Option<Rc<dyn Any>>>,
+}
+
+impl AnnotationCache {
+    /// Returns the cached value if it is of type `T`.
+    pub(crate) fn get<T: 'static>(&self) -> Option<Rc<T>> {
+        let value = self.value.borrow().clone()?;
+        value.downcast::<T>().ok()
+    }
+
+    /// Replaces the cached value.
+    pub(crate) fn set<T: 'static>(&self, value: Rc<T>) {
+        *self.value.borrow_mut() = Some(value);
+    }
+
+    /// Drops the cached value.
+    pub(crate) fn invalidate(&self) {
+        self.value.borrow_mut().take();
+    }
+}
+
+impl std::fmt::Debug for AnnotationCache {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("AnnotationCache")
+            .field("cached", &self.value.borrow().is_some())
+            .finish()
+    }
 }
@@ -11,8 +11,8 @@
 use std::{cell::RefCell, fmt::Display, pin::Pin, rc::Rc, str::FromStr};
 
 use crate::{
-    clone, inner, pin_ptr, required_property, sbmlcxx, sbo_term, traits::fromptr::FromPtr,
-    unitdef::UnitDefinition, upcast_annotation,
+    clone, incremental::ChangeTracker, inner, pin_ptr, required_property, sbmlcxx, sbo_term,
+    traits::fromptr::FromPtr, unitdef::UnitDefinition, upcast_annotation,
 };
 
 /// A safe wrapper around the libSBML Species class.
@@ -25,6 +25,9 @@ use crate::{
 /// through a RefCell and Pin to ensure memory safety while allowing interior mutability.
 pub struct Unit<'a> {
     inner: RefCell<Pin<&'a mut sbmlcxx::Unit>>,
+    annotation_cache: AnnotationCache,
+    /// Marks the section of the document that contains this element
+    changes: ChangeTracker<'a>,
 }
 
 // Set the inner trait for the Unit struct
@@ -45,7 +48,7 @@ impl<'a> Unit<'a> {
     ///
     /// # Returns
     /// A new Unit instance
-    pub fn new(unit_definition: &UnitDefinition, kind: UnitKind) -> Self {
+    pub fn new(unit_definition: &UnitDefinition<'a>, kind: UnitKind) -> Self {
         let unit_ptr = unit_definition.inner().borrow_mut().as_mut().createUnit();
         let mut unit = pin_ptr!(unit_ptr, sbmlcxx::Unit);
 
@@ -58,6 +61,8 @@ impl<'a> Unit<'a> {
 
         Self {
             inner: RefCell::new(unit),
+            annotation_cache: AnnotationCache::default(),
+            changes: unit_definition.changes(),
         }
     }
 
@@ -107,6 +112,8 @@ impl FromPtr<sbmlcxx::Unit> for Unit<'_> {
         let unit = pin_ptr!(ptr, sbmlcxx::Unit);
         Self {
             inner: RefCell::new(unit),
+            annotation_cache: AnnotationCache::default(),
+            changes: ChangeTracker::default(),
         }
     }
 }
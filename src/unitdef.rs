@@ -12,7 +12,11 @@ use std::{cell::RefCell, pin::Pin, rc::Rc};
 use cxx::let_cxx_string;
 
 use crate::{
-    clone, inner, into_id,
+    clone,
+    incremental::{ChangeTracker, Tracked},
+    index_key, inner, into_id,
+    lazy::{LazyList, ListIter},
+    memory::{self, MemoryUsage},
     model::Model,
     optional_property, pin_ptr, required_property,
     sbmlcxx::{self},
@@ -28,7 +32,10 @@ use crate::{
 /// through a RefCell and Pin to ensure memory safety while allowing interior mutability.
 pub struct UnitDefinition<'a> {
     inner: RefCell<Pin<&'a mut sbmlcxx::UnitDefinition>>,
-    units: RefCell<Vec<Rc<Unit<'a>>>>,
+    annotation_cache: AnnotationCache,
+    /// Marks the section of the document that contains this element
+    changes: ChangeTracker<'a>,
+    units: LazyList<Unit<'a>>,
 }
 
 // Set the inner trait for the UnitDefinition struct
@@ -43,6 +50,9 @@ clone!(UnitDefinition<'a>, sbmlcxx::UnitDefinition, units);
 // Set the into_id trait for the UnitDefinition struct
 into_id!(&Rc<UnitDefinition<'_>>, id);
 
+// Index UnitDefinition collections by id
+index_key!(UnitDefinition<'_>, getId);
+
 impl<'a> UnitDefinition<'a> {
     /// Creates a new UnitDefinition instance within the given Model.
     ///
@@ -65,12 +75,21 @@ impl<'a> UnitDefinition<'a> {
 
         Self {
             inner: RefCell::new(unit_definition),
-            units: RefCell::new(Vec::new()),
+            annotation_cache: AnnotationCache::default(),
+            changes: model.changes(),
+            units: LazyList::new(),
         }
     }
 
     // Getter and setter for id
-    required_property!(UnitDefinition<'a>, id, String, getId, setId);
+    required_property!(
+        UnitDefinition<'a>,
+        id,
+        String,
+        getId,
+        setId,
+        after_set = key_changed
+    );
 
     // Getter and setter for name
     optional_property!(
@@ -88,7 +107,8 @@ impl<'a> UnitDefinition<'a> {
     /// A new Unit instance
     pub fn create_unit(&self, kind: UnitKind) -> Rc<Unit<'a>> {
         let unit = Rc::new(Unit::new(self, kind));
-        self.units.borrow_mut().push(Rc::clone(&unit));
+        self.units.push(Rc::clone(&unit));
+        unit.mark_dirty();
         unit
     }
 
@@ -105,7 +125,14 @@ impl<'a> UnitDefinition<'a> {
     /// # Returns
     /// A vector of all units in the unit definition
     pub fn units(&self) -> Vec<Rc<Unit<'a>>> {
-        self.units.borrow().to_vec()
+        self.loaded_units().borrow().to_vec()
+    }
+
+    /// Returns an iterator over the units in the unit definition.
+    ///
+    /// Unlike [`UnitDefinition::units`], this does not copy the list.
+    pub fn units_iter(&self) -> ListIter<'_, Unit<'a>> {
+        ListIter::new(self.loaded_units())
     }
 
     /// Returns a unit from the unit definition by kind.
@@ -113,13 +140,31 @@ impl<'a> UnitDefinition<'a> {
     /// # Returns
     /// A unit from the unit definition by kind
     pub fn get_unit(&self, kind: UnitKind) -> Option<Rc<Unit<'a>>> {
-        self.units
+        self.loaded_units()
             .borrow()
             .iter()
             .find(|unit| unit.kind() == kind)
             .map(Rc::clone)
     }
 
+    /// Returns the units, wrapping them on first access.
+    fn loaded_units(&self) -> &RefCell<Vec<Rc<Unit<'a>>>> {
+        self.units.get_or_load(|| {
+            let n_units = self.inner.borrow().getNumUnits().0;
+            (0..n_units)
+                .map(|i| {
+                    let unit = self.inner.borrow_mut().as_mut().getUnit(i.into());
+                    Rc::new(Unit::from_ptr(unit).with_changes(self.changes))
+                })
+                .collect()
+        })
+    }
+
+    /// Reports the unit wrappers held by this unit definition.
+    pub(crate) fn wrapper_usage(&self) -> MemoryUsage {
+        self.units.memory_usage(memory::leaf)
+    }
+
     // SBO Term Methods generated by the `sbo_term` macro
     sbo_term!(sbmlcxx::UnitDefinition, sbmlcxx::SBase);
 }
@@ -147,18 +192,13 @@ impl FromPtr<sbmlcxx::UnitDefinition> for UnitDefinition<'_> {
     /// A new UnitDefinition instance
     fn from_ptr(ptr: *mut sbmlcxx::UnitDefinition) -> Self {
         let unit_definition = pin_ptr!(ptr, sbmlcxx::UnitDefinition);
-        let unit_definition = RefCell::new(unit_definition);
-
-        let n_units = unit_definition.borrow().getNumUnits().0;
-        let units: Vec<_> = (0..n_units)
-            .map(|i| {
-                let unit = unit_definition.borrow_mut().as_mut().getUnit(i.into());
-                Rc::new(Unit::from_ptr(unit))
-            })
-            .collect();
+
+        // Units are wrapped on first access
         Self {
-            inner: unit_definition,
-            units: RefCell::new(units),
+            inner: RefCell::new(unit_definition),
+            annotation_cache: AnnotationCache::default(),
+            changes: ChangeTracker::default(),
+            units: LazyList::deferred(),
         }
     }
 }
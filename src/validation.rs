@@ -0,0 +1,476 @@
+//! Selective and parallel consistency checking of SBML documents.
+//!
+//! libSBML groups its consistency checks into categories (identifiers, units, MathML, ...)
+//! that can be switched on and off individually. [`ValidationOptions`] selects the
+//! categories to run and whether independent categories should be checked concurrently.
+//! The outcome is a [`ValidationReport`] holding the merged error log and the time spent
+//! in every category.
+//!
+//! ```no_run
+//! use sbml::prelude::*;
+//!
+//! let doc = SBMLReader::from_file("model.xml").unwrap();
+//! let options = ValidationOptions::new()
+//!     .units(false)
+//!     .modeling_practice(false)
+//!     .parallel(true);
+//!
+//! let report = doc.check_consistency_with(&options);
+//! for timing in &report.timings {
+//!     println!("{:?}: {:?}", timing.check, timing.duration);
+//! }
+//! ```
+
+use std::time::{Duration, Instant};
+
+use crate::{
+    instrument::{trace_event, trace_span},
+    sbmlcxx,
+    sbmldoc::SBMLDocument,
+    sbmlerror::{SBMLError, SBMLErrorLog, SBMLErrorSeverity},
+};
+
+/// A category of consistency checks performed by libSBML.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub enum ConsistencyCheck {
+    /// Uniqueness and validity of identifiers and references to them
+    Identifier,
+    /// General SBML validity rules not covered by the other categories
+    General,
+    /// Correct use of SBO terms
+    Sbo,
+    /// Validity of MathML expressions
+    MathML,
+    /// Consistency of units of measurement
+    Units,
+    /// Detection of overdetermined models
+    Overdetermined,
+    /// Recommendations on good modeling practice
+    ModelingPractice,
+}
+
+impl ConsistencyCheck {
+    /// All checks, in the order in which libSBML runs them.
+    pub const ALL: [ConsistencyCheck; 7] = [
+        ConsistencyCheck::Identifier,
+        ConsistencyCheck::General,
+        ConsistencyCheck::Sbo,
+        ConsistencyCheck::MathML,
+        ConsistencyCheck::Units,
+        ConsistencyCheck::Overdetermined,
+        ConsistencyCheck::ModelingPractice,
+    ];
+
+    /// Returns whether later checks can only run once this check passed.
+    ///
+    /// Identifier and general consistency are structural prerequisites for all other
+    /// categories and are therefore never run concurrently.
+    fn is_prerequisite(self) -> bool {
+        matches!(
+            self,
+            ConsistencyCheck::Identifier | ConsistencyCheck::General
+        )
+    }
+}
+
+impl From<ConsistencyCheck> for sbmlcxx::SBMLErrorCategory_t {
+    /// Converts a Rust ConsistencyCheck enum to the corresponding C++ SBML enum value
+    fn from(value: ConsistencyCheck) -> Self {
+        match value {
+            ConsistencyCheck::Identifier => {
+                sbmlcxx::SBMLErrorCategory_t::LIBSBML_CAT_IDENTIFIER_CONSISTENCY
+            }
+            ConsistencyCheck::General => {
+                sbmlcxx::SBMLErrorCategory_t::LIBSBML_CAT_GENERAL_CONSISTENCY
+            }
+            ConsistencyCheck::Sbo => sbmlcxx::SBMLErrorCategory_t::LIBSBML_CAT_SBO_CONSISTENCY,
+            ConsistencyCheck::MathML => {
+                sbmlcxx::SBMLErrorCategory_t::LIBSBML_CAT_MATHML_CONSISTENCY
+            }
+            ConsistencyCheck::Units => sbmlcxx::SBMLErrorCategory_t::LIBSBML_CAT_UNITS_CONSISTENCY,
+            ConsistencyCheck::Overdetermined => {
+                sbmlcxx::SBMLErrorCategory_t::LIBSBML_CAT_OVERDETERMINED_MODEL
+            }
+            ConsistencyCheck::ModelingPractice => {
+                sbmlcxx::SBMLErrorCategory_t::LIBSBML_CAT_MODELING_PRACTICE
+            }
+        }
+    }
+}
+
+/// Options controlling which consistency checks are run and how.
+///
+/// By default all categories are enabled, matching
+/// [`SBMLDocument::check_consistency`], and checks run one after another.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct ValidationOptions {
+    checks: Vec<ConsistencyCheck>,
+    parallel: bool,
+}
+
+impl ValidationOptions {
+    /// Creates options with all consistency checks enabled.
+    pub fn new() -> Self {
+        Self {
+            checks: ConsistencyCheck::ALL.to_vec(),
+            parallel: false,
+        }
+    }
+
+    /// Creates options with all consistency checks disabled.
+    ///
+    /// Individual checks can then be enabled using the builder methods.
+    pub fn none() -> Self {
+        Self {
+            checks: Vec::new(),
+            parallel: false,
+        }
+    }
+
+    /// Enables or disables a consistency check.
+    ///
+    /// # Arguments
+    /// * `check` - The category of checks to configure
+    /// * `enabled` - Whether the checks should be run
+    pub fn check(mut self, check: ConsistencyCheck, enabled: bool) -> Self {
+        self.checks.retain(|current| *current != check);
+        if enabled {
+            self.checks.push(check);
+        }
+        self
+    }
+
+    /// Enables or disables the identifier consistency checks.
+    pub fn identifiers(self, enabled: bool) -> Self {
+        self.check(ConsistencyCheck::Identifier, enabled)
+    }
+
+    /// Enables or disables the general consistency checks.
+    pub fn general(self, enabled: bool) -> Self {
+        self.check(ConsistencyCheck::General, enabled)
+    }
+
+    /// Enables or disables the SBO term checks.
+    pub fn sbo(self, enabled: bool) -> Self {
+        self.check(ConsistencyCheck::Sbo, enabled)
+    }
+
+    /// Enables or disables the MathML checks.
+    pub fn mathml(self, enabled: bool) -> Self {
+        self.check(ConsistencyCheck::MathML, enabled)
+    }
+
+    /// Enables or disables the unit consistency checks.
+    pub fn units(self, enabled: bool) -> Self {
+        self.check(ConsistencyCheck::Units, enabled)
+    }
+
+    /// Enables or disables the overdetermined model checks.
+    pub fn overdetermined(self, enabled: bool) -> Self {
+        self.check(ConsistencyCheck::Overdetermined, enabled)
+    }
+
+    /// Enables or disables the modeling practice checks.
+    pub fn modeling_practice(self, enabled: bool) -> Self {
+        self.check(ConsistencyCheck::ModelingPractice, enabled)
+    }
+
+    /// Runs independent categories concurrently.
+    ///
+    /// When checking sequentially, libSBML stops at the first category that reports
+    /// errors. In parallel mode, identifier and general consistency are still checked
+    /// first on the document itself. If they pass, every remaining category is checked
+    /// in its own thread on a copy of the document, and all of them run to completion.
+    pub fn parallel(mut self, parallel: bool) -> Self {
+        self.parallel = parallel;
+        self
+    }
+
+    /// Returns the enabled checks in the order in which libSBML runs them.
+    pub fn enabled_checks(&self) -> Vec<ConsistencyCheck> {
+        ConsistencyCheck::ALL
+            .into_iter()
+            .filter(|check| self.checks.contains(check))
+            .collect()
+    }
+}
+
+impl Default for ValidationOptions {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+/// Time spent in and errors found by a single category of consistency checks.
+#[derive(Debug, Clone)]
+pub struct CheckTiming {
+    /// The category of checks
+    pub check: ConsistencyCheck,
+    /// Wall-clock time spent running the checks
+    pub duration: Duration,
+    /// Number of errors, warnings and other messages reported by the checks
+    pub n_errors: usize,
+}
+
+/// The outcome of a consistency check run with [`ValidationOptions`].
+#[derive(Debug)]
+pub struct ValidationReport {
+    /// The merged error log of all categories, in libSBML's check order
+    pub log: SBMLErrorLog,
+    /// Timings of the categories that were run
+    pub timings: Vec<CheckTiming>,
+    /// Enabled categories that were not run because an earlier category failed
+    pub skipped: Vec<ConsistencyCheck>,
+    /// Total wall-clock time of the validation
+    pub total: Duration,
+}
+
+/// Runs the consistency checks selected by `options` on `document`.
+///
+/// Errors already present in the document's error log (e.g. from reading it) are
+/// included in the report. Checks run on copies are not added to the document's own
+/// error log. Afterwards the categories enabled on the document before the call are
+/// restored.
+pub(crate) fn check_consistency(
+    document: &SBMLDocument,
+    options: &ValidationOptions,
+) -> ValidationReport {
+    let start = Instant::now();
+    let validators = document.inner().borrow().getApplicableValidators();
+    let n_existing = document.inner().borrow().getNumErrors().0;
+    let mut errors = SBMLErrorLog::collect_errors(document, 0..n_existing);
+    let mut timings = Vec::new();
+    let mut skipped = Vec::new();
+
+    let checks = options.enabled_checks();
+    let (sequential, concurrent): (Vec<_>, Vec<_>) = if options.parallel {
+        checks
+            .into_iter()
+            .partition(|check| check.is_prerequisite())
+    } else {
+        (checks, Vec::new())
+    };
+
+    // Like libSBML, stop at the first category that reports errors
+    let mut failed = false;
+    for check in sequential {
+        if failed {
+            skipped.push(check);
+            continue;
+        }
+
+        let (check_errors, timing) = run_check(document, check);
+        failed = has_errors(&check_errors);
+        errors.extend(check_errors);
+        timings.push(timing);
+    }
+
+    if failed {
+        skipped.extend(concurrent);
+    } else if !concurrent.is_empty() {
+        let copies: Vec<_> = concurrent
+            .iter()
+            .map(|check| (*check, document.clone()))
+            .collect();
+
+        let results: Vec<_> = std::thread::scope(|scope| {
+            let handles: Vec<_> = copies
+                .into_iter()
+                .map(|(check, copy)| scope.spawn(move || run_check(&copy, check)))
+                .collect();
+
+            handles
+                .into_iter()
+                .map(|handle| handle.join().expect("Consistency check panicked"))
+                .collect()
+        });
+
+        for (check_errors, timing) in results {
+            errors.extend(check_errors);
+            timings.push(timing);
+        }
+    }
+
+    document
+        .inner()
+        .borrow_mut()
+        .pin_mut()
+        .setApplicableValidators(validators);
+
+    ValidationReport {
+        log: SBMLErrorLog::from_errors(errors),
+        timings,
+        skipped,
+        total: start.elapsed(),
+    }
+}
+
+/// Runs a single category of consistency checks and returns the errors it reported.
+fn run_check(document: &SBMLDocument, check: ConsistencyCheck) -> (Vec<SBMLError>, CheckTiming) {
+    trace_span!("check_consistency", category = ?check);
+    for category in ConsistencyCheck::ALL {
+        document
+            .inner()
+            .borrow_mut()
+            .pin_mut()
+            .setConsistencyChecks(category.into(), category == check);
+    }
+
+    let n_before = document.inner().borrow().getNumErrors().0;
+    let start = Instant::now();
+    document.inner().borrow_mut().pin_mut().checkConsistency();
+    let duration = start.elapsed();
+    let n_after = document.inner().borrow().getNumErrors().0;
+
+    let errors = SBMLErrorLog::collect_errors(document, n_before..n_after);
+    trace_event!(n_errors = errors.len(), duration = ?duration);
+    let timing = CheckTiming {
+        check,
+        duration,
+        n_errors: errors.len(),
+    };
+
+    (errors, timing)
+}
+
+/// Returns whether any of the errors has severity Error or Fatal.
+fn has_errors(errors: &[SBMLError]) -> bool {
+    errors.iter().any(|error| {
+        error.severity == SBMLErrorSeverity::Error || error.severity == SBMLErrorSeverity::Fatal
+    })
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn invalid_document() -> SBMLDocument {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("model");
+
+        // A species without a compartment and a parameter without value or units
+        model
+            .build_species("some")
+            .initial_concentration(-10.0)
+            .build();
+        model.build_parameter("test").build();
+
+        doc
+    }
+
+    #[test]
+    fn test_options_enabled_checks() {
+        let options = ValidationOptions::none()
+            .modeling_practice(true)
+            .identifiers(true)
+            .units(true)
+            .units(false);
+
+        assert_eq!(
+            options.enabled_checks(),
+            vec![
+                ConsistencyCheck::Identifier,
+                ConsistencyCheck::ModelingPractice
+            ]
+        );
+        assert_eq!(
+            ValidationOptions::default().enabled_checks(),
+            ConsistencyCheck::ALL.to_vec()
+        );
+    }
+
+    #[test]
+    fn test_no_checks() {
+        let doc = invalid_document();
+        let report = doc.check_consistency_with(&ValidationOptions::none());
+
+        assert!(report.log.valid);
+        assert!(report.log.errors.is_empty());
+        assert!(report.timings.is_empty());
+    }
+
+    #[test]
+    fn test_all_checks_match_check_consistency() {
+        let report = invalid_document().check_consistency_with(&ValidationOptions::new());
+        let log = invalid_document().check_consistency();
+
+        assert_eq!(report.log.valid, log.valid);
+        assert_eq!(report.log.errors.len(), log.errors.len());
+
+        let n_errors: usize = report.timings.iter().map(|timing| timing.n_errors).sum();
+        assert_eq!(n_errors, report.log.errors.len());
+    }
+
+    #[test]
+    fn test_selected_checks() {
+        let doc = invalid_document();
+        let options = ValidationOptions::none().modeling_practice(true);
+        let report = doc.check_consistency_with(&options);
+
+        assert_eq!(report.timings.len(), 1);
+        assert_eq!(report.timings[0].check, ConsistencyCheck::ModelingPractice);
+        assert!(report
+            .log
+            .errors
+            .iter()
+            .all(|error| error.severity != SBMLErrorSeverity::Error));
+    }
+
+    /// A structurally valid document whose parameter lacks a value and units, which
+    /// only yields warnings, so that no category stops the checks early.
+    fn warning_document() -> SBMLDocument {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("model");
+        model.build_compartment("cytosol").size(1.0).build();
+        model
+            .build_species("glucose")
+            .compartment("cytosol")
+            .initial_concentration(10.0)
+            .build();
+        model.build_parameter("test").build();
+
+        doc
+    }
+
+    #[test]
+    fn test_parallel_matches_sequential() {
+        let options = ValidationOptions::new();
+        let sequential = warning_document().check_consistency_with(&options);
+        let parallel = warning_document().check_consistency_with(&options.clone().parallel(true));
+
+        let mut sequential_messages: Vec<_> = sequential
+            .log
+            .errors
+            .iter()
+            .map(|error| error.message.clone())
+            .collect();
+        let mut parallel_messages: Vec<_> = parallel
+            .log
+            .errors
+            .iter()
+            .map(|error| error.message.clone())
+            .collect();
+        sequential_messages.sort();
+        parallel_messages.sort();
+
+        assert!(sequential.skipped.is_empty());
+        assert!(parallel.skipped.is_empty());
+        assert!(!sequential_messages.is_empty());
+        assert_eq!(sequential_messages, parallel_messages);
+        assert_eq!(parallel.timings.len(), options.enabled_checks().len());
+    }
+
+    #[test]
+    fn test_check_settings_are_restored() {
+        let doc = invalid_document();
+        doc.inner()
+            .borrow_mut()
+            .pin_mut()
+            .setConsistencyChecks(ConsistencyCheck::Units.into(), false);
+        let validators = doc.inner().borrow().getApplicableValidators();
+
+        doc.check_consistency_with(&ValidationOptions::none().units(true).parallel(true));
+        doc.check_consistency_with(&ValidationOptions::none().sbo(true));
+        assert_eq!(doc.inner().borrow().getApplicableValidators(), validators);
+    }
+}
@@ -0,0 +1,335 @@
+//! Copy-on-write variants of a shared base document.
+//!
+//! Parameter scans derive many documents from one base model, each differing in a few
+//! numeric values. Instead of cloning or re-parsing the base for every variant, a
+//! [`DocumentVariant`] records only the changed values on top of a borrowed base
+//! document. A native document is only built when the variant is materialized, which
+//! clones the base with libSBML's `SBMLDocument::clone` and applies the changes.
+//!
+//! ```no_run
+//! use sbml::prelude::*;
+//!
+//! let base = SBMLReader::from_file("model.xml")?;
+//!
+//! for k in [0.1, 1.0, 10.0] {
+//!     let mut variant = base.variant();
+//!     variant.set_parameter_value("k1", k);
+//!     let xml = variant.to_xml_string()?;
+//!     // ...
+//! }
+//! # Ok::<(), Box<dyn std::error::Error>>(())
+//! ```
+
+use std::{cell::OnceCell, collections::BTreeMap, fmt, rc::Rc};
+
+use crate::{errors::LibSBMLError, model::Model, sbmldoc::SBMLDocument, sbmlerror::SBMLErrorLog};
+
+/// A numeric value of a model element that a variant can change.
+#[derive(Debug, Clone, PartialEq, Eq, PartialOrd, Ord, Hash)]
+pub enum ValueTarget {
+    /// The value of the parameter with the given id
+    ParameterValue(String),
+    /// The value of the FBC flux bound with the given id
+    FluxBoundValue(String),
+    /// The initial concentration of the species with the given id
+    SpeciesInitialConcentration(String),
+    /// The initial amount of the species with the given id
+    SpeciesInitialAmount(String),
+    /// The size of the compartment with the given id
+    CompartmentSize(String),
+}
+
+impl fmt::Display for ValueTarget {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        match self {
+            ValueTarget::ParameterValue(id) => write!(f, "value of parameter '{id}'"),
+            ValueTarget::FluxBoundValue(id) => write!(f, "value of flux bound '{id}'"),
+            ValueTarget::SpeciesInitialConcentration(id) => {
+                write!(f, "initial concentration of species '{id}'")
+            }
+            ValueTarget::SpeciesInitialAmount(id) => {
+                write!(f, "initial amount of species '{id}'")
+            }
+            ValueTarget::CompartmentSize(id) => write!(f, "size of compartment '{id}'"),
+        }
+    }
+}
+
+/// A set of value changes over a shared, unchanged base document.
+///
+/// The base document is borrowed and never modified by the variant. It must not be
+/// changed while variants of it exist, since the changes are applied to its state at
+/// the time a variant is materialized.
+pub struct DocumentVariant<'b> {
+    /// The document the changes apply to
+    base: &'b SBMLDocument,
+    /// The model of the base document, wrapped on first lookup
+    base_model: OnceCell<Option<Rc<Model<'b>>>>,
+    /// The changed values
+    changes: BTreeMap<ValueTarget, f64>,
+}
+
+impl<'b> DocumentVariant<'b> {
+    /// Creates a variant of the given document without any changes.
+    ///
+    /// # Arguments
+    /// * `base` - The document the changes apply to
+    pub fn new(base: &'b SBMLDocument) -> Self {
+        Self {
+            base,
+            base_model: OnceCell::new(),
+            changes: BTreeMap::new(),
+        }
+    }
+
+    /// Returns the base document of the variant.
+    pub fn base(&self) -> &'b SBMLDocument {
+        self.base
+    }
+
+    /// Changes a value of the variant, replacing an earlier change of the same value.
+    ///
+    /// Whether the element exists is only checked when the variant is materialized.
+    ///
+    /// # Arguments
+    /// * `target` - The value to change
+    /// * `value` - The new value
+    pub fn set(&mut self, target: ValueTarget, value: f64) -> &mut Self {
+        self.changes.insert(target, value);
+        self
+    }
+
+    /// Changes the value of a parameter.
+    pub fn set_parameter_value(&mut self, id: &str, value: f64) -> &mut Self {
+        self.set(ValueTarget::ParameterValue(id.to_string()), value)
+    }
+
+    /// Changes the value of an FBC flux bound.
+    pub fn set_flux_bound_value(&mut self, id: &str, value: f64) -> &mut Self {
+        self.set(ValueTarget::FluxBoundValue(id.to_string()), value)
+    }
+
+    /// Changes the initial concentration of a species.
+    pub fn set_species_initial_concentration(&mut self, id: &str, value: f64) -> &mut Self {
+        self.set(
+            ValueTarget::SpeciesInitialConcentration(id.to_string()),
+            value,
+        )
+    }
+
+    /// Changes the initial amount of a species.
+    pub fn set_species_initial_amount(&mut self, id: &str, value: f64) -> &mut Self {
+        self.set(ValueTarget::SpeciesInitialAmount(id.to_string()), value)
+    }
+
+    /// Changes the size of a compartment.
+    pub fn set_compartment_size(&mut self, id: &str, value: f64) -> &mut Self {
+        self.set(ValueTarget::CompartmentSize(id.to_string()), value)
+    }
+
+    /// Reverts a change, so that the value of the base document applies again.
+    ///
+    /// # Returns
+    /// The reverted value, or None if the value was not changed
+    pub fn reset(&mut self, target: &ValueTarget) -> Option<f64> {
+        self.changes.remove(target)
+    }
+
+    /// Returns the value as seen by the variant.
+    ///
+    /// # Returns
+    /// The changed value if there is one, otherwise the value of the base document, or
+    /// None if the element does not exist or has no value
+    pub fn get(&self, target: &ValueTarget) -> Option<f64> {
+        if let Some(&value) = self.changes.get(target) {
+            return Some(value);
+        }
+
+        let model = self.base_model.get_or_init(|| self.base.model()).as_ref()?;
+        match target {
+            ValueTarget::ParameterValue(id) => model.get_parameter(id)?.value(),
+            ValueTarget::FluxBoundValue(id) => model.get_flux_bound(id)?.value(),
+            ValueTarget::SpeciesInitialConcentration(id) => {
+                model.get_species(id)?.initial_concentration()
+            }
+            ValueTarget::SpeciesInitialAmount(id) => model.get_species(id)?.initial_amount(),
+            ValueTarget::CompartmentSize(id) => model.get_compartment(id)?.size(),
+        }
+    }
+
+    /// Returns the changes of the variant, ordered by target.
+    pub fn changes(&self) -> impl Iterator<Item = (&ValueTarget, f64)> + '_ {
+        self.changes.iter().map(|(target, &value)| (target, value))
+    }
+
+    /// Returns whether the variant changes any value.
+    pub fn is_empty(&self) -> bool {
+        self.changes.is_empty()
+    }
+
+    /// Builds a native document holding the base document with all changes applied.
+    ///
+    /// # Returns
+    /// An independent document that owns its own libSBML object tree
+    ///
+    /// # Errors
+    /// Returns `LibSBMLError::InvalidArgument` if a changed element does not exist in the
+    /// base document
+    pub fn materialize(&self) -> Result<SBMLDocument, LibSBMLError> {
+        let document = self.base.clone();
+        if self.changes.is_empty() {
+            return Ok(document);
+        }
+
+        {
+            let model = document.model().ok_or_else(|| {
+                LibSBMLError::InvalidArgument("The base document has no model".to_string())
+            })?;
+            for (target, &value) in &self.changes {
+                apply(&model, target, value).ok_or_else(|| {
+                    LibSBMLError::InvalidArgument(format!(
+                        "Cannot change the {target}: no such element in the base document"
+                    ))
+                })?;
+            }
+        }
+
+        Ok(document)
+    }
+
+    /// Materializes the variant and serializes it to an XML string.
+    ///
+    /// # Errors
+    /// See [`DocumentVariant::materialize`]
+    pub fn to_xml_string(&self) -> Result<String, LibSBMLError> {
+        Ok(self.materialize()?.to_xml_string())
+    }
+
+    /// Materializes the variant and checks its consistency.
+    ///
+    /// # Errors
+    /// See [`DocumentVariant::materialize`]
+    pub fn check_consistency(&self) -> Result<SBMLErrorLog, LibSBMLError> {
+        Ok(self.materialize()?.check_consistency())
+    }
+}
+
+impl fmt::Debug for DocumentVariant<'_> {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        let mut ds = f.debug_struct("DocumentVariant");
+        ds.field("changes", &self.changes);
+        ds.finish()
+    }
+}
+
+/// Applies a single change to a materialized model, or returns None if the element
+/// does not exist.
+fn apply(model: &Model<'_>, target: &ValueTarget, value: f64) -> Option<()> {
+    match target {
+        ValueTarget::ParameterValue(id) => model.get_parameter(id)?.set_value(value),
+        ValueTarget::FluxBoundValue(id) => model.get_flux_bound(id)?.set_value(value),
+        ValueTarget::SpeciesInitialConcentration(id) => {
+            model.get_species(id)?.set_initial_concentration(value)
+        }
+        ValueTarget::SpeciesInitialAmount(id) => model.get_species(id)?.set_initial_amount(value),
+        ValueTarget::CompartmentSize(id) => model.get_compartment(id)?.set_size(value),
+    }
+    Some(())
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::prelude::*;
+
+    fn base_document() -> SBMLDocument {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("base");
+        model.build_compartment("cytosol").size(1.0).build();
+        model
+            .build_species("glucose")
+            .compartment("cytosol")
+            .initial_concentration(5.0)
+            .build();
+        model.build_parameter("k1").value(0.5).build();
+        model.create_reaction("r1");
+        let flux_bound = model
+            .create_flux_bound("fb", "r1", FluxBoundOperation::LessEqual)
+            .unwrap();
+        flux_bound.set_value(100.0);
+        doc
+    }
+
+    #[test]
+    fn test_variant_get() {
+        let base = base_document();
+        let mut variant = base.variant();
+        variant.set_parameter_value("k1", 2.0);
+
+        let k1 = ValueTarget::ParameterValue("k1".to_string());
+        let glucose = ValueTarget::SpeciesInitialConcentration("glucose".to_string());
+        assert_eq!(variant.get(&k1), Some(2.0));
+        assert_eq!(variant.get(&glucose), Some(5.0));
+        assert_eq!(
+            variant.get(&ValueTarget::ParameterValue("unknown".to_string())),
+            None
+        );
+
+        assert_eq!(variant.reset(&k1), Some(2.0));
+        assert_eq!(variant.get(&k1), Some(0.5));
+        assert!(variant.is_empty());
+    }
+
+    #[test]
+    fn test_variant_materialize() {
+        let base = base_document();
+        let mut variant = base.variant();
+        variant
+            .set_parameter_value("k1", 2.0)
+            .set_flux_bound_value("fb", 10.0)
+            .set_species_initial_concentration("glucose", 1.0)
+            .set_compartment_size("cytosol", 3.0);
+
+        let document = variant.materialize().unwrap();
+        let model = document.model().unwrap();
+        assert_eq!(model.get_parameter("k1").unwrap().value(), Some(2.0));
+        assert_eq!(model.get_flux_bound("fb").unwrap().value(), Some(10.0));
+        assert_eq!(
+            model
+                .get_species("glucose")
+                .unwrap()
+                .initial_concentration(),
+            Some(1.0)
+        );
+        assert_eq!(model.get_compartment("cytosol").unwrap().size(), Some(3.0));
+
+        // The base document is left untouched
+        let base_model = base.model().unwrap();
+        assert_eq!(base_model.get_parameter("k1").unwrap().value(), Some(0.5));
+        assert_eq!(
+            base_model.get_flux_bound("fb").unwrap().value(),
+            Some(100.0)
+        );
+    }
+
+    #[test]
+    fn test_variant_missing_element() {
+        let base = base_document();
+        let mut variant = base.variant();
+        variant.set_parameter_value("unknown", 1.0);
+
+        assert!(matches!(
+            variant.materialize(),
+            Err(LibSBMLError::InvalidArgument(_))
+        ));
+        assert!(variant.to_xml_string().is_err());
+    }
+
+    #[test]
+    fn test_variant_without_changes() {
+        let base = base_document();
+        let variant = DocumentVariant::new(&base);
+        assert_eq!(variant.to_xml_string().unwrap(), base.to_xml_string());
+        assert!(variant.check_consistency().is_ok());
+    }
+}
@@ -0,0 +1,343 @@
+//! This module provides a safe Rust interface to the libSBML SBMLWriter class.
+//!
+//! An [`SBMLWriter`] owns a native writer and an output buffer that are reused for
+//! every document it writes. libSBML streams the document straight into the buffer,
+//! whose capacity is kept between documents, so writing many documents of similar
+//! size allocates on the native side only while the buffer grows. After a document
+//! of more than [`MAX_RETAINED_BUFFER_BYTES`] the buffer is released again, so that
+//! the thread-local writers do not keep the size of the largest document forever.
+//!
+//! [`SBMLDocument::to_xml_string`], [`SBMLDocument::write_to`] and
+//! [`SBMLDocument::write_to_file`] use a writer owned by the current thread, see
+//! [`SBMLWriter::with_thread_local`]. Services that write documents at a high rate
+//! can also keep a writer of their own:
+//!
+//! ```no_run
+//! use sbml::prelude::*;
+//!
+//! let reader = SBMLReader::new();
+//! let writer = SBMLWriter::new();
+//! for path in ["model_a.xml", "model_b.xml"] {
+//!     let doc = reader.read_file(path)?;
+//!     let _xml = writer.write_string(&doc);
+//! }
+//! # Ok::<(), Box<dyn std::error::Error>>(())
+//! ```
+
+use std::{
+    cell::RefCell,
+    io::Write,
+    path::{Path, PathBuf},
+    sync::atomic::{AtomicU64, Ordering},
+};
+
+use autocxx::WithinUniquePtr;
+use cxx::{let_cxx_string, CxxString, UniquePtr};
+
+use crate::{
+    errors::LibSBMLError,
+    instrument::{trace_event, trace_span},
+    reader::{recycle_buffer, MAX_RETAINED_BUFFER_BYTES},
+    sbmlcxx,
+    sbmldoc::SBMLDocument,
+};
+
+thread_local! {
+    /// Writer used by the serialization methods of [`SBMLDocument`] on this thread
+    static THREAD_WRITER: SBMLWriter = SBMLWriter::new();
+}
+
+/// A safe wrapper around the libSBML SBMLWriter class.
+///
+/// The writer and its output buffer are reused for every document written through
+/// it. A writer is not `Sync`, use one writer per thread.
+pub struct SBMLWriter {
+    /// The underlying libSBML writer
+    inner: RefCell<UniquePtr<sbmlcxx::SBMLWriter>>,
+    /// Native output buffer, kept between documents up to [`MAX_RETAINED_BUFFER_BYTES`]
+    buffer: RefCell<UniquePtr<CxxString>>,
+}
+
+impl SBMLWriter {
+    /// Creates a new SBMLWriter instance.
+    ///
+    /// # Returns
+    /// A new SBMLWriter instance with an empty output buffer
+    pub fn new() -> Self {
+        Self {
+            inner: RefCell::new(sbmlcxx::SBMLWriter::new().within_unique_ptr()),
+            buffer: RefCell::new(sbmlcxx::make_string("")),
+        }
+    }
+
+    /// Runs `f` with the writer owned by the current thread.
+    ///
+    /// Every thread, including the worker threads of a rayon pool, lazily creates one
+    /// writer that is reused for all documents it writes. If the thread is shutting
+    /// down and its writer is gone, or if the writer is in use further up the stack,
+    /// e.g. by a [`Write`] destination that writes another document, a temporary
+    /// writer is used instead.
+    ///
+    /// # Arguments
+    /// * `f` - The function to run with the writer
+    ///
+    /// # Returns
+    /// The result of `f`
+    pub fn with_thread_local<R>(f: impl FnOnce(&SBMLWriter) -> R) -> R {
+        let mut f = Some(f);
+        THREAD_WRITER
+            .try_with(|writer| {
+                if writer.buffer.try_borrow_mut().is_ok() {
+                    Some((f.take().expect("called at most once"))(writer))
+                } else {
+                    None
+                }
+            })
+            .ok()
+            .flatten()
+            .unwrap_or_else(|| (f.take().expect("called at most once"))(&SBMLWriter::new()))
+    }
+
+    /// Serializes a document to an XML string.
+    ///
+    /// # Arguments
+    /// * `document` - The document to write
+    ///
+    /// # Returns
+    /// A String containing the XML representation of the document, or an empty
+    /// String if the document is not available
+    pub fn write_string(&self, document: &SBMLDocument) -> String {
+        trace_span!("write_string");
+        self.with_output(document, |xml| xml.to_string_lossy().into_owned())
+            .unwrap_or_default()
+    }
+
+    /// Writes the XML representation of a document to a writer.
+    ///
+    /// The document is serialized into the reused native buffer, which is written out
+    /// directly, without an intermediate Rust `String`.
+    ///
+    /// # Arguments
+    /// * `document` - The document to write
+    /// * `output` - The destination to write the SBML XML to
+    ///
+    /// # Returns
+    /// Ok(()) if the document was written, or the error returned by the writer
+    pub fn write_to(
+        &self,
+        document: &SBMLDocument,
+        mut output: impl Write,
+    ) -> Result<(), LibSBMLError> {
+        self.with_output(document, |xml| output.write_all(xml.as_bytes()))
+            .transpose()?;
+        output.flush()?;
+        Ok(())
+    }
+
+    /// Writes a document to a file.
+    ///
+    /// The file is written by libSBML directly. If the file name ends in `.gz`,
+    /// `.zip` or `.bz2`, the output is compressed accordingly, which requires
+    /// libSBML to be built with the respective compression support.
+    ///
+    /// # Arguments
+    /// * `document` - The document to write
+    /// * `path` - Path of the file to write
+    ///
+    /// # Returns
+    /// Ok(()) if the document was written, or an error if compression is not
+    /// available or the file could not be written
+    pub fn write_file(
+        &self,
+        document: &SBMLDocument,
+        path: impl AsRef<Path>,
+    ) -> Result<(), LibSBMLError> {
+        let path = path.as_ref();
+        let path_str = path.to_str().ok_or_else(|| {
+            LibSBMLError::InvalidArgument(format!("Path is not valid UTF-8: {}", path.display()))
+        })?;
+        trace_span!("write_file", path = path_str);
+
+        let is_gzip = path
+            .extension()
+            .is_some_and(|ext| ext.eq_ignore_ascii_case("gz"));
+        if is_gzip && !sbmlcxx::SBMLWriter::hasZlib() {
+            return Err(LibSBMLError::InvalidArgument(
+                "libSBML has been built without zlib support, cannot write gzip files".to_string(),
+            ));
+        }
+
+        let doc_ptr = document.document_ptr().ok_or_else(|| {
+            LibSBMLError::InvalidArgument("The document is not available".to_string())
+        })?;
+
+        let_cxx_string!(filename = path_str);
+        let written = unsafe {
+            self.inner
+                .borrow_mut()
+                .pin_mut()
+                .writeSBMLToFile(doc_ptr, &filename)
+        };
+
+        if written {
+            Ok(())
+        } else {
+            Err(std::io::Error::other(format!(
+                "Failed to write SBML document to {}",
+                path.display()
+            ))
+            .into())
+        }
+    }
+
+    /// Serializes a document into the output buffer and passes the result to `f`.
+    ///
+    /// # Returns
+    /// The result of `f`, or None if the document is not available
+    fn with_output<R>(
+        &self,
+        document: &SBMLDocument,
+        f: impl FnOnce(&CxxString) -> R,
+    ) -> Option<R> {
+        let doc_ptr = document.document_ptr()?;
+        let mut buffer = self.buffer.borrow_mut();
+
+        // SAFETY: The document is borrowed for the duration of the call
+        unsafe {
+            sbmlcxx::sbmlrs::writeSBMLInto(
+                self.inner.borrow_mut().pin_mut(),
+                doc_ptr,
+                buffer.pin_mut(),
+            );
+        }
+        trace_event!(bytes_out = buffer.len());
+
+        let result = f(&buffer);
+        if buffer.len() > MAX_RETAINED_BUFFER_BYTES {
+            recycle_buffer(&mut buffer);
+        }
+        Some(result)
+    }
+}
+
+/// Counter that makes the name of every temporary file of this process unique.
+static TEMP_FILES: AtomicU64 = AtomicU64::new(0);
+
+/// Returns a hidden path next to `path` for writing a file before moving it into place.
+///
+/// The name contains the process id and a counter shared by all threads, so that
+/// concurrent writers of the same target never write to the same temporary file.
+///
+/// # Arguments
+/// * `path` - Path of the file that will be replaced
+///
+/// # Returns
+/// The temporary path, or an error if `path` does not name a file
+pub(crate) fn temp_path_for(path: &Path) -> std::io::Result<PathBuf> {
+    let file_name = path.file_name().ok_or_else(|| {
+        std::io::Error::new(
+            std::io::ErrorKind::InvalidInput,
+            format!("Not a file path: {}", path.display()),
+        )
+    })?;
+    let mut temp_name = std::ffi::OsString::from(".");
+    temp_name.push(file_name);
+    temp_name.push(format!(
+        ".{}.{}.tmp",
+        std::process::id(),
+        TEMP_FILES.fetch_add(1, Ordering::Relaxed)
+    ));
+    Ok(path.with_file_name(temp_name))
+}
+
+impl Default for SBMLWriter {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl std::fmt::Debug for SBMLWriter {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("SBMLWriter").finish_non_exhaustive()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::prelude::*;
+
+    #[test]
+    fn test_writer_reuse() {
+        let large = SBMLReader::from_file("tests/data/odes_example_test.xml").unwrap();
+        let small = SBMLDocument::default();
+        small.create_model("small");
+
+        let writer = SBMLWriter::new();
+        let large_xml = writer.write_string(&large);
+        let small_xml = writer.write_string(&small);
+
+        // The buffer holds only the last document, whatever its size
+        assert!(small_xml.len() < large_xml.len());
+        assert!(small_xml.trim_end().ends_with("</sbml>"));
+        assert_eq!(small_xml.matches("<?xml").count(), 1);
+        assert_eq!(writer.write_string(&large), large_xml);
+
+        let mut output = Vec::new();
+        writer.write_to(&small, &mut output).unwrap();
+        assert_eq!(String::from_utf8(output).unwrap(), small_xml);
+    }
+
+    #[test]
+    fn test_large_buffer_is_released() {
+        let small = SBMLDocument::default();
+        small.create_model("small");
+        let large = SBMLDocument::default();
+        let annotation = format!(
+            "<data xmlns=\"https://example.org\">{}</data>",
+            "x".repeat(MAX_RETAINED_BUFFER_BYTES)
+        );
+        large
+            .create_model("large")
+            .set_annotation(&annotation)
+            .unwrap();
+
+        let writer = SBMLWriter::new();
+        writer.write_string(&small);
+        let retained = writer.buffer.borrow().as_ptr();
+        writer.write_string(&small);
+        assert_eq!(writer.buffer.borrow().as_ptr(), retained);
+
+        // The buffer of a document above the limit is replaced after the write
+        let xml = writer.write_string(&large);
+        assert!(xml.len() > MAX_RETAINED_BUFFER_BYTES);
+        assert_ne!(writer.buffer.borrow().as_ptr(), retained);
+        assert!(writer.buffer.borrow().is_empty());
+        assert_eq!(writer.write_string(&small), small.to_xml_string());
+    }
+
+    #[test]
+    fn test_thread_local_writer() {
+        let doc = SBMLReader::from_file("tests/data/example.xml").unwrap();
+        let xml = SBMLWriter::new().write_string(&doc);
+
+        assert_eq!(doc.to_xml_string(), xml);
+        let nested = SBMLWriter::with_thread_local(|writer| {
+            // Documents can be written while the thread's writer is in use
+            assert_eq!(doc.to_xml_string(), xml);
+            writer.write_string(&doc)
+        });
+        assert_eq!(nested, xml);
+    }
+
+    #[test]
+    fn test_write_file() {
+        let dir = tempfile::tempdir().unwrap();
+        let path = dir.path().join("model.xml");
+        let doc = SBMLReader::from_file("tests/data/example.xml").unwrap();
+
+        SBMLWriter::new().write_file(&doc, &path).unwrap();
+        let read = SBMLReader::new().read_file(&path).unwrap();
+        assert_eq!(read.model().unwrap().id(), "example");
+    }
+}
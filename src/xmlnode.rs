@@ -0,0 +1,842 @@
+//! Serde deserialization straight from libSBML's native XML trees.
+//!
+//! libSBML keeps annotations as parsed `XMLNode` trees. Reading an annotation as a
+//! string serializes that tree back into XML text, which then has to be parsed again
+//! on the Rust side. The deserializer in this module walks the native tree instead.
+//!
+//! It follows the conventions of quick-xml's serde support, so that types written for
+//! [`quick_xml::de::from_str`] deserialize the same way:
+//!
+//! - attributes are mapped to fields prefixed with `@`
+//! - child elements are mapped to fields of the same (local) name, and repeated
+//!   elements to sequences
+//! - the text content of an element is mapped to a `$text` field
+//! - child elements that do not match any other field are mapped to a `$value` field,
+//!   with the element name selecting the variant of an enum
+//! - primitives are parsed from the text of an element or the value of an attribute,
+//!   and sequences of primitives from whitespace-separated lists
+
+use std::borrow::Cow;
+
+use autocxx::c_int;
+use quick_xml::DeError;
+use serde::de::{
+    self,
+    value::{BorrowedStrDeserializer, CowStrDeserializer, SeqDeserializer, StringDeserializer},
+    DeserializeSeed, Deserializer, EnumAccess, IntoDeserializer, MapAccess, SeqAccess,
+    VariantAccess, Visitor,
+};
+
+use crate::sbmlcxx;
+
+/// A borrowed view of a native XML node.
+#[derive(Clone, Copy)]
+pub(crate) struct XmlNode<'n> {
+    inner: &'n sbmlcxx::XMLNode,
+}
+
+impl<'n> XmlNode<'n> {
+    /// Wraps a native node, returning None for a null pointer.
+    pub(crate) fn from_ptr(ptr: *const sbmlcxx::XMLNode) -> Option<Self> {
+        unsafe { ptr.as_ref() }.map(|inner| Self { inner })
+    }
+
+    /// Returns the node as its `XMLToken` base class.
+    fn token(&self) -> &'n sbmlcxx::XMLToken {
+        // XMLNode derives from XMLToken as its only base class
+        unsafe { &*(self.inner as *const sbmlcxx::XMLNode).cast::<sbmlcxx::XMLToken>() }
+    }
+
+    /// Returns the local name of an element node.
+    fn name(&self) -> &'n str {
+        self.token().getName().to_str().unwrap_or_default()
+    }
+
+    /// Returns the child nodes of this node.
+    fn children(&self) -> impl Iterator<Item = XmlNode<'n>> {
+        let inner = self.inner;
+        (0..inner.getNumChildren().0).map(move |i| XmlNode {
+            inner: inner.getChild1(i.into()),
+        })
+    }
+
+    /// Returns the child element nodes of this node.
+    fn elements(&self) -> impl Iterator<Item = XmlNode<'n>> {
+        self.children().filter(|child| child.token().isElement())
+    }
+
+    /// Returns the names and values of the attributes of this node.
+    ///
+    /// libSBML keeps namespace declarations apart from the other attributes. As in
+    /// quick-xml, they are reported first, as `xmlns` and `xmlns:prefix` attributes.
+    fn attributes(&self) -> Vec<(String, String)> {
+        let token = self.token();
+        let namespaces = (0..token.getNamespacesLength().0).map(|i| {
+            let name = sbmlcxx::sbmlrs::namespaceAttrName(token, c_int(i));
+            let uri = sbmlcxx::sbmlrs::namespaceURI(token, c_int(i));
+            (
+                name.to_str().unwrap_or_default().to_string(),
+                uri.to_str().unwrap_or_default().to_string(),
+            )
+        });
+        let attributes = (0..token.getAttributesLength().0).map(|i| {
+            let name = token.getAttrName(c_int(i));
+            let value = token.getAttrValue(c_int(i));
+            (
+                name.to_str().unwrap_or_default().to_string(),
+                value.to_str().unwrap_or_default().to_string(),
+            )
+        });
+        namespaces.chain(attributes).collect()
+    }
+
+    /// Returns the trimmed text content of this node.
+    ///
+    /// Text is only borrowed from the native tree if it consists of a single text node.
+    fn text(&self) -> Cow<'n, str> {
+        let mut texts = self
+            .children()
+            .filter(|child| child.token().isText())
+            .map(|child| child.token().getCharacters().to_str().unwrap_or_default());
+
+        let Some(first) = texts.next() else {
+            return Cow::Borrowed("");
+        };
+        match texts.next() {
+            None => Cow::Borrowed(first.trim()),
+            Some(second) => {
+                let mut text = format!("{first}{second}");
+                texts.for_each(|rest| text.push_str(rest));
+                Cow::Owned(text.trim().to_string())
+            }
+        }
+    }
+
+    /// Returns true if this node has attributes or child elements.
+    fn has_structure(&self) -> bool {
+        !self.token().isAttributesEmpty() || self.elements().next().is_some()
+    }
+}
+
+/// Deserializes a value from a native XML node.
+pub(crate) fn from_node<T>(node: XmlNode<'_>) -> Result<T, DeError>
+where
+    T: for<'de> de::Deserialize<'de>,
+{
+    T::deserialize(ElementDeserializer { node })
+}
+
+/// Forwards deserialization methods to the deserializer returned by an expression.
+macro_rules! forward_to {
+    ($target:ident => $($method:ident),* $(,)?) => {
+        $(
+            fn $method<V: Visitor<'n>>(self, visitor: V) -> Result<V::Value, DeError> {
+                self.$target().$method(visitor)
+            }
+        )*
+    };
+}
+
+/// Deserializes a single element.
+struct ElementDeserializer<'n> {
+    node: XmlNode<'n>,
+}
+
+impl<'n> ElementDeserializer<'n> {
+    fn text(self) -> TextDeserializer<'n> {
+        TextDeserializer(self.node.text())
+    }
+}
+
+impl<'n> Deserializer<'n> for ElementDeserializer<'n> {
+    type Error = DeError;
+
+    fn deserialize_any<V: Visitor<'n>>(self, visitor: V) -> Result<V::Value, DeError> {
+        if self.node.has_structure() {
+            self.deserialize_map(visitor)
+        } else {
+            self.text().deserialize_any(visitor)
+        }
+    }
+
+    forward_to!(text =>
+        deserialize_bool, deserialize_i8, deserialize_i16, deserialize_i32, deserialize_i64,
+        deserialize_u8, deserialize_u16, deserialize_u32, deserialize_u64, deserialize_f32,
+        deserialize_f64, deserialize_char, deserialize_str, deserialize_string,
+        deserialize_bytes, deserialize_byte_buf, deserialize_identifier, deserialize_seq,
+    );
+
+    fn deserialize_option<V: Visitor<'n>>(self, visitor: V) -> Result<V::Value, DeError> {
+        visitor.visit_some(self)
+    }
+
+    fn deserialize_unit<V: Visitor<'n>>(self, visitor: V) -> Result<V::Value, DeError> {
+        visitor.visit_unit()
+    }
+
+    fn deserialize_unit_struct<V: Visitor<'n>>(
+        self,
+        _name: &'static str,
+        visitor: V,
+    ) -> Result<V::Value, DeError> {
+        visitor.visit_unit()
+    }
+
+    fn deserialize_newtype_struct<V: Visitor<'n>>(
+        self,
+        _name: &'static str,
+        visitor: V,
+    ) -> Result<V::Value, DeError> {
+        visitor.visit_newtype_struct(self)
+    }
+
+    fn deserialize_tuple<V: Visitor<'n>>(
+        self,
+        _len: usize,
+        visitor: V,
+    ) -> Result<V::Value, DeError> {
+        self.deserialize_seq(visitor)
+    }
+
+    fn deserialize_tuple_struct<V: Visitor<'n>>(
+        self,
+        _name: &'static str,
+        _len: usize,
+        visitor: V,
+    ) -> Result<V::Value, DeError> {
+        self.deserialize_seq(visitor)
+    }
+
+    fn deserialize_map<V: Visitor<'n>>(self, visitor: V) -> Result<V::Value, DeError> {
+        visitor.visit_map(ElementMap::new(self.node, None))
+    }
+
+    fn deserialize_struct<V: Visitor<'n>>(
+        self,
+        _name: &'static str,
+        fields: &'static [&'static str],
+        visitor: V,
+    ) -> Result<V::Value, DeError> {
+        visitor.visit_map(ElementMap::new(self.node, Some(fields)))
+    }
+
+    fn deserialize_enum<V: Visitor<'n>>(
+        self,
+        name: &'static str,
+        variants: &'static [&'static str],
+        visitor: V,
+    ) -> Result<V::Value, DeError> {
+        self.text().deserialize_enum(name, variants, visitor)
+    }
+
+    fn deserialize_ignored_any<V: Visitor<'n>>(self, visitor: V) -> Result<V::Value, DeError> {
+        visitor.visit_unit()
+    }
+}
+
+/// A map entry whose key has been handed out, but whose value has not.
+enum Pending<'n> {
+    Attribute(String),
+    Elements(ElementsDeserializer<'n>),
+    Text(Cow<'n, str>),
+}
+
+/// Presents the attributes, child elements and text of an element as map entries.
+struct ElementMap<'n> {
+    attributes: std::vec::IntoIter<(String, String)>,
+    elements: std::vec::IntoIter<(&'n str, ElementsDeserializer<'n>)>,
+    text: Option<Cow<'n, str>>,
+    pending: Option<Pending<'n>>,
+}
+
+impl<'n> ElementMap<'n> {
+    /// Groups the child elements of a node by name.
+    ///
+    /// If `fields` is given and contains `$value`, elements that do not match any other
+    /// field are collected under `$value`. Text is only exposed as `$text` if no fields
+    /// are given, or if `$text` is one of them.
+    fn new(node: XmlNode<'n>, fields: Option<&'static [&'static str]>) -> Self {
+        let has_field = |field: &str| fields.is_some_and(|fields| fields.contains(&field));
+        let collect_values = has_field("$value");
+
+        let mut elements: Vec<(&'n str, ElementsDeserializer<'n>)> = Vec::new();
+        for element in node.elements() {
+            let name = element.name();
+            let key = if collect_values && !has_field(name) {
+                "$value"
+            } else {
+                name
+            };
+
+            match elements.iter_mut().find(|(existing, _)| *existing == key) {
+                Some((_, group)) => group.nodes.push(element),
+                None => elements.push((
+                    key,
+                    ElementsDeserializer {
+                        nodes: vec![element],
+                        values: key == "$value",
+                    },
+                )),
+            }
+        }
+
+        let text = (fields.is_none() || has_field("$text"))
+            .then(|| node.text())
+            .filter(|text| !text.is_empty());
+
+        Self {
+            attributes: node.attributes().into_iter(),
+            elements: elements.into_iter(),
+            text,
+            pending: None,
+        }
+    }
+}
+
+impl<'n> MapAccess<'n> for ElementMap<'n> {
+    type Error = DeError;
+
+    fn next_key_seed<K: DeserializeSeed<'n>>(
+        &mut self,
+        seed: K,
+    ) -> Result<Option<K::Value>, DeError> {
+        if let Some((name, value)) = self.attributes.next() {
+            self.pending = Some(Pending::Attribute(value));
+            let key: StringDeserializer<DeError> = format!("@{name}").into_deserializer();
+            return seed.deserialize(key).map(Some);
+        }
+
+        if let Some((name, elements)) = self.elements.next() {
+            self.pending = Some(Pending::Elements(elements));
+            return seed
+                .deserialize(BorrowedStrDeserializer::<DeError>::new(name))
+                .map(Some);
+        }
+
+        if let Some(text) = self.text.take() {
+            self.pending = Some(Pending::Text(text));
+            return seed
+                .deserialize(BorrowedStrDeserializer::<DeError>::new("$text"))
+                .map(Some);
+        }
+
+        Ok(None)
+    }
+
+    fn next_value_seed<V: DeserializeSeed<'n>>(&mut self, seed: V) -> Result<V::Value, DeError> {
+        match self.pending.take() {
+            Some(Pending::Attribute(value)) => {
+                seed.deserialize(TextDeserializer(Cow::Owned(value)))
+            }
+            Some(Pending::Elements(elements)) => seed.deserialize(elements),
+            Some(Pending::Text(text)) => seed.deserialize(TextDeserializer(text)),
+            None => Err(DeError::Custom("value requested before key".to_string())),
+        }
+    }
+}
+
+/// Deserializes one or more sibling elements sharing a map key.
+///
+/// Sequences consume all elements, any other type the first one. For `$value` entries
+/// (`values` is set), enums take their variant from the element name.
+struct ElementsDeserializer<'n> {
+    nodes: Vec<XmlNode<'n>>,
+    values: bool,
+}
+
+impl<'n> ElementsDeserializer<'n> {
+    fn first(self) -> ElementDeserializer<'n> {
+        ElementDeserializer {
+            node: self.nodes[0],
+        }
+    }
+}
+
+impl<'n> Deserializer<'n> for ElementsDeserializer<'n> {
+    type Error = DeError;
+
+    forward_to!(first =>
+        deserialize_any, deserialize_bool, deserialize_i8, deserialize_i16, deserialize_i32,
+        deserialize_i64, deserialize_u8, deserialize_u16, deserialize_u32, deserialize_u64,
+        deserialize_f32, deserialize_f64, deserialize_char, deserialize_str,
+        deserialize_string, deserialize_bytes, deserialize_byte_buf, deserialize_unit,
+        deserialize_map, deserialize_identifier, deserialize_ignored_any,
+    );
+
+    fn deserialize_option<V: Visitor<'n>>(self, visitor: V) -> Result<V::Value, DeError> {
+        visitor.visit_some(self)
+    }
+
+    fn deserialize_unit_struct<V: Visitor<'n>>(
+        self,
+        name: &'static str,
+        visitor: V,
+    ) -> Result<V::Value, DeError> {
+        self.first().deserialize_unit_struct(name, visitor)
+    }
+
+    fn deserialize_newtype_struct<V: Visitor<'n>>(
+        self,
+        _name: &'static str,
+        visitor: V,
+    ) -> Result<V::Value, DeError> {
+        visitor.visit_newtype_struct(self)
+    }
+
+    fn deserialize_seq<V: Visitor<'n>>(self, visitor: V) -> Result<V::Value, DeError> {
+        visitor.visit_seq(ElementSeq {
+            nodes: self.nodes.into_iter(),
+            values: self.values,
+        })
+    }
+
+    fn deserialize_tuple<V: Visitor<'n>>(
+        self,
+        _len: usize,
+        visitor: V,
+    ) -> Result<V::Value, DeError> {
+        self.deserialize_seq(visitor)
+    }
+
+    fn deserialize_tuple_struct<V: Visitor<'n>>(
+        self,
+        _name: &'static str,
+        _len: usize,
+        visitor: V,
+    ) -> Result<V::Value, DeError> {
+        self.deserialize_seq(visitor)
+    }
+
+    fn deserialize_struct<V: Visitor<'n>>(
+        self,
+        name: &'static str,
+        fields: &'static [&'static str],
+        visitor: V,
+    ) -> Result<V::Value, DeError> {
+        self.first().deserialize_struct(name, fields, visitor)
+    }
+
+    fn deserialize_enum<V: Visitor<'n>>(
+        self,
+        name: &'static str,
+        variants: &'static [&'static str],
+        visitor: V,
+    ) -> Result<V::Value, DeError> {
+        if self.values {
+            visitor.visit_enum(ElementEnum {
+                node: self.nodes[0],
+            })
+        } else {
+            self.first().deserialize_enum(name, variants, visitor)
+        }
+    }
+}
+
+/// Yields sibling elements as sequence items.
+struct ElementSeq<'n> {
+    nodes: std::vec::IntoIter<XmlNode<'n>>,
+    values: bool,
+}
+
+impl<'n> SeqAccess<'n> for ElementSeq<'n> {
+    type Error = DeError;
+
+    fn next_element_seed<T: DeserializeSeed<'n>>(
+        &mut self,
+        seed: T,
+    ) -> Result<Option<T::Value>, DeError> {
+        self.nodes
+            .next()
+            .map(|node| {
+                seed.deserialize(ElementsDeserializer {
+                    nodes: vec![node],
+                    values: self.values,
+                })
+            })
+            .transpose()
+    }
+
+    fn size_hint(&self) -> Option<usize> {
+        Some(self.nodes.len())
+    }
+}
+
+/// Deserializes an enum whose variant is given by the name of an element.
+struct ElementEnum<'n> {
+    node: XmlNode<'n>,
+}
+
+impl<'n> EnumAccess<'n> for ElementEnum<'n> {
+    type Error = DeError;
+    type Variant = ElementDeserializer<'n>;
+
+    fn variant_seed<V: DeserializeSeed<'n>>(
+        self,
+        seed: V,
+    ) -> Result<(V::Value, Self::Variant), DeError> {
+        let variant =
+            seed.deserialize(BorrowedStrDeserializer::<DeError>::new(self.node.name()))?;
+        Ok((variant, ElementDeserializer { node: self.node }))
+    }
+}
+
+impl<'n> VariantAccess<'n> for ElementDeserializer<'n> {
+    type Error = DeError;
+
+    fn unit_variant(self) -> Result<(), DeError> {
+        Ok(())
+    }
+
+    fn newtype_variant_seed<T: DeserializeSeed<'n>>(self, seed: T) -> Result<T::Value, DeError> {
+        seed.deserialize(self)
+    }
+
+    fn tuple_variant<V: Visitor<'n>>(self, len: usize, visitor: V) -> Result<V::Value, DeError> {
+        Deserializer::deserialize_tuple(self, len, visitor)
+    }
+
+    fn struct_variant<V: Visitor<'n>>(
+        self,
+        fields: &'static [&'static str],
+        visitor: V,
+    ) -> Result<V::Value, DeError> {
+        Deserializer::deserialize_struct(self, "", fields, visitor)
+    }
+}
+
+/// Deserializes primitives from the text of an element or the value of an attribute.
+struct TextDeserializer<'n>(Cow<'n, str>);
+
+impl<'n> TextDeserializer<'n> {
+    fn parse<T: std::str::FromStr>(&self) -> Result<T, DeError> {
+        self.0.parse().map_err(|_| {
+            DeError::Custom(format!(
+                "cannot parse '{}' as {}",
+                self.0,
+                std::any::type_name::<T>()
+            ))
+        })
+    }
+}
+
+/// Implements deserialization methods that parse the text into a primitive.
+macro_rules! parse_text {
+    ($($method:ident => $visit:ident),* $(,)?) => {
+        $(
+            fn $method<V: Visitor<'n>>(self, visitor: V) -> Result<V::Value, DeError> {
+                visitor.$visit(self.parse()?)
+            }
+        )*
+    };
+}
+
+impl<'n> IntoDeserializer<'n, DeError> for TextDeserializer<'n> {
+    type Deserializer = Self;
+
+    fn into_deserializer(self) -> Self {
+        self
+    }
+}
+
+impl<'n> Deserializer<'n> for TextDeserializer<'n> {
+    type Error = DeError;
+
+    fn deserialize_any<V: Visitor<'n>>(self, visitor: V) -> Result<V::Value, DeError> {
+        match self.0 {
+            Cow::Borrowed(text) => visitor.visit_borrowed_str(text),
+            Cow::Owned(text) => visitor.visit_string(text),
+        }
+    }
+
+    fn deserialize_bool<V: Visitor<'n>>(self, visitor: V) -> Result<V::Value, DeError> {
+        match self.0.as_ref() {
+            "true" | "1" => visitor.visit_bool(true),
+            "false" | "0" => visitor.visit_bool(false),
+            other => Err(DeError::Custom(format!("cannot parse '{other}' as bool"))),
+        }
+    }
+
+    parse_text!(
+        deserialize_i8 => visit_i8, deserialize_i16 => visit_i16,
+        deserialize_i32 => visit_i32, deserialize_i64 => visit_i64,
+        deserialize_u8 => visit_u8, deserialize_u16 => visit_u16,
+        deserialize_u32 => visit_u32, deserialize_u64 => visit_u64,
+        deserialize_f32 => visit_f32, deserialize_f64 => visit_f64,
+        deserialize_char => visit_char,
+    );
+
+    fn deserialize_str<V: Visitor<'n>>(self, visitor: V) -> Result<V::Value, DeError> {
+        self.deserialize_any(visitor)
+    }
+
+    fn deserialize_string<V: Visitor<'n>>(self, visitor: V) -> Result<V::Value, DeError> {
+        self.deserialize_any(visitor)
+    }
+
+    fn deserialize_identifier<V: Visitor<'n>>(self, visitor: V) -> Result<V::Value, DeError> {
+        self.deserialize_any(visitor)
+    }
+
+    fn deserialize_bytes<V: Visitor<'n>>(self, visitor: V) -> Result<V::Value, DeError> {
+        match self.0 {
+            Cow::Borrowed(text) => visitor.visit_borrowed_bytes(text.as_bytes()),
+            Cow::Owned(text) => visitor.visit_byte_buf(text.into_bytes()),
+        }
+    }
+
+    fn deserialize_byte_buf<V: Visitor<'n>>(self, visitor: V) -> Result<V::Value, DeError> {
+        self.deserialize_bytes(visitor)
+    }
+
+    fn deserialize_option<V: Visitor<'n>>(self, visitor: V) -> Result<V::Value, DeError> {
+        visitor.visit_some(self)
+    }
+
+    fn deserialize_unit<V: Visitor<'n>>(self, visitor: V) -> Result<V::Value, DeError> {
+        visitor.visit_unit()
+    }
+
+    fn deserialize_unit_struct<V: Visitor<'n>>(
+        self,
+        _name: &'static str,
+        visitor: V,
+    ) -> Result<V::Value, DeError> {
+        visitor.visit_unit()
+    }
+
+    fn deserialize_newtype_struct<V: Visitor<'n>>(
+        self,
+        _name: &'static str,
+        visitor: V,
+    ) -> Result<V::Value, DeError> {
+        visitor.visit_newtype_struct(self)
+    }
+
+    fn deserialize_seq<V: Visitor<'n>>(self, visitor: V) -> Result<V::Value, DeError> {
+        let items: Vec<Cow<'n, str>> = match self.0 {
+            Cow::Borrowed(text) => text.split_whitespace().map(Cow::Borrowed).collect(),
+            Cow::Owned(text) => text
+                .split_whitespace()
+                .map(|item| Cow::Owned(item.to_string()))
+                .collect(),
+        };
+        Deserializer::deserialize_any(
+            SeqDeserializer::new(items.into_iter().map(TextDeserializer)),
+            visitor,
+        )
+    }
+
+    fn deserialize_tuple<V: Visitor<'n>>(
+        self,
+        _len: usize,
+        visitor: V,
+    ) -> Result<V::Value, DeError> {
+        self.deserialize_seq(visitor)
+    }
+
+    fn deserialize_tuple_struct<V: Visitor<'n>>(
+        self,
+        _name: &'static str,
+        _len: usize,
+        visitor: V,
+    ) -> Result<V::Value, DeError> {
+        self.deserialize_seq(visitor)
+    }
+
+    fn deserialize_map<V: Visitor<'n>>(self, _visitor: V) -> Result<V::Value, DeError> {
+        Err(DeError::Custom(format!(
+            "expected an element, found text '{}'",
+            self.0
+        )))
+    }
+
+    fn deserialize_struct<V: Visitor<'n>>(
+        self,
+        _name: &'static str,
+        _fields: &'static [&'static str],
+        visitor: V,
+    ) -> Result<V::Value, DeError> {
+        self.deserialize_map(visitor)
+    }
+
+    fn deserialize_enum<V: Visitor<'n>>(
+        self,
+        name: &'static str,
+        variants: &'static [&'static str],
+        visitor: V,
+    ) -> Result<V::Value, DeError> {
+        CowStrDeserializer::<DeError>::new(self.0).deserialize_enum(name, variants, visitor)
+    }
+
+    fn deserialize_ignored_any<V: Visitor<'n>>(self, visitor: V) -> Result<V::Value, DeError> {
+        visitor.visit_unit()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use serde::Deserialize;
+
+    use super::*;
+    use crate::{prelude::*, wrapper::Wrapper};
+
+    #[derive(Debug, Deserialize, PartialEq)]
+    enum Unit {
+        #[serde(rename = "mM")]
+        MilliMolar,
+        #[serde(rename = "uM")]
+        MicroMolar,
+    }
+
+    #[derive(Debug, Deserialize, PartialEq)]
+    struct Measurement {
+        #[serde(rename = "@id")]
+        id: String,
+        #[serde(rename = "@unit")]
+        unit: Unit,
+        #[serde(rename = "@replicate")]
+        replicate: Option<u32>,
+        time: Vec<f64>,
+        value: Vec<f64>,
+        note: Option<String>,
+    }
+
+    #[derive(Debug, Deserialize, PartialEq)]
+    struct Data {
+        #[serde(rename = "@file")]
+        file: String,
+        #[serde(rename = "measurement", default)]
+        measurements: Vec<Measurement>,
+    }
+
+    #[derive(Debug, Deserialize, PartialEq)]
+    enum Content {
+        #[serde(rename = "data")]
+        Data(Data),
+        #[serde(rename = "label")]
+        Label(String),
+    }
+
+    const ANNOTATION: &str = r#"<data xmlns="https://www.enzymeml.org/v2" file="data.csv">
+        <measurement id="m0" unit="mM" replicate="1">
+            <time>0.0</time><time>1.0</time><time>2.0</time>
+            <value>10.0</value><value>5.5</value><value>2.25</value>
+            <note>first and only</note>
+        </measurement>
+        <measurement id="m1" unit="uM">
+            <time>0.0</time>
+            <value>1.0</value>
+        </measurement>
+    </data>"#;
+
+    fn annotated_species(doc: &SBMLDocument) -> std::rc::Rc<Species<'_>> {
+        let model = doc.create_model("model");
+        let species = model.create_species("glc");
+        species.set_annotation(ANNOTATION).unwrap();
+        species
+    }
+
+    #[test]
+    fn test_deserialize_matches_quick_xml() {
+        let doc = SBMLDocument::default();
+        let species = annotated_species(&doc);
+
+        let native: Data = species.get_annotation_serde().unwrap();
+        let parsed: Wrapper<Data> = quick_xml::de::from_str(&species.get_annotation()).unwrap();
+        assert_eq!(native, parsed.annotation);
+
+        assert_eq!(native.file, "data.csv");
+        assert_eq!(native.measurements.len(), 2);
+        assert_eq!(native.measurements[0].unit, Unit::MilliMolar);
+        assert_eq!(native.measurements[0].replicate, Some(1));
+        assert_eq!(native.measurements[0].time, vec![0.0, 1.0, 2.0]);
+        assert_eq!(
+            native.measurements[0].note.as_deref(),
+            Some("first and only")
+        );
+        assert_eq!(native.measurements[1].replicate, None);
+        assert_eq!(native.measurements[1].note, None);
+    }
+
+    #[test]
+    fn test_deserialize_value_enum() {
+        let doc = SBMLDocument::default();
+        let species = annotated_species(&doc);
+
+        let content: Content = species.get_annotation_serde().unwrap();
+        assert!(matches!(content, Content::Data(data) if data.measurements.len() == 2));
+
+        species.set_annotation("<label> glucose </label>").unwrap();
+        let content: Content = species.get_annotation_serde().unwrap();
+        assert_eq!(content, Content::Label("glucose".to_string()));
+    }
+
+    #[test]
+    fn test_deserialize_errors() {
+        let doc = SBMLDocument::default();
+        let model = doc.create_model("model");
+        let species = model.create_species("glc");
+
+        assert!(species.get_annotation_serde::<Data>().is_err());
+
+        species
+            .set_annotation(r#"<measurement id="m0" unit="nM"><time>0</time></measurement>"#)
+            .unwrap();
+        assert!(species.get_annotation_serde::<Measurement>().is_err());
+    }
+
+    #[test]
+    fn test_cached_annotation() {
+        let doc = SBMLDocument::default();
+        let species = annotated_species(&doc);
+
+        let first = species.get_annotation_serde_cached::<Data>().unwrap();
+        let second = species.get_annotation_serde_cached::<Data>().unwrap();
+        assert!(std::rc::Rc::ptr_eq(&first, &second));
+
+        species
+            .set_annotation(r#"<data file="other.csv"></data>"#)
+            .unwrap();
+        let third = species.get_annotation_serde_cached::<Data>().unwrap();
+        assert_eq!(third.file, "other.csv");
+        assert!(third.measurements.is_empty());
+        assert_eq!(first.file, "data.csv");
+    }
+
+    #[derive(Debug, Deserialize, PartialEq)]
+    struct Namespaced {
+        #[serde(rename = "@xmlns")]
+        xmlns: String,
+        #[serde(rename = "@xmlns:ex")]
+        ex: Option<String>,
+        #[serde(rename = "@file")]
+        file: String,
+    }
+
+    #[test]
+    fn test_deserialize_namespace_declarations() {
+        let doc = SBMLDocument::default();
+        let species = annotated_species(&doc);
+
+        let native: Namespaced = species.get_annotation_serde().unwrap();
+        let parsed: Wrapper<Namespaced> =
+            quick_xml::de::from_str(&species.get_annotation()).unwrap();
+        assert_eq!(native, parsed.annotation);
+        assert_eq!(native.xmlns, "https://www.enzymeml.org/v2");
+        assert_eq!(native.ex, None);
+
+        species
+            .set_annotation(
+                r#"<data xmlns="https://www.enzymeml.org/v2" xmlns:ex="https://example.org" file="a.csv"/>"#,
+            )
+            .unwrap();
+        let native: Namespaced = species.get_annotation_serde().unwrap();
+        assert_eq!(native.ex.as_deref(), Some("https://example.org"));
+        assert_eq!(native.file, "a.csv");
+    }
+
+    #[test]
+    fn test_null_node() {
+        assert!(XmlNode::from_ptr(std::ptr::null()).is_none());
+    }
+}